@@ -0,0 +1,146 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+
+// vstream_engine::process_audio throughput at several chunk sizes.
+//
+// Needs a model: VSTREAM_BENCH_MODEL=/path/to/vosk-model. Audio comes from
+// VSTREAM_BENCH_AUDIO (16 kHz mono WAV) when set, else a synthetic signal,
+// which exercises the decoder but not its language model the same way.
+
+#include <benchmark/benchmark.h>
+#include "vstream_engine.h"
+#include "audio_file.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int sample_rate = 16000;
+
+std::vector<int16_t> load_audio() {
+    if (const char* path = std::getenv("VSTREAM_BENCH_AUDIO")) {
+        audio_file file(path, sample_rate);
+        return {file.samples().begin(), file.samples().end()};
+    }
+
+    // 30s of gliding harmonics under noise, loosely voice-shaped
+    std::vector<int16_t> audio(static_cast<size_t>(sample_rate) * 30);
+    std::mt19937 rng(42);
+    std::normal_distribution<double> noise(0.0, 300.0);
+    double phase = 0.0;
+    for (size_t i = 0; i < audio.size(); ++i) {
+        double t = static_cast<double>(i) / sample_rate;
+        double f0 = 120.0 + 40.0 * std::sin(2.0 * M_PI * 0.7 * t);
+        phase += 2.0 * M_PI * f0 / sample_rate;
+        double v = 0.0;
+        for (int h = 1; h <= 8; ++h) {
+            v += std::sin(h * phase) / h;
+        }
+        double envelope = 0.5 + 0.5 * std::sin(2.0 * M_PI * 2.0 * t);
+        audio[i] = static_cast<int16_t>(std::clamp(4000.0 * envelope * v + noise(rng), -32768.0, 32767.0));
+    }
+    return audio;
+}
+
+vstream_engine* shared_engine() {
+    static std::unique_ptr<vstream_engine> engine = []() -> std::unique_ptr<vstream_engine> {
+        const char* model = std::getenv("VSTREAM_BENCH_MODEL");
+        if (!model) {
+            return nullptr;
+        }
+        vstream_engine::config cfg;
+        cfg.sample_rate = sample_rate;
+        return std::make_unique<vstream_engine>(model, cfg);
+    }();
+    return engine.get();
+}
+
+const std::vector<int16_t>& shared_audio() {
+    static const std::vector<int16_t> audio = load_audio();
+    return audio;
+}
+
+} // namespace
+
+// Arg: chunk size in ms
+static void BM_EngineProcessAudio(benchmark::State& state) {
+    auto* engine = shared_engine();
+    if (!engine) {
+        state.SkipWithError("Set VSTREAM_BENCH_MODEL to a Vosk model directory");
+        return;
+    }
+    const auto& audio = shared_audio();
+    const size_t chunk = static_cast<size_t>(sample_rate * state.range(0) / 1000);
+
+    engine->reset();
+    recognition_result result;
+    size_t pos = 0;
+    size_t samples = 0;
+    for (auto _ : state) {
+        if (pos + chunk > audio.size()) {
+            pos = 0;
+        }
+        engine->process_audio(std::span<const int16_t>(audio).subspan(pos, chunk), result);
+        benchmark::DoNotOptimize(result);
+        pos += chunk;
+        samples += chunk;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(samples));
+    // Seconds of decode per second of audio
+    state.counters["rtf"] = benchmark::Counter(static_cast<double>(samples) / sample_rate,
+                                               benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_EngineProcessAudio)
+    ->Arg(20)->Arg(50)->Arg(100)->Arg(200)->Arg(500)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Session path: pool lookup plus decode, one recognizer per session
+static void BM_EngineProcessAudioSessions(benchmark::State& state) {
+    auto* engine = shared_engine();
+    if (!engine) {
+        state.SkipWithError("Set VSTREAM_BENCH_MODEL to a Vosk model directory");
+        return;
+    }
+    const auto& audio = shared_audio();
+    const size_t chunk = sample_rate / 10;
+    const int sessions = static_cast<int>(state.range(0));
+
+    recognition_result result;
+    size_t pos = 0;
+    size_t samples = 0;
+    int next = 0;
+    for (auto _ : state) {
+        if (pos + chunk > audio.size()) {
+            pos = 0;
+        }
+        engine->process_audio("bench-" + std::to_string(next), std::span<const int16_t>(audio).subspan(pos, chunk),
+                              result);
+        next = (next + 1) % sessions;
+        pos += chunk;
+        samples += chunk;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(samples));
+    state.counters["rtf"] = benchmark::Counter(static_cast<double>(samples) / sample_rate,
+                                               benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_EngineProcessAudioSessions)
+    ->Arg(1)->Arg(8)->Arg(32)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
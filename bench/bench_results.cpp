@@ -0,0 +1,75 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+
+// Parsing of Vosk result JSON into recognition_result, the per-chunk work
+// audio_processor and the WebSocket path do after every decode.
+
+#include <benchmark/benchmark.h>
+#include "recognition_result.h"
+#include <string>
+
+namespace {
+
+// Vosk-shaped final result with per-word timing and confidence
+std::string final_json(int words) {
+    std::string text;
+    std::string result = "{\n  \"result\" : [";
+    for (int i = 0; i < words; ++i) {
+        std::string word = "word" + std::to_string(i % 97);
+        text += (i ? " " : "") + word;
+        result += std::string(i ? ", " : "") + "{\n      \"conf\" : 0.98" + std::to_string(i % 10) +
+                  ",\n      \"end\" : " + std::to_string(0.3 * (i + 1)) +
+                  ",\n      \"start\" : " + std::to_string(0.3 * i) +
+                  ",\n      \"word\" : \"" + word + "\"\n    }";
+    }
+    return result + "],\n  \"text\" : \"" + text + "\"\n}";
+}
+
+std::string partial_json(int words) {
+    std::string text;
+    for (int i = 0; i < words; ++i) {
+        text += (i ? " " : "") + ("word" + std::to_string(i % 97));
+    }
+    return "{\n  \"partial\" : \"" + text + "\"\n}";
+}
+
+} // namespace
+
+static void BM_ResultPartial(benchmark::State& state) {
+    const std::string json = partial_json(static_cast<int>(state.range(0)));
+    recognition_result result;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(result.assign(json));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+BENCHMARK(BM_ResultPartial)->Arg(5)->Arg(50);
+
+static void BM_ResultFinal(benchmark::State& state) {
+    const std::string json = final_json(static_cast<int>(state.range(0)));
+    recognition_result result;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(result.assign(json));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+BENCHMARK(BM_ResultFinal)->Arg(5)->Arg(50);
+
+static void BM_ResultFinalWithWords(benchmark::State& state) {
+    const std::string json = final_json(static_cast<int>(state.range(0)));
+    recognition_result result;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(result.assign(json, true));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+BENCHMARK(BM_ResultFinalWithWords)->Arg(5)->Arg(50);
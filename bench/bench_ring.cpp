@@ -0,0 +1,80 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+
+// The microphone hand-off: the PortAudio callback writes frames into the
+// spsc_ring, the processing thread reads whole chunks back out in place.
+
+#include <benchmark/benchmark.h>
+#include "spsc_ring.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t chunk_samples = 1600;   // 100ms at 16 kHz
+constexpr size_t ring_chunks = 8;
+
+} // namespace
+
+// Arg: callback frames per write; one thread alternates both sides
+static void BM_RingWriteRead(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0));
+    spsc_ring<int16_t> ring(chunk_samples * ring_chunks);
+    std::vector<int16_t> callback(frames, 1);
+
+    size_t samples = 0;
+    for (auto _ : state) {
+        while (ring.read_available() < chunk_samples) {
+            ring.try_write(callback.data(), callback.size());
+        }
+        auto chunk = ring.read_span(chunk_samples);
+        benchmark::DoNotOptimize(chunk.data());
+        ring.release(chunk.size());
+        samples += chunk.size();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(samples * sizeof(int16_t)));
+}
+BENCHMARK(BM_RingWriteRead)->Arg(64)->Arg(256)->Arg(1600);
+
+// Producer on its own thread, as with a real capture callback
+static void BM_RingProducerConsumer(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0));
+    spsc_ring<int16_t> ring(chunk_samples * ring_chunks);
+    std::atomic<bool> stop{false};
+
+    std::thread producer([&] {
+        std::vector<int16_t> callback(frames, 1);
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (!ring.try_write(callback.data(), callback.size())) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    size_t samples = 0;
+    for (auto _ : state) {
+        // Whole chunks, as the processing thread consumes them
+        while (ring.read_available() < chunk_samples) {
+            std::this_thread::yield();
+        }
+        auto chunk = ring.read_span(chunk_samples);
+        benchmark::DoNotOptimize(chunk.data());
+        ring.release(chunk.size());
+        samples += chunk.size();
+    }
+
+    stop = true;
+    producer.join();
+    state.SetBytesProcessed(static_cast<int64_t>(samples * sizeof(int16_t)));
+}
+BENCHMARK(BM_RingProducerConsumer)->Arg(256)->UseRealTime();
@@ -0,0 +1,73 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+
+// Word and character error rate on transcripts from one sentence to a
+// long meeting, with about 10% of the words edited.
+
+#include <benchmark/benchmark.h>
+#include "benchmark_manager.h"
+#include <random>
+#include <string>
+#include <utility>
+
+namespace {
+
+std::pair<std::string, std::string> make_transcripts(int words) {
+    static const char* vocabulary[] = {
+        "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "speech", "model",
+        "server", "stream", "audio", "result", "partial", "final", "session", "latency", "decode", "worker"};
+    constexpr int vocabulary_size = sizeof(vocabulary) / sizeof(vocabulary[0]);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pick(0, vocabulary_size - 1);
+    std::uniform_int_distribution<int> edit(0, 29);
+
+    std::string reference;
+    std::string hypothesis;
+    for (int i = 0; i < words; ++i) {
+        std::string word = vocabulary[pick(rng)];
+        reference += (i ? " " : "") + word;
+        switch (edit(rng)) {
+            case 0:  // deletion
+                break;
+            case 1:  // substitution
+                hypothesis += (hypothesis.empty() ? "" : " ") + std::string(vocabulary[pick(rng)]);
+                break;
+            case 2:  // insertion
+                hypothesis += (hypothesis.empty() ? "" : " ") + word + " " + vocabulary[pick(rng)];
+                break;
+            default:
+                hypothesis += (hypothesis.empty() ? "" : " ") + word;
+        }
+    }
+    return {reference, hypothesis};
+}
+
+} // namespace
+
+static void BM_WordErrorRate(benchmark::State& state) {
+    auto [reference, hypothesis] = make_transcripts(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(benchmark_manager::calculate_wer(reference, hypothesis));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WordErrorRate)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_CharacterErrorRate(benchmark::State& state) {
+    auto [reference, hypothesis] = make_transcripts(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(benchmark_manager::calculate_cer(reference, hypothesis));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * reference.size()));
+}
+BENCHMARK(BM_CharacterErrorRate)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
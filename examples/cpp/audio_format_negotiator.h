@@ -0,0 +1,84 @@
+/**
+ * @file audio_format_negotiator.h
+ * @brief Codec choice and audio_format announcements of the vstream clients
+ *
+ * Free of Qt so the server's test suite can check it against the decoder.
+ */
+
+#pragma once
+
+#include <optional>
+
+/**
+ * @class AudioFormatNegotiator
+ * @brief Keeps the server's view of the session's audio format in step with what is sent
+ *
+ * The server decodes a session's audio by its last "audio_format" command,
+ * not by fields of the audio messages. Opus only encodes 8, 12, 16, 24 and
+ * 48 kHz, so audio at another rate (e.g. 32 kHz) is sent as PCM, and the
+ * server must be told before the first such message - and again whenever
+ * the rate or the codec changes.
+ *
+ * @par Example:
+ * @code
+ * bool announce = false;
+ * auto format = negotiator.formatFor(sample_rate, announce);
+ * if (announce) {
+ *     sendAudioFormat(format);
+ * }
+ * @endcode
+ */
+class AudioFormatNegotiator
+{
+public:
+    /**
+     * @brief Codec and rate of outgoing audio
+     */
+    struct Format {
+        bool opus = false;                 ///< Opus packets instead of PCM
+        int sample_rate = 0;               ///< Capture rate
+
+        bool operator==(const Format&) const = default;
+    };
+
+    /**
+     * @brief Checks if Opus can encode audio at a rate
+     */
+    static bool opusSupportsRate(int sample_rate)
+    {
+        return sample_rate == 8000 || sample_rate == 12000 || sample_rate == 16000 ||
+               sample_rate == 24000 || sample_rate == 48000;
+    }
+
+    /**
+     * @brief Chooses whether Opus is wanted; takes effect with the next audio
+     */
+    void setOpusEnabled(bool enabled) { m_opus_enabled = enabled; }
+
+    /**
+     * @brief Checks if Opus is wanted
+     */
+    bool isOpusEnabled() const { return m_opus_enabled; }
+
+    /**
+     * @brief Forgets the announced format, e.g. on a new connection
+     */
+    void reset() { m_announced.reset(); }
+
+    /**
+     * @brief Format for audio about to be sent
+     * @param sample_rate Rate of the audio
+     * @param announce Set to true if an audio_format command must precede it
+     */
+    Format formatFor(int sample_rate, bool& announce)
+    {
+        Format format{m_opus_enabled && opusSupportsRate(sample_rate), sample_rate};
+        announce = m_announced != format;
+        m_announced = format;
+        return format;
+    }
+
+private:
+    bool m_opus_enabled = false;           ///< Opus requested by the user
+    std::optional<Format> m_announced;     ///< Format the server was last told
+};
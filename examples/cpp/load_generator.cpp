@@ -0,0 +1,526 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+// Headless WebSocket load generator for vstream.
+//
+// Replays WAV files as N concurrent sessions, speaking the same protocol as
+// the Qt client (websocket_client.cpp), and reports throughput, result
+// latency and the server's own load. With --ramp it adds sessions round by
+// round until the server can no longer keep up, and reports the largest
+// sustainable session count per decode thread.
+//
+// Result latency is measured from the newest audio chunk a session had sent
+// to the arrival of each transcription: how far results trail the audio.
+
+#include "audio_file.h"
+#include "latency_histogram.h"
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+using tcp = asio::ip::tcp;
+using json = nlohmann::json;
+using clock_type = std::chrono::steady_clock;
+
+namespace {
+
+struct options {
+    std::string host = "localhost";
+    std::string port = "8080";
+    size_t sessions = 4;
+    double speed = 1.0;                 ///< Audio seconds sent per wall second per session (0 = unpaced)
+    int chunk_ms = 100;
+    int duration_s = 30;                ///< Length of one round
+    int sample_rate = 16000;
+    bool ramp = false;
+    size_t step = 0;                    ///< Sessions added per ramp round (0 = --sessions)
+    size_t max_sessions = 1024;
+    double max_p99_ms = 1000.0;         ///< Result lag a sustainable round stays under
+    bool json_output = false;
+    std::vector<std::string> files;
+};
+
+/**
+ * @brief Counters shared by the sessions of one round
+ */
+struct round_counters {
+    latency_histogram latency;
+    std::atomic<uint64_t> samples_sent{0};
+    std::atomic<uint64_t> results{0};
+    std::atomic<uint64_t> errors{0};
+};
+
+struct round_report {
+    size_t sessions = 0;
+    double wall_s = 0.0;
+    double audio_s = 0.0;
+    double throughput = 0.0;            ///< Audio seconds per wall second, all sessions
+    double target = 0.0;                ///< Throughput the round asked for (0 = unpaced)
+    latency_histogram::summary latency;
+    uint64_t results = 0;
+    uint64_t errors = 0;
+    json server;                        ///< Server "load" stats after the round
+    uint64_t server_dropped = 0;
+    uint64_t server_rejected = 0;
+    size_t decode_threads = 0;
+    bool sustainable = false;
+};
+
+/**
+ * @brief One simulated client: connects, streams audio on a schedule, reads results
+ *
+ * All handlers of a session run on its strand, so its state needs no locks.
+ * Beast allows one outstanding read and one outstanding write at a time.
+ */
+class session : public std::enable_shared_from_this<session> {
+public:
+    session(asio::io_context& io, const options& opts, const tcp::resolver::results_type& endpoints,
+            std::span<const int16_t> audio, size_t offset, std::string id, round_counters& counters,
+            clock_type::time_point start, clock_type::time_point deadline)
+        : m_ws(asio::make_strand(io))
+        , m_timer(m_ws.get_executor())
+        , m_opts(opts)
+        , m_endpoints(endpoints)
+        , m_audio(audio)
+        , m_pos(offset % audio.size())
+        , m_id(std::move(id))
+        , m_counters(counters)
+        , m_start(start)
+        , m_deadline(deadline)
+        , m_chunk(static_cast<size_t>(opts.sample_rate) * opts.chunk_ms / 1000) {
+    }
+
+    void run() {
+        websocket::stream_base::timeout timeouts;
+        timeouts.handshake_timeout = std::chrono::seconds(10);
+        timeouts.idle_timeout = std::chrono::seconds(30);
+        timeouts.keep_alive_pings = true;
+        m_ws.set_option(timeouts);
+
+        auto self = shared_from_this();
+        beast::get_lowest_layer(m_ws).expires_after(std::chrono::seconds(10));
+        beast::get_lowest_layer(m_ws).async_connect(m_endpoints,
+            [self](beast::error_code ec, const tcp::endpoint&) {
+                if (ec) {
+                    return self->fail();
+                }
+                beast::get_lowest_layer(self->m_ws).expires_never();
+                // Small messages must not wait on Nagle, or it shows up as result lag
+                beast::get_lowest_layer(self->m_ws).socket().set_option(tcp::no_delay(true));
+                self->m_ws.async_handshake(self->m_opts.host, "/", [self](beast::error_code ec) {
+                    if (ec) {
+                        return self->fail();
+                    }
+                    self->read();
+                    self->schedule_send();
+                });
+            });
+    }
+
+private:
+    void fail() {
+        m_counters.errors++;
+        m_timer.cancel();
+    }
+
+    void read() {
+        auto self = shared_from_this();
+        m_ws.async_read(m_buffer, [self](beast::error_code ec, size_t) {
+            if (ec) {
+                if (!self->m_closing) {
+                    self->fail();
+                }
+                return;
+            }
+            auto message = json::parse(beast::buffers_to_string(self->m_buffer.data()), nullptr, false);
+            self->m_buffer.consume(self->m_buffer.size());
+            if (message.is_object() && message.value("type", "") == "transcribe" &&
+                self->m_last_send != clock_type::time_point{}) {
+                self->m_counters.latency.record(clock_type::now() - self->m_last_send);
+                self->m_counters.results++;
+            }
+            self->read();
+        });
+    }
+
+    void schedule_send() {
+        if (clock_type::now() >= m_deadline) {
+            return close();
+        }
+        if (m_opts.speed <= 0.0) {
+            return send();
+        }
+
+        // Chunk k is due k chunks of audio (scaled by speed) after the start
+        auto due = m_start + std::chrono::duration_cast<clock_type::duration>(
+                                 std::chrono::duration<double, std::milli>(m_sent_chunks * m_opts.chunk_ms / m_opts.speed));
+        m_timer.expires_at(due);
+        auto self = shared_from_this();
+        m_timer.async_wait([self](beast::error_code ec) {
+            if (!ec) {
+                self->send();
+            }
+        });
+    }
+
+    void send() {
+        json message;
+        message["type"] = "audio";
+        message["sample_rate"] = m_opts.sample_rate;
+        message["channels"] = 1;
+        message["session_id"] = m_id;
+
+        json samples = json::array();
+        for (size_t i = 0; i < m_chunk; ++i) {
+            samples.push_back(m_audio[m_pos]);
+            m_pos = (m_pos + 1) % m_audio.size();
+        }
+        message["audio"] = std::move(samples);
+        m_out = message.dump();
+
+        auto self = shared_from_this();
+        m_ws.text(true);
+        m_ws.async_write(asio::buffer(m_out), [self](beast::error_code ec, size_t) {
+            if (ec) {
+                return self->fail();
+            }
+            self->m_last_send = clock_type::now();
+            self->m_sent_chunks++;
+            self->m_counters.samples_sent += self->m_chunk;
+            self->schedule_send();
+        });
+    }
+
+    void close() {
+        m_closing = true;
+        auto self = shared_from_this();
+        m_ws.async_close(websocket::close_code::normal, [self](beast::error_code) {});
+    }
+
+    websocket::stream<beast::tcp_stream> m_ws;
+    asio::steady_timer m_timer;
+    const options& m_opts;
+    tcp::resolver::results_type m_endpoints;
+    std::span<const int16_t> m_audio;
+    size_t m_pos;
+    std::string m_id;
+    round_counters& m_counters;
+    clock_type::time_point m_start;
+    clock_type::time_point m_deadline;
+    size_t m_chunk;
+    size_t m_sent_chunks = 0;
+    clock_type::time_point m_last_send{};
+    beast::flat_buffer m_buffer;
+    std::string m_out;
+    bool m_closing = false;
+};
+
+// The command handler's reply may wrap the stats object; find it anywhere
+const json* find_key(const json& value, const std::string& key) {
+    if (!value.is_object()) {
+        return nullptr;
+    }
+    if (auto it = value.find(key); it != value.end()) {
+        return &*it;
+    }
+    for (const auto& [name, child] : value.items()) {
+        if (const json* found = find_key(child, key)) {
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+json query_stats(const options& opts) {
+    try {
+        asio::io_context io;
+        tcp::resolver resolver(io);
+        websocket::stream<tcp::socket> ws(io);
+        asio::connect(ws.next_layer(), resolver.resolve(opts.host, opts.port));
+        ws.handshake(opts.host, "/");
+        ws.write(asio::buffer(json{{"type", "command"}, {"command", "stats"}}.dump()));
+
+        // Skip transcripts broadcast to every client until the reply arrives
+        for (int i = 0; i < 100; ++i) {
+            beast::flat_buffer buffer;
+            ws.read(buffer);
+            auto message = json::parse(beast::buffers_to_string(buffer.data()), nullptr, false);
+            if (const json* stats = find_key(message, "stats")) {
+                json result = *stats;
+                ws.close(websocket::close_code::normal);
+                return result;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "stats query failed: " << e.what() << "\n";
+    }
+    return json::object();
+}
+
+uint64_t load_counter(const json& stats, const char* name) {
+    if (stats.contains("load") && stats["load"].contains(name)) {
+        return stats["load"][name].get<uint64_t>();
+    }
+    return 0;
+}
+
+round_report run_round(const options& opts, std::span<const int16_t> audio, size_t sessions, int round) {
+    json before = query_stats(opts);
+
+    asio::io_context io;
+    tcp::resolver resolver(io);
+    auto endpoints = resolver.resolve(opts.host, opts.port);
+
+    round_counters counters;
+    auto start = clock_type::now() + std::chrono::milliseconds(200);
+    auto deadline = start + std::chrono::seconds(opts.duration_s);
+
+    for (size_t i = 0; i < sessions; ++i) {
+        // Spread sessions over the audio and over one chunk interval
+        auto offset = audio.size() * i / sessions;
+        auto stagger = std::chrono::milliseconds(opts.chunk_ms * static_cast<int>(i) / static_cast<int>(sessions));
+        std::make_shared<session>(io, opts, endpoints, audio, offset,
+                                  "loadgen-" + std::to_string(round) + "-" + std::to_string(i),
+                                  counters, start + stagger, deadline)->run();
+    }
+
+    std::vector<std::thread> threads;
+    const unsigned thread_count = std::max(1u, std::min(std::thread::hardware_concurrency(), 8u));
+    for (unsigned t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&io] { io.run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = clock_type::now();
+
+    json after = query_stats(opts);
+
+    round_report report;
+    report.sessions = sessions;
+    report.wall_s = std::max(0.0, std::chrono::duration<double>(end - start).count());
+    report.audio_s = static_cast<double>(counters.samples_sent.load()) / opts.sample_rate;
+    report.throughput = report.wall_s > 0.0 ? report.audio_s / report.wall_s : 0.0;
+    report.target = opts.speed * static_cast<double>(sessions);
+    report.latency = counters.latency.snapshot();
+    report.results = counters.results.load();
+    report.errors = counters.errors.load();
+    report.server = after.value("load", json::object());
+    report.server_dropped = load_counter(after, "dropped_chunks") - load_counter(before, "dropped_chunks");
+    report.server_rejected = load_counter(after, "rejected_chunks") - load_counter(before, "rejected_chunks");
+    report.decode_threads = after.value("decode_threads", size_t{0});
+
+    report.sustainable = report.errors == 0 && report.server_dropped == 0 && report.server_rejected == 0 &&
+                         report.latency.p99_ms <= opts.max_p99_ms &&
+                         (report.target <= 0.0 || report.throughput >= 0.95 * report.target);
+    return report;
+}
+
+json to_json(const round_report& r) {
+    return {
+        {"sessions", r.sessions},
+        {"wall_s", r.wall_s},
+        {"audio_s", r.audio_s},
+        {"throughput_x_realtime", r.throughput},
+        {"target_x_realtime", r.target},
+        {"results", r.results},
+        {"errors", r.errors},
+        {"latency_ms", {{"p50", r.latency.p50_ms}, {"p99", r.latency.p99_ms},
+                        {"p999", r.latency.p999_ms}, {"max", r.latency.max_ms}}},
+        {"server_load", r.server},
+        {"server_dropped_chunks", r.server_dropped},
+        {"server_rejected_chunks", r.server_rejected},
+        {"decode_threads", r.decode_threads},
+        {"sustainable", r.sustainable}
+    };
+}
+
+void print_report(const round_report& r) {
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(8) << r.sessions << " sessions  "
+              << std::setw(8) << r.throughput << "x realtime  "
+              << "lag p50 " << std::setw(8) << r.latency.p50_ms << " ms  "
+              << "p99 " << std::setw(8) << r.latency.p99_ms << " ms  "
+              << "p999 " << std::setw(8) << r.latency.p999_ms << " ms  "
+              << "rtf " << r.server.value("real_time_factor", 0.0) << "  "
+              << "util " << r.server.value("utilization", 0.0) << "  "
+              << "errors " << r.errors << "  "
+              << "dropped " << r.server_dropped + r.server_rejected << "  "
+              << (r.sustainable ? "ok" : "NOT SUSTAINABLE") << "\n";
+}
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options] FILE.wav [FILE.wav ...]\n"
+              << "Replays 16-bit mono WAV files as concurrent vstream WebSocket sessions.\n"
+              << "Options:\n"
+              << "  --host HOST        Server host (default: localhost)\n"
+              << "  --port PORT        Server port (default: 8080)\n"
+              << "  --sessions N       Concurrent sessions (default: 4)\n"
+              << "  --speed X          Audio speed per session, 1 = real time, 0 = as fast as possible\n"
+              << "                     (default: 1)\n"
+              << "  --chunk-ms MS      Audio per message (default: 100)\n"
+              << "  --duration S       Seconds per round (default: 30)\n"
+              << "  --rate HZ          Sample rate of the files and the model (default: 16000)\n"
+              << "  --ramp             Add sessions each round until the server cannot keep up\n"
+              << "  --step N           Sessions added per ramp round (default: --sessions)\n"
+              << "  --max-sessions N   Stop ramping here (default: 1024)\n"
+              << "  --max-p99-ms MS    Result lag a sustainable round stays under (default: 1000)\n"
+              << "  --json             Print results as JSON\n";
+}
+
+options parse_options(int argc, char* argv[]) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument(arg + " needs a value");
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--host") {
+            opts.host = next();
+        } else if (arg == "--port") {
+            opts.port = next();
+        } else if (arg == "--sessions") {
+            opts.sessions = std::stoul(next());
+        } else if (arg == "--speed") {
+            opts.speed = std::stod(next());
+        } else if (arg == "--chunk-ms") {
+            opts.chunk_ms = std::stoi(next());
+        } else if (arg == "--duration") {
+            opts.duration_s = std::stoi(next());
+        } else if (arg == "--rate") {
+            opts.sample_rate = std::stoi(next());
+        } else if (arg == "--ramp") {
+            opts.ramp = true;
+        } else if (arg == "--step") {
+            opts.step = std::stoul(next());
+        } else if (arg == "--max-sessions") {
+            opts.max_sessions = std::stoul(next());
+        } else if (arg == "--max-p99-ms") {
+            opts.max_p99_ms = std::stod(next());
+        } else if (arg == "--json") {
+            opts.json_output = true;
+        } else if (arg == "--help") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("Unknown option: " + arg);
+        } else {
+            opts.files.push_back(arg);
+        }
+    }
+
+    if (opts.files.empty()) {
+        throw std::invalid_argument("At least one WAV file is required");
+    }
+    if (opts.sessions == 0 || opts.chunk_ms <= 0 || opts.duration_s <= 0 || opts.speed < 0.0) {
+        throw std::invalid_argument("Sessions, chunk size and duration must be positive, speed not negative");
+    }
+    if (opts.step == 0) {
+        opts.step = opts.sessions;
+    }
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    options opts;
+    try {
+        opts = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // All files back to back; sessions start at different points of it
+    std::vector<int16_t> audio;
+    try {
+        for (const auto& path : opts.files) {
+            audio_file file(path, opts.sample_rate);
+            audio.insert(audio.end(), file.samples().begin(), file.samples().end());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    if (audio.empty()) {
+        std::cerr << "Error: input files contain no audio\n";
+        return 1;
+    }
+
+    std::vector<round_report> reports;
+    size_t sessions = opts.sessions;
+    int round = 0;
+    do {
+        reports.push_back(run_round(opts, audio, sessions, round++));
+        if (!opts.json_output) {
+            print_report(reports.back());
+        }
+        sessions += opts.step;
+    } while (opts.ramp && reports.back().sustainable && sessions <= opts.max_sessions);
+
+    // Largest round that kept up
+    size_t best = 0;
+    size_t threads = 0;
+    for (const auto& r : reports) {
+        if (r.sustainable && r.sessions > best) {
+            best = r.sessions;
+            threads = r.decode_threads;
+        }
+    }
+    double per_core = threads > 0 ? static_cast<double>(best) / static_cast<double>(threads) : 0.0;
+
+    if (opts.json_output) {
+        json out;
+        out["rounds"] = json::array();
+        for (const auto& r : reports) {
+            out["rounds"].push_back(to_json(r));
+        }
+        out["max_sustainable_sessions"] = best;
+        out["sessions_per_decode_thread"] = per_core;
+        std::cout << out.dump(2) << "\n";
+    } else if (opts.ramp) {
+        std::cout << "Max sustainable sessions: " << best;
+        if (threads > 0) {
+            std::cout << " (" << std::setprecision(2) << per_core << " per decode thread, "
+                      << threads << " threads)";
+        }
+        std::cout << "\n";
+    }
+
+    return (reports.back().sustainable || opts.ramp) ? 0 : 2;
+}
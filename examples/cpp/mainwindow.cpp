@@ -291,6 +291,12 @@ QGroupBox* MainWindow::createAudioGroup()
     connect(m_dual_instance_checkbox, &QCheckBox::toggled, this, &MainWindow::onDualInstanceToggled);
     source_layout->addWidget(m_dual_instance_checkbox);
 
+    // Opus compression checkbox
+    m_opus_checkbox = new QCheckBox("Compress audio (Opus)");
+    m_opus_checkbox->setToolTip("Send 24 kbit/s Opus packets instead of 16-bit PCM");
+    connect(m_opus_checkbox, &QCheckBox::toggled, this, &MainWindow::onOpusToggled);
+    source_layout->addWidget(m_opus_checkbox);
+
     main_layout->addLayout(source_layout);
 
     // Separator
@@ -606,6 +612,12 @@ void MainWindow::onRecordClicked()
     }
 }
 
+void MainWindow::onOpusToggled(bool checked)
+{
+    m_websocket_client->setOpusEnabled(checked);
+    m_secondary_client->setOpusEnabled(checked);
+}
+
 void MainWindow::onDualInstanceToggled(bool checked)
 {
     m_dual_instance_enabled = checked;
@@ -1127,6 +1139,7 @@ void MainWindow::loadSettings()
 
     // Dual instance mode
     m_dual_instance_checkbox->setChecked(settings.value("dual_instance", false).toBool());
+    m_opus_checkbox->setChecked(settings.value("opus", false).toBool());
 
     // Audio source mode
     int audio_mode = settings.value("audio_source_mode", CLIENT_AUDIO).toInt();
@@ -1188,6 +1201,7 @@ void MainWindow::saveSettings()
 
     // Dual instance mode
     settings.setValue("dual_instance", m_dual_instance_checkbox->isChecked());
+    settings.setValue("opus", m_opus_checkbox->isChecked());
 
     // Audio source mode
     settings.setValue("audio_source_mode", static_cast<int>(m_audio_source_mode));
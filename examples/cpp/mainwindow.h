@@ -140,6 +140,12 @@ private slots:
      */
     void onDualInstanceToggled(bool checked);
 
+    /**
+     * @brief Toggles Opus compression of client audio
+     * @param checked True to send Opus packets instead of PCM
+     */
+    void onOpusToggled(bool checked);
+
     /**
      * @brief Browse for vstream executable
      */
@@ -354,6 +360,7 @@ private:
 
     // Dual instance controls
     QCheckBox* m_dual_instance_checkbox; ///< Enable dual instance mode
+    QCheckBox* m_opus_checkbox;          ///< Compress client audio with Opus
 
     // Primary transcription display
     QTextEdit* m_transcription_text; ///< Main transcription display
@@ -10,6 +10,8 @@
 #include <QDebug>
 #include <QNetworkRequest>
 #include <QSslConfiguration>
+#include <opus.h>
+#include <cstring>
 
 WebSocketClient::WebSocketClient(QObject *parent)
     : QObject(parent)
@@ -51,6 +53,7 @@ WebSocketClient::WebSocketClient(QObject *parent)
 WebSocketClient::~WebSocketClient()
 {
     disconnectFromServer();
+    releaseOpusEncoder();
 }
 
 void WebSocketClient::connectToServer(const QString& host, int port)
@@ -117,10 +120,32 @@ void WebSocketClient::sendAudioData(const std::vector<int16_t>& samples, int sam
     message["session_id"] = m_session_id;
     message["timestamp"] = QDateTime::currentMSecsSinceEpoch();
 
-    // Convert samples to JSON array
+    // The server decodes by the announced format, so tell it before the codec or rate changes
+    bool announce = false;
+    auto format = m_format.formatFor(sample_rate, announce);
+    if (announce) {
+        if (m_format.isOpusEnabled() && !format.opus) {
+            emit statusUpdate(QString("Opus cannot encode %1 Hz, sending PCM").arg(sample_rate));
+        }
+        releaseOpusEncoder();
+        sendAudioFormat(format);
+    }
+
+    // Convert samples (or Opus packets) to JSON array
     QJsonArray audio_array;
-    for (int16_t sample : samples) {
-        audio_array.append(sample);
+    if (format.opus) {
+        std::vector<int16_t> words = encodeOpus(samples, sample_rate);
+        if (words.empty()) {
+            return;
+        }
+        for (int16_t word : words) {
+            audio_array.append(word);
+        }
+        message["codec"] = "opus";
+    } else {
+        for (int16_t sample : samples) {
+            audio_array.append(sample);
+        }
     }
     message["audio"] = audio_array;
 
@@ -134,6 +159,87 @@ void WebSocketClient::sendAudioData(const std::vector<int16_t>& samples, int sam
     }
 }
 
+void WebSocketClient::setOpusEnabled(bool enabled, int bitrate)
+{
+    if (enabled == m_format.isOpusEnabled() && bitrate == m_opus_bitrate) {
+        return;
+    }
+
+    // The next audio message announces the new format
+    m_format.setOpusEnabled(enabled);
+    m_opus_bitrate = bitrate;
+    releaseOpusEncoder();
+}
+
+void WebSocketClient::sendAudioFormat(const AudioFormatNegotiator::Format& format)
+{
+    QJsonObject params;
+    params["session_id"] = m_session_id;
+    params["codec"] = format.opus ? "opus" : "pcm";
+    params["sample_rate"] = format.sample_rate;
+    sendCommand("audio_format", params);
+}
+
+void WebSocketClient::releaseOpusEncoder()
+{
+    if (m_opus_encoder) {
+        opus_encoder_destroy(m_opus_encoder);
+        m_opus_encoder = nullptr;
+    }
+    m_opus_rate = 0;
+    m_opus_pending.clear();
+}
+
+std::vector<int16_t> WebSocketClient::encodeOpus(const std::vector<int16_t>& samples, int sample_rate)
+{
+    if (!m_opus_encoder || m_opus_rate != sample_rate) {
+        releaseOpusEncoder();
+
+        int error = OPUS_OK;
+        m_opus_encoder = opus_encoder_create(sample_rate, 1, OPUS_APPLICATION_VOIP, &error);
+        if (error != OPUS_OK || !m_opus_encoder) {
+            m_opus_encoder = nullptr;
+            emit errorOccurred(QString("Failed to create Opus encoder: %1").arg(opus_strerror(error)));
+            return {};
+        }
+        opus_encoder_ctl(m_opus_encoder, OPUS_SET_BITRATE(m_opus_bitrate));
+        m_opus_rate = sample_rate;
+    }
+
+    m_opus_pending.insert(m_opus_pending.end(), samples.begin(), samples.end());
+
+    // 20ms packets; a packet is at most 1275 bytes
+    const size_t frame_samples = static_cast<size_t>(sample_rate) / 50;
+    unsigned char packet[1275];
+    m_opus_message.clear();
+
+    size_t offset = 0;
+    for (; offset + frame_samples <= m_opus_pending.size(); offset += frame_samples) {
+        opus_int32 bytes = opus_encode(m_opus_encoder, m_opus_pending.data() + offset,
+                                       static_cast<int>(frame_samples), packet, sizeof(packet));
+        if (bytes <= 0) {
+            qWarning() << "Opus encoding failed:" << opus_strerror(bytes);
+            continue;
+        }
+
+        // [u16 little-endian length][packet][pad to a whole word]
+        m_opus_message.push_back(static_cast<uint8_t>(bytes & 0xFF));
+        m_opus_message.push_back(static_cast<uint8_t>(bytes >> 8));
+        m_opus_message.insert(m_opus_message.end(), packet, packet + bytes);
+        if (bytes % 2 != 0) {
+            m_opus_message.push_back(0);
+        }
+    }
+    m_opus_pending.erase(m_opus_pending.begin(), m_opus_pending.begin() + offset);
+
+    // Little-endian byte pairs as 16-bit words
+    std::vector<int16_t> words(m_opus_message.size() / 2);
+    for (size_t i = 0; i < words.size(); ++i) {
+        words[i] = static_cast<int16_t>(m_opus_message[2 * i] | (m_opus_message[2 * i + 1] << 8));
+    }
+    return words;
+}
+
 void WebSocketClient::sendCommand(const QString& command, const QJsonObject& params)
 {
     if (!m_is_connected) {
@@ -169,6 +275,10 @@ void WebSocketClient::onConnected()
     // Start ping timer
     m_ping_timer->start(PING_INTERVAL_MS);
 
+    // A new connection starts a new session format and Opus stream
+    m_format.reset();
+    releaseOpusEncoder();
+
     emit connectionChanged(true);
     emit statusUpdate("Connected to server");
 
@@ -13,8 +13,13 @@
 #include <QTimer>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include "audio_format_negotiator.h"
 #include <vector>
 #include <atomic>
+#include <cstdint>
+
+// Forward declaration
+typedef struct OpusEncoder OpusEncoder;
 
 /**
  * @class WebSocketClient
@@ -44,6 +49,11 @@
  * }
  * ```
  *
+ * With Opus enabled, "audio" carries 16-bit words whose little-endian
+ * bytes are length-prefixed Opus packets instead of PCM samples. The
+ * server goes by the session's "audio_format" command, which is sent
+ * before the first audio and again whenever the codec or rate changes.
+ *
  * **Incoming Transcription Message:**
  * ```json
  * {
@@ -120,6 +130,22 @@ public:
      */
     void sendAudioData(const std::vector<int16_t>& samples, int sample_rate);
 
+    /**
+     * @brief Compresses outgoing audio with Opus
+     * @param enabled true to send Opus packets, false for raw PCM
+     * @param bitrate Encoder bitrate in bits per second
+     *
+     * Audio is encoded in 20ms packets; samples that do not fill a packet
+     * are kept for the next call. Rates Opus cannot encode (e.g. 32 kHz)
+     * are sent, and announced, as PCM.
+     */
+    void setOpusEnabled(bool enabled, int bitrate = 24000);
+
+    /**
+     * @brief Checks if outgoing audio is Opus-compressed
+     */
+    bool isOpusEnabled() const { return m_format.isOpusEnabled(); }
+
     /**
      * @brief Sends command to vstream server
      * @param command Command name (e.g., "reset", "set_grammar")
@@ -221,6 +247,22 @@ private:
      */
     void resetReconnectionState();
 
+    /**
+     * @brief Encodes samples into framed Opus packets
+     * @return Framed packets as 16-bit words, empty if no packet completed
+     */
+    std::vector<int16_t> encodeOpus(const std::vector<int16_t>& samples, int sample_rate);
+
+    /**
+     * @brief Announces the codec and rate of the following audio to the server
+     */
+    void sendAudioFormat(const AudioFormatNegotiator::Format& format);
+
+    /**
+     * @brief Frees the Opus encoder and drops buffered samples
+     */
+    void releaseOpusEncoder();
+
     /**
      * @brief Starts automatic reconnection timer
      */
@@ -245,6 +287,14 @@ private:
     static constexpr int INITIAL_RECONNECT_DELAY_MS = 1000; ///< Initial reconnection delay
     static constexpr int PING_INTERVAL_MS = 30000; ///< Ping interval
 
+    // Opus compression
+    AudioFormatNegotiator m_format;        ///< Codec choice and what the server was told
+    int m_opus_bitrate = 24000;            ///< Encoder bitrate
+    int m_opus_rate = 0;                   ///< Rate the encoder was created for
+    OpusEncoder* m_opus_encoder = nullptr; ///< Created on first audio
+    std::vector<int16_t> m_opus_pending;   ///< Samples short of a full packet
+    std::vector<uint8_t> m_opus_message;   ///< Framed packets of one message
+
     // Statistics
     std::atomic<size_t> m_messages_sent;   ///< Total messages sent
     std::atomic<size_t> m_messages_received; ///< Total messages received
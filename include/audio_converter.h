@@ -0,0 +1,167 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <span>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class audio_converter
+ * @brief Converts client or device audio to mono 16-bit PCM at the model rate
+ *
+ * Input may be interleaved int16 or float32 with any number of channels at
+ * any rate (8 kHz up to 192 kHz, including 44.1 kHz). Each call:
+ *
+ * - **Decodes** the samples to float, scaled to the int16 range
+ * - **Downmixes** all channels to mono by averaging
+ * - **Resamples** to the model rate with a windowed-sinc polyphase filter:
+ *   for a rate ratio L/M only every M-th sample of the L-times upsampled
+ *   signal is computed, each as one taps_per_phase dot product
+ * - **Encodes** back to int16 with rounding and saturation
+ *
+ * The filter history, polyphase position and any partial input frame are
+ * carried across calls, so splitting a stream into chunks of any size
+ * produces the same output as converting it in one piece.
+ *
+ * The dot product and the mono int16/float conversions have hand-written
+ * AVX-512 paths (the Release flags); other builds use plain loops that GCC
+ * vectorizes at -O3.
+ *
+ * @note Not thread-safe: use one converter per audio stream
+ *
+ * @par Example:
+ * @code
+ * audio_converter::config cfg;
+ * cfg.input_rate = 48000;
+ * cfg.input_channels = 2;
+ * cfg.format = audio_converter::sample_format::float32;
+ * audio_converter converter(cfg);
+ *
+ * std::span<const int16_t> mono = converter.process(std::as_bytes(std::span(frames)));
+ * @endcode
+ */
+class audio_converter {
+public:
+    /**
+     * @enum sample_format
+     * @brief Encoding of input samples
+     */
+    enum class sample_format {
+        int16,      ///< Signed 16-bit PCM
+        float32     ///< IEEE float in [-1, 1]
+    };
+
+    /**
+     * @struct config
+     * @brief Input format and filter parameters
+     */
+    struct config {
+        int input_rate = 16000;                         ///< Input sample rate in Hz
+        int input_channels = 1;                         ///< Interleaved input channels
+        sample_format format = sample_format::int16;    ///< Input sample encoding
+        int output_rate = 16000;                        ///< Model sample rate in Hz
+        int taps_per_phase = 48;                        ///< Filter length at 1:1, scaled up when decimating
+
+        config() = default;
+    };
+
+    audio_converter();
+    explicit audio_converter(const config& cfg);
+
+    /**
+     * @brief Convert a block of interleaved input
+     *
+     * @param input Raw sample bytes; a trailing partial frame is kept for the next call
+     * @return Mono 16-bit samples at the model rate, valid until the next call
+     */
+    std::span<const int16_t> process(std::span<const std::byte> input);
+
+    /**
+     * @brief Convert samples delivered as int16
+     *
+     * Returns @p input itself when the converter is a passthrough. With a
+     * float32 format the bytes are reinterpreted, which is how float frames
+     * arrive through the WebSocket server's int16 audio buffers.
+     */
+    std::span<const int16_t> process(std::span<const int16_t> input);
+
+    /**
+     * @brief Check if input is already mono int16 at the model rate
+     */
+    bool passthrough() const;
+
+    /**
+     * @brief Check if the rate is converted
+     */
+    bool resampling() const { return m_up != m_down; }
+
+    /**
+     * @brief Filter taps evaluated per output sample (0 when not resampling)
+     */
+    size_t taps() const { return resampling() ? m_taps : 0; }
+
+    /**
+     * @brief Get the converter configuration
+     */
+    const config& get_config() const { return m_config; }
+
+    /**
+     * @brief Forget the filter history and any partial frame
+     */
+    void reset();
+
+    /**
+     * @brief Parse "s16" / "int16" or "f32" / "float32"
+     * @throws std::invalid_argument for other names
+     */
+    static sample_format parse_format(const std::string& name);
+
+    /**
+     * @brief Split interleaved int16 frames into one buffer per channel
+     *
+     * Stereo input has an AVX-512 path (the Release flags); other channel
+     * counts use a plain strided loop. A trailing partial frame is ignored.
+     *
+     * @param interleaved Frames of planes.size() samples each
+     * @param planes One buffer per channel, resized to the frame count
+     */
+    static void deinterleave(std::span<const int16_t> interleaved, std::vector<std::vector<int16_t>>& planes);
+
+    /**
+     * @brief Bytes per sample of a format
+     */
+    static size_t sample_size(sample_format format) {
+        return format == sample_format::int16 ? sizeof(int16_t) : sizeof(float);
+    }
+
+private:
+    config m_config;
+    size_t m_frame_bytes;                   ///< Bytes per interleaved frame
+    size_t m_up = 1;                        ///< Interpolation factor L
+    size_t m_down = 1;                      ///< Decimation factor M
+    size_t m_taps = 0;                      ///< Taps per polyphase branch (multiple of 16)
+
+    std::vector<float> m_coeffs;            ///< L branches of m_taps reversed coefficients
+    std::vector<float> m_buffer;            ///< Mono input: m_taps - 1 history samples, then new audio
+    size_t m_index = 0;                     ///< Newest buffer sample under the next output's window
+    size_t m_phase = 0;                     ///< Polyphase branch of the next output
+
+    std::vector<std::byte> m_carry;         ///< Partial frame from the previous call
+    std::vector<int16_t> m_output;
+
+    void design_filter();
+    void decode(std::span<const std::byte> frames);
+    void resample();
+};
@@ -0,0 +1,98 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class audio_file
+ * @brief Read-only, memory-mapped 16-bit PCM audio file
+ *
+ * Maps a WAV file (RIFF, PCM, 16-bit, mono) or a headerless raw file of
+ * little-endian 16-bit mono samples into memory. The samples are used in
+ * place, so multi-gigabyte archives are decoded without reading them into
+ * the heap first; the kernel pages the data in as the decoder advances.
+ *
+ * @par Example:
+ * @code
+ * audio_file file("meeting.wav", 16000);
+ * engine.process_audio(file.samples());
+ * @endcode
+ *
+ * @note Files whose sample data starts at an odd offset are copied once
+ *       into an aligned buffer instead of being used in place.
+ */
+class audio_file {
+public:
+    /**
+     * @brief Map an audio file
+     *
+     * @param path WAV or raw PCM file
+     * @param sample_rate Expected sample rate; raw files are assumed to use it
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     * @throws std::invalid_argument if the WAV format is not 16-bit mono PCM
+     *         at the expected sample rate
+     */
+    audio_file(const std::string& path, int sample_rate);
+
+    /**
+     * @brief Destructor - unmaps the file
+     */
+    ~audio_file();
+
+    audio_file(const audio_file&) = delete;
+    audio_file& operator=(const audio_file&) = delete;
+
+    /**
+     * @brief Get the samples of the file
+     * @note Valid for the lifetime of this object
+     */
+    std::span<const int16_t> samples() const { return m_samples; }
+
+    /**
+     * @brief Get the sample rate in Hz
+     */
+    int sample_rate() const { return m_sample_rate; }
+
+    /**
+     * @brief Get the duration in milliseconds
+     */
+    double duration_ms() const;
+
+    /**
+     * @brief Get the file path
+     */
+    const std::string& path() const { return m_path; }
+
+    /**
+     * @brief Check if the file extension names an audio format we read
+     */
+    static bool is_supported(const std::string& path);
+
+private:
+    std::string m_path;
+    int m_sample_rate;
+    void* m_map = nullptr;                       ///< mmap() base, nullptr for empty files
+    size_t m_map_size = 0;
+    std::vector<int16_t> m_copy;                 ///< Aligned copy for odd data offsets
+    std::span<const int16_t> m_samples;
+
+    /**
+     * @brief Locate the sample data of a WAV file
+     * @return Byte range of the data chunk within the mapping
+     */
+    std::span<const uint8_t> parse_wav(std::span<const uint8_t> bytes, int sample_rate) const;
+};
@@ -12,10 +12,14 @@
 #pragma once
 
 #include "vstream_engine.h"
+#include "voice_activity_detector.h"
+#include "utterance_cap.h"
 #include <hyni/hyni_websocket_server.h>
 #include <string>
 #include <vector>
+#include <span>
 #include <chrono>
+#include <memory>
 #include <cstdint>
 
 class benchmark_manager;
@@ -24,47 +28,51 @@ class benchmark_manager;
  * @class audio_processor
  * @brief Simplified audio processing pipeline for real-time speech recognition
  *
- * The audio_processor class provides a streamlined audio processing pipeline
- * using time-based finalization only (no VAD). This approach works better
- * for continuous formal speech where VAD can cause fragmentation.
+ * The audio_processor class provides a streamlined audio processing pipeline.
+ * Utterances end where the model's endpointer detects the speaker has
+ * stopped (see vstream_engine::config::endpointer); a timer only caps
+ * utterances that never pause. Optionally a voice activity detector gates
+ * the decoder during silence and finalizes at its own speech endpoints.
  *
  * @par Key Features:
- * - **Time-based Processing**: Consistent finalization intervals
- * - **No VAD Complexity**: Eliminates VAD-related fragmentation issues
- * - **Optimized for Continuous Speech**: Better for formal presentations
+ * - **Model Endpointing**: Final results follow speech pauses, not a clock
+ * - **Utterance Cap**: Speech without pauses is finalized after max_utterance_ms
+ * - **Optional VAD Gating**: Silence is never sent to the decoder
+ * - **Endpoint Finalization**: Utterances end when the speaker pauses
  * - **Performance Monitoring**: Integrated benchmarking support
  * - **WebSocket Integration**: Direct broadcasting of transcription results
  *
  * @par Processing Pipeline:
  * ```
- * Audio Input → Engine Processing → Result Handling → WebSocket Broadcast
- *      ↓              ↓                 ↓                    ↓
- * Always Process  JSON Parsing    Deduplication      Client Delivery
+ * Audio Input → [VAD Gate] → Engine Processing → Result Handling → WebSocket Broadcast
+ *      ↓            ↓               ↓                 ↓                    ↓
+ *  PCM chunks  Skip silence    Typed Result     Deduplication      Client Delivery
  * ```
  *
- * @par Operating Mode:
- * - Processes all audio as speech
- * - Finalizes results at regular time intervals
- * - No silence detection or VAD complexity
- * - Consistent behavior and timing
+ * @par Operating Modes:
+ * - Without VAD: all audio is decoded, results finalize at model endpoints
+ * - With VAD: only speech (plus one chunk of pre-roll) is decoded, results
+ *   finalize at the first of the model and VAD endpoints
+ *
+ * In both modes the cap only forces a final result while words are
+ * pending; silence never costs a final-result computation.
  */
 class audio_processor {
 public:
     /**
      * @brief Constructs a simplified audio processor
      *
-     * Initializes the audio processing pipeline without VAD complexity.
-     * Uses time-based finalization only for consistent behavior.
+     * Initializes the audio processing pipeline without VAD gating.
      *
      * @param engine Pointer to initialized Vosk speech recognition engine
      * @param server Pointer to WebSocket server for broadcasting results
-     * @param finalize_interval_ms Time interval for forced finalization (milliseconds)
+     * @param max_utterance_ms Longest utterance before a final result is forced (milliseconds)
      * @param buffer_ms Audio buffer size (for statistics and logging)
      * @param benchmark Optional benchmark manager for performance monitoring
      */
     audio_processor(vstream_engine* engine,
                     hyni_websocket_server* server,
-                    int finalize_interval_ms = 2000,
+                    int max_utterance_ms = 15000,
                     int buffer_ms = 100,
                     benchmark_manager* benchmark = nullptr);
 
@@ -76,12 +84,57 @@ public:
     /**
      * @brief Processes audio data through the recognition pipeline
      *
-     * Processes all audio as speech and handles time-based finalization.
-     * Much simpler than VAD-based processing with consistent behavior.
+     * Decodes the chunk, delivers its result and forces a final result
+     * only when the utterance cap or a VAD endpoint is reached.
+     *
+     * @param audio 16-bit PCM audio samples
+     * @param captured Time the chunk was captured (default = now); result
+     *        latency is measured from here
+     */
+    virtual void process_audio(std::span<const int16_t> audio,
+                               std::chrono::steady_clock::time_point captured = {});
+
+    /**
+     * @brief Gate decoding with a voice activity detector
+     *
+     * @param cfg Detector configuration (sample rate must match the audio)
      *
-     * @param audio Vector of 16-bit PCM audio samples
+     * @throws std::invalid_argument if the configuration is invalid
+     */
+    void enable_vad(const voice_activity_detector::config& cfg);
+
+    /**
+     * @brief Transcribe one channel of a multi-channel capture
+     *
+     * Decodes on a stream of its own instead of the engine's default
+     * stream, so each channel's processor can run on a different thread,
+     * and tags results with session "mic-capture/ch<channel>".
+     *
+     * @param channel Zero-based capture channel
+     * @throws std::runtime_error if the stream cannot be created
+     */
+    void set_channel(int channel);
+
+    /**
+     * @brief Get the session id results are delivered under
+     */
+    const std::string& get_session_id() const { return m_session_id; }
+
+    /**
+     * @brief Check if VAD gating is enabled
+     */
+    bool has_vad() const { return m_vad != nullptr; }
+
+    /**
+     * @brief Get number of audio chunks skipped as silence
+     */
+    size_t get_skipped_chunks() const { return m_skipped_chunks; }
+
+    /**
+     * @brief Record deliver and end-to-end latency of final results
+     * @param metrics Stage histograms (nullptr = off), not owned
      */
-    virtual void process_audio(const std::vector<int16_t>& audio);
+    void set_metrics(pipeline_metrics* metrics) { m_metrics = metrics; }
 
 protected:  // Protected for testing
     /**
@@ -90,10 +143,10 @@ protected:  // Protected for testing
     void force_finalize();
 
     /**
-     * @brief Processes JSON response from the speech recognition engine
-     * @param result_json JSON string response from Vosk
+     * @brief Processes a result from the speech recognition engine
+     * @param result Typed Vosk result
      */
-    void handle_speech_result(const std::string& result_json);
+    void handle_speech_result(const recognition_result& result);
 
     /**
      * @brief Processes and broadcasts final transcription results
@@ -109,25 +162,42 @@ protected:  // Protected for testing
 
     // Core components
     vstream_engine* m_engine;                    ///< Speech recognition engine
+    std::shared_ptr<vstream_engine::stream> m_stream; ///< Channel stream (nullptr = engine default stream)
     hyni_websocket_server* m_server;             ///< WebSocket server
     std::string m_session_id;                    ///< Session identifier
     bool m_show_partial;                         ///< Show partial results flag
 
     // Timing configuration
-    int m_finalize_interval_ms;                  ///< Finalization interval
     int m_buffer_ms;                             ///< Buffer size (for logging)
 
     // Timing state
-    std::chrono::steady_clock::time_point m_last_finalize_time; ///< Last finalization time
+    utterance_cap m_cap;                         ///< Forced finalization of utterances without endpoint
+    std::chrono::steady_clock::time_point m_chunk_time;         ///< Capture time of the current chunk
 
     // Result caching (for deduplication)
     std::string m_last_final_text;               ///< Last final result
     std::string m_last_partial_text;             ///< Last partial result
 
     // Performance optimization
-    std::string m_result_buffer;                 ///< Reusable string buffer
+    recognition_result m_result;                 ///< Reusable result buffers
 
     // Benchmarking
     benchmark_manager* m_benchmark = nullptr;    ///< Performance monitoring
     size_t m_accumulated_audio_samples = 0;      ///< Sample counter
+    pipeline_metrics* m_metrics = nullptr;       ///< Stage latency histograms
+
+    // Voice activity detection
+    std::unique_ptr<voice_activity_detector> m_vad; ///< Optional silence gate
+    std::vector<int16_t> m_preroll;              ///< Last silent chunk, decoded before speech onset
+    size_t m_skipped_chunks = 0;                 ///< Chunks not decoded
+
+    /**
+     * @brief Decode on the channel stream or the engine's default stream
+     */
+    void decode(std::span<const int16_t> audio);
+
+    /**
+     * @brief Run the detector and report frame decisions to the benchmark
+     */
+    voice_activity_detector::decision detect_speech(std::span<const int16_t> audio);
 };
@@ -0,0 +1,161 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <span>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+// Forward declarations
+typedef struct VoskBatchModel VoskBatchModel;
+typedef struct VoskBatchRecognizer VoskBatchRecognizer;
+
+/**
+ * @class batch_decoder
+ * @brief Decodes chunks from many streams in GPU batches (Vosk batch API)
+ *
+ * Callers hand in one chunk at a time and block until it is decoded, just
+ * like a CPU recognizer. Behind that, a collector thread gathers the
+ * chunks of all waiting callers and submits them together:
+ *
+ * - A batch is flushed when it holds max_batch chunks or when its oldest
+ *   chunk has waited max_wait_ms, whichever comes first
+ * - The whole batch is pushed through one vosk_batch_model_wait() round,
+ *   then each caller is woken with the result of its own recognizer
+ *
+ * The batch recognizer only produces final results (it endpoints on its
+ * own); chunks that do not complete an utterance return an empty string.
+ *
+ * @note Requires libvosk built with CUDA; otherwise construction fails
+ * @note Each recognizer must have at most one chunk in flight, which holds
+ *       when it is owned by one vstream_engine::stream
+ *
+ * @par Example:
+ * @code
+ * batch_decoder gpu("/opt/models/vosk-model-en-us-0.22", 16000.0f, {});
+ * VoskBatchRecognizer* rec = gpu.create_recognizer();
+ * std::string result = gpu.decode(rec, chunk, false); // "" or {"text": ...}
+ * @endcode
+ */
+class batch_decoder {
+public:
+    /**
+     * @struct config
+     * @brief Batching parameters
+     */
+    struct config {
+        size_t max_batch = 64;      ///< Chunks submitted per batch
+        int max_wait_ms = 10;       ///< Longest a chunk waits for its batch to fill
+
+        config() = default;
+    };
+
+    /**
+     * @brief Initialize the GPU and load a batch model
+     *
+     * @param model_path Vosk model directory
+     * @param sample_rate Sample rate of recognizers created from the model
+     * @param cfg Batching parameters
+     *
+     * @throws std::runtime_error if the model cannot be loaded or Vosk was
+     *         built without CUDA
+     */
+    batch_decoder(const std::string& model_path, float sample_rate, const config& cfg);
+
+    /**
+     * @brief Destructor - wakes waiting callers, stops the collector and frees the model
+     */
+    ~batch_decoder();
+
+    batch_decoder(const batch_decoder&) = delete;
+    batch_decoder& operator=(const batch_decoder&) = delete;
+
+    /**
+     * @brief Create a recognizer for one stream
+     * @throws std::runtime_error if creation fails
+     */
+    VoskBatchRecognizer* create_recognizer();
+
+    /**
+     * @brief Free a recognizer from create_recognizer()
+     */
+    static void free_recognizer(VoskBatchRecognizer* recognizer);
+
+    /**
+     * @brief Decode one chunk as part of the next batch
+     *
+     * Blocks until the batch holding the chunk has been decoded. One
+     * completed utterance is returned per call; if a chunk completes
+     * several, the rest are returned by the following calls.
+     *
+     * @param recognizer Recognizer from create_recognizer()
+     * @param audio 16-bit PCM samples (may be empty when finishing)
+     * @param finish End the stream; the recognizer accepts no more audio
+     *
+     * @return Vosk final result JSON, or empty if no utterance completed
+     */
+    std::string decode(VoskBatchRecognizer* recognizer, std::span<const int16_t> audio, bool finish);
+
+    /**
+     * @brief Get the number of batches submitted
+     */
+    uint64_t get_batch_count() const { return m_batches.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of chunks decoded
+     */
+    uint64_t get_chunk_count() const { return m_chunks.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief One chunk waiting for its batch, owned by the blocked caller
+     */
+    struct request {
+        VoskBatchRecognizer* recognizer;
+        std::span<const int16_t> audio;
+        bool finish;
+        std::string result;
+        bool done = false;
+    };
+
+    config m_config;
+    VoskBatchModel* m_model = nullptr;
+    float m_sample_rate;
+
+    std::vector<request*> m_pending;                     ///< Chunks for the next batch
+    std::chrono::steady_clock::time_point m_oldest;      ///< Arrival of m_pending.front()
+    std::mutex m_mutex;                                  ///< Protects m_pending and request::done
+    std::condition_variable m_collector_cv;              ///< Wakes the collector
+    std::condition_variable m_done_cv;                   ///< Wakes callers of a finished batch
+    bool m_running = true;                               ///< Guarded by m_mutex
+
+    std::atomic<uint64_t> m_batches{0};
+    std::atomic<uint64_t> m_chunks{0};
+
+    std::thread m_collector;
+
+    /**
+     * @brief Collect, submit and fan out batches until stopped
+     */
+    void collector_loop();
+
+    /**
+     * @brief Submit one batch to the GPU and fill in the results
+     */
+    void run_batch(const std::vector<request*>& batch);
+};
@@ -12,11 +12,18 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <deque>
 #include <chrono>
 #include <functional>
 #include <atomic>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <cstdint>
 
 /**
  * @class benchmark_manager
@@ -28,18 +35,34 @@
  * - Confidence scoring analysis
  * - Voice Activity Detection performance
  * - Detailed segment-by-segment analysis
+ *
+ * The segment log is compact so that long runs fit in memory: texts live in
+ * an append-only arena and each segment is a small fixed-size record. For
+ * runs of many hours, stream_segments() writes segments to disk as they
+ * arrive and keeps only the unwritten ones; a writer thread formats and
+ * writes them, so adding a transcription never waits on the disk.
+ *
+ * @note Thread-safe: transcriptions may be added from several decode workers
  */
 class benchmark_manager {
 public:
+    /**
+     * @brief Kind of a transcription segment
+     */
+    enum class segment_type : uint8_t {
+        partial,
+        final
+    };
+
     /**
      * @struct transcription_segment
      * @brief Individual transcription segment with timing and quality metrics
      */
     struct transcription_segment {
         std::string text;                                           ///< Transcribed text
-        std::string type;                                           ///< "partial" or "final"
-        std::chrono::steady_clock::time_point start_time;           ///< Segment start time
-        std::chrono::steady_clock::time_point end_time;             ///< Segment end time
+        segment_type type = segment_type::final;
+        std::chrono::milliseconds start_offset{0};                  ///< Segment start since start()
+        std::chrono::milliseconds end_offset{0};                    ///< Segment end since start()
         double confidence = 1.0;                                    ///< Confidence score (0-1)
         size_t audio_samples = 0;                                   ///< Audio samples processed
         double processing_latency_ms = 0.0;                         ///< Processing latency
@@ -93,9 +116,6 @@ public:
         int partial_segments = 0;                                   ///< Number of partial results
         int final_segments = 0;                                     ///< Number of final results
         double partial_to_final_ratio = 0.0;                       ///< Ratio of partial to final
-
-        // Detailed segment data
-        std::vector<transcription_segment> segments;
     };
 
     /**
@@ -140,13 +160,13 @@ public:
     /**
      * @brief Add a transcription segment (from vstream engine)
      * @param text Transcribed text
-     * @param type Segment type ("partial" or "final")
+     * @param type Segment type ("partial" or "final"; anything else is kept as partial)
      * @param confidence Confidence score
      * @param audio_samples Number of audio samples processed
      * @param processing_latency_ms Processing latency in milliseconds
      */
     void add_transcription(const std::string& text,
-                           const std::string& type,
+                           std::string_view type,
                            double confidence = 1.0,
                            size_t audio_samples = 0,
                            double processing_latency_ms = 0.0);
@@ -160,9 +180,51 @@ public:
 
     /**
      * @brief Get current benchmark results (for live monitoring)
+     *
+     * Metrics are maintained incrementally, so a query only pays for the
+     * transcriptions added since the previous one.
+     *
+     * @param include_text Copy the reference and hypothesis texts, which
+     *                     grow with the run; stats queries leave them out
      * @return Current results
      */
-    benchmark_results get_current_results() const;
+    benchmark_results get_current_results(bool include_text = true) const;
+
+    /**
+     * @brief Get the segment history
+     * @param first Index of the first segment to return, e.g. the count
+     *        already seen, to fetch only new segments
+     * @note While streaming, only segments not yet written are returned
+     */
+    std::vector<transcription_segment> get_segments(size_t first = 0) const;
+
+    /**
+     * @brief Write segments to a file while the run goes on
+     *
+     * Segments are handed to a writer thread in batches of flush_segments
+     * and dropped from memory, so the log stays bounded however long the
+     * run. The latest segment is held back until the next one arrives, as
+     * VAD decisions still update it; stop() writes the rest and waits for
+     * the file to be complete.
+     *
+     * @param path File to write, truncated
+     * @param format "jsonl" (one JSON object per segment) or "csv"
+     * @param flush_segments Segments buffered before a write
+     * @throws std::invalid_argument if the format is unknown
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    void stream_segments(const std::string& path, const std::string& format = "jsonl",
+                         size_t flush_segments = 256);
+
+    /**
+     * @brief Get the number of segments written by stream_segments()
+     */
+    uint64_t get_streamed_segments() const;
+
+    /**
+     * @brief Get the label of a segment type ("partial", "final")
+     */
+    static const char* segment_type_name(segment_type type);
 
     /**
      * @brief Set progress callback for live updates
@@ -205,21 +267,199 @@ private:
     std::chrono::steady_clock::time_point m_last_segment_time;
 
     std::string m_reference_text;
-    std::vector<transcription_segment> m_segments;
     size_t m_total_samples;
 
+    /**
+     * @brief Append-only storage for segment texts
+     *
+     * Blocks are reserved up front and never grow, so stored texts never
+     * move and the log does not pay for reallocation copies.
+     */
+    struct text_arena {
+        static constexpr size_t block_size = 64 * 1024;
+
+        struct ref {
+            uint32_t block = 0;
+            uint32_t offset = 0;
+            uint32_t length = 0;
+        };
+
+        std::vector<std::string> blocks;
+
+        ref append(std::string_view text);
+        std::string_view view(const ref& r) const {
+            return std::string_view(blocks[r.block]).substr(r.offset, r.length);
+        }
+        void clear();                        ///< Keeps the first block for reuse
+    };
+
+    /**
+     * @brief Compact in-memory form of a transcription_segment
+     */
+    struct segment_record {
+        text_arena::ref text;
+        uint32_t start_ms = 0;               ///< Offset from m_start_time
+        uint32_t end_ms = 0;
+        float confidence = 1.0f;
+        float processing_latency_ms = 0.0f;
+        uint32_t audio_samples = 0;
+        int32_t silence_frames_before = 0;
+        segment_type type = segment_type::final;
+        bool vad_detected = false;
+    };
+
+    text_arena m_arena;
+    std::deque<segment_record> m_segments;                      ///< Segments not yet streamed
+    uint64_t m_segment_count = 0;                               ///< Segments added since start()
+    uint64_t m_segment_base = 0;                                ///< Index of m_segments.front()
+
+    // Segment streaming (stream_segments)
+    size_t m_stream_flush = 0;                                  ///< 0 = not streaming
+
+    /**
+     * @brief Segments handed from m_segments to the writer thread
+     */
+    struct segment_batch {
+        uint64_t base = 0;                   ///< Index of the first record
+        std::vector<segment_record> records;
+        text_arena arena;                    ///< Texts of the records
+    };
+
+    std::ofstream m_segment_stream;                             ///< Writer thread only while it runs
+    bool m_stream_csv = false;
+    std::deque<segment_batch> m_write_queue;
+    bool m_writing = false;                                     ///< Writer is formatting a batch
+    bool m_writer_stop = false;
+    std::atomic<bool> m_stream_failed{false};
+    std::atomic<uint64_t> m_streamed_segments{0};
+    std::mutex m_write_mutex;                                   ///< Protects the queue and flags above
+    std::condition_variable m_write_cv;                         ///< Batch queued, or writer stopping
+    std::condition_variable m_written_cv;                       ///< Queue drained
+    std::thread m_writer;
+
+    /**
+     * @brief Word alignment against the reference, extended one hypothesis word at a time
+     *
+     * Keeps the DP column of the last hypothesis word (O(reference) memory);
+     * each cell carries its operation breakdown like levenshtein_distance().
+     */
+    struct word_aligner {
+        struct cell {
+            int cost;
+            int subs;
+            int dels;
+            int ins;
+        };
+
+        std::vector<int> reference;          ///< Interned reference words
+        std::vector<cell> column;            ///< Column of the last consumed hypothesis word
+        std::vector<cell> scratch;
+        size_t consumed = 0;                 ///< Hypothesis words aligned so far
+
+        void reset(std::vector<int> ref);
+        void push(int word);
+        const cell& result() const { return column.back(); }
+    };
+
+    /**
+     * @brief Myers/Hyyro bit-parallel edit distance against a fixed pattern,
+     *        fed one text character at a time
+     */
+    struct char_aligner {
+        std::vector<uint64_t> peq;           ///< Match masks, 256 x blocks
+        std::vector<uint64_t> pv;
+        std::vector<uint64_t> mv;
+        size_t blocks = 0;
+        uint64_t last_bit = 0;
+        int score = 0;
+        size_t consumed = 0;                 ///< Text characters fed so far
+
+        void reset(const std::string& pattern);
+        void push(unsigned char c);
+    };
+
+    // Hypothesis built incrementally from final segments
+    std::string m_hypothesis_text;                              ///< Normalized final texts
+    std::string m_hypothesis_chars;                             ///< Final text without spaces
+    std::vector<int> m_hypothesis_words;                        ///< Interned, -1 = not in reference
+    std::unordered_map<std::string, int> m_reference_ids;       ///< Reference word -> id
+    std::string m_reference_chars;                              ///< Reference without spaces
+    mutable word_aligner m_word_aligner;                        ///< Caught up lazily on query
+    mutable char_aligner m_char_aligner;
+
+    // Running aggregates over m_segments
+    int m_partial_count = 0;
+    int m_final_count = 0;
+    size_t m_latency_count = 0;
+    double m_latency_sum = 0.0;
+    double m_latency_min = 0.0;
+    double m_latency_max = 0.0;
+    double m_confidence_sum = 0.0;
+    double m_confidence_min = 1.0;
+    double m_confidence_max = 0.0;
+    size_t m_silence_count = 0;
+    double m_silence_frames_sum = 0.0;
+
     // VAD analysis
     std::vector<bool> m_vad_ground_truth;
     std::vector<bool> m_vad_decisions;
     double m_vad_frame_duration_ms;
+    size_t m_vad_scored = 0;                                    ///< Decisions compared to ground truth
+    int m_vad_correct = 0;
+    int m_vad_false_positives = 0;
+    int m_vad_false_negatives = 0;
 
     progress_callback_t m_progress_callback;
 
+    /// Protects all session state above
+    mutable std::mutex m_mutex;
+
+    /**
+     * @brief Compute results from current state
+     * @note Caller must hold m_mutex
+     */
+    benchmark_results compute_results(bool include_text = true) const;
+
     // Helper methods
-    static int levenshtein_distance(const std::vector<std::string>& ref,
-                                    const std::vector<std::string>& hyp,
+    void reset_aggregates();
+    void add_silence_contribution(const segment_record& segment, int sign);
+    transcription_segment expand(const segment_record& record) const;
+
+    /**
+     * @brief Hand buffered segments to the writer thread and drop them
+     * @param keep Most recent segments to hold back
+     * @note Caller must hold m_mutex
+     */
+    void flush_segments(size_t keep);
+
+    /**
+     * @brief Wait until the writer thread has written every queued batch
+     */
+    void wait_for_writer();
+    void stop_writer();
+    void writer_loop();
+    void write_batch(const segment_batch& batch);
+    void score_vad_decisions();
+    void rebuild_hypothesis_words();
+    int word_id(const std::string& word) const;
+
+    /**
+     * @brief Word-level edit distance with operation breakdown
+     *
+     * Banded two-row DP over interned token ids: memory is O(n) and the band
+     * grows (Ukkonen doubling) only as far as the distance requires. The
+     * substitution/deletion/insertion counts are carried along each cell and
+     * match a backtrace of the full matrix.
+     */
+    static int levenshtein_distance(const std::vector<int>& ref,
+                                    const std::vector<int>& hyp,
                                     int* subs = nullptr, int* dels = nullptr, int* ins = nullptr);
 
+    /**
+     * @brief Byte-level edit distance (Myers/Hyyro bit-parallel, 64 rows per word)
+     */
+    static int bit_parallel_distance(const std::string& a, const std::string& b);
+
     void export_txt_format(const benchmark_results& results, std::ofstream& file, const std::string& model_path) const;
     void export_json_format(const benchmark_results& results, std::ofstream& file, const std::string& model_path) const;
     void export_csv_format(const benchmark_results& results, std::ofstream& file) const;
@@ -0,0 +1,90 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class chunk_controller
+ * @brief Picks how much audio one session decodes per call
+ *
+ * Larger chunks mean fewer decode calls and partial results per second of
+ * audio (throughput); smaller chunks mean results reach the client sooner
+ * (latency). The controller observes the audio-to-result latency of every
+ * decoded chunk and, once per window of observations, adjusts the chunk:
+ *
+ * | condition                                   | chunk                  |
+ * |---------------------------------------------|------------------------|
+ * | worst latency in window over the target     | halve (down to min_ms) |
+ * | node loaded, or session has a backlog       | + step_ms (up to max)  |
+ * | otherwise                                   | step back to default   |
+ *
+ * Growing back from below the default needs the latency to stay under
+ * half the target, so a session does not oscillate around it.
+ *
+ * @note observe() must be called from one thread (the session's decode
+ *       worker); set_target_ms() is safe from any thread
+ */
+class chunk_controller {
+public:
+    /**
+     * @struct config
+     * @brief Chunk bounds and adaptation speed
+     */
+    struct config {
+        int default_ms = 100;               ///< Chunk without pressure either way
+        int min_ms = 20;                    ///< Smallest chunk when chasing a latency target
+        int max_ms = 1000;                  ///< Largest chunk under load
+        int step_ms = 50;                   ///< Additive growth per window
+        size_t window = 4;                  ///< Observations per decision
+
+        config() = default;
+    };
+
+    chunk_controller();
+    explicit chunk_controller(const config& cfg);
+
+    /**
+     * @brief Set the latency the session asks for
+     * @param target_ms Audio-to-result latency in ms (0 = none)
+     */
+    void set_target_ms(int target_ms) { m_target_ms.store(target_ms < 0 ? 0 : target_ms, std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the session's latency target (0 = none)
+     */
+    int get_target_ms() const { return m_target_ms.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Record one decoded chunk
+     *
+     * @param latency_ms Time from the audio's arrival to its result
+     * @param loaded The node is shedding load
+     * @param backlog More audio of the session was already waiting
+     * @return true if chunk_ms() changed
+     */
+    bool observe(double latency_ms, bool loaded, bool backlog);
+
+    /**
+     * @brief Current chunk size in ms
+     */
+    int chunk_ms() const { return m_chunk_ms; }
+
+private:
+    config m_config;
+    std::atomic<int> m_target_ms{0};
+    int m_chunk_ms;
+    size_t m_seen = 0;                      ///< Observations in the current window
+    double m_worst_ms = 0.0;                ///< Highest latency in the current window
+    bool m_pressure = false;                ///< Load or backlog seen in the current window
+};
@@ -0,0 +1,76 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @class client_session_table
+ * @brief Which WebSocket client owns which session
+ *
+ * A session belongs to the client that first sent audio or a command for
+ * it; other clients cannot send audio to it or reconfigure it. The WebSocket
+ * server reports no disconnects, so a claim lasts until the session has
+ * been idle for the session timeout (or is released) - after that another
+ * client, or a new connection at a reused socket address, starts fresh.
+ *
+ * @note Thread-safe
+ */
+class client_session_table {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Bind a session to a client, or refresh the binding
+     *
+     * A client that claims a new session gives up its previous one.
+     *
+     * @return false if another client owns the session
+     */
+    bool claim(const void* client, const std::string& session_id);
+
+    /**
+     * @brief Session of a client, empty if it has none
+     */
+    std::string session_of(const void* client);
+
+    /**
+     * @brief Whether any client owns the session
+     */
+    bool has_owner(const std::string& session_id) const;
+
+    /**
+     * @brief Drop the claim on a session
+     */
+    void release_session(const std::string& session_id);
+
+    /**
+     * @brief Drop claims unused for timeout
+     * @return Number of claims dropped
+     */
+    size_t evict_idle(std::chrono::milliseconds timeout);
+
+    size_t size() const;
+
+private:
+    struct claim_entry {
+        std::string session_id;
+        clock::time_point last_used;
+    };
+
+    std::unordered_map<const void*, claim_entry> m_by_client;
+    std::unordered_map<std::string, const void*> m_owners;      ///< Session id -> client
+    mutable std::mutex m_mutex;                                 ///< Protects both maps
+};
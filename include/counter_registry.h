@@ -0,0 +1,116 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * @class counter_registry
+ * @brief Event counters of the serving pipeline, sharded per thread
+ *
+ * Decode workers, the WebSocket I/O thread and the local socket thread all
+ * count events per audio chunk. A single shared atomic per counter would
+ * bounce its cache line between every core at each increment; here each
+ * thread increments its own cache-line-aligned shard and a snapshot sums
+ * the shards when stats are queried or scraped. add() is one uncontended
+ * relaxed fetch_add, so counting costs the same at any message rate.
+ *
+ * @par Example:
+ * @code
+ * counter_registry counters;
+ * counters.add(counter_registry::counter::messages_processed);
+ * auto s = counters.snapshot();
+ * std::cout << s[counter_registry::counter::messages_processed] << "\n";
+ * @endcode
+ */
+class counter_registry {
+public:
+    enum class counter {
+        messages_processed,     ///< Client audio chunks decoded
+        audio_chunks,           ///< Client audio chunks received
+        results_delivered,      ///< Results handed to a transport
+        samples_routed,         ///< Samples decoded on non-default models
+        vad_skipped_chunks,     ///< Client chunks not decoded (silence)
+        chunk_adjustments,      ///< Adaptive chunk size changes
+        opus_packets,           ///< Opus packets decoded
+        opus_errors,            ///< Opus packets dropped as corrupt
+        drained_sessions        ///< Sessions finalized while draining
+    };
+
+    static constexpr size_t counter_count = 9;
+    static constexpr size_t shard_count = 32;   ///< Threads beyond this share shards
+
+    /**
+     * @struct snapshot_t
+     * @brief Totals at one point in time
+     */
+    struct snapshot_t {
+        std::array<uint64_t, counter_count> values{};
+
+        uint64_t operator[](counter c) const { return values[static_cast<size_t>(c)]; }
+    };
+
+    counter_registry() = default;
+
+    counter_registry(const counter_registry&) = delete;
+    counter_registry& operator=(const counter_registry&) = delete;
+
+    /**
+     * @brief Count events on the calling thread's shard
+     */
+    void add(counter c, uint64_t n = 1) noexcept {
+        m_shards[thread_shard()].values[static_cast<size_t>(c)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sum all shards
+     * @note Concurrent add() calls may or may not be included
+     */
+    snapshot_t snapshot() const noexcept;
+
+    /**
+     * @brief Current total of one counter
+     */
+    uint64_t get(counter c) const noexcept;
+
+    /**
+     * @brief Get the label of a counter ("messages_processed", ...)
+     */
+    static const char* counter_name(counter c) noexcept;
+
+    /**
+     * @brief All counters of a snapshot, keyed by name
+     */
+    static nlohmann::json to_json(const snapshot_t& s);
+
+    /**
+     * @brief Prometheus text exposition: one vstream_<name>_total counter each
+     */
+    static std::string to_prometheus(const snapshot_t& s);
+
+private:
+    struct alignas(64) shard {
+        std::array<std::atomic<uint64_t>, counter_count> values{};
+    };
+
+    std::array<shard, shard_count> m_shards{};
+
+    /**
+     * @brief Shard of the calling thread, assigned round-robin on first use
+     */
+    static size_t thread_shard() noexcept;
+};
@@ -0,0 +1,308 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <moodycamel/concurrentqueue.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * @class decode_dispatcher
+ * @brief Worker thread pool that decodes audio off the network threads
+ *
+ * Audio frames are queued per session and decoded by a fixed pool of
+ * worker threads:
+ *
+ * - **Session affinity**: A session is owned by one worker at a time, so its
+ *   frames are always decoded in arrival order and never concurrently
+ * - **Work stealing**: An idle worker takes whole runnable sessions from the
+ *   run queue of a busier worker, moving the session's affinity with it
+ * - **Lock-free hand-off**: Frames and runnable sessions travel through
+ *   moodycamel::ConcurrentQueue; the network thread only touches a mutex
+ *   to look up the session and to wake a sleeping worker
+ * - **Memory domains**: With worker_domains set (one NUMA node per worker),
+ *   a session is placed on, and only stolen between, the workers of one
+ *   domain, session_domain(), so it always reads the model replica of
+ *   that node
+ *
+ * @par Flow:
+ * ```
+ * submit() → session queue → owner run queue → worker → job handler
+ *                                   ↑
+ *                          idle workers steal
+ * ```
+ *
+ * @par Load shedding:
+ * - A session with max_session_frames queued drops new frames
+ * - set_coalesce() lets a worker decode several queued frames of a session
+ *   in one handler call, trading cadence for per-call overhead
+ * - set_session_chunk() does the same for one session, by audio length
+ * - set_accepting_sessions(false) refuses frames of sessions not yet known
+ *
+ * @note Frames of one session must be submitted from one thread at a time
+ *       (true for a WebSocket connection) to keep them in order
+ */
+class decode_dispatcher {
+public:
+    /**
+     * @struct config
+     * @brief Worker pool configuration
+     */
+    struct config {
+        size_t num_threads = 0;          ///< Worker count (0 = hardware concurrency)
+        bool pin_threads = false;        ///< Pin each worker to one CPU
+        std::vector<int> cpu_list;       ///< CPUs to pin to (empty = 0..N-1)
+        size_t max_batch = 8;            ///< Frames decoded per session before yielding
+        size_t max_session_frames = 0;   ///< Queued frames per session before dropping (0 = unlimited)
+        std::vector<size_t> worker_domains; ///< Memory domain per worker, 0..N-1 (empty = one domain)
+
+        config() = default;
+    };
+
+    /**
+     * @struct audio_job
+     * @brief One chunk of session audio waiting to be decoded
+     */
+    struct audio_job {
+        std::string session_id;                                 ///< Owning session
+        std::vector<int16_t> samples;                           ///< 16-bit PCM samples
+        std::chrono::steady_clock::time_point enqueue_time;     ///< Time of submit()
+        size_t backlog = 0;                                     ///< Session frames still queued behind this job
+        size_t decoded_samples = 0;                             ///< Set by the handler when samples is not model-rate PCM
+    };
+
+    /**
+     * @brief Handler invoked on a worker thread for each job
+     */
+    using job_handler_t = std::function<void(audio_job&)>;
+
+    /**
+     * @brief Construct dispatcher (workers are started by start())
+     * @param cfg Worker pool configuration
+     * @param handler Function decoding one job
+     */
+    decode_dispatcher(const config& cfg, job_handler_t handler);
+
+    /**
+     * @brief Destructor - stops and joins all workers
+     */
+    ~decode_dispatcher();
+
+    decode_dispatcher(const decode_dispatcher&) = delete;
+    decode_dispatcher& operator=(const decode_dispatcher&) = delete;
+
+    /**
+     * @brief Start worker threads
+     * @note Safe to call multiple times
+     */
+    void start();
+
+    /**
+     * @brief Stop and join worker threads
+     * @note Queued jobs that have not started are discarded
+     */
+    void stop();
+
+    /**
+     * @brief Queue audio for a session
+     *
+     * @param session_id Session identifier
+     * @param samples Audio samples (moved into the job)
+     * @return false if the frame was not queued: the dispatcher is not
+     *         running, the session queue is full, or new sessions are refused
+     */
+    bool submit(const std::string& session_id, std::vector<int16_t> samples);
+
+    /**
+     * @brief Memory domain whose workers decode a session
+     *
+     * A pure function of the session id, so callers can pick the matching
+     * per-domain resources before the session's first frame.
+     */
+    size_t session_domain(const std::string& session_id) const;
+
+    /**
+     * @brief Get the number of memory domains (1 without worker_domains)
+     */
+    size_t get_domain_count() const { return m_domain_workers.size(); }
+
+    /**
+     * @brief Check if a session has been admitted and not yet forgotten
+     */
+    bool has_session(const std::string& session_id);
+
+    /**
+     * @brief Admit or refuse frames of sessions not seen before
+     */
+    void set_accepting_sessions(bool accept) { m_accepting.store(accept, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check if new sessions are admitted
+     */
+    bool is_accepting_sessions() const { return m_accepting.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Decode up to @p frames queued frames of a session per handler call
+     *
+     * The frames' samples are concatenated into the first job; its
+     * enqueue_time is kept. 1 restores one call per frame.
+     */
+    void set_coalesce(size_t frames) { m_coalesce.store(std::max<size_t>(1, frames), std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of frames decoded per handler call
+     */
+    size_t get_coalesce() const { return m_coalesce.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Coalesce queued frames of one session up to @p samples per handler call
+     *
+     * Applies on top of set_coalesce(); 0 restores one frame per call.
+     * @p samples counts decoded audio: for sessions whose handler reports
+     * audio_job::decoded_samples (Opus, other rates or channel counts), the
+     * queued frames are measured by what the session's last job decoded to.
+     * Ignored for sessions not (or no longer) known.
+     */
+    void set_session_chunk(const std::string& session_id, size_t samples);
+
+    /**
+     * @brief Forget a session once its queued frames are decoded
+     */
+    void release_session(const std::string& session_id);
+
+    /**
+     * @brief Forget sessions with no queued frames that were idle for timeout
+     * @return Number of sessions forgotten
+     */
+    size_t evict_idle_sessions(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Forget sessions with no queued frames that were idle for timeout
+     *
+     * Once a session is returned no worker touches it again, so the caller
+     * can flush its decoder state.
+     *
+     * @return Ids of the sessions forgotten
+     */
+    std::vector<std::string> take_idle_sessions(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Get the number of known sessions
+     */
+    size_t get_session_count();
+
+    /**
+     * @brief Get number of worker threads
+     */
+    size_t get_thread_count() const { return m_workers.size(); }
+
+    /**
+     * @brief Get the CPU a worker is pinned to, or -1 if workers are not pinned
+     */
+    int get_worker_cpu(size_t index) const;
+
+    /**
+     * @brief Get number of frames queued but not yet decoded
+     */
+    size_t get_queue_depth() const { return m_queued_frames.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get number of sessions moved between workers by stealing
+     */
+    size_t get_steal_count() const { return m_steals.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the time all workers spent in the job handler
+     */
+    uint64_t get_busy_ns() const { return m_busy_ns.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the longest queue wait since the last call, and reset it
+     */
+    std::chrono::nanoseconds take_max_queue_wait() {
+        return std::chrono::nanoseconds(m_max_wait_ns.exchange(0, std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Get the number of frames dropped on a full session queue
+     */
+    size_t get_dropped_count() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of frames refused because their session was not admitted
+     */
+    size_t get_rejected_count() const { return m_rejected.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Check if workers are running
+     */
+    bool is_running() const { return m_running.load(); }
+
+private:
+    /**
+     * @brief Per-session frame queue and scheduling state
+     */
+    struct session_queue {
+        std::string id;                                         ///< Session identifier
+        moodycamel::ConcurrentQueue<audio_job> frames;          ///< Frames in arrival order
+        std::atomic<size_t> pending{0};                         ///< Frames not yet decoded
+        std::atomic<bool> scheduled{false};                     ///< In a run queue or running
+        std::atomic<size_t> owner{0};                           ///< Worker the session sticks to
+        std::atomic<size_t> chunk_samples{0};                   ///< Coalesce up to this much audio
+        double units_per_sample = 1.0;                          ///< Queued units per decoded sample, worker-owned
+        std::chrono::steady_clock::time_point last_submit;      ///< Guarded by sessions mutex
+    };
+
+    /**
+     * @brief One decode worker with its run queue of sessions
+     */
+    struct alignas(64) worker {
+        moodycamel::ConcurrentQueue<std::shared_ptr<session_queue>> run_queue;
+        std::mutex wake_mutex;
+        std::condition_variable wake_cv;
+        std::thread thread;
+    };
+
+    config m_config;
+    job_handler_t m_handler;
+    std::vector<std::unique_ptr<worker>> m_workers;
+    std::vector<std::vector<size_t>> m_domain_workers;   ///< Worker indices per memory domain
+    std::atomic<bool> m_running{false};
+    std::atomic<size_t> m_queued_frames{0};
+    std::atomic<size_t> m_steals{0};
+    std::atomic<size_t> m_next_owner{0};
+    std::atomic<bool> m_accepting{true};
+    std::atomic<size_t> m_coalesce{1};
+    std::atomic<uint64_t> m_busy_ns{0};
+    std::atomic<uint64_t> m_max_wait_ns{0};
+    std::atomic<size_t> m_dropped{0};
+    std::atomic<size_t> m_rejected{0};
+
+    std::unordered_map<std::string, std::shared_ptr<session_queue>> m_sessions;
+    std::mutex m_sessions_mutex;
+
+    void worker_loop(size_t index);
+    void run_session(size_t index, const std::shared_ptr<session_queue>& session);
+    bool steal(size_t thief, std::shared_ptr<session_queue>& session);
+    void schedule(const std::shared_ptr<session_queue>& session);
+    void wake(size_t index);
+    void pin_thread(size_t index);
+};
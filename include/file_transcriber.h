@@ -0,0 +1,136 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "vstream_engine.h"
+#include "audio_file.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <span>
+#include <cstddef>
+
+class benchmark_manager;
+
+/**
+ * @class file_transcriber
+ * @brief Offline batch transcription of audio files on all cores
+ *
+ * Transcribes WAV or raw PCM files as fast as the hardware allows instead
+ * of in real time:
+ *
+ * - **Memory-mapped input**: files are mapped with audio_file, not read
+ * - **Silence splitting**: long files are cut at pauses into segments of
+ *   roughly target_segment_ms, so one file keeps every core busy
+ * - **Parallel decode**: worker threads decode segments on their own
+ *   vstream_engine::stream, all sharing the engine's single loaded model;
+ *   the longest segments are scheduled first to balance the tail
+ * - **Ordered output**: segment results are stitched back in file and
+ *   time order, and reported to the benchmark in that order
+ *
+ * @par Example:
+ * @code
+ * file_transcriber transcriber(engine, file_transcriber::config{});
+ * for (const auto& t : transcriber.transcribe(file_transcriber::collect_inputs("archive/"))) {
+ *     std::cout << t.path << ": " << t.text << "\n";
+ * }
+ * @endcode
+ */
+class file_transcriber {
+public:
+    /**
+     * @struct config
+     * @brief Batch transcription configuration
+     */
+    struct config {
+        size_t num_threads = 0;              ///< Worker count (0 = hardware concurrency)
+        int sample_rate = 16000;             ///< Expected input sample rate
+        int target_segment_ms = 30000;       ///< Start looking for a pause after this long
+        int max_segment_ms = 60000;          ///< Cut at the quietest frame if no pause by then
+        int min_pause_ms = 200;              ///< Silence needed to count as a pause
+        float silence_threshold_db = -40.0f; ///< Frames below this level are silence
+
+        config() = default;
+    };
+
+    /**
+     * @struct file_result
+     * @brief Transcript of one input file
+     */
+    struct file_result {
+        std::string path;                    ///< Input file
+        std::string text;                    ///< Final text of all segments in order
+        double duration_ms = 0.0;            ///< Audio duration
+        size_t segments = 0;                 ///< Number of segments decoded
+        std::string error;                   ///< Non-empty if the file could not be read
+    };
+
+    /**
+     * @brief Construct transcriber
+     * @param engine Engine providing the shared model (must outlive this object)
+     * @param cfg Batch configuration
+     * @param benchmark Optional benchmark receiving every segment result
+     */
+    file_transcriber(vstream_engine& engine, const config& cfg,
+                     benchmark_manager* benchmark = nullptr);
+
+    /**
+     * @brief Transcribe files
+     *
+     * Blocks until every file is decoded. Unreadable files are reported in
+     * file_result::error and do not stop the batch.
+     *
+     * @param paths Input files
+     * @return One result per input, in input order
+     */
+    std::vector<file_result> transcribe(const std::vector<std::string>& paths);
+
+    /**
+     * @brief Request that transcribe() stops after the segments in progress
+     */
+    void cancel() { m_cancelled = true; }
+
+    /**
+     * @brief Expand a file or directory into a sorted list of audio files
+     * @throws std::invalid_argument if the path does not exist or holds no audio
+     */
+    static std::vector<std::string> collect_inputs(const std::string& path);
+
+    /**
+     * @brief Compute segment boundaries at pauses
+     *
+     * @param audio Samples of one file
+     * @param cfg Segment length and silence parameters
+     * @return Start offsets of each segment; the last segment ends at audio.size()
+     */
+    static std::vector<size_t> split_at_silence(std::span<const int16_t> audio, const config& cfg);
+
+private:
+    /**
+     * @brief One piece of a file decoded by a single worker
+     */
+    struct segment {
+        size_t file_index;
+        std::span<const int16_t> audio;
+        std::string text;                    ///< Concatenated final results
+        float confidence = 1.0f;             ///< Mean confidence of the final results
+        double latency_ms = 0.0;             ///< Wall time spent decoding
+    };
+
+    vstream_engine& m_engine;
+    config m_config;
+    benchmark_manager* m_benchmark;
+    std::atomic<bool> m_cancelled{false};
+
+    void decode_segment(vstream_engine::stream& stream, segment& seg) const;
+};
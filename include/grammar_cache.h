@@ -0,0 +1,120 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Forward declaration
+typedef struct VoskRecognizer VoskRecognizer;
+
+/**
+ * @class grammar_cache
+ * @brief Bounded LRU pool of idle recognizers, keyed by their grammar
+ *
+ * Building a grammar graph (vosk_recognizer_set_grm) costs far more than
+ * decoding a chunk. IVR-style clients switch between a handful of
+ * grammars, so instead of rebuilding, a stream hands its idle recognizer
+ * back here and takes one already built for the next grammar: a pointer
+ * swap on a hit.
+ *
+ * - Keys are normalize()d grammar JSON, so formatting differences hit
+ * - Entries carry the engine model generation; stale ones never match
+ * - A recognizer is owned by exactly one stream or by the cache
+ * - Beyond capacity, the least recently released recognizer is freed
+ *
+ * @note Thread-safe; the lock is never held while a recognizer is built or freed
+ *
+ * @par Example:
+ * @code
+ * VoskRecognizer* next = cache.acquire(grammar_cache::normalize(grm), generation);
+ * if (!next) {
+ *     next = build(grm);                      // miss: the expensive path
+ * }
+ * cache.release(current_key, generation, current);
+ * @endcode
+ */
+class grammar_cache {
+public:
+    using free_function = void (*)(VoskRecognizer*);
+
+    /**
+     * @brief Create a cache
+     *
+     * @param capacity Idle recognizers kept (0 = disabled, every release frees)
+     * @param free_recognizer Releases evicted recognizers (vosk_recognizer_free)
+     */
+    explicit grammar_cache(size_t capacity, free_function free_recognizer);
+
+    /**
+     * @brief Destructor - frees all cached recognizers
+     */
+    ~grammar_cache();
+
+    grammar_cache(const grammar_cache&) = delete;
+    grammar_cache& operator=(const grammar_cache&) = delete;
+
+    /**
+     * @brief Take an idle recognizer built for a grammar
+     *
+     * @param key Normalized grammar ("" = no grammar)
+     * @param generation Model generation the recognizer must belong to
+     * @return Recognizer now owned by the caller, or nullptr on a miss
+     */
+    VoskRecognizer* acquire(const std::string& key, uint64_t generation);
+
+    /**
+     * @brief Hand an idle recognizer to the cache
+     *
+     * The caller must have reset it and undone per-stream settings.
+     * Takes ownership; may free it or an older entry right away.
+     */
+    void release(const std::string& key, uint64_t generation, VoskRecognizer* recognizer);
+
+    /**
+     * @brief Free all cached recognizers, e.g. after a model switch
+     */
+    void clear();
+
+    /**
+     * @brief Canonical form of a grammar, used as the cache key
+     *
+     * Valid JSON is re-serialized compactly (whitespace and object key
+     * order no longer matter); anything else is used verbatim.
+     */
+    static std::string normalize(const std::string& grammar);
+
+    size_t capacity() const { return m_capacity; }
+    size_t size() const;
+    uint64_t get_hit_count() const { return m_hits.load(std::memory_order_relaxed); }
+    uint64_t get_miss_count() const { return m_misses.load(std::memory_order_relaxed); }
+
+private:
+    struct entry {
+        std::string key;
+        uint64_t generation;
+        VoskRecognizer* recognizer;
+    };
+
+    const size_t m_capacity;
+    const free_function m_free;
+    std::list<entry> m_entries;             ///< Most recently released first
+    mutable std::mutex m_mutex;             ///< Protects m_entries
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+};
@@ -0,0 +1,89 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class huge_page_advisor
+ * @brief Backs memory allocated during a model load with transparent huge pages
+ *
+ * Vosk reads the acoustic model and decoding graph into anonymous heap
+ * memory, several GB for large models, which decoding then walks almost
+ * randomly. With 4 KB pages that walk misses the TLB constantly; with 2 MB
+ * pages the whole model fits in a few thousand TLB entries.
+ *
+ * The allocations happen inside Vosk, so the advisor works on the mappings
+ * instead: it snapshots the process's anonymous mappings before the load
+ * and afterwards marks every new or grown one MADV_HUGEPAGE and asks the
+ * kernel to collapse it right away (MADV_COLLAPSE, Linux 6.1+; older
+ * kernels leave it to khugepaged). Works with the THP mode "madvise" as
+ * well as "always"; does nothing if THP is "never".
+ *
+ * @par Example:
+ * @code
+ * huge_page_advisor advisor;
+ * auto engine = std::make_shared<vstream_engine>(path);
+ * size_t bytes = advisor.advise_new_regions();
+ * @endcode
+ */
+class huge_page_advisor {
+public:
+    /**
+     * @struct region
+     * @brief One anonymous private read-write mapping
+     */
+    struct region {
+        uintptr_t start = 0;
+        uintptr_t end = 0;
+
+        bool operator==(const region&) const = default;
+    };
+
+    /**
+     * @brief Snapshot the current anonymous mappings
+     */
+    huge_page_advisor();
+
+    /**
+     * @brief Advise huge pages for mappings that appeared or grew since the snapshot
+     *
+     * @param min_bytes Smallest mapping worth advising
+     * @return Bytes advised
+     */
+    size_t advise_new_regions(size_t min_bytes = 2 * 1024 * 1024);
+
+    /**
+     * @brief Anonymous private read-write mappings in /proc/<pid>/maps format
+     */
+    static std::vector<region> parse_maps(std::istream& maps);
+
+    /**
+     * @brief Anonymous memory of this process backed by huge pages, in KB
+     * @param smaps_rollup Path to the process's smaps_rollup
+     */
+    static size_t huge_pages_kb(const std::string& smaps_rollup = "/proc/self/smaps_rollup");
+
+    /**
+     * @brief Check if the kernel allows transparent huge pages on request
+     */
+    static bool available();
+
+private:
+    std::vector<region> m_before;
+
+    static std::vector<region> current_regions();
+};
@@ -0,0 +1,147 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+
+/**
+ * @class latency_histogram
+ * @brief Lock-free log-linear (HDR-style) histogram of durations
+ *
+ * Values are recorded in microseconds into buckets whose width grows with
+ * the value: every power of two is split into 32 linear sub-buckets, so a
+ * percentile is accurate to about 3% from 1us up to roughly 71 minutes.
+ * record() is one relaxed fetch_add per counter and never blocks, so it is
+ * safe on decode workers and the audio path; readers take a snapshot.
+ *
+ * @par Example:
+ * @code
+ * latency_histogram decode;
+ * decode.record(std::chrono::steady_clock::now() - start);
+ * auto s = decode.snapshot();
+ * std::cout << s.p99_ms << " ms\n";
+ * @endcode
+ */
+class latency_histogram {
+public:
+    static constexpr int sub_bucket_bits = 6;                      ///< 64 values below the first split
+    static constexpr uint64_t max_value_us = (uint64_t{1} << 32) - 1;
+    static constexpr size_t bucket_count = (32 - sub_bucket_bits + 1) * 32 + 32;
+
+    /**
+     * @struct summary
+     * @brief Point-in-time view of the histogram
+     */
+    struct summary {
+        uint64_t count = 0;
+        double sum_ms = 0.0;
+        double mean_ms = 0.0;
+        double max_ms = 0.0;
+        double p50_ms = 0.0;
+        double p99_ms = 0.0;
+        double p999_ms = 0.0;
+    };
+
+    latency_histogram() = default;
+
+    latency_histogram(const latency_histogram&) = delete;
+    latency_histogram& operator=(const latency_histogram&) = delete;
+
+    /**
+     * @brief Record one value in microseconds (clamped to max_value_us)
+     */
+    void record_us(uint64_t value) noexcept {
+        if (value > max_value_us) {
+            value = max_value_us;
+        }
+        m_buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum_us.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t max = m_max_us.load(std::memory_order_relaxed);
+        while (value > max && !m_max_us.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Record one duration (negative durations count as zero)
+     */
+    template<typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> duration) noexcept {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        record_us(us > 0 ? static_cast<uint64_t>(us) : 0);
+    }
+
+    /**
+     * @brief Get the number of recorded values
+     */
+    uint64_t count() const noexcept { return m_count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get a value at or below which the fraction q of values fall
+     * @param q Quantile in [0, 1]
+     * @return Value in milliseconds (bucket midpoint, exact below 64us)
+     */
+    double percentile(double q) const noexcept;
+
+    /**
+     * @brief Compute count, mean, max and p50/p99/p999 from one pass
+     * @note Concurrent record() calls may or may not be included
+     */
+    summary snapshot() const noexcept;
+
+    /**
+     * @brief Clear all counters
+     * @note Not atomic with respect to concurrent record() calls
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Bucket holding a value in microseconds
+     */
+    static constexpr size_t bucket_index(uint64_t value) noexcept {
+        if (value < (uint64_t{1} << sub_bucket_bits)) {
+            return static_cast<size_t>(value);
+        }
+        // Shift so the top sub_bucket_bits bits remain: mantissa in [32, 63]
+        const int shift = std::bit_width(value) - sub_bucket_bits;
+        return static_cast<size_t>(shift) * 32 + static_cast<size_t>(value >> shift);
+    }
+
+    /**
+     * @brief Smallest value in microseconds mapped to a bucket
+     */
+    static constexpr uint64_t bucket_lower_bound(size_t index) noexcept {
+        if (index < (size_t{1} << sub_bucket_bits)) {
+            return index;
+        }
+        const size_t shift = index / 32 - 1;
+        return static_cast<uint64_t>(index % 32 + 32) << shift;
+    }
+
+    /**
+     * @brief Number of microsecond values mapped to a bucket
+     */
+    static constexpr uint64_t bucket_width(size_t index) noexcept {
+        return index < (size_t{1} << sub_bucket_bits) ? 1 : uint64_t{1} << (index / 32 - 1);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, bucket_count> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum_us{0};
+    std::atomic<uint64_t> m_max_us{0};
+};
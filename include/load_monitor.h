@@ -0,0 +1,123 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class load_monitor
+ * @brief Tracks decode load and picks a graded load-shedding level
+ *
+ * Fed once per interval with running totals from the decode workers, it
+ * derives:
+ *
+ * - **utilization**: worker busy time / (elapsed time × workers)
+ * - **real-time factor**: worker busy time / duration of the audio decoded
+ * - **queue pressure**: longest queue wait / max_queue_wait_ms
+ *
+ * The load is the larger of utilization and queue pressure, smoothed over
+ * intervals. It maps to a level, and each level sheds more than the last:
+ *
+ * | level         | load        | action                                 |
+ * |---------------|-------------|----------------------------------------|
+ * | normal        | < 0.70      | none                                   |
+ * | no_partials   | >= 0.70     | stop computing partial results         |
+ * | coarse        | >= 0.85     | decode queued chunks together          |
+ * | reject        | >= 1.00     | refuse new sessions                    |
+ *
+ * Levels rise as soon as the load crosses a threshold. They fall one
+ * step at a time, and only once the load is `hysteresis` below that
+ * level's threshold, so the server does not flap at a boundary.
+ *
+ * @note update() must be called from one thread; the getters are safe from any thread
+ */
+class load_monitor {
+public:
+    /**
+     * @enum level
+     * @brief Load shedding levels, in escalation order
+     */
+    enum class level {
+        normal,
+        no_partials,
+        coarse,
+        reject
+    };
+
+    /**
+     * @struct config
+     * @brief Capacity and thresholds
+     */
+    struct config {
+        size_t workers = 1;                 ///< Decode workers sharing the load
+        int sample_rate = 16000;            ///< Rate of the decoded audio
+        double no_partials_load = 0.70;     ///< Load that suspends partial results
+        double coarse_load = 0.85;          ///< Load that coalesces queued chunks
+        double reject_load = 1.00;          ///< Load that refuses new sessions
+        double hysteresis = 0.10;           ///< Margin below a threshold before stepping down
+        double max_queue_wait_ms = 1000.0;  ///< Queue wait counted as full load
+        double smoothing = 0.5;             ///< Weight of the newest interval (1 = no smoothing)
+
+        config() = default;
+    };
+
+    /**
+     * @struct totals
+     * @brief Running counters of the decode workers
+     */
+    struct totals {
+        uint64_t busy_ns = 0;                       ///< Time spent decoding, all workers
+        uint64_t samples = 0;                       ///< Audio samples decoded
+        std::chrono::nanoseconds max_queue_wait{0}; ///< Longest queue wait since the last update
+    };
+
+    load_monitor();
+    explicit load_monitor(const config& cfg);
+
+    /**
+     * @brief Fold in one interval and re-evaluate the level
+     *
+     * @param now Current time; the first call only sets the baseline
+     * @param current Counters at @p now
+     * @return Level after the update
+     */
+    level update(std::chrono::steady_clock::time_point now, const totals& current);
+
+    level get_level() const { return m_level.load(std::memory_order_relaxed); }
+    double get_load() const { return m_load.load(std::memory_order_relaxed); }
+    double get_utilization() const { return m_utilization.load(std::memory_order_relaxed); }
+    double get_real_time_factor() const { return m_rtf.load(std::memory_order_relaxed); }
+    double get_queue_wait_ms() const { return m_queue_wait_ms.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the label of a level ("normal", "no_partials", ...)
+     */
+    static const char* level_name(level l) noexcept;
+
+private:
+    config m_config;
+
+    bool m_started = false;
+    std::chrono::steady_clock::time_point m_last_time;
+    totals m_last;
+
+    std::atomic<level> m_level{level::normal};
+    std::atomic<double> m_load{0.0};
+    std::atomic<double> m_utilization{0.0};
+    std::atomic<double> m_rtf{0.0};
+    std::atomic<double> m_queue_wait_ms{0.0};
+
+    double threshold(level l) const;
+};
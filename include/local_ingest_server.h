@@ -0,0 +1,208 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class local_ingest_server
+ * @brief Unix domain socket transport for producers on the same host
+ *
+ * A co-located producer (e.g. a telephony gateway) streams audio without
+ * TCP, WebSocket framing or masking: each connection carries one session,
+ * audio payloads are read from the socket straight into the sample buffer
+ * that is handed to the decoder, and results come back on the same
+ * connection. One epoll thread serves all connections.
+ *
+ * @par Protocol:
+ * Every frame is an 8-byte header followed by its payload, little-endian:
+ * ```
+ * uint8  type       frame_type
+ * uint8  reserved[3]
+ * uint32 length     payload bytes (at most max_payload)
+ * ```
+ * | type     | direction | payload                                        |
+ * |----------|-----------|------------------------------------------------|
+ * | hello    | to server | session id (UTF-8), must be the first frame    |
+ * | audio    | to server | 16-bit mono PCM at the model rate              |
+ * | command  | to server | JSON command, as sent over the WebSocket       |
+ * | result   | to client | JSON transcription                             |
+ * | response | to client | JSON command response                          |
+ * | error    | to client | UTF-8 message; the server then closes          |
+ *
+ * A path starting with '@' binds in the Linux abstract namespace.
+ *
+ * @note send() is thread-safe; handlers run on the server thread
+ */
+class local_ingest_server {
+public:
+    /**
+     * @enum frame_type
+     * @brief Frame types of the protocol
+     */
+    enum class frame_type : uint8_t {
+        hello = 1,          ///< Client names its session
+        audio = 2,          ///< PCM samples
+        command = 3,        ///< JSON command
+        result = 0x81,      ///< Transcription
+        response = 0x82,    ///< Command response
+        error = 0x83        ///< Fatal protocol error
+    };
+
+    static constexpr size_t header_size = 8;            ///< Bytes before each payload
+    static constexpr size_t max_payload = 1 << 20;      ///< Largest accepted payload
+    static constexpr size_t max_pending_output = 1 << 20; ///< Unsent bytes before results are dropped
+
+    /**
+     * @brief Receives a session's audio; the samples may be moved from
+     */
+    using audio_handler_t = std::function<void(const std::string& session_id, std::vector<int16_t>& samples)>;
+
+    /**
+     * @brief Handles a command; params always carry the connection's session_id
+     */
+    using command_handler_t = std::function<nlohmann::json(const std::string& command, const nlohmann::json& params)>;
+
+    /**
+     * @brief Called when a session's connection closes
+     */
+    using close_handler_t = std::function<void(const std::string& session_id)>;
+
+    /**
+     * @brief Bind and listen on a Unix socket
+     *
+     * An existing socket file at the path is replaced.
+     *
+     * @throws std::invalid_argument if the path is empty or too long
+     * @throws std::runtime_error if the socket cannot be bound
+     */
+    local_ingest_server(const std::string& path,
+                        audio_handler_t on_audio,
+                        command_handler_t on_command,
+                        close_handler_t on_close = {});
+
+    /**
+     * @brief Destructor - stops the server and removes the socket file
+     */
+    ~local_ingest_server();
+
+    local_ingest_server(const local_ingest_server&) = delete;
+    local_ingest_server& operator=(const local_ingest_server&) = delete;
+
+    /**
+     * @brief Start serving on a background thread
+     * @note Safe to call multiple times
+     */
+    void start();
+
+    /**
+     * @brief Stop serving, close all connections and join the thread
+     */
+    void stop();
+
+    /**
+     * @brief Send a frame to the connection of a session
+     *
+     * Written immediately if the socket accepts it, otherwise queued for
+     * the server thread. Dropped if the client lets more than
+     * max_pending_output bytes pile up.
+     *
+     * @return false if the session has no local connection
+     */
+    bool send(const std::string& session_id, frame_type type, const std::string& payload);
+
+    /**
+     * @brief Check if a session is connected through this server
+     */
+    bool has_session(const std::string& session_id) const;
+
+    const std::string& path() const { return m_path; }
+    size_t get_connection_count() const { return m_connection_count.load(std::memory_order_relaxed); }
+    uint64_t get_frames_received() const { return m_frames.load(std::memory_order_relaxed); }
+    uint64_t get_bytes_received() const { return m_bytes.load(std::memory_order_relaxed); }
+    uint64_t get_protocol_errors() const { return m_errors.load(std::memory_order_relaxed); }
+    uint64_t get_dropped_results() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief One client connection
+     */
+    struct connection {
+        int fd = -1;
+        std::string session_id;                 ///< Empty until hello
+        uint8_t header[header_size] = {};       ///< Header being read
+        size_t header_read = 0;
+        frame_type type = frame_type::hello;    ///< Type of the payload being read
+        size_t payload_size = 0;
+        size_t payload_read = 0;
+        std::vector<int16_t> samples;           ///< Audio payload, read in place
+        std::string text;                       ///< Other payloads
+
+        std::mutex write_mutex;                 ///< Guards the fields below
+        std::string pending;                    ///< Bytes the socket did not take yet
+        bool closed = false;                    ///< fd is closed, drop sends
+    };
+
+    std::string m_path;
+    audio_handler_t m_on_audio;
+    command_handler_t m_on_command;
+    close_handler_t m_on_close;
+
+    int m_listen_fd = -1;
+    int m_epoll_fd = -1;
+    int m_wake_fd = -1;                         ///< eventfd that stops the loop
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    std::unordered_map<int, std::shared_ptr<connection>> m_connections;   ///< Server thread only
+    std::unordered_map<std::string, std::shared_ptr<connection>> m_sessions;
+    mutable std::mutex m_sessions_mutex;        ///< Protects m_sessions
+
+    std::atomic<size_t> m_connection_count{0};
+    std::atomic<uint64_t> m_frames{0};
+    std::atomic<uint64_t> m_bytes{0};
+    std::atomic<uint64_t> m_errors{0};
+    std::atomic<uint64_t> m_dropped{0};
+
+    void serve_loop();
+    void accept_connections();
+
+    /**
+     * @brief Read and dispatch every complete frame available
+     * @return false if the connection must be closed
+     */
+    bool read_frames(connection& conn);
+
+    /**
+     * @brief Handle one complete frame
+     * @return false if the connection must be closed
+     */
+    bool dispatch_frame(connection& conn);
+
+    void flush(connection& conn);
+    void fail(connection& conn, const std::string& message);
+    void close_connection(const std::shared_ptr<connection>& conn);
+
+    /**
+     * @brief Queue or write a frame; caller holds conn.write_mutex
+     */
+    bool write_frame_locked(connection& conn, frame_type type, const std::string& payload);
+};
@@ -13,17 +13,28 @@
 #define LOGGING_H
 
 #include <nlohmann/json.hpp>
+#include <moodycamel/concurrentqueue.h>
 #include <string>
 #include <vector>
 #include <memory>
 #include <fstream>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <ctime>
+#include <cstdint>
 
 /**
  * @brief Thread-safe singleton logger class designed for embedded systems
  *
- * This logger provides synchronous logging capabilities with the following features:
- * - Thread-safe operations using mutex protection
+ * This logger provides asynchronous logging capabilities with the following features:
+ * - Lock-free hand-off: callers only push a record onto a multi-producer
+ *   queue; a background writer thread formats and writes batches
+ * - Cheap filtering: the LOG_* macros check the level before evaluating
+ *   their argument, and levels below VSTREAM_MIN_LOG_LEVEL compile out
+ * - Timestamps are formatted once per second, not once per line
  * - Exception-safe design with noexcept guarantees
  * - Dual output support (console and file)
  * - Configurable log levels with filtering
@@ -79,17 +90,28 @@ public:
      */
     bool is_enabled() const noexcept;
 
+    /**
+     * @brief Check if a message of this level would be written
+     * @note Lock-free; used by the LOG_* macros before building the message
+     */
+    bool should_log(Level level) const noexcept {
+        return m_enabled.load(std::memory_order_relaxed) &&
+               static_cast<int>(level) >= m_min_level.load(std::memory_order_relaxed);
+    }
+
     /**
      * @brief Core logging function - thread-safe and exception-safe
      * @param level Log level for this message
      * @param message The message to log
-     * @param file Source file name (optional, used by macros)
+     * @param file Source file name (optional, used by macros; must outlive
+     *        the logger, e.g. __FILE__)
      * @param line Source line number (optional, used by macros)
      * @note Messages below the minimum log level are filtered out
+     * @note Queues the message and returns; it is written by the writer thread
      * @note All exceptions are caught internally to prevent crashes
      */
-    void log(Level level, const std::string& message,
-             const std::string& file = "", int line = -1) noexcept;
+    void log(Level level, std::string message,
+             const char* file = nullptr, int line = -1) noexcept;
 
     /**
      * @brief Log a titled section with multiple messages
@@ -116,7 +138,7 @@ public:
     std::string get_log_file_name() const noexcept;
 
     /**
-     * @brief Force flush of log file buffers to disk
+     * @brief Write all queued messages and flush log file buffers to disk
      * @note Useful for ensuring logs are written before critical operations
      */
     void flush() noexcept;
@@ -166,17 +188,46 @@ private:
     struct loggerState {
         bool file_logging_enabled = false;      ///< File logging enabled flag
         bool console_logging_enabled = true;    ///< Console logging enabled flag
-        Level min_level = Level::DEBUG;         ///< Minimum log level filter
         std::ofstream log_file;                 ///< Output file stream
         std::string log_file_name;              ///< Current log file name
     };
 
+    /**
+     * @brief One queued message
+     */
+    struct log_record {
+        Level level = Level::INFO;
+        std::chrono::system_clock::time_point time;
+        const char* file = nullptr;
+        int line = -1;
+        std::string message;
+    };
+
     /// Pointer to internal state (allows for clean reinitialization)
     std::unique_ptr<loggerState> m_state;
 
-    /// Mutex for thread-safe operations
+    /// Protects m_state; taken by the writer per batch, never by log()
     mutable std::mutex m_mutex;
 
+    std::atomic<bool> m_enabled{false};                     ///< At least one output is enabled
+    std::atomic<int> m_min_level{static_cast<int>(Level::DEBUG)}; ///< Minimum log level filter
+
+    // Asynchronous writer
+    moodycamel::ConcurrentQueue<log_record> m_queue;        ///< Records waiting to be written
+    std::thread m_writer;
+    std::atomic<bool> m_writer_running{false};
+    std::mutex m_writer_mutex;                              ///< Guards the writer wake-up
+    std::condition_variable m_writer_cv;
+    std::condition_variable m_flushed_cv;
+    std::atomic<uint64_t> m_enqueued{0};                    ///< Records queued so far
+    std::atomic<uint64_t> m_written{0};                     ///< Records written so far
+
+    // Writer thread only
+    std::vector<log_record> m_batch;                        ///< Dequeued records
+    std::string m_buffer;                                   ///< Formatted batch
+    std::time_t m_cached_second = 0;                        ///< Second of m_cached_time
+    std::string m_cached_time;
+
     /**
      * @brief Generate a unique log filename with timestamp
      * @return Generated filename in format "hyni_log_YYYYMMDD_HHMMSS.log"
@@ -192,13 +243,51 @@ private:
     std::string level_to_string(Level level) const noexcept;
 
     /**
-     * @brief Get current timestamp as formatted string
-     * @return Current time in "YYYY-MM-DD HH:MM:SS" format
-     * @note Exception-safe - returns error message if time formatting fails
+     * @brief Get a timestamp as formatted string
+     * @return Time in "YYYY-MM-DD HH:MM:SS" format, reformatted once per second
+     * @note Writer thread only
      */
-    std::string current_time() const noexcept;
+    const std::string& format_time(std::chrono::system_clock::time_point time) noexcept;
+
+    /**
+     * @brief Writer thread: drain the queue in batches until stopped
+     */
+    void writer_loop() noexcept;
+
+    /**
+     * @brief Format and write queued records
+     * @return Number of records written
+     */
+    size_t write_batch() noexcept;
+
+    /**
+     * @brief Stop the writer thread after it drained the queue
+     */
+    void stop_writer() noexcept;
 };
 
+/**
+ * @brief Lowest level compiled in (0 = DEBUG, 1 = INFO, 2 = WARNING, 3 = ERROR)
+ *
+ * Set by the build (-DVSTREAM_MIN_LOG_LEVEL=1 drops all LOG_DEBUG calls).
+ */
+#ifndef VSTREAM_MIN_LOG_LEVEL
+#define VSTREAM_MIN_LOG_LEVEL 0
+#endif
+
+/**
+ * @brief Log if the level is compiled in and enabled at runtime
+ *
+ * The message expression is only evaluated when the message will be written.
+ */
+#define VSTREAM_LOG(level, msg)                                                        \
+    do {                                                                               \
+        if (static_cast<int>(level) >= VSTREAM_MIN_LOG_LEVEL &&                        \
+            logger::instance().should_log(level)) {                                    \
+            logger::instance().log(level, msg, __FILE__, __LINE__);                    \
+        }                                                                              \
+    } while (0)
+
 /**
  * @brief Convenience macros for easier logging with automatic file/line info
  *
@@ -211,9 +300,9 @@ private:
  *   LOG_WARNING("Configuration file not found, using defaults");
  *   LOG_ERROR("Failed to connect to database");
  */
-#define LOG_DEBUG(msg) logger::instance().log(logger::Level::DEBUG, msg, __FILE__, __LINE__)
-#define LOG_INFO(msg) logger::instance().log(logger::Level::INFO, msg, __FILE__, __LINE__)
-#define LOG_WARNING(msg) logger::instance().log(logger::Level::WARNING, msg, __FILE__, __LINE__)
-#define LOG_ERROR(msg) logger::instance().log(logger::Level::ERROR, msg, __FILE__, __LINE__)
+#define LOG_DEBUG(msg) VSTREAM_LOG(logger::Level::DEBUG, msg)
+#define LOG_INFO(msg) VSTREAM_LOG(logger::Level::INFO, msg)
+#define LOG_WARNING(msg) VSTREAM_LOG(logger::Level::WARNING, msg)
+#define LOG_ERROR(msg) VSTREAM_LOG(logger::Level::ERROR, msg)
 
 #endif // LOGGING_H
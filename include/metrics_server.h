@@ -0,0 +1,96 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+/**
+ * @class metrics_server
+ * @brief Minimal HTTP/1.0 endpoint for metrics scrapes
+ *
+ * Serves GET requests on its own thread, one connection at a time, which
+ * is all a Prometheus scraper needs. The handler maps the request path to
+ * a response; the server never touches the audio pipeline itself.
+ *
+ * @par Example:
+ * @code
+ * metrics_server server(9100, [&](const std::string& path) {
+ *     metrics_server::response r;
+ *     if (path == "/metrics") r.body = metrics.to_prometheus();
+ *     else r.status = 404;
+ *     return r;
+ * });
+ * server.start();
+ * @endcode
+ */
+class metrics_server {
+public:
+    /**
+     * @struct response
+     * @brief Reply to one request
+     */
+    struct response {
+        int status = 200;                                       ///< HTTP status code
+        std::string content_type = "text/plain; version=0.0.4"; ///< Prometheus text format
+        std::string body;
+    };
+
+    /**
+     * @brief Request handler, called on the server thread with the request path
+     */
+    using handler_t = std::function<response(const std::string& path)>;
+
+    /**
+     * @brief Bind and listen on the port
+     * @param port TCP port (0 = any free port, see port())
+     * @param handler Request handler
+     * @throws std::runtime_error if the port cannot be bound
+     */
+    metrics_server(uint16_t port, handler_t handler);
+
+    /**
+     * @brief Destructor - stops the server thread and closes the socket
+     */
+    ~metrics_server();
+
+    metrics_server(const metrics_server&) = delete;
+    metrics_server& operator=(const metrics_server&) = delete;
+
+    /**
+     * @brief Start serving on a background thread
+     * @note Safe to call multiple times
+     */
+    void start();
+
+    /**
+     * @brief Stop serving and join the thread
+     */
+    void stop();
+
+    /**
+     * @brief Get the bound port
+     */
+    uint16_t port() const { return m_port; }
+
+private:
+    int m_listen_fd = -1;
+    uint16_t m_port = 0;
+    handler_t m_handler;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    void serve_loop();
+    void handle_connection(int fd);
+};
@@ -11,8 +11,8 @@
 /**
  * This module provides a high-performance, thread-safe audio capture system
  * optimized for Automatic Speech Recognition (ASR) applications. It uses
- * PortAudio for cross-platform audio input and a lock-free queue for
- * efficient audio data transfer between threads.
+ * PortAudio for cross-platform audio input and a preallocated lock-free
+ * SPSC ring buffer for efficient audio data transfer between threads.
  *
  * @example
  * @code
@@ -22,7 +22,7 @@
  * cfg.accumulate_ms = 100;  // Process 100ms chunks
  *
  * mic_capture mic(cfg);
- * mic.set_audio_callback([](const std::vector<int16_t>& audio) {
+ * mic.set_audio_callback([](std::span<const int16_t> audio) {
  *     // Process audio data
  * });
  * mic.start();
@@ -31,10 +31,11 @@
 
 #pragma once
 
+#include "spsc_ring.h"
 #include <portaudio.h>
-#include <moodycamel/concurrentqueue.h>
 #include <vector>
-#include <condition_variable>
+#include <span>
+#include <cstdint>
 #include <functional>
 #include <atomic>
 #include <thread>
@@ -47,13 +48,13 @@
  * This class provides real-time audio capture from system microphones with
  * features specifically designed for speech recognition:
  * - Configurable audio accumulation for optimal ASR chunk sizes
- * - Lock-free audio queue for low-latency processing
+ * - Wait-free ring buffer, no allocation or locking on the audio thread
  * - Automatic sample rate and format configuration
  * - Drop detection for overrun scenarios
  *
  * The class uses a producer-consumer pattern where:
- * - Producer: PortAudio callback captures audio from hardware
- * - Consumer: Processing thread delivers audio to user callback
+ * - Producer: PortAudio callback copies samples into the ring
+ * - Consumer: Processing thread delivers accumulate_ms chunks to user callback
  *
  * @note The audio callback is executed in a separate thread
  * @warning Do not perform blocking operations in the audio callback
@@ -64,12 +65,13 @@ public:
      * @typedef audio_callback_t
      * @brief Callback function type for audio data delivery
      *
-     * @param samples Vector containing PCM audio samples (16-bit signed)
+     * @param samples PCM audio samples (16-bit signed), viewed in place in the ring
      *
      * @note Called from the processing thread, not the audio thread
-     * @note The vector size depends on the accumulate_ms configuration
+     * @note The span size depends on the accumulate_ms configuration
+     * @note The span is only valid for the duration of the call
      */
-    using audio_callback_t = std::function<void(const std::vector<int16_t>&)>;
+    using audio_callback_t = std::function<void(std::span<const int16_t>)>;
 
     /**
      * @struct config
@@ -108,10 +110,11 @@ public:
         int device_index = -1;
 
         /**
-         * @brief Maximum size of the audio queue
-         * @note Prevents unbounded memory growth if consumer is slow
+         * @brief Ring buffer size in accumulate_ms chunks
+         * @note Audio arriving while the ring is full is dropped and counted
+         * @note 32 chunks = 9.6 s of audio at the default accumulate_ms
          */
-        size_t queue_size = 1000;
+        size_t queue_size = 32;
 
         /**
          * @brief Audio accumulation time in milliseconds
@@ -194,7 +197,7 @@ public:
      *
      * @example
      * @code
-     * mic.set_audio_callback([](const std::vector<int16_t>& audio) {
+     * mic.set_audio_callback([](std::span<const int16_t> audio) {
      *     // Process audio - this is called from a separate thread
      *     vosk_recognizer_accept_waveform(recognizer, audio.data(), audio.size());
      * });
@@ -208,11 +211,11 @@ public:
      * Alternative to using callbacks - allows manual polling for audio data.
      * Useful for integrating with existing event loops.
      *
-     * @param[out] samples Vector to receive audio samples
-     * @return true if audio was dequeued, false if queue was empty
+     * @param[out] samples Vector to receive one accumulate_ms chunk
+     * @return true if audio was dequeued, false if no full chunk is buffered
      *
      * @note Non-blocking operation
-     * @note Can be used instead of or in addition to callbacks
+     * @note Only use when no audio callback is set (single consumer)
      */
     bool dequeue_audio(std::vector<int16_t>& samples);
 
@@ -225,7 +228,7 @@ public:
     /**
      * @brief Get the number of dropped audio frames
      *
-     * Frames are dropped when the audio queue is full, indicating that
+     * Frames are dropped when the ring buffer is full, indicating that
      * the consumer cannot keep up with the audio input rate.
      *
      * @return Total number of frames dropped since start
@@ -235,6 +238,14 @@ public:
      */
     size_t get_dropped_frames() const { return m_dropped_frames; }
 
+    /**
+     * @brief Get the time the audio callback completed the chunk being delivered
+     *
+     * Valid inside the audio callback and after dequeue_audio(); the
+     * difference to now is the time the chunk waited in the ring.
+     */
+    std::chrono::steady_clock::time_point chunk_time() const { return m_chunk_time; }
+
     /**
      * @brief List all available audio input devices
      *
@@ -265,62 +276,65 @@ private:
     PaStream* m_stream = nullptr;
 
     /**
-     * @brief Lock-free queue for audio data transfer
+     * @brief Number of samples in one delivered chunk (frames * channels)
      *
-     * Uses moodycamel::ConcurrentQueue for efficient single-producer,
-     * single-consumer audio data transfer without locks.
+     * Calculated from sample_rate, accumulate_ms and channels
      */
-    moodycamel::ConcurrentQueue<std::vector<int16_t>> m_audio_queue;
+    size_t m_chunk_samples;
 
     /**
-     * @brief User-provided audio callback function
+     * @brief Ring buffer between the PortAudio callback and the consumer
+     *
+     * Capacity is a whole number of chunks, so every chunk is contiguous.
      */
-    audio_callback_t m_callback;
+    spsc_ring<int16_t> m_ring;
 
     /**
-     * @brief Processing thread for audio callback delivery
+     * @brief Completion time of each chunk in m_ring, in steady_clock ticks
+     *
+     * Written by the audio thread next to the samples, so timestamps travel
+     * with their chunk without any allocation or locking.
      */
-    std::thread m_processing_thread;
+    spsc_ring<int64_t> m_chunk_times;
 
     /**
-     * @brief Atomic flag indicating capture is active
+     * @brief Completion time of the chunk being delivered (consumer only)
      */
-    std::atomic<bool> m_running{false};
+    std::chrono::steady_clock::time_point m_chunk_time;
 
     /**
-     * @brief Counter for dropped audio frames
+     * @brief User-provided audio callback function
      */
-    std::atomic<size_t> m_dropped_frames{0};
+    audio_callback_t m_callback;
 
     /**
-     * @brief Buffer for accumulating audio before delivery
-     *
-     * Audio is accumulated here until we have enough samples
-     * as specified by accumulate_ms configuration.
+     * @brief Processing thread for audio callback delivery
      */
-    std::vector<int16_t> m_accumulation_buffer;
+    std::thread m_processing_thread;
 
     /**
-     * @brief Current number of accumulated frames
+     * @brief Atomic flag indicating capture is active
      */
-    size_t m_accumulated_frames = 0;
+    std::atomic<bool> m_running{false};
 
     /**
-     * @brief Target number of frames to accumulate
-     *
-     * Calculated from sample_rate and accumulate_ms
+     * @brief Counter for dropped audio frames
      */
-    size_t m_frames_to_accumulate;
+    std::atomic<size_t> m_dropped_frames{0};
 
     /**
-     * @brief Condition variable for efficient thread synchronization
+     * @brief Complete chunks published by the audio thread
+     *
+     * Bumped by the PortAudio callback after each chunk boundary; the
+     * processing thread sleeps on it with std::atomic::wait(). The
+     * notification is a wake-up, never a lock on the audio thread.
      */
-    std::condition_variable m_data_cv;
+    std::atomic<uint32_t> m_data_seq{0};
 
     /**
-     * @brief Mutex for condition variable
+     * @brief Samples written since the last published chunk (audio thread only)
      */
-    std::mutex m_data_mutex;
+    size_t m_unpublished_samples = 0;
 
     /**
      * @brief PortAudio callback function
@@ -348,11 +362,17 @@ private:
     /**
      * @brief Main processing loop for audio callback delivery
      *
-     * Runs in a separate thread, dequeuing audio from the lock-free
-     * queue and delivering it to the user callback.
+     * Runs in a separate thread, reading whole chunks from the ring and
+     * delivering them in place to the user callback.
      *
      * @note Runs until m_running becomes false
-     * @note Uses condition variable for efficient waiting
+     * @note Sleeps on m_data_seq between chunks
      */
     void processing_loop();
+
+    /**
+     * @brief Pop the completion time of the next chunk into m_chunk_time
+     * @note Consumer only; falls back to now if no time was recorded
+     */
+    void take_chunk_time();
 };
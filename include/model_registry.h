@@ -0,0 +1,204 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// Forward declaration
+class vstream_engine;
+
+/**
+ * @class model_registry
+ * @brief Named speech models served by one process, loaded on demand
+ *
+ * Each model is a complete vstream_engine (model, session pool, grammar
+ * cache). Callers hold a model through the shared_ptr acquire() returns;
+ * that reference count is what keeps a model loaded. A model nobody
+ * references is idle and may be unloaded, least recently used first, when
+ * loading another would exceed the memory budget.
+ *
+ * - Models load lazily on first acquire(), outside the registry lock
+ * - Concurrent acquires of a loading model wait for that one load
+ * - Resident models (the --model engine) are never unloaded
+ * - Memory is accounted per model: memory_mb from the configuration or
+ *   the size of the model directory, which Vosk maps almost entirely
+ *
+ * @note Thread-safe
+ *
+ * @par Example:
+ * @code
+ * model_registry models(4096, [](const model_registry::model_spec& spec) {
+ *     return std::make_shared<vstream_engine>(spec.path);
+ * });
+ * models.add({"commands", "models/vosk-model-small-en-us-0.15"});
+ * auto engine = models.acquire("commands");   // loads now, stays loaded while referenced
+ * @endcode
+ */
+class model_registry {
+public:
+    /**
+     * @struct model_spec
+     * @brief One named model
+     */
+    struct model_spec {
+        std::string name;                   ///< Name sessions select the model by
+        std::string path;                   ///< Vosk model directory
+        size_t memory_mb = 0;               ///< Memory charged to the budget (0 = directory size)
+        bool preload = false;               ///< Load at startup instead of on first use
+    };
+
+    /**
+     * @struct config
+     * @brief Contents of a --models file
+     */
+    struct config {
+        size_t memory_budget_mb = 0;        ///< Loaded models limit (0 = unlimited)
+        std::vector<model_spec> models;
+    };
+
+    /**
+     * @struct model_status
+     * @brief Snapshot of one model for stats
+     */
+    struct model_status {
+        std::string name;
+        std::string path;
+        size_t memory_mb = 0;
+        bool loaded = false;
+        bool resident = false;
+        long references = 0;                ///< Holders besides the registry
+    };
+
+    using factory = std::function<std::shared_ptr<vstream_engine>(const model_spec&)>;
+
+    /**
+     * @brief Create an empty registry
+     *
+     * @param memory_budget_mb Limit for loaded models (0 = unlimited)
+     * @param create Loads the engine of a model; may throw
+     * @throws std::invalid_argument if create is empty
+     */
+    model_registry(size_t memory_budget_mb, factory create);
+
+    /**
+     * @brief Destructor - unloads idle models
+     */
+    ~model_registry();
+
+    model_registry(const model_registry&) = delete;
+    model_registry& operator=(const model_registry&) = delete;
+
+    /**
+     * @brief Register a model to load on first use
+     * @throws std::invalid_argument for an empty or duplicate name or an empty path
+     */
+    void add(model_spec spec);
+
+    /**
+     * @brief Register an already loaded model that is never unloaded
+     * @throws std::invalid_argument for an empty or duplicate name or no engine
+     */
+    void add_resident(model_spec spec, std::shared_ptr<vstream_engine> engine);
+
+    /**
+     * @brief Get a model, loading it if needed
+     *
+     * Blocks while the model loads. Idle models are unloaded first if the
+     * budget requires it.
+     *
+     * @throws std::invalid_argument for an unknown name
+     * @throws std::runtime_error if the model does not fit the budget or fails to load
+     */
+    std::shared_ptr<vstream_engine> acquire(const std::string& name);
+
+    /**
+     * @brief Check if a model name is registered
+     */
+    bool contains(const std::string& name) const;
+
+    /**
+     * @brief All currently loaded models, e.g. for periodic maintenance
+     */
+    std::vector<std::shared_ptr<vstream_engine>> loaded_engines() const;
+
+    /**
+     * @brief Snapshot of every registered model, in name order
+     */
+    std::vector<model_status> status() const;
+
+    size_t memory_budget_mb() const { return m_budget_mb; }
+    size_t memory_used_mb() const;
+    uint64_t get_load_count() const { return m_loads.load(std::memory_order_relaxed); }
+    uint64_t get_unload_count() const { return m_unloads.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Read a --models file
+     *
+     * @code
+     * {
+     *   "memory_budget_mb": 6144,
+     *   "models": [
+     *     {"name": "commands", "path": "models/vosk-model-small-en-us-0.15", "preload": true},
+     *     {"name": "dictation", "path": "models/vosk-model-en-us-0.42-gigaspeech", "memory_mb": 4500}
+     *   ]
+     * }
+     * @endcode
+     *
+     * @throws std::runtime_error if the file cannot be read
+     * @throws std::invalid_argument if it is not a valid model list
+     */
+    static config load_config(const std::string& path);
+
+    /**
+     * @brief Estimate the resident size of a model from its directory
+     * @return Total file size in MB, rounded up (0 if the path is unreadable)
+     */
+    static size_t estimate_memory_mb(const std::string& model_path);
+
+private:
+    struct entry {
+        model_spec spec;
+        std::shared_ptr<vstream_engine> engine;
+        bool resident = false;
+        bool loading = false;
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    /**
+     * @brief Unload idle models until need_mb more fits the budget
+     *
+     * Called with m_mutex held; the unloaded engines are moved to
+     * unloaded so they are destroyed after the lock is released.
+     *
+     * @return false if the model cannot fit even with every idle model unloaded
+     */
+    bool make_room(size_t need_mb, std::vector<std::shared_ptr<vstream_engine>>& unloaded);
+
+    const size_t m_budget_mb;
+    const factory m_create;
+    std::map<std::string, entry> m_entries;   ///< Name -> model
+    size_t m_used_mb = 0;                     ///< Loaded and loading models
+    mutable std::mutex m_mutex;               ///< Protects m_entries and m_used_mb
+    std::condition_variable m_loaded;         ///< Signalled when a load finishes
+    std::atomic<uint64_t> m_loads{0};
+    std::atomic<uint64_t> m_unloads{0};
+};
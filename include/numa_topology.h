@@ -0,0 +1,142 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @class numa_topology
+ * @brief NUMA nodes of the machine and the placement of threads and memory on them
+ *
+ * On a multi-socket (or NPS-partitioned EPYC) machine every memory access
+ * from a core to another node's memory crosses the interconnect. Decoding
+ * streams the acoustic model and decoding graph through the caches, so a
+ * decode worker should run next to the copy of the model it reads:
+ *
+ * - detect() reads the nodes and their CPUs from sysfs; without NUMA
+ *   support it reports one node with every online CPU
+ * - place_workers() spreads decode workers over the nodes and assigns each
+ *   worker the node index (memory domain) of its CPU
+ * - run_on_node() runs a function on a thread bound to a node, so the
+ *   memory it allocates is local to that node (first touch)
+ * - interleave_memory() spreads the pages the calling thread allocates
+ *   over all nodes, for one shared copy with uniform average latency
+ *
+ * Memory policies use the set_mempolicy system call directly; libnuma is
+ * not required. Failures are logged and leave the default policy.
+ *
+ * @par Example:
+ * @code
+ * auto topology = numa_topology::detect();
+ * auto placement = topology.place_workers(16);
+ * for (size_t n = 0; n < topology.node_count(); ++n) {
+ *     topology.run_on_node(n, [&] { replicas.push_back(std::make_shared<vstream_engine>(path)); });
+ * }
+ * @endcode
+ */
+class numa_topology {
+public:
+    /**
+     * @struct node
+     * @brief One NUMA node
+     */
+    struct node {
+        int id = 0;                         ///< Kernel node number
+        std::vector<int> cpus;              ///< Online CPUs of the node, ascending
+    };
+
+    /**
+     * @struct worker_placement
+     * @brief CPU and memory domain of each decode worker
+     */
+    struct worker_placement {
+        std::vector<int> cpus;              ///< CPU per worker
+        std::vector<size_t> domains;        ///< Node index (0..node_count()-1) per worker
+    };
+
+    /**
+     * @brief One node with every CPU reported by the standard library
+     */
+    numa_topology();
+
+    /**
+     * @brief Topology from explicit nodes
+     * @throws std::invalid_argument if there is no node with CPUs
+     */
+    explicit numa_topology(std::vector<node> nodes);
+
+    /**
+     * @brief Read the topology from sysfs
+     *
+     * @param sysfs_root Directory holding node<N>/cpulist
+     * @return Detected nodes, or a single node if the directory has none
+     */
+    static numa_topology detect(const std::string& sysfs_root = "/sys/devices/system/node");
+
+    /**
+     * @brief Parse a CPU list such as "0,2,4-7" (the sysfs cpulist format)
+     * @throws std::invalid_argument on malformed input
+     */
+    static std::vector<int> parse_cpu_list(const std::string& list);
+
+    const std::vector<node>& nodes() const { return m_nodes; }
+    size_t node_count() const { return m_nodes.size(); }
+
+    /**
+     * @brief Node index of a CPU, or -1 if the CPU is not part of the topology
+     */
+    int node_index_of_cpu(int cpu) const;
+
+    /**
+     * @brief Keep only the listed CPUs, dropping nodes left without any
+     * @throws std::invalid_argument if none of the CPUs is known
+     */
+    numa_topology restrict_to(const std::vector<int>& cpus) const;
+
+    /**
+     * @brief Spread workers over the nodes
+     *
+     * Worker i runs on node i % node_count(); the workers of a node take
+     * its CPUs in order, so neighbouring workers share a CCD's L3 cache
+     * and wrap around when a node has fewer CPUs than workers.
+     */
+    worker_placement place_workers(size_t workers) const;
+
+    /**
+     * @brief Run fn on a new thread bound to a node's CPUs and memory, and wait for it
+     *
+     * Exceptions thrown by fn are rethrown to the caller.
+     */
+    void run_on_node(size_t index, const std::function<void()>& fn) const;
+
+    /**
+     * @brief Interleave the calling thread's future allocations over all nodes
+     * @return false if the kernel refused the policy
+     */
+    bool interleave_memory() const;
+
+    /**
+     * @brief Restore the default (local) allocation policy of the calling thread
+     */
+    static void reset_memory_policy();
+
+    /**
+     * @brief Check if the machine has more than one node
+     */
+    bool is_numa() const { return m_nodes.size() > 1; }
+
+private:
+    std::vector<node> m_nodes;
+};
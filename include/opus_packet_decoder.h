@@ -0,0 +1,104 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Forward declaration
+typedef struct OpusDecoder OpusDecoder;
+
+/**
+ * @class opus_packet_decoder
+ * @brief Decodes the Opus packets a WebSocket session sends instead of PCM
+ *
+ * Audio messages still arrive as 16-bit words (hyni_audio_data::samples);
+ * in Opus mode their bytes, little-endian, carry length-prefixed packets,
+ * each padded to a whole word:
+ *
+ * @code
+ * [u16 length][length bytes of packet][0x00 if length is odd] [u16 length][...] ...
+ * @endcode
+ *
+ * A message holds whole packets only. Because every record is word
+ * aligned, messages can be concatenated (as the decode dispatcher does
+ * when coalescing) and still parse. A zero length ends the message.
+ * Truncated or undecodable packets are skipped and counted; the decoder
+ * conceals the gap on the next good packet.
+ *
+ * @note Not thread-safe: use one decoder per session
+ *
+ * @par Example:
+ * @code
+ * opus_packet_decoder opus(16000);
+ * std::vector<int16_t> pcm;
+ * opus.decode(audio.samples, pcm); // 20ms packets -> 320 samples each
+ * @endcode
+ */
+class opus_packet_decoder {
+public:
+    /**
+     * @brief Create a mono decoder
+     *
+     * @param sample_rate Output rate: 8000, 12000, 16000, 24000 or 48000
+     * @throws std::invalid_argument for other rates
+     * @throws std::runtime_error if libopus fails to create the decoder
+     */
+    explicit opus_packet_decoder(int sample_rate);
+
+    /**
+     * @brief Destructor - frees the libopus decoder
+     */
+    ~opus_packet_decoder();
+
+    opus_packet_decoder(const opus_packet_decoder&) = delete;
+    opus_packet_decoder& operator=(const opus_packet_decoder&) = delete;
+
+    /**
+     * @brief Decode every packet of one message
+     *
+     * @param message Framed packets as delivered in hyni_audio_data::samples
+     * @param pcm Decoded mono samples are appended here
+     * @return Number of packets decoded
+     */
+    size_t decode(std::span<const int16_t> message, std::vector<int16_t>& pcm);
+
+    /**
+     * @brief Forget decoder state, e.g. after a reset command
+     */
+    void reset();
+
+    /**
+     * @brief Check if libopus decodes at this rate
+     */
+    static bool supports_rate(int sample_rate);
+
+    /**
+     * @brief Append one packet to a message in the framing above
+     *
+     * Used by tests and C++ clients.
+     */
+    static void frame(std::span<const uint8_t> packet, std::vector<uint8_t>& message);
+
+    int sample_rate() const { return m_sample_rate; }
+    uint64_t get_packet_count() const { return m_packets; }
+    uint64_t get_error_count() const { return m_errors; }
+
+private:
+    OpusDecoder* m_decoder = nullptr;
+    int m_sample_rate;
+    size_t m_max_frame;                     ///< Samples in the longest packet (120ms)
+    uint64_t m_packets = 0;
+    uint64_t m_errors = 0;
+};
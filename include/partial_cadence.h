@@ -0,0 +1,81 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @class partial_cadence
+ * @brief Decides when a stream computes its next partial result
+ *
+ * Building a partial walks the decoder lattice, so a stream reports one at
+ * most once per decode call, and only after interval samples of audio were
+ * accepted since its last partial or final result. Counting audio rather
+ * than calls keeps the cadence independent of chunk size and decode speed.
+ *
+ * @par Example:
+ * @code
+ * cadence.configure(true, 3200);             // 200ms at 16 kHz
+ * if (endpointed) cadence.reset();           // final result: start over
+ * cadence.add(samples_since_endpoint);
+ * if (cadence.due(suspended)) {
+ *     return vosk_recognizer_partial_result(recognizer);
+ * }
+ * @endcode
+ *
+ * @note Not thread-safe; the owning stream serializes calls
+ */
+class partial_cadence {
+public:
+    /**
+     * @brief Choose whether and how often partials are reported
+     * @param enabled Report partial results at all
+     * @param interval_samples Audio between two partials (0 = every call)
+     */
+    void configure(bool enabled, size_t interval_samples);
+
+    /**
+     * @brief Count audio accepted by the recognizer
+     */
+    void add(size_t samples) { m_unreported += samples; }
+
+    /**
+     * @brief Forget the counted audio after a final result
+     */
+    void reset() { m_unreported = 0; }
+
+    /**
+     * @brief Check if a partial is due, and start a new interval if so
+     * @param suspended Partials are suspended engine-wide (load shedding)
+     */
+    bool due(bool suspended);
+
+    /**
+     * @brief Audio counted since the last partial or final result
+     */
+    size_t unreported() const { return m_unreported; }
+
+    /**
+     * @brief Check if partials are reported at all
+     */
+    bool enabled() const { return m_enabled; }
+
+    /**
+     * @brief Audio required between two partials
+     */
+    size_t interval() const { return m_interval; }
+
+private:
+    bool m_enabled = true;                  ///< Report partial results
+    size_t m_interval = 0;                  ///< Audio required between two partials
+    size_t m_unreported = 0;                ///< Audio accepted since the last partial or final
+};
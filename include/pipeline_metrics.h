@@ -0,0 +1,99 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "latency_histogram.h"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <chrono>
+#include <string>
+
+/**
+ * @class pipeline_metrics
+ * @brief Latency histograms for each stage an audio chunk passes through
+ *
+ * Stages, in pipeline order:
+ * - **capture**: microphone chunk completed by the audio callback until the
+ *   processing thread delivers it
+ * - **queue**: WebSocket chunk submitted until a decode worker picks it up
+ * - **decode**: Vosk accept_waveform/result calls
+ * - **parse**: Vosk JSON parsed into a recognition_result
+ * - **deliver**: queue_transcription() handing the text to the server
+ * - **end_to_end**: chunk arrival (capture or submit) until its result is queued
+ *
+ * All stages record lock-free; see latency_histogram.
+ */
+class pipeline_metrics {
+public:
+    enum class stage {
+        capture,
+        queue,
+        decode,
+        parse,
+        deliver,
+        end_to_end
+    };
+
+    static constexpr size_t stage_count = 6;
+
+    pipeline_metrics() = default;
+
+    pipeline_metrics(const pipeline_metrics&) = delete;
+    pipeline_metrics& operator=(const pipeline_metrics&) = delete;
+
+    /**
+     * @brief Record the duration of one stage
+     */
+    template<typename Rep, typename Period>
+    void record(stage s, std::chrono::duration<Rep, Period> duration) noexcept {
+        m_stages[static_cast<size_t>(s)].record(duration);
+    }
+
+    /**
+     * @brief Record a stage that started at the given time and ends now
+     */
+    void record_since(stage s, std::chrono::steady_clock::time_point start) noexcept {
+        record(s, std::chrono::steady_clock::now() - start);
+    }
+
+    /**
+     * @brief Get the histogram of one stage
+     */
+    const latency_histogram& histogram(stage s) const { return m_stages[static_cast<size_t>(s)]; }
+
+    /**
+     * @brief Get the label of a stage ("capture", "queue", ...)
+     */
+    static const char* stage_name(stage s) noexcept;
+
+    /**
+     * @brief Summaries of all stages that recorded values, keyed by stage name
+     *
+     * Each entry holds count, mean_ms, max_ms, p50_ms, p99_ms and p999_ms.
+     */
+    nlohmann::json to_json() const;
+
+    /**
+     * @brief Prometheus text exposition of all stages
+     *
+     * One summary family, vstream_stage_latency_seconds, labelled by stage
+     * with quantiles 0.5, 0.99 and 0.999 plus _sum and _count.
+     */
+    std::string to_prometheus() const;
+
+    /**
+     * @brief Clear all stages
+     */
+    void reset() noexcept;
+
+private:
+    std::array<latency_histogram, stage_count> m_stages;
+};
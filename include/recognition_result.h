@@ -0,0 +1,156 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @class recognition_result
+ * @brief Typed view of one Vosk recognition result
+ *
+ * Replaces full nlohmann::json parsing on the decode hot path. assign()
+ * copies the Vosk JSON into an internal buffer and runs a targeted parser
+ * that only extracts the fields vstream uses:
+ *
+ * - `text` / `partial` → kind() and text()
+ * - `alternatives[0].confidence` → confidence() (1.0 when absent)
+ * - `result` / `partial_result` word lists → words() (opt-in)
+ * - `alternatives` → alternatives()
+ *
+ * Every other member (speaker vectors etc.) is skipped without being
+ * materialized. Buffers keep their capacity, so reusing one object per
+ * stream or worker does not allocate in steady state.
+ *
+ * @par Views:
+ * Strings are stored as slices into the internal buffers and resolved with
+ * view(), so results stay valid when copied or moved. A view is invalidated
+ * by the next assign() or clear().
+ *
+ * @note The raw JSON stays available through json() for callers that need
+ *       the complete document (opt-in full parse)
+ */
+class recognition_result {
+public:
+    /**
+     * @brief Result type
+     */
+    enum class result_kind {
+        none,       ///< Empty or unparseable result
+        partial,    ///< Utterance in progress
+        final       ///< Completed utterance
+    };
+
+    /**
+     * @struct slice
+     * @brief Location of a string inside the result buffers
+     */
+    struct slice {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        bool decoded = false;       ///< Lives in the unescape buffer, not the raw JSON
+    };
+
+    /**
+     * @struct word
+     * @brief Word with timing from the `result` list
+     */
+    struct word {
+        slice text;
+        float start = 0.0f;         ///< Start time in seconds
+        float end = 0.0f;           ///< End time in seconds
+        float confidence = 1.0f;    ///< Word confidence (0-1)
+    };
+
+    /**
+     * @struct alternative
+     * @brief One N-best entry
+     */
+    struct alternative {
+        slice text;
+        float confidence = 0.0f;    ///< Vosk alternative score
+    };
+
+    recognition_result();
+
+    /**
+     * @brief Copy and parse a Vosk JSON result
+     *
+     * @param json JSON text as returned by vosk_recognizer_*result()
+     * @param with_words Also extract the word list (timings, per-word confidence)
+     *
+     * @return false if the JSON is malformed; the result is then kind none
+     */
+    bool assign(std::string_view json, bool with_words = false);
+
+    /**
+     * @brief Reset to an empty result, keeping buffer capacity
+     */
+    void clear();
+
+    result_kind kind() const { return m_kind; }
+    bool is_final() const { return m_kind == result_kind::final; }
+    bool is_partial() const { return m_kind == result_kind::partial; }
+
+    /**
+     * @brief Check if the result carries no text
+     */
+    bool empty() const { return m_text.length == 0; }
+
+    /**
+     * @brief Recognized text (final or partial)
+     */
+    std::string_view text() const { return view(m_text); }
+
+    /**
+     * @brief Confidence of the first alternative, 1.0 without alternatives
+     */
+    float confidence() const { return m_confidence; }
+
+    /**
+     * @brief Word list (only filled when parsed with with_words)
+     */
+    const std::vector<word>& words() const { return m_words; }
+
+    /**
+     * @brief N-best alternatives (empty unless configured on the engine)
+     */
+    const std::vector<alternative>& alternatives() const { return m_alternatives; }
+
+    /**
+     * @brief Raw Vosk JSON of this result
+     */
+    std::string_view json() const { return m_raw; }
+
+    /**
+     * @brief Resolve a slice to a string view
+     */
+    std::string_view view(const slice& s) const;
+
+    /**
+     * @brief Result kind as the "partial" / "final" type string used by benchmarks
+     */
+    const char* type_name() const;
+
+private:
+    class parser;
+
+    std::string m_raw;                          ///< Copy of the Vosk JSON
+    std::string m_decoded;                      ///< Strings that contained escapes
+    result_kind m_kind = result_kind::none;
+    slice m_text;
+    float m_confidence = 1.0f;
+    std::vector<word> m_words;
+    std::vector<alternative> m_alternatives;
+};
@@ -0,0 +1,167 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class session_pool
+ * @brief Bounded pool of per-session objects with least recently used eviction
+ *
+ * Holds at most capacity entries. When a new session needs room, the least
+ * recently used entry nobody else holds a reference to is evicted; an entry
+ * whose shared_ptr is still held (a decode in flight) is never evicted. Use
+ * order is tracked with a counter, so entries touched within the same clock
+ * tick still evict in order.
+ *
+ * @par Example:
+ * @code
+ * session_pool<stream> pool(64);
+ * if (auto found = pool.find(id)) return found;
+ * pool.make_room();                        // throws if every session is held
+ * return pool.insert(id, create_stream()).first;
+ * @endcode
+ *
+ * @note Not thread-safe; the owner serializes calls with its own mutex
+ */
+template<typename T>
+class session_pool {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Create an empty pool
+     * @param capacity Maximum number of sessions
+     */
+    explicit session_pool(size_t capacity) : m_capacity(capacity) {}
+
+    /**
+     * @brief Look up a session and mark it used
+     * @return Session object, or nullptr if the session is not pooled
+     */
+    std::shared_ptr<T> find(const std::string& session_id, clock::time_point now = clock::now()) {
+        auto it = m_entries.find(session_id);
+        if (it == m_entries.end()) {
+            return nullptr;
+        }
+        touch(it->second, now);
+        return it->second.item;
+    }
+
+    /**
+     * @brief Evict the least recently used idle session if the pool is full
+     * @return Evicted session id, empty if the pool had room
+     * @throws std::runtime_error if the pool is full and every session is held
+     */
+    std::string make_room() {
+        if (m_entries.size() < m_capacity) {
+            return {};
+        }
+
+        auto victim = m_entries.end();
+        for (auto cur = m_entries.begin(); cur != m_entries.end(); ++cur) {
+            if (cur->second.item.use_count() == 1 &&
+                (victim == m_entries.end() || cur->second.order < victim->second.order)) {
+                victim = cur;
+            }
+        }
+
+        if (victim == m_entries.end()) {
+            throw std::runtime_error("Session pool exhausted (" +
+                                     std::to_string(m_capacity) + " sessions in use)");
+        }
+
+        std::string evicted = victim->first;
+        m_entries.erase(victim);
+        return evicted;
+    }
+
+    /**
+     * @brief Add a session unless another caller added it first
+     * @return The pooled object and whether it is the one passed in
+     */
+    std::pair<std::shared_ptr<T>, bool> insert(const std::string& session_id, std::shared_ptr<T> item,
+                                               clock::time_point now = clock::now()) {
+        auto [it, inserted] = m_entries.try_emplace(session_id, entry{std::move(item)});
+        touch(it->second, now);
+        return {it->second.item, inserted};
+    }
+
+    /**
+     * @brief Remove a session
+     * @return false if the session was not pooled
+     */
+    bool erase(const std::string& session_id) { return m_entries.erase(session_id) > 0; }
+
+    /**
+     * @brief Remove sessions unused since cutoff that nobody holds
+     * @return Ids of the evicted sessions
+     */
+    std::vector<std::string> evict_idle(clock::time_point cutoff) {
+        std::vector<std::string> evicted;
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second.last_used < cutoff && it->second.item.use_count() == 1) {
+                evicted.push_back(it->first);
+                it = m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return evicted;
+    }
+
+    /**
+     * @brief Remove every session
+     */
+    void clear() { m_entries.clear(); }
+
+    /**
+     * @brief Check if a session is pooled
+     */
+    bool contains(const std::string& session_id) const { return m_entries.contains(session_id); }
+
+    /**
+     * @brief Get number of pooled sessions
+     */
+    size_t size() const { return m_entries.size(); }
+
+    /**
+     * @brief Get maximum number of sessions
+     */
+    size_t capacity() const { return m_capacity; }
+
+private:
+    /**
+     * @brief Pooled object with its use history
+     */
+    struct entry {
+        std::shared_ptr<T> item;                ///< Session object
+        clock::time_point last_used{};          ///< Last access, for idle eviction
+        uint64_t order = 0;                     ///< Last access, for LRU eviction
+    };
+
+    void touch(entry& e, clock::time_point now) {
+        e.last_used = now;
+        e.order = ++m_use_counter;
+    }
+
+    size_t m_capacity;                                      ///< Maximum number of sessions
+    std::unordered_map<std::string, entry> m_entries;       ///< Sessions keyed by id
+    uint64_t m_use_counter = 0;                             ///< Orders accesses
+};
@@ -0,0 +1,55 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <span>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * @brief Feed audio to a recognizer in slices, continuing past endpoints
+ *
+ * One call may carry several frames merged by the dispatcher, so an
+ * endpoint can fall anywhere inside it. After a slice reaches an endpoint,
+ * on_endpoint() collects that final result and the remaining slices are
+ * fed to the next utterance: no audio of the call is ever skipped.
+ *
+ * @param audio Audio to feed
+ * @param slice_samples Samples per accept call (0 is treated as 1)
+ * @param accept Feeds one std::span<const Sample> slice and returns the
+ *        accept_waveform code (> 0 endpoint, 0 more audio needed, < 0 error)
+ * @param on_endpoint Called after every slice that reached an endpoint
+ * @return Samples fed after the last endpoint (all of them if none)
+ *
+ * @par Example:
+ * @code
+ * size_t tail = feed_slices(audio, 1600,
+ *     [&](std::span<const int16_t> slice) { return accept(recognizer, slice); },
+ *     [&]() { finals.emplace_back(vosk_recognizer_result(recognizer)); });
+ * @endcode
+ */
+template<typename Sample, typename Accept, typename Endpoint>
+size_t feed_slices(std::span<const Sample> audio, size_t slice_samples,
+                   Accept&& accept, Endpoint&& on_endpoint) {
+    const size_t slice = std::max<size_t>(1, slice_samples);
+    size_t tail = 0;
+
+    for (size_t pos = 0; pos < audio.size(); pos += slice) {
+        auto current = audio.subspan(pos, std::min(slice, audio.size() - pos));
+        tail += current.size();
+        if (accept(current) > 0) {
+            on_endpoint();
+            tail = 0;
+        }
+    }
+    return tail;
+}
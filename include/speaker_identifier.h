@@ -0,0 +1,282 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations for Vosk types
+typedef struct VoskModel VoskModel;
+typedef struct VoskSpkModel VoskSpkModel;
+typedef struct VoskRecognizer VoskRecognizer;
+
+/**
+ * @class utterance_buffer
+ * @brief Fixed-capacity ring holding the latest audio of the current utterance
+ *
+ * Appending never allocates once the ring exists; when an utterance runs
+ * longer than the capacity only its most recent part is kept.
+ */
+class utterance_buffer {
+public:
+    explicit utterance_buffer(size_t capacity);
+
+    /**
+     * @brief Append samples, overwriting the oldest ones when full
+     */
+    void append(std::span<const int16_t> samples);
+
+    /**
+     * @brief Move the buffered audio out in chronological order and start over
+     */
+    std::vector<int16_t> take();
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_ring.size(); }
+
+private:
+    std::vector<int16_t> m_ring;
+    size_t m_head = 0;                      ///< Next write position
+    size_t m_size = 0;
+};
+
+/**
+ * @class speaker_tracker
+ * @brief Labels speaker embeddings of one conversation by online clustering
+ *
+ * Each embedding joins the known speaker whose centroid is most similar
+ * (cosine) if the similarity reaches the threshold, otherwise it starts a
+ * new speaker. Labels are "S1", "S2", ... in order of first appearance.
+ */
+class speaker_tracker {
+public:
+    explicit speaker_tracker(double threshold, size_t max_speakers = 16);
+
+    /**
+     * @brief Assign an embedding to a speaker
+     *
+     * @param embedding Speaker vector (e.g. a Vosk x-vector)
+     * @param similarity Set to the cosine similarity with the chosen
+     *                   speaker before the update, 1.0 for a new speaker
+     * @return Speaker label
+     */
+    std::string assign(std::span<const float> embedding, double& similarity);
+
+    size_t speaker_count() const { return m_speakers.size(); }
+
+    /**
+     * @brief Cosine similarity of two vectors, 0 if either is zero or the sizes differ
+     */
+    static double cosine(std::span<const float> a, std::span<const float> b);
+
+private:
+    struct speaker {
+        std::vector<float> centroid;        ///< Running mean of the member embeddings
+        size_t members = 0;
+    };
+
+    double m_threshold;
+    size_t m_max_speakers;                  ///< Beyond this, the closest speaker is always chosen
+    std::vector<speaker> m_speakers;
+};
+
+/**
+ * @class speaker_identifier
+ * @brief Speaker labelling of final utterances, off the decode path
+ *
+ * A Vosk recognizer built with a speaker model extracts an x-vector while
+ * it decodes, which slows every chunk of every session although only one
+ * embedding per utterance is needed. Here the decode workers only append
+ * each chunk they decode to the session's utterance_buffer; when a final
+ * result is delivered the utterance is handed to a small pool of
+ * low-priority threads that compute its embedding, label it with the
+ * session's speaker_tracker and report it through the label handler,
+ * tagged with the utterance id returned by end_utterance().
+ *
+ * When the pool falls behind, new utterances are skipped rather than
+ * queued without bound, so transcription latency is never affected.
+ *
+ * @par Threading:
+ * append() and end_utterance() for one session must come from one thread
+ * at a time (the session's decode worker); everything else is thread-safe.
+ * The label handler runs on the pool threads.
+ */
+class speaker_identifier {
+public:
+    /**
+     * @struct config
+     * @brief Speaker identification settings
+     */
+    struct config {
+        std::string model_path;             ///< Vosk speaker model directory
+        size_t threads = 1;                 ///< Embedding threads
+        size_t max_pending = 64;            ///< Utterances waiting; further ones are skipped
+        int sample_rate = 16000;            ///< Rate of the appended audio
+        int min_utterance_ms = 500;         ///< Shorter utterances are not labelled
+        int max_utterance_ms = 30000;       ///< Audio kept per utterance (the latest part)
+        double match_threshold = 0.5;       ///< Cosine similarity to join a known speaker
+        int nice = 10;                      ///< Scheduling niceness of the pool threads
+    };
+
+    /**
+     * @struct label
+     * @brief Speaker of one utterance
+     */
+    struct label {
+        std::string session_id;
+        uint64_t utterance_id = 0;          ///< 1 for the session's first final result
+        std::string text;                   ///< Transcript of the final result
+        std::string speaker;                ///< "S1", "S2", ...
+        double similarity = 0.0;            ///< Match with the speaker's earlier utterances
+        int frames = 0;                     ///< Speech frames the embedding was computed on
+    };
+
+    using label_handler_t = std::function<void(const label&)>;
+
+    /**
+     * @brief Computes an embedding; returns an empty vector if none could be computed
+     *
+     * Replaces the Vosk x-vector extraction, e.g. in tests.
+     */
+    using embedder_t = std::function<std::vector<float>(VoskModel* model, std::span<const int16_t> audio,
+                                                        int& frames)>;
+
+    /**
+     * @brief Load the speaker model and start the pool
+     *
+     * @param embedder Embedding function; empty to use Vosk with config::model_path
+     * @throws std::invalid_argument if no thread is configured
+     * @throws std::runtime_error if the speaker model cannot be loaded
+     */
+    speaker_identifier(const config& cfg, label_handler_t on_label, embedder_t embedder = {});
+
+    /**
+     * @brief Destructor - stops the pool
+     */
+    ~speaker_identifier();
+
+    speaker_identifier(const speaker_identifier&) = delete;
+    speaker_identifier& operator=(const speaker_identifier&) = delete;
+
+    /**
+     * @brief Stop the pool; queued utterances are discarded
+     */
+    void stop();
+
+    /**
+     * @brief Add decoded audio to the session's current utterance
+     */
+    void append(const std::string& session_id, std::span<const int16_t> samples);
+
+    /**
+     * @brief Close the session's current utterance and queue it for labelling
+     *
+     * @param model Acoustic model the session decodes with; kept alive until labelled
+     * @param text Transcript of the final result, reported with the label
+     * @return Id of the utterance (counts the session's final results from 1)
+     */
+    uint64_t end_utterance(const std::string& session_id, std::shared_ptr<VoskModel> model,
+                           std::string text = {});
+
+    /**
+     * @brief Labels of a session's most recent utterances, oldest first
+     */
+    std::vector<label> recent_labels(const std::string& session_id);
+
+    /**
+     * @brief Forget a session's audio and speakers
+     */
+    void release_session(const std::string& session_id);
+
+    /**
+     * @brief Forget sessions idle for timeout
+     * @return Number of sessions forgotten
+     */
+    size_t evict_idle_sessions(std::chrono::milliseconds timeout);
+
+    size_t get_thread_count() const { return m_threads.size(); }
+    size_t get_pending() const { return m_pending.load(std::memory_order_relaxed); }
+    uint64_t get_labelled_count() const { return m_labelled.load(std::memory_order_relaxed); }
+    uint64_t get_skipped_count() const { return m_skipped.load(std::memory_order_relaxed); }
+    uint64_t get_short_count() const { return m_short.load(std::memory_order_relaxed); }
+
+    static constexpr size_t recent_label_count = 32;   ///< Labels kept per session
+
+private:
+    struct session_state {
+        explicit session_state(const config& cfg);
+
+        utterance_buffer audio;             ///< Only touched by the session's decode worker
+        uint64_t utterances = 0;            ///< Only touched by the session's decode worker
+        speaker_tracker tracker;            ///< Guarded by m_sessions_mutex
+        std::deque<label> recent;           ///< Guarded by m_sessions_mutex
+        std::chrono::steady_clock::time_point last_used;    ///< Guarded by m_sessions_mutex
+    };
+
+    struct job {
+        std::shared_ptr<session_state> session;
+        std::string session_id;
+        uint64_t utterance_id = 0;
+        std::string text;
+        std::vector<int16_t> audio;
+        std::shared_ptr<VoskModel> model;
+    };
+
+    config m_config;
+    label_handler_t m_on_label;
+    embedder_t m_embedder;
+    VoskSpkModel* m_spk_model = nullptr;
+
+    std::unordered_map<std::string, std::shared_ptr<session_state>> m_sessions;
+    std::mutex m_sessions_mutex;            ///< Protects m_sessions and the shared session fields
+
+    std::deque<job> m_queue;
+    std::mutex m_queue_mutex;               ///< Protects m_queue and m_running
+    std::condition_variable m_queue_cv;
+    bool m_running = true;
+    std::vector<std::thread> m_threads;
+
+    std::atomic<size_t> m_pending{0};
+    std::atomic<uint64_t> m_labelled{0};
+    std::atomic<uint64_t> m_skipped{0};
+    std::atomic<uint64_t> m_short{0};
+
+    void worker_loop();
+    std::shared_ptr<session_state> get_session(const std::string& session_id);
+
+    /**
+     * @brief Speaker recognizer of one pool thread, rebuilt when the model changes
+     */
+    struct recognizer_cache {
+        VoskRecognizer* recognizer = nullptr;
+        VoskModel* model = nullptr;
+
+        ~recognizer_cache();
+    };
+
+    /**
+     * @brief x-vector of an utterance from a recognizer with the speaker model
+     */
+    std::vector<float> vosk_embedding(recognizer_cache& cache, VoskModel* model,
+                                      std::span<const int16_t> audio, int& frames);
+};
@@ -0,0 +1,159 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+
+/**
+ * @class spsc_ring
+ * @brief Preallocated single-producer/single-consumer ring buffer
+ *
+ * Wait-free on both sides: the producer only ever touches the write index
+ * and the consumer only the read index, each on its own cache line. No
+ * allocation happens after construction, which makes try_write() safe to
+ * call from a real-time audio callback.
+ *
+ * The consumer reads contiguous spans straight out of the storage. When
+ * the capacity is a multiple of the consumer's read size and it always
+ * releases whole reads, every read_span() of that size is contiguous.
+ *
+ * @tparam T Trivially copyable element type (e.g. int16_t samples)
+ *
+ * @par Example:
+ * @code
+ * spsc_ring<int16_t> ring(4800 * 8);
+ *
+ * // Producer (audio thread)
+ * ring.try_write(samples, count);
+ *
+ * // Consumer
+ * auto chunk = ring.read_span(4800);
+ * if (chunk.size() == 4800) {
+ *     process(chunk);
+ *     ring.release(chunk.size());
+ * }
+ * @endcode
+ */
+template<typename T>
+class spsc_ring {
+    static_assert(std::is_trivially_copyable_v<T>, "spsc_ring elements must be trivially copyable");
+
+public:
+    /**
+     * @brief Allocate the ring
+     * @param capacity Number of elements the ring holds
+     * @throws std::invalid_argument if capacity is zero
+     */
+    explicit spsc_ring(size_t capacity)
+        : m_capacity(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("spsc_ring capacity must be positive");
+        }
+        m_buffer = std::make_unique<T[]>(capacity);
+    }
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    /**
+     * @brief Get the number of elements the ring holds
+     */
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief Write all elements or none (producer only)
+     *
+     * @return false if there is not enough free space; nothing is written
+     */
+    bool try_write(const T* data, size_t count) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+
+        if (m_capacity - (head - m_cached_tail) < count) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (m_capacity - (head - m_cached_tail) < count) {
+                return false;
+            }
+        }
+
+        const size_t pos = head % m_capacity;
+        const size_t first = std::min(count, m_capacity - pos);
+        std::memcpy(m_buffer.get() + pos, data, first * sizeof(T));
+        std::memcpy(m_buffer.get(), data + first, (count - first) * sizeof(T));
+
+        m_head.store(head + count, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get the readable region starting at the read index (consumer only)
+     *
+     * @param max_count Upper bound on the span size
+     * @return Contiguous span of at most max_count elements; shorter when the
+     *         ring holds less or the region wraps around the end of storage
+     *
+     * @note The span stays valid until release()
+     */
+    std::span<const T> read_span(size_t max_count) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        if (m_cached_head - tail < max_count) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+        }
+
+        const size_t pos = tail % m_capacity;
+        const size_t count = std::min({max_count, m_cached_head - tail, m_capacity - pos});
+        return std::span<const T>(m_buffer.get() + pos, count);
+    }
+
+    /**
+     * @brief Mark elements returned by read_span() as consumed (consumer only)
+     */
+    void release(size_t count) {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    /**
+     * @brief Number of elements available for reading (approximate off the consumer thread)
+     */
+    size_t read_available() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Drop all readable elements (consumer only)
+     */
+    void discard() {
+        m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t cache_line = 64;
+
+    // Producer side
+    alignas(cache_line) std::atomic<size_t> m_head{0};   ///< Total elements written
+    size_t m_cached_tail = 0;                              ///< Producer's copy of m_tail
+
+    // Consumer side
+    alignas(cache_line) std::atomic<size_t> m_tail{0};   ///< Total elements read
+    size_t m_cached_head = 0;                              ///< Consumer's copy of m_head
+
+    // Shared, read-only after construction
+    alignas(cache_line) const size_t m_capacity;
+    std::unique_ptr<T[]> m_buffer;
+};
@@ -0,0 +1,120 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class utterance_cap
+ * @brief Decides when the audio processor forces a final result
+ *
+ * Utterances end where the model endpoints. The cap only finalizes an
+ * utterance that ran for max_ms without an endpoint, and only if it has
+ * text to finalize; with VAD, an utterance also ends when the speaker
+ * stopped inside a chunk. Every final result restarts the cap.
+ *
+ * @par Example:
+ * @code
+ * auto now = std::chrono::steady_clock::now();
+ * decode(audio);
+ * auto action = cap.after_decode(now, result.is_final(), !vad.in_speech(),
+ *                                [&] { return has_partial_result(); });
+ * if (action != utterance_cap::action::none) {
+ *     force_finalize();   // calls cap.close()
+ * }
+ * @endcode
+ *
+ * @note Not thread-safe; one audio processor drives it
+ */
+class utterance_cap {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief What follows the decode of a speech chunk
+     */
+    enum class action {
+        none,               ///< Keep decoding the utterance
+        cap_reached,        ///< Finalize: no endpoint for max_ms
+        speech_ended        ///< Finalize: the speaker stopped inside the chunk
+    };
+
+    /**
+     * @brief Create a cap
+     * @param max_ms Longest utterance before it is finalized
+     * @param start Start of the first utterance
+     */
+    explicit utterance_cap(int max_ms, clock::time_point start = clock::now())
+        : m_max(max_ms), m_start(start) {}
+
+    /**
+     * @brief Decide after a speech chunk was decoded
+     *
+     * @param now When the chunk's processing started
+     * @param endpointed The model returned a final result for the chunk
+     * @param speech_ended Voice activity ended inside the chunk
+     * @param pending Returns true if the utterance has text to finalize;
+     *        only called when the cap ran out, since it may query the decoder
+     */
+    template<typename Pending>
+    action after_decode(clock::time_point now, bool endpointed, bool speech_ended, Pending&& pending) {
+        auto elapsed = now - m_start;
+        if (endpointed) {
+            close(now);
+            return action::none;
+        }
+        m_open = true;
+
+        if (elapsed >= m_max) {
+            // Nothing pending (silence): only restart the cap
+            m_start = now;
+            return pending() ? action::cap_reached : action::none;
+        }
+        return speech_ended ? action::speech_ended : action::none;
+    }
+
+    /**
+     * @brief The utterance ended with a final result, the next one starts
+     */
+    void close(clock::time_point now) {
+        m_open = false;
+        m_start = now;
+    }
+
+    /**
+     * @brief Restart the cap without ending the utterance (silence, delivered text)
+     */
+    void restart(clock::time_point now) { m_start = now; }
+
+    /**
+     * @brief Check if audio was decoded since the last final result
+     */
+    bool open() const { return m_open; }
+
+    /**
+     * @brief Time since the utterance (or the last restart) began, in ms
+     */
+    int64_t elapsed_ms(clock::time_point now) const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(now - m_start).count();
+    }
+
+    /**
+     * @brief Longest utterance in ms
+     */
+    int max_ms() const { return static_cast<int>(m_max.count()); }
+
+private:
+    std::chrono::milliseconds m_max;        ///< Longest utterance
+    clock::time_point m_start;              ///< Start of the utterance, or last restart
+    bool m_open = false;                    ///< Audio decoded since the last final result
+};
@@ -12,9 +12,24 @@
 #pragma once
 
 #include "vstream_engine.h"
+#include "model_registry.h"
 #include "mic_capture.h"
 #include "audio_processor.h"
+#include "audio_converter.h"
+#include "opus_packet_decoder.h"
 #include "benchmark_manager.h"
+#include "decode_dispatcher.h"
+#include "load_monitor.h"
+#include "chunk_controller.h"
+#include "file_transcriber.h"
+#include "pipeline_metrics.h"
+#include "metrics_server.h"
+#include "counter_registry.h"
+#include "local_ingest_server.h"
+#include "speaker_identifier.h"
+#include "client_session_table.h"
+#include "websocket_outbox.h"
+#include "numa_topology.h"
 #include <hyni/hyni_websocket_server.h>
 #include <nlohmann/json.hpp>
 #include <string>
@@ -22,6 +37,10 @@
 #include <memory>
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 using json = nlohmann::json;
 
@@ -34,7 +53,9 @@ using json = nlohmann::json;
  * the lifecycle of all components including the speech engine, WebSocket
  * server, microphone capture, and audio processing pipeline.
  *
- * Simplified version without VAD for better performance and reliability.
+ * Audio is decoded continuously with timed finalization by default; an
+ * optional voice activity detector skips silence and finalizes at speech
+ * endpoints for both the microphone and WebSocket sessions.
  */
 class vstream_app {
 public:
@@ -45,25 +66,69 @@ public:
     struct config {
         // Required parameters
         std::string model_path;                    ///< Path to Vosk model directory
+        std::string models_file;                   ///< JSON list of more named models (optional)
 
         // Engine configuration
         std::string speaker_model_path;            ///< Path to speaker model (optional)
+        size_t spk_threads = 1;                    ///< Low-priority speaker embedding threads
         std::string grammar;                       ///< JSON grammar specification
+        size_t grammar_cache_size = 16;            ///< Idle grammar recognizers kept for reuse
         int max_alternatives = 0;                  ///< Number of alternative results
         bool enable_partial_words = true;          ///< Enable partial word results
+        int partial_interval_ms = 200;             ///< Minimum audio between partial results
+        bool partials_opt_in = false;              ///< Sessions subscribe to partial results
         int sample_rate = 16000;                   ///< Audio sample rate
 
         // Server configuration
         uint16_t port = 8080;                      ///< WebSocket server port
         int log_level = 0;                         ///< Vosk log level
+        size_t max_sessions = 64;                  ///< Maximum pooled session recognizers
+        int session_idle_ms = 60000;               ///< Release idle session recognizers (0 = never)
+        uint16_t metrics_port = 0;                 ///< Prometheus scrape port (0 = disabled)
+        std::string local_socket;                  ///< Unix socket for local producers (empty = disabled)
+        int drain_timeout_ms = 30000;              ///< Longest wait for sessions on SIGTERM (0 = stop at once)
+
+        // Decode worker configuration
+        size_t decode_threads = 0;                 ///< Decode workers (0 = hardware concurrency)
+        bool pin_decode_threads = false;           ///< Pin each decode worker to one CPU
+        std::vector<int> decode_cpus;              ///< CPUs for pinned workers (empty = 0..N-1)
+        std::string numa_mode = "off";             ///< "off", "replicate" (model per node) or "interleave"
+        bool huge_pages = false;                   ///< Back model memory with transparent huge pages
+        size_t max_session_queue = 50;             ///< Queued chunks per session before dropping (0 = unlimited)
+        bool load_shedding = true;                 ///< Shed partials, cadence, then sessions under load
+        bool adaptive_chunks = true;               ///< Adapt audio per decode call to load and latency
+        int latency_target_ms = 0;                 ///< Default session latency target (0 = none)
+
+        // Decoder backend
+        std::string backend = "cpu";               ///< "cpu" or "gpu" (Vosk batch recognizer)
+        size_t gpu_batch_size = 64;                ///< Maximum chunks per GPU batch
+        int gpu_batch_wait_ms = 10;                ///< Longest a chunk waits for its GPU batch
 
         // Audio processing configuration
         int buffer_ms = 100;                       ///< Audio buffer size in milliseconds
-        int finalize_ms = 2000;                    ///< Force finalization interval
+        int finalize_ms = 15000;                   ///< Longest utterance before it is finalized
+
+        // Endpointing (0 = model default)
+        std::string endpoint_mode = "default";     ///< "default", "short", "long" or "very-long"
+        int endpoint_start_ms = 0;                 ///< Silence before speech that ends an utterance
+        int endpoint_silence_ms = 0;               ///< Silence after speech that ends an utterance
+        int endpoint_max_ms = 0;                   ///< Utterance length at which Vosk ends it
+
+        // Voice activity detection
+        bool vad_enabled = false;                  ///< Skip decoding during silence
+        float vad_threshold_db = -40.0f;           ///< Minimum speech level in dBFS
+        int vad_hangover_ms = 300;                 ///< Silence tolerated before an endpoint
 
         // Microphone configuration
         bool use_mic = false;                      ///< Enable microphone capture
         int mic_device = -1;                       ///< Microphone device index (-1 = default)
+        int mic_rate = 0;                          ///< Capture rate, resampled to sample_rate (0 = sample_rate)
+        int mic_channels = 1;                      ///< Capture channels, downmixed to mono
+        bool mic_split_channels = false;           ///< Transcribe each capture channel separately
+
+        // Offline file transcription
+        std::string input_path;                    ///< File or directory to transcribe (disables server)
+        std::string transcript_dir;                ///< Write <name>.txt per input (empty = stdout)
 
         // Benchmark configuration
         bool benchmark_enabled = false;            ///< Enable benchmarking
@@ -71,6 +136,7 @@ public:
         std::string benchmark_reference_file;      ///< Path to reference text file
         std::string benchmark_output_file;         ///< Output file for results
         std::string benchmark_format = "txt";
+        std::string benchmark_segments_file;       ///< Stream segments here as they arrive (.jsonl or .csv)
 
         /**
          * @brief Default constructor with sensible defaults
@@ -103,11 +169,62 @@ public:
      */
     bool is_running() const { return m_running.load(); }
 
+    /**
+     * @brief Load a model in the background and switch sessions over to it
+     *
+     * Connections stay open while the model loads; see
+     * vstream_engine::load_model() for when sessions switch.
+     *
+     * @param model_path Vosk model directory
+     * @return false if the engine is not running or a reload is in progress
+     */
+    bool reload_model(const std::string& model_path);
+
+    /**
+     * @brief Ask the main loop to reload the current model (SIGHUP)
+     * @note Async-signal-safe
+     */
+    void request_model_reload();
+
+    /**
+     * @brief Ask the main loop to stop (SIGINT)
+     * @note Async-signal-safe
+     */
+    void request_stop();
+
+    /**
+     * @brief Ask the main loop to drain: refuse new sessions, flush the open
+     *        ones as they go quiet, and exit when none is left (SIGTERM)
+     *
+     * A second request, or one during file transcription, stops right away.
+     *
+     * @note Async-signal-safe
+     */
+    void request_drain();
+
+    /**
+     * @brief Check if the server is draining
+     */
+    bool is_draining() const { return m_drain_requested.load() || m_draining.load(); }
+
+    /**
+     * @brief Get the health and load summary served on /health
+     *
+     * Cheap enough for a load balancer to poll every second: only counters
+     * and the load monitor's smoothed values.
+     */
+    json get_health() const;
+
     /**
      * @brief Get application statistics
      */
     json get_stats() const;
 
+    /**
+     * @brief Get stage latencies and counters in Prometheus text format
+     */
+    std::string get_prometheus_metrics() const;
+
     /**
      * @brief Parse command line arguments
      */
@@ -123,32 +240,163 @@ public:
      */
     static void validate_config(const config& cfg);
 
+    /**
+     * @brief Parse a CPU list such as "0,2,4-7"
+     * @throws std::invalid_argument on malformed input
+     */
+    static std::vector<int> parse_cpu_list(const std::string& list);
+
 private:
     config m_config;                                          ///< Application configuration
     std::atomic<bool> m_running{false};                       ///< Running state flag
 
     // Core components
-    std::unique_ptr<vstream_engine> m_engine;                 ///< Speech recognition engine
+    std::shared_ptr<vstream_engine> m_engine;                 ///< Default model (--model)
+    std::unique_ptr<model_registry> m_models;                 ///< Named models, incl. the default
+    numa_topology m_topology;                                 ///< Nodes the decode workers run on
+    std::vector<std::shared_ptr<vstream_engine>> m_replicas;  ///< Default model per memory domain, [0] = m_engine
+    std::vector<int> m_worker_cpus;                           ///< CPU per decode worker (empty = not pinned)
+    std::atomic<size_t> m_huge_pages_advised_mb{0};           ///< Model memory advised for huge pages
+
+    /**
+     * @struct mic_channel
+     * @brief Pipeline of one capture channel (--mic-split-channels)
+     */
+    struct mic_channel {
+        std::unique_ptr<audio_converter> converter;           ///< Capture rate to model rate (nullptr = same)
+        std::unique_ptr<audio_processor> processor;           ///< Decodes on the channel's own stream
+    };
+
+    std::vector<mic_channel> m_mic_channels;                  ///< Fixed before capture starts; outlives the workers
+    std::vector<std::vector<int16_t>> m_mic_planes;           ///< Deinterleaved capture chunk (capture thread)
+    std::unique_ptr<decode_dispatcher> m_dispatcher;          ///< WebSocket decode workers
     std::unique_ptr<hyni_websocket_server> m_server;          ///< WebSocket server
 
     // Microphone components (optional)
     std::unique_ptr<mic_capture> m_mic;                       ///< Microphone capture
     std::unique_ptr<audio_processor> m_processor;             ///< Audio processing pipeline
     std::unique_ptr<benchmark_manager> m_benchmark;
+    std::unique_ptr<file_transcriber> m_transcriber;          ///< Batch mode (--input)
 
     // Statistics
     std::chrono::steady_clock::time_point m_start_time;       ///< Application start time
-    std::atomic<size_t> m_messages_processed{0};              ///< WebSocket messages processed
+    counter_registry m_counters;                              ///< Per-thread event counters
+    std::chrono::steady_clock::time_point m_last_eviction_check; ///< Last idle session sweep
+    std::chrono::steady_clock::time_point m_last_stats_log;   ///< Last periodic stats line
+    int m_wake_fd = -1;                                       ///< eventfd that wakes the main loop
+    pipeline_metrics m_metrics;                               ///< Per-stage latency histograms
+    std::unique_ptr<load_monitor> m_load;                     ///< Decode load and shedding level
+    std::chrono::steady_clock::time_point m_last_load_check;  ///< Last load evaluation
+    std::unique_ptr<metrics_server> m_metrics_server;         ///< Scrape endpoint (--metrics-port)
+    std::unique_ptr<local_ingest_server> m_local_ingest;      ///< Unix socket transport (--local-socket)
+    std::unique_ptr<speaker_identifier> m_speakers;           ///< Async speaker labels (--spk-model)
+
+    // Model reload
+    std::thread m_reload_thread;                              ///< Background model loader
+    std::atomic<bool> m_reloading{false};                     ///< A model is being loaded
+    std::atomic<bool> m_reload_requested{false};              ///< SIGHUP received
+
+    // Draining
+    std::atomic<bool> m_drain_requested{false};               ///< SIGTERM or drain command received
+    std::atomic<bool> m_stop_requested{false};                ///< SIGINT or second SIGTERM received
+    std::atomic<bool> m_draining{false};                      ///< New sessions are refused
+    std::chrono::steady_clock::time_point m_drain_deadline;   ///< Exit even with busy sessions
+
+    // Session tracking
+    client_session_table m_client_sessions;                   ///< Client socket -> owned session
+    websocket_outbox m_websocket_outbox;                      ///< Frames waiting for their client's next message
+
+    /**
+     * @brief Model a WebSocket session selected instead of the default
+     */
+    struct session_model {
+        std::string name;
+        std::shared_ptr<vstream_engine> engine;               ///< Null until the model is first used
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    std::unordered_map<std::string, session_model> m_session_models; ///< Session id -> selected model
+    std::mutex m_session_models_mutex;                        ///< Protects m_session_models
+
+    /**
+     * @brief Voice activity state of one WebSocket session
+     * @note Only touched by the decode worker currently owning the session
+     */
+    struct session_vad {
+        voice_activity_detector detector;
+        std::vector<int16_t> preroll;                         ///< Last silent chunk
+        std::chrono::steady_clock::time_point last_used;
+
+        explicit session_vad(const voice_activity_detector::config& cfg) : detector(cfg) {}
+    };
+
+    /**
+     * @brief Adaptive chunk size of one WebSocket session
+     * @note observe() only runs on the decode worker currently owning the session
+     */
+    struct session_chunking {
+        chunk_controller controller;
+        std::chrono::steady_clock::time_point last_used;
+
+        explicit session_chunking(const chunk_controller::config& cfg) : controller(cfg) {}
+    };
+
+    std::unordered_map<std::string, std::shared_ptr<session_chunking>> m_session_chunking; ///< Session id -> chunking
+    std::mutex m_session_chunking_mutex;                      ///< Protects m_session_chunking
+
+    std::unordered_map<std::string, std::shared_ptr<session_vad>> m_session_vads; ///< Session id -> VAD
+    std::mutex m_session_vads_mutex;                          ///< Protects m_session_vads
+
+    /**
+     * @brief Input format announced by a WebSocket session
+     *
+     * Only used on the session's decode worker, which runs its jobs in order.
+     */
+    struct session_format {
+        audio_converter converter;
+        std::unique_ptr<opus_packet_decoder> opus;            ///< Set when the session sends Opus
+        std::vector<int16_t> pcm;                             ///< Decoded Opus, swapped into the job
+        std::chrono::steady_clock::time_point last_used;
+
+        explicit session_format(const audio_converter::config& cfg) : converter(cfg) {}
+    };
+
+    std::unordered_map<std::string, std::shared_ptr<session_format>> m_session_formats; ///< Session id -> format
+    std::mutex m_session_formats_mutex;                       ///< Protects m_session_formats
+    std::unique_ptr<audio_converter> m_mic_converter;         ///< Mic rate/channels to model format
 
     // Benchmarking
     std::string m_benchmark_reference_file;
     std::string m_benchmark_output_file;
 
+    /**
+     * @brief Load the default model once per NUMA node (--numa replicate)
+     */
+    void initialize_replicas();
+
+    /**
+     * @brief Run a model load with the configured memory placement
+     *
+     * Binds the load to a NUMA node, or interleaves it over all nodes when
+     * node is -1, and advises huge pages for the memory it allocated.
+     */
+    void place_model_load(int node, const std::function<void()>& load);
+
     /**
      * @brief Initialize the speech recognition engine
      */
     void initialize_engine();
 
+    /**
+     * @brief Engine configuration shared by every loaded model
+     */
+    vstream_engine::config make_engine_config() const;
+
+    /**
+     * @brief Register the default engine and the --models file
+     */
+    void initialize_models();
+
     /**
      * @brief Initialize the WebSocket server
      */
@@ -159,6 +407,11 @@ private:
      */
     void initialize_microphone();
 
+    /**
+     * @brief Create the single microphone pipeline (channels downmixed to mono)
+     */
+    void initialize_mic_processor(const mic_capture::config& mic_cfg);
+
     /**
      * @brief Setup signal handlers
      */
@@ -169,12 +422,186 @@ private:
      */
     void initialize_benchmark();
 
+    /**
+     * @brief Transcribe config.input_path offline and write the transcripts
+     * @return Process exit code
+     */
+    int run_file_transcription();
+
+    /**
+     * @brief Act on stop and drain requests while run_file_transcription() runs
+     */
+    void watch_file_transcription();
+
+    /**
+     * @brief Stop the benchmark, export and print its results
+     */
+    void finish_benchmark();
+
+    /**
+     * @brief Initialize the decode worker pool
+     */
+    void initialize_dispatcher();
+
+    /**
+     * @brief Number of decode workers to start
+     *
+     * --decode-threads if set; otherwise one per CPU, or one per GPU batch
+     * slot with the GPU backend, where workers mostly wait for their batch.
+     */
+    size_t decode_thread_count() const;
+
+    /**
+     * @brief Start the Prometheus scrape endpoint (if a metrics port is set)
+     */
+    void initialize_metrics_server();
+
+    /**
+     * @brief Start the Unix socket transport (if a local socket is set)
+     */
+    void initialize_local_ingest();
+
+    /**
+     * @brief Start the speaker labelling pool (if a speaker model is set)
+     */
+    void initialize_speaker_identifier();
+
+    /**
+     * @brief Stop accepting sessions and start the drain deadline
+     */
+    void begin_drain();
+
+    /**
+     * @brief Flush sessions that went quiet; stop once all are gone or the deadline passed
+     */
+    void drain_sessions();
+
+    /**
+     * @brief Deliver the final result of a session's open utterance and release it
+     *
+     * @note The session must have no queued frames
+     */
+    void finalize_session(const std::string& session_id);
+
+    /**
+     * @brief Client sessions known to the decode workers, capture channels excluded
+     */
+    size_t active_client_sessions() const;
+
     /**
      * @brief Handle WebSocket audio callback
+     *
+     * Runs on the server I/O thread and only queues the audio for the
+     * decode workers.
      */
     void handle_websocket_audio(const hyni_audio_data& audio,
                                 websocket::stream<tcp::socket>* client_ws);
 
+    /**
+     * @brief Queue a client session's audio for the decode workers
+     *
+     * Shared by the WebSocket and local socket transports.
+     */
+    void submit_session_audio(const std::string& session_id, std::vector<int16_t> samples);
+
+    /**
+     * @brief Decode one queued WebSocket audio job (decode worker thread)
+     */
+    void process_websocket_job(decode_dispatcher::audio_job& job);
+
+    /**
+     * @brief Find the capture channel a dispatcher session belongs to
+     * @return nullptr for WebSocket sessions
+     */
+    mic_channel* find_mic_channel(const std::string& session_id);
+
+    /**
+     * @brief Why a WebSocket client may not use a session id, empty if it may
+     */
+    std::string websocket_session_conflict(const std::string& session_id,
+                                           websocket::stream<tcp::socket>* client_ws);
+
+    /**
+     * @brief Split a multi-channel capture chunk and queue each channel for the decode workers
+     */
+    void submit_mic_channels(std::span<const int16_t> interleaved);
+
+    /**
+     * @brief Send a decoded WebSocket result to its client and the benchmark
+     */
+    void deliver_websocket_result(const std::string& session_id,
+                                  const recognition_result& result,
+                                  size_t samples,
+                                  double processing_latency_ms);
+
+    /**
+     * @brief Send a speaker label to the client as a follow-up to its result
+     *
+     * Local clients get it right away, WebSocket clients through the outbox.
+     */
+    void deliver_speaker_label(const speaker_identifier::label& label);
+
+    /**
+     * @brief Write the frames queued for a session to its WebSocket client
+     * @note Called from the client's own audio and command callbacks
+     */
+    void flush_websocket_outbox(const std::string& session_id,
+                                websocket::stream<tcp::socket>* client_ws);
+
+    /**
+     * @brief Engine a session decodes on, loading its selected model if needed
+     *
+     * Sessions that never sent select_model use the default engine, or
+     * with --numa replicate its replica in the session's memory domain.
+     *
+     * @throws std::runtime_error if the selected model cannot be loaded
+     */
+    std::shared_ptr<vstream_engine> engine_for_session(const std::string& session_id);
+
+    /**
+     * @brief Route a session to a named model from its next audio on
+     *
+     * The session's recognizer on its previous model is released.
+     *
+     * @throws std::invalid_argument for an unknown model name
+     */
+    void select_session_model(const std::string& session_id, const std::string& model_name);
+
+    /**
+     * @brief Audio samples decoded by all models, including unloaded ones
+     */
+    size_t total_samples_processed() const;
+
+    /**
+     * @brief Get or create the adaptive chunk state of a session
+     */
+    std::shared_ptr<session_chunking> get_session_chunking(const std::string& session_id);
+
+    /**
+     * @brief Feed a decoded chunk's latency to its session's chunk controller
+     *
+     * Applies a changed chunk size to the session's engine stream and
+     * dispatcher queue.
+     */
+    void adapt_session_chunk(const std::string& session_id, vstream_engine& engine,
+                             const decode_dispatcher::audio_job& job);
+
+    /**
+     * @brief Get or create the VAD state of a session
+     */
+    std::shared_ptr<session_vad> get_session_vad(const std::string& session_id);
+
+    /**
+     * @brief Get the converter of a session that announced a non-native format
+     * @return nullptr if the session sends mono 16-bit audio at the model rate
+     */
+    std::shared_ptr<session_format> find_session_format(const std::string& session_id);
+
+    /**
+     * @brief Build the detector configuration from the app configuration
+     */
+    voice_activity_detector::config make_vad_config() const;
+
     /**
      * @brief Handle WebSocket command
      */
@@ -182,8 +609,48 @@ private:
                                   const json& params,
                                   websocket::stream<tcp::socket>* client_ws);
 
+    /**
+     * @brief Resolve the session a command applies to
+     *
+     * Uses the "session_id" parameter if present, otherwise the session
+     * last seen sending audio on the same client socket. An explicit id is
+     * claimed for the client; it must not belong to another client, a
+     * local socket connection or a capture channel.
+     *
+     * @return Session id, or empty string if unknown
+     * @throws std::invalid_argument if the client may not use the session
+     */
+    std::string resolve_session_id(const json& params,
+                                   websocket::stream<tcp::socket>* client_ws);
+
+    /**
+     * @brief Wait for a background model load to finish
+     */
+    void join_reload_thread();
+
+    /**
+     * @brief Release idle session recognizers periodically
+     */
+    void evict_idle_sessions();
+
+    /**
+     * @brief Re-evaluate decode load and apply its shedding level
+     */
+    void update_load();
+
     /**
      * @brief Print periodic statistics
      */
     void print_periodic_stats();
+
+    /**
+     * @brief Wake the main loop early (stop, drain, reload)
+     * @note Async-signal-safe
+     */
+    void wake_main_loop();
+
+    /**
+     * @brief Block until woken or the timeout passes
+     */
+    void wait_for_wakeup(std::chrono::milliseconds timeout);
 };
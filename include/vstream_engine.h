@@ -25,6 +25,10 @@
  * - N-best alternatives
  * - Word-level timing information
  * - Partial recognition results
+ * - Per-session recognizer pool sharing one loaded model
+ * - Explicit per-stream decoder state (vstream_engine::stream)
+ * - Hot model reload without dropping streams (load_model())
+ * - Optional GPU batch backend (Vosk batch recognizer API)
  *
  * @note Requires Vosk model files to be downloaded separately
  * @note Thread-safe: All public methods are protected by mutex
@@ -49,11 +53,23 @@
 
 #pragma once
 
+#include "recognition_result.h"
+#include "pipeline_metrics.h"
+#include "batch_decoder.h"
+#include "grammar_cache.h"
+#include "partial_cadence.h"
+#include "session_pool.h"
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
+#include <deque>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <span>
+#include <cstdint>
 
 // Forward declarations
 typedef struct VoskModel VoskModel;
@@ -82,6 +98,26 @@ typedef struct VoskRecognizer VoskRecognizer;
  */
 class vstream_engine {
 public:
+    /**
+     * @brief Decoder implementation behind the streams
+     */
+    enum class backend_type {
+        cpu,            ///< One Vosk recognizer per stream, decoded on the calling thread
+        gpu_batch       ///< Vosk batch recognizers, chunks of all streams decoded in GPU batches
+    };
+
+    /**
+     * @brief How long Vosk waits after speech before it ends an utterance
+     *
+     * Scales all of the model's endpoint rules (vosk_recognizer_set_endpointer_mode).
+     */
+    enum class endpointer_mode {
+        model_default,      ///< Rules from the model configuration
+        short_answers,      ///< Commands and yes/no answers, ends quickly
+        long_answers,       ///< Dictation with thinking pauses
+        very_long_answers   ///< Rarely ends on a pause
+    };
+
     /**
      * @struct config
      * @brief Configuration parameters for the speech recognition engine
@@ -135,6 +171,44 @@ public:
          */
         bool enable_partial_words = true;
 
+        /**
+         * @brief Compute partial results at all
+         *
+         * When disabled, vosk_recognizer_partial_result() is never called
+         * and chunks that do not complete an utterance return "{}".
+         */
+        bool enable_partial_results = true;
+
+        /**
+         * @brief Minimum audio between two partial results of a stream
+         *
+         * Building a partial walks the decoder lattice, so a stream computes
+         * at most one per process_audio() call and only once this much new
+         * audio has been accepted since the previous one. Measured in audio
+         * time, so it is independent of chunk size and decode speed.
+         *
+         * @note 0 computes a partial after every chunk
+         */
+        int partial_interval_ms = 200;
+
+        /**
+         * @brief Audio fed to Vosk per accept_waveform call, in ms
+         *
+         * The initial slice of every stream; set_chunk_ms() adapts it per
+         * session. Larger slices cost fewer calls, smaller ones detect an
+         * endpoint sooner.
+         */
+        int chunk_ms = 100;
+
+        /**
+         * @brief Sessions only get partial results after subscribing
+         *
+         * When set, session streams start with partials disabled until
+         * set_partial_results() enables them. The session-less stream
+         * follows enable_partial_results.
+         */
+        bool partial_results_opt_in = false;
+
         /**
          * @brief Maximum number of alternative transcriptions
          *
@@ -147,6 +221,30 @@ public:
          */
         int max_alternatives = 0;
 
+        /**
+         * @brief Endpoint rule set used by every recognizer
+         *
+         * Vosk endpoints on trailing silence: a stream returns a final
+         * result as soon as the speaker stops, with no forced
+         * finalization. The fields below fine-tune it.
+         */
+        endpointer_mode endpointer = endpointer_mode::model_default;
+
+        /**
+         * @brief Silence before any speech that ends an utterance, in ms (0 = model default)
+         */
+        int endpoint_start_max_ms = 0;
+
+        /**
+         * @brief Silence after speech that ends an utterance, in ms (0 = model default)
+         */
+        int endpoint_end_ms = 0;
+
+        /**
+         * @brief Longest utterance before Vosk ends it, in ms (0 = model default)
+         */
+        int endpoint_max_ms = 0;
+
         /**
          * @brief Path to speaker identification model
          *
@@ -158,12 +256,273 @@ public:
          */
         std::string speaker_model_path;
 
+        /**
+         * @brief Maximum number of pooled per-session recognizers
+         *
+         * Upper bound for the recognizers created by the session-aware
+         * process_audio() overload. When the pool is full, the least
+         * recently used idle session is evicted to make room.
+         *
+         * @note Each recognizer keeps its own decoder state in memory
+         */
+        size_t max_sessions = 64;
+
+        /**
+         * @brief Idle time after which a session recognizer is released
+         *
+         * Sessions that have not been used for this long are freed by
+         * evict_idle_sessions().
+         *
+         * @note 0 disables idle eviction
+         */
+        int session_idle_timeout_ms = 60000;
+
+        /**
+         * @brief Idle recognizers kept per grammar for reuse
+         *
+         * Switching a stream to a grammar it (or a released stream) used
+         * before swaps in the already built recognizer instead of
+         * rebuilding the grammar graph. See grammar_cache.
+         *
+         * @note 0 rebuilds on every switch
+         */
+        size_t grammar_cache_size = 16;
+
+        /**
+         * @brief Decoder backend
+         *
+         * gpu_batch loads the model onto the GPU and decodes the chunks of
+         * all streams together (see batch_decoder). It only returns final
+         * results: grammars, alternatives, speaker identification and
+         * load_model() are not available.
+         *
+         * @note Requires libvosk built with CUDA
+         */
+        backend_type backend = backend_type::cpu;
+
+        /**
+         * @brief Maximum chunks per GPU batch (gpu_batch only)
+         */
+        size_t gpu_batch_size = 64;
+
+        /**
+         * @brief Longest a chunk waits for its GPU batch to fill (gpu_batch only)
+         */
+        int gpu_batch_wait_ms = 10;
+
         /**
          * @brief Default constructor with sensible defaults
          */
         config() = default;
     };
 
+    /**
+     * @class stream
+     * @brief One independent decoding stream on the engine's shared model
+     *
+     * A stream owns its Vosk recognizer together with all per-utterance
+     * state, so streams never influence each other: a final result on one
+     * stream only resets that stream's recognizer on its next audio chunk.
+     * Calls on one stream are serialized by its own mutex; different
+     * streams can be decoded from different threads concurrently.
+     *
+     * Streams are created by vstream_engine::create_stream().
+     *
+     * @warning A stream must not be used after its engine is destroyed.
+     *          Releasing it then is safe: its recognizer goes back to a
+     *          grammar cache and generation counter the stream shares.
+     *
+     * @example
+     * @code
+     * auto stream = engine.create_stream();
+     * std::string result = stream->process_audio(audio_chunk);
+     * @endcode
+     */
+    class stream {
+    public:
+        /**
+         * @brief Destructor - releases the recognizer
+         */
+        ~stream();
+
+        stream(const stream&) = delete;
+        stream& operator=(const stream&) = delete;
+
+        /**
+         * @brief Process audio data and get recognition results
+         * @see vstream_engine::process_audio()
+         */
+        std::string process_audio(std::span<const int16_t> audio_data, bool is_final = false);
+
+        /**
+         * @brief Process float audio data (samples in the 16-bit range)
+         * @see vstream_engine::process_audio()
+         */
+        std::string process_audio(std::span<const float> audio_data, bool is_final = false);
+
+        /**
+         * @brief Flush the utterance and get the final result
+         */
+        std::string finalize();
+
+        /**
+         * @brief Process audio data into a reusable typed result
+         * @see vstream_engine::process_audio(std::span<const int16_t>, recognition_result&, bool)
+         */
+        void process_audio(std::span<const int16_t> audio_data,
+                           recognition_result& result,
+                           bool is_final = false);
+
+        /**
+         * @brief Flush the utterance into a reusable typed result
+         */
+        void finalize(recognition_result& result);
+
+        /**
+         * @brief Take a final result queued by an earlier call
+         *
+         * Audio after an endpoint is decoded as the next utterance within
+         * the same call, so one call can complete several utterances. It
+         * returns the first final result and queues the others; later calls
+         * return them first, and this drains them once no audio follows.
+         *
+         * @return false if no final result is queued
+         */
+        bool next_final(recognition_result& result);
+
+        /**
+         * @brief Reset the recognizer and the utterance state
+         */
+        void reset();
+
+        /**
+         * @brief Set grammar constraints (empty string removes them)
+         *
+         * Starts a new utterance on a recognizer built for the grammar,
+         * taken from the engine's grammar cache when one is idle there.
+         */
+        void set_grammar(const std::string& grammar);
+
+        /**
+         * @brief Set maximum number of alternative results
+         */
+        void set_max_alternatives(int max);
+
+        /**
+         * @brief Choose whether and how often partial results are computed
+         *
+         * @param enabled Compute partial results on this stream
+         * @param interval_ms Minimum audio between two partials (0 = every chunk)
+         *
+         * @see config::partial_interval_ms
+         */
+        void set_partial_results(bool enabled, int interval_ms);
+
+        /**
+         * @brief Change the audio fed to Vosk per call
+         * @param chunk_ms Slice length in ms, at least 10
+         * @see config::chunk_ms
+         */
+        void set_chunk_ms(int chunk_ms);
+
+        /**
+         * @brief Enable NLSML output
+         */
+        void enable_nlsml_output(bool enable);
+
+        /**
+         * @brief Check if partial results are available
+         */
+        bool has_partial_result() const;
+
+        /**
+         * @brief Check if the recognizer ended an utterance with its last audio
+         *
+         * The recognizer is reset before the next chunk of audio when set.
+         */
+        bool just_finalized() const;
+
+    private:
+        friend class vstream_engine;
+
+        stream(vstream_engine& engine, std::shared_ptr<VoskModel> model,
+               uint64_t generation, VoskRecognizer* recognizer);
+
+        /**
+         * @brief What a decode call did, logged after m_mutex is released
+         */
+        struct decode_info {
+            bool finalized = false;                 ///< Returned a final result
+            bool forced = false;                    ///< Final result forced by end of stream
+            int error = 0;                          ///< Last Vosk error code, 0 if none
+        };
+
+        /**
+         * @brief Feed audio and return the Vosk JSON
+         * @note Caller holds m_mutex; the buffer is valid until the next Vosk call
+         */
+        template<typename Sample>
+        const char* decode(std::span<const Sample> audio_data, bool is_final, decode_info& info);
+
+        /**
+         * @brief Return the oldest queued final result
+         * @note Caller holds m_mutex and m_finals is not empty
+         */
+        const char* take_final(decode_info& info);
+
+        /**
+         * @brief Log the outcome of a decode call
+         * @note Called without m_mutex so logging never extends the critical section
+         */
+        void log_decode(const decode_info& info, std::string_view json) const;
+
+        /**
+         * @brief Decode a chunk through the engine's batch decoder
+         * @note Caller holds m_mutex; the result is valid until the next call
+         */
+        const char* decode_batch(std::span<const int16_t> audio_data, bool is_final, decode_info& info);
+
+        /**
+         * @brief Finish and free the batch recognizer, discarding pending results
+         * @note Caller holds m_mutex
+         */
+        void close_batch_stream();
+
+        /**
+         * @brief Start a new utterance, moving to the engine's current model if it changed
+         * @note Caller holds m_mutex
+         */
+        void begin_utterance();
+
+        /**
+         * @brief Reset m_recognizer, undo per-stream settings and hand it to the grammar cache
+         * @note Caller holds m_mutex; m_recognizer is null afterwards
+         */
+        void recycle_recognizer();
+
+        vstream_engine& m_engine;                   ///< Owning engine (model, counters)
+        std::shared_ptr<grammar_cache> m_recognizers; ///< Engine's grammar cache, outlives the engine
+        std::shared_ptr<const std::atomic<uint64_t>> m_engine_generation; ///< Engine's model generation
+        std::shared_ptr<batch_decoder> m_batch;     ///< Engine's batch decoder (gpu_batch)
+        int m_default_alternatives = 0;             ///< Engine max_alternatives, restored on recycle
+        std::shared_ptr<VoskModel> m_model;         ///< Model m_recognizer was built from
+        uint64_t m_model_generation = 0;            ///< Engine model generation of m_model
+        VoskRecognizer* m_recognizer = nullptr;     ///< Owned recognizer
+        std::string m_grammar;                      ///< Grammar to reapply after a model switch
+        std::string m_grammar_key;                  ///< Normalized m_grammar, grammar_cache key
+        int m_max_alternatives = -1;                ///< Override to reapply (-1 = engine default)
+        bool m_nlsml = false;                       ///< NLSML output to reapply
+        partial_cadence m_cadence;                  ///< When the next partial result is due
+        size_t m_chunk_samples = 0;                 ///< Audio per accept_waveform call
+        VoskBatchRecognizer* m_batch_recognizer = nullptr; ///< Owned batch recognizer (gpu_batch)
+        std::string m_batch_result;                 ///< Last batch result returned by decode()
+        std::vector<int16_t> m_batch_samples;       ///< Float input converted for the batch API
+        std::deque<std::string> m_finals;           ///< Final results not returned yet, oldest first
+        std::string m_final;                        ///< Queued final result returned by decode()
+        bool m_just_finalized = false;              ///< Final result produced, reset before next audio
+        mutable std::mutex m_mutex;                 ///< Serializes calls on this stream
+    };
+
     /**
      * @brief Construct engine with default configuration
      *
@@ -224,7 +583,8 @@ public:
      * Feeds audio data to the recognizer and returns results in JSON format.
      * This is the main method for speech recognition.
      *
-     * @param audio_data Vector of 16-bit PCM samples
+     * @param audio_data 16-bit PCM samples (vectors, arrays and ring buffer
+     *                   regions convert implicitly, no copy is made)
      * @param is_final Force final recognition (default: false)
      *
      * @return JSON string containing recognition results
@@ -236,7 +596,7 @@ public:
      * - With speaker: `{"spk": [0.1, -0.2, ...], "spk_frames": 150}`
      *
      * @note Thread-safe - can be called from multiple threads
-     * @note Empty audio vectors are valid (used for flushing)
+     * @note Empty audio spans are valid (used for flushing)
      * @note Sample rate must match configuration
      *
      * @example
@@ -255,10 +615,140 @@ public:
      * }
      *
      * // Force final result
-     * std::string final_result = engine.process_audio({}, true);
+     * std::string final_result = engine.finalize();
      * @endcode
      */
-    std::string process_audio(const std::vector<int16_t>& audio_data, bool is_final = false);
+    std::string process_audio(std::span<const int16_t> audio_data, bool is_final = false);
+
+    /**
+     * @brief Process float audio data and get recognition results
+     *
+     * Feeds the samples through vosk_recognizer_accept_waveform_f without
+     * converting them first.
+     *
+     * @param audio_data Float samples scaled to the 16-bit range
+     *                   ([-32768, 32767]), not normalized to [-1, 1]
+     * @param is_final Force final recognition (default: false)
+     *
+     * @return JSON string containing recognition results
+     */
+    std::string process_audio(std::span<const float> audio_data, bool is_final = false);
+
+    /**
+     * @brief Flush the current utterance and get the final result
+     *
+     * Equivalent to processing an empty chunk with is_final set.
+     *
+     * @return JSON string containing the final result
+     */
+    std::string finalize();
+
+    /**
+     * @brief Process audio data into a typed result
+     *
+     * Hot-path variant of process_audio(): instead of returning a JSON
+     * string for the caller to parse, the Vosk result is copied into
+     * @p result and scanned by its targeted parser. Reusing one result
+     * object per thread avoids per-chunk allocations. Word timings are only
+     * extracted when config::enable_word_times is set.
+     *
+     * @param audio_data 16-bit PCM samples
+     * @param result Result to overwrite
+     * @param is_final Force final recognition (default: false)
+     *
+     * @example
+     * @code
+     * recognition_result result;
+     * engine.process_audio(audio_chunk, result);
+     * if (result.is_final() && !result.empty()) {
+     *     std::cout << "Final: " << result.text() << std::endl;
+     * }
+     * @endcode
+     */
+    void process_audio(std::span<const int16_t> audio_data,
+                       recognition_result& result,
+                       bool is_final = false);
+
+    /**
+     * @brief Flush the current utterance into a typed result
+     */
+    void finalize(recognition_result& result);
+
+    /**
+     * @brief Take a final result queued by an earlier call
+     * @see stream::next_final()
+     */
+    bool next_final(recognition_result& result);
+
+    /**
+     * @brief Take a final result a session queued by an earlier call
+     *
+     * @param session_id Session identifier
+     * @param result Receives the final result
+     *
+     * @return false if the session has no recognizer or no queued final result
+     */
+    bool next_final(const std::string& session_id, recognition_result& result);
+
+    /**
+     * @brief Process audio data for a specific session
+     *
+     * Same as process_audio() but decodes on a recognizer owned by the given
+     * session. Recognizers are created lazily on first use from the shared
+     * model, so independent sessions never share decoder state and can be
+     * decoded in parallel from different threads.
+     *
+     * @param session_id Session identifier (e.g. hyni_audio_data::session_id)
+     * @param audio_data 16-bit PCM samples
+     * @param is_final Force final recognition (default: false)
+     *
+     * @return JSON string containing recognition results
+     *
+     * @throws std::runtime_error if the pool is full and no session can be evicted
+     *
+     * @note Thread-safe - calls for different sessions do not block each other
+     */
+    std::string process_audio(const std::string& session_id,
+                              std::span<const int16_t> audio_data,
+                              bool is_final = false);
+
+    /**
+     * @brief Process float audio data for a specific session
+     *
+     * @param session_id Session identifier
+     * @param audio_data Float samples scaled to the 16-bit range
+     * @param is_final Force final recognition (default: false)
+     *
+     * @throws std::runtime_error if the pool is full and no session can be evicted
+     */
+    std::string process_audio(const std::string& session_id,
+                              std::span<const float> audio_data,
+                              bool is_final = false);
+
+    /**
+     * @brief Process audio data for a specific session into a typed result
+     *
+     * @throws std::runtime_error if the pool is full and no session can be evicted
+     */
+    void process_audio(const std::string& session_id,
+                       std::span<const int16_t> audio_data,
+                       recognition_result& result,
+                       bool is_final = false);
+
+    /**
+     * @brief Create an independent decoding stream
+     *
+     * The stream gets its own recognizer configured like the engine
+     * (sample rate, word times, alternatives, speaker model) and the grammar
+     * last set with the global set_grammar().
+     *
+     * @return New stream, not tracked by the session pool
+     *
+     * @throws std::runtime_error if recognizer creation fails
+     *
+     * @note Thread-safe
+     */
+    std::shared_ptr<stream> create_stream();
 
     /**
      * @brief Reset the recognizer state
@@ -277,6 +767,15 @@ public:
      */
     void reset();
 
+    /**
+     * @brief Reset the recognizer of a single session
+     *
+     * @param session_id Session identifier
+     *
+     * @note No-op if the session has no recognizer yet
+     */
+    void reset(const std::string& session_id);
+
     /**
      * @brief Set grammar constraints for recognition
      *
@@ -291,6 +790,7 @@ public:
      * - Empty string to remove grammar constraints
      *
      * @note Grammar significantly improves accuracy for limited vocabularies
+     * @note Recently used grammars are switched to without rebuilding (grammar_cache_size)
      * @note Thread-safe
      *
      * @example
@@ -304,6 +804,84 @@ public:
      */
     void set_grammar(const std::string& grammar);
 
+    /**
+     * @brief Set grammar constraints for a single session
+     *
+     * @param session_id Session identifier
+     * @param grammar JSON array of allowed phrases, empty to remove
+     *
+     * @note Creates the session recognizer if it does not exist yet
+     */
+    void set_grammar(const std::string& session_id, const std::string& grammar);
+
+    /**
+     * @brief Change the partial result cadence of the session-less stream
+     *
+     * @param enabled Compute partial results
+     * @param interval_ms Minimum audio between two partials (0 = every chunk)
+     */
+    void set_partial_results(bool enabled, int interval_ms);
+
+    /**
+     * @brief Subscribe a session to partial results or unsubscribe it
+     *
+     * @param session_id Session identifier
+     * @param enabled Compute partial results for the session
+     * @param interval_ms Minimum audio between two partials (0 = every chunk)
+     *
+     * @note Creates the session recognizer if it does not exist yet
+     */
+    void set_partial_results(const std::string& session_id, bool enabled, int interval_ms);
+
+    /**
+     * @brief Change the audio a session feeds to Vosk per call
+     *
+     * @param session_id Session identifier
+     * @param chunk_ms Slice length in ms, at least 10
+     *
+     * @note Creates the session recognizer if it does not exist yet
+     */
+    void set_chunk_ms(const std::string& session_id, int chunk_ms);
+
+    /**
+     * @brief Stop or resume partial results on every stream
+     *
+     * Load shedding: while suspended, decode() returns "{}" instead of
+     * partials. Per-stream settings are kept and apply again on resume.
+     */
+    void suspend_partial_results(bool suspended) { m_partials_suspended.store(suspended, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check if partial results are suspended
+     */
+    bool partial_results_suspended() const { return m_partials_suspended.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Release the recognizer of a session
+     *
+     * @param session_id Session identifier
+     *
+     * @note In-flight decodes on the session finish before it is freed
+     */
+    void release_session(const std::string& session_id);
+
+    /**
+     * @brief Release sessions idle for longer than session_idle_timeout_ms
+     *
+     * @return Number of sessions released
+     */
+    size_t evict_idle_sessions();
+
+    /**
+     * @brief Get number of pooled session recognizers
+     */
+    size_t get_session_count() const;
+
+    /**
+     * @brief Check if a session has a pooled recognizer
+     */
+    bool has_session(const std::string& session_id) const;
+
     /**
      * @brief Set maximum number of alternative results
      *
@@ -363,14 +941,93 @@ public:
      *
      * @return true if partial enabled, false otherwise.
      */
-    bool has_partial_enabled() const { return m_config.enable_partial_words; }
+    bool has_partial_enabled() const { return m_config.enable_partial_results; }
+
+    /**
+     * @brief Record decode and parse latency of every stream
+     *
+     * @param metrics Stage histograms (nullptr = off), must outlive the engine
+     *
+     * @note Set before audio is processed; the pointer is not synchronized
+     */
+    void set_metrics(pipeline_metrics* metrics) { m_metrics = metrics; }
+
+    /**
+     * @brief Load another model and switch all streams over to it
+     *
+     * The model is loaded on the calling thread without holding any engine
+     * lock, so decoding continues on the current model meanwhile. Once it
+     * is loaded, streams created afterwards use it immediately; existing
+     * streams (sessions and the microphone stream) keep their model until
+     * their next utterance boundary, so no utterance is split across
+     * models. A model is freed when the last stream using it has switched.
+     *
+     * @param model_path Path to the new Vosk model directory
+     *
+     * @throws std::runtime_error if the model cannot be loaded; the current
+     *         model stays active
+     *
+     * @note Thread-safe; may take tens of seconds for large models, call it
+     *       from a background thread
+     * @note The new model must accept the configured sample rate
+     *
+     * @example
+     * @code
+     * std::thread([&] { engine.load_model("/opt/models/vosk-model-en-us-0.42-gigaspeech"); }).detach();
+     * @endcode
+     */
+    void load_model(const std::string& model_path);
+
+    /**
+     * @brief Get the path of the model new streams are created from
+     */
+    std::string get_model_path() const;
+
+    /**
+     * @brief Get the model new streams are created from
+     *
+     * The returned reference keeps the model alive across a reload.
+     */
+    std::shared_ptr<VoskModel> get_model() const;
+
+    /**
+     * @brief Get the number of completed load_model() calls
+     */
+    uint64_t get_model_generation() const { return m_model_generation->load(std::memory_order_acquire); }
+
+    /**
+     * @brief Get the GPU batch decoder (nullptr with the CPU backend)
+     */
+    const batch_decoder* get_batch_decoder() const { return m_batch.get(); }
+
+    /**
+     * @brief Get the pool of grammar-configured recognizers (hit/miss counters)
+     */
+    const grammar_cache& get_grammar_cache() const { return *m_grammar_cache; }
 
 private:
     /**
-     * @brief Vosk language model
-     * @note Owned by this class, deleted in destructor
+     * @brief Vosk language model new streams are created from
+     * @note Shared with the streams built from it; freed with the last one
+     */
+    std::shared_ptr<VoskModel> m_model;
+
+    /**
+     * @brief Path m_model was loaded from
+     */
+    std::string m_model_path;
+
+    /**
+     * @brief Incremented each time load_model() installs a model
+     * @note Read by streams at utterance boundaries without locking;
+     *       shared so that streams released after the engine can read it
      */
-    VoskModel* m_model = nullptr;
+    std::shared_ptr<std::atomic<uint64_t>> m_model_generation = std::make_shared<std::atomic<uint64_t>>(0);
+
+    /**
+     * @brief GPU batch decoder, replaces m_model with the gpu_batch backend
+     */
+    std::shared_ptr<batch_decoder> m_batch;
 
     /**
      * @brief Vosk speaker model (optional)
@@ -379,21 +1036,19 @@ private:
     VoskSpkModel* m_spk_model = nullptr;
 
     /**
-     * @brief Vosk recognizer instance
-     * @note Recreated when configuration changes
+     * @brief Current configuration
      */
-    VoskRecognizer* m_recognizer = nullptr;
+    config m_config;
 
     /**
-     * @brief Current configuration
+     * @brief Idle recognizers by grammar; shared with every stream
      */
-    config m_config;
+    std::shared_ptr<grammar_cache> m_grammar_cache;
 
     /**
-     * @brief Mutex for thread-safe operations
-     * @note Protects all Vosk API calls
+     * @brief Stream used by the session-less API (microphone path)
      */
-    mutable std::mutex m_mutex;
+    std::shared_ptr<stream> m_default_stream;
 
     /**
      * @brief Atomic counter for processed samples
@@ -401,15 +1056,50 @@ private:
      */
     std::atomic<size_t> m_total_samples{0};
 
+    std::atomic<bool> m_partials_suspended{false}; ///< Set by load shedding
+
     /**
-     * @brief Initialize or reinitialize the recognizer
-     *
-     * Creates a new recognizer instance with current configuration.
-     * Called during construction and when configuration changes.
+     * @brief Stage latency histograms (optional, not owned)
+     */
+    pipeline_metrics* m_metrics = nullptr;
+
+    /**
+     * @brief Session streams keyed by session id
+     */
+    session_pool<stream> m_sessions;
+
+    /**
+     * @brief Mutex protecting m_sessions, m_default_grammar, m_model and m_model_path
+     * @note Never held while decoding
+     */
+    mutable std::mutex m_sessions_mutex;
+
+    /**
+     * @brief Grammar applied to newly created streams
+     */
+    std::string m_default_grammar;
+
+    /**
+     * @brief Create a configured recognizer from a model
      *
-     * @throws std::runtime_error if initialization fails
+     * @throws std::runtime_error if creation fails
+     */
+    VoskRecognizer* create_recognizer(VoskModel* model) const;
+
+    /**
+     * @brief Get the current model and its generation
+     */
+    std::shared_ptr<VoskModel> current_model(uint64_t& generation) const;
+
+    /**
+     * @brief Find or lazily create the stream of a session
      *
-     * @note Must be called with mutex held
+     * @throws std::runtime_error if the pool is full and nothing can be evicted
+     */
+    std::shared_ptr<stream> acquire_session(const std::string& session_id);
+
+    /**
+     * @brief Find the stream of a session without creating it
      */
-    void initialize_recognizer();
+    std::shared_ptr<stream> find_session(const std::string& session_id);
 };
@@ -0,0 +1,91 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class websocket_outbox
+ * @brief JSON messages waiting to be written to a WebSocket client
+ *
+ * The WebSocket server only pushes plain transcripts on its own. Frames
+ * with more fields (final results with their utterance_id, speaker labels)
+ * are queued here per session and written on the client's connection
+ * while it hands the server its next audio frame or command - the only
+ * time the connection is known to be alive and not written from elsewhere.
+ *
+ * A client that stops sending would never get them, so take_stale() hands
+ * queued messages back after a while for the plain transcript path.
+ *
+ * @note Thread-safe
+ */
+class websocket_outbox {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief A queued message
+     */
+    struct message {
+        std::string json;                   ///< Frame written to the client
+        bool transcript = false;            ///< Final result, can fall back to a plain transcript
+        std::string text;                   ///< Transcript text (transcript only)
+        float confidence = 0.0f;            ///< Transcript confidence (transcript only)
+        clock::time_point queued;           ///< Set by push()
+    };
+
+    /**
+     * @brief Create an outbox
+     * @param max_per_session Messages kept per session, the oldest are dropped beyond it
+     */
+    explicit websocket_outbox(size_t max_per_session = 64);
+
+    /**
+     * @brief Queue a message for a session
+     */
+    void push(const std::string& session_id, message msg);
+
+    /**
+     * @brief Take the messages queued for a session, oldest first
+     */
+    std::vector<message> take(const std::string& session_id);
+
+    /**
+     * @brief Take the messages of sessions whose oldest message waited for age
+     * @return Session id and message pairs, each session's oldest first
+     */
+    std::vector<std::pair<std::string, message>> take_stale(std::chrono::milliseconds age);
+
+    /**
+     * @brief Number of queued messages
+     */
+    size_t size() const;
+
+    /**
+     * @brief Messages dropped because a session queued more than max_per_session
+     */
+    uint64_t get_dropped() const;
+
+private:
+    size_t m_max_per_session;
+    std::unordered_map<std::string, std::deque<message>> m_queues; ///< Session id -> messages
+    size_t m_size = 0;                                              ///< Messages in m_queues
+    uint64_t m_dropped = 0;                                         ///< Messages dropped on overflow
+    mutable std::mutex m_mutex;                                     ///< Protects the members above
+};
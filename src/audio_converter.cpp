@@ -0,0 +1,336 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "audio_converter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Largest interpolation factor accepted; 44.1 kHz -> 16 kHz needs 160
+constexpr size_t max_up = 4096;
+
+float dot(const float* x, const float* c, size_t n) {
+    size_t k = 0;
+    float sum = 0.0f;
+
+#if defined(__AVX512F__)
+    // Two accumulators hide the FMA latency; n is a multiple of 16
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; k + 32 <= n; k += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + k), _mm512_loadu_ps(c + k), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + k + 16), _mm512_loadu_ps(c + k + 16), acc1);
+    }
+    for (; k + 16 <= n; k += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + k), _mm512_loadu_ps(c + k), acc0);
+    }
+    sum = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+#endif
+
+    for (; k < n; ++k) {
+        sum += x[k] * c[k];
+    }
+    return sum;
+}
+
+int16_t to_int16(float sample) {
+    return static_cast<int16_t>(std::lrint(std::clamp(sample, -32768.0f, 32767.0f)));
+}
+
+void to_int16(const float* in, int16_t* out, size_t n) {
+    size_t i = 0;
+
+#if defined(__AVX512F__)
+    const __m512 lo = _mm512_set1_ps(-32768.0f);
+    const __m512 hi = _mm512_set1_ps(32767.0f);
+    for (; i + 16 <= n; i += 16) {
+        __m512 v = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(in + i), lo), hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(v)));
+    }
+#endif
+
+    for (; i < n; ++i) {
+        out[i] = to_int16(in[i]);
+    }
+}
+
+void deinterleave_stereo(const int16_t* in, int16_t* left, int16_t* right, size_t frames) {
+    size_t i = 0;
+
+#if defined(__AVX512BW__)
+    // 16 frames per step: even samples to the low half, odd to the high half
+    const __m512i order = _mm512_set_epi16(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1,
+                                           30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+    for (; i + 16 <= frames; i += 16) {
+        __m512i v = _mm512_permutexvar_epi16(order, _mm512_loadu_si512(in + 2 * i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(left + i), _mm512_castsi512_si256(v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(right + i), _mm512_extracti64x4_epi64(v, 1));
+    }
+#endif
+
+    for (; i < frames; ++i) {
+        left[i] = in[2 * i];
+        right[i] = in[2 * i + 1];
+    }
+}
+
+template<typename T>
+T load(const std::byte* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+} // anonymous namespace
+
+audio_converter::audio_converter()
+    : audio_converter(config{}) {
+}
+
+audio_converter::audio_converter(const config& cfg)
+    : m_config(cfg) {
+
+    if (m_config.input_rate < 1000 || m_config.input_rate > 384000 ||
+        m_config.output_rate < 1000 || m_config.output_rate > 384000) {
+        throw std::invalid_argument("Sample rates must be between 1000 and 384000 Hz");
+    }
+    if (m_config.input_channels < 1 || m_config.input_channels > 32) {
+        throw std::invalid_argument("Channel count must be between 1 and 32");
+    }
+    if (m_config.taps_per_phase < 1 || m_config.taps_per_phase > 1024) {
+        throw std::invalid_argument("Filter taps per phase must be between 1 and 1024");
+    }
+
+    m_frame_bytes = sample_size(m_config.format) * static_cast<size_t>(m_config.input_channels);
+
+    const auto divisor = std::gcd(m_config.input_rate, m_config.output_rate);
+    m_up = static_cast<size_t>(m_config.output_rate / divisor);
+    m_down = static_cast<size_t>(m_config.input_rate / divisor);
+    if (m_up > max_up) {
+        throw std::invalid_argument("Unsupported resampling ratio " + std::to_string(m_config.input_rate) +
+                                    " -> " + std::to_string(m_config.output_rate) + " Hz");
+    }
+
+    if (resampling()) {
+        design_filter();
+    }
+
+    m_carry.reserve(m_frame_bytes);
+    reset();
+}
+
+void audio_converter::design_filter() {
+    // Longer filters when decimating keep the transition band narrow at the output rate
+    const double ratio = static_cast<double>(m_down) / static_cast<double>(m_up);
+    size_t taps = static_cast<size_t>(std::ceil(m_config.taps_per_phase * std::max(1.0, ratio)));
+    m_taps = (taps + 15) / 16 * 16;
+
+    // Windowed sinc at the upsampled rate, cut off at 90% of the lower Nyquist frequency
+    const size_t length = m_taps * m_up;
+    const double cutoff = 0.45 * std::min(1.0, 1.0 / ratio) / static_cast<double>(m_up);
+    const double center = static_cast<double>(length - 1) / 2.0;
+
+    std::vector<double> prototype(length);
+    for (size_t j = 0; j < length; ++j) {
+        const double x = static_cast<double>(j) - center;
+        const double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+        const double w = 2.0 * M_PI * static_cast<double>(j) / static_cast<double>(length - 1);
+        const double blackman = 0.42 - 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+        prototype[j] = sinc * blackman;
+    }
+
+    // Branch p holds taps p, p + L, p + 2L, ... reversed so the dot product
+    // runs forward over the input window; each is normalized to unity DC gain
+    m_coeffs.assign(m_up * m_taps, 0.0f);
+    for (size_t p = 0; p < m_up; ++p) {
+        double sum = 0.0;
+        for (size_t k = 0; k < m_taps; ++k) {
+            sum += prototype[p + k * m_up];
+        }
+        for (size_t k = 0; k < m_taps; ++k) {
+            m_coeffs[p * m_taps + (m_taps - 1 - k)] = static_cast<float>(prototype[p + k * m_up] / sum);
+        }
+    }
+}
+
+void audio_converter::reset() {
+    m_carry.clear();
+    m_output.clear();
+    m_phase = 0;
+
+    // Start with a window of silence so the first output needs no special case
+    m_buffer.assign(resampling() ? m_taps - 1 : 0, 0.0f);
+    m_index = m_buffer.size();
+}
+
+bool audio_converter::passthrough() const {
+    return !resampling() && m_config.input_channels == 1 && m_config.format == sample_format::int16;
+}
+
+void audio_converter::deinterleave(std::span<const int16_t> interleaved,
+                                   std::vector<std::vector<int16_t>>& planes) {
+    const size_t channels = planes.size();
+    if (channels == 0) {
+        return;
+    }
+
+    const size_t frames = interleaved.size() / channels;
+    for (auto& plane : planes) {
+        plane.resize(frames);
+    }
+
+    if (channels == 2) {
+        deinterleave_stereo(interleaved.data(), planes[0].data(), planes[1].data(), frames);
+        return;
+    }
+
+    for (size_t c = 0; c < channels; ++c) {
+        int16_t* out = planes[c].data();
+        const int16_t* in = interleaved.data() + c;
+        for (size_t i = 0; i < frames; ++i) {
+            out[i] = in[i * channels];
+        }
+    }
+}
+
+audio_converter::sample_format audio_converter::parse_format(const std::string& name) {
+    if (name == "s16" || name == "int16") {
+        return sample_format::int16;
+    }
+    if (name == "f32" || name == "float32") {
+        return sample_format::float32;
+    }
+    throw std::invalid_argument("Unknown sample format: " + name + " (expected s16 or f32)");
+}
+
+std::span<const int16_t> audio_converter::process(std::span<const int16_t> input) {
+    if (passthrough() && m_carry.empty()) {
+        return input;
+    }
+    return process(std::as_bytes(input));
+}
+
+std::span<const int16_t> audio_converter::process(std::span<const std::byte> input) {
+    m_output.clear();
+    if (!resampling()) {
+        m_buffer.clear();
+    }
+
+    // Complete the frame left over from the previous call
+    if (!m_carry.empty()) {
+        size_t needed = std::min(m_frame_bytes - m_carry.size(), input.size());
+        m_carry.insert(m_carry.end(), input.begin(), input.begin() + needed);
+        input = input.subspan(needed);
+
+        if (m_carry.size() < m_frame_bytes) {
+            return m_output;
+        }
+        decode(m_carry);
+        m_carry.clear();
+    }
+
+    const size_t whole = input.size() / m_frame_bytes * m_frame_bytes;
+    decode(input.first(whole));
+    m_carry.assign(input.begin() + whole, input.end());
+
+    if (resampling()) {
+        resample();
+    } else {
+        m_output.resize(m_buffer.size());
+        to_int16(m_buffer.data(), m_output.data(), m_buffer.size());
+    }
+    return m_output;
+}
+
+void audio_converter::decode(std::span<const std::byte> frames) {
+    const size_t count = frames.size() / m_frame_bytes;
+    const size_t channels = static_cast<size_t>(m_config.input_channels);
+    const size_t offset = m_buffer.size();
+    m_buffer.resize(offset + count);
+
+    float* dst = m_buffer.data() + offset;
+    const std::byte* src = frames.data();
+    size_t i = 0;
+
+    if (m_config.format == sample_format::int16) {
+        if (channels == 1) {
+#if defined(__AVX512F__)
+            for (; i + 16 <= count; i += 16) {
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * sizeof(int16_t)));
+                _mm512_storeu_ps(dst + i, _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(s)));
+            }
+#endif
+            for (; i < count; ++i) {
+                dst[i] = static_cast<float>(load<int16_t>(src + i * sizeof(int16_t)));
+            }
+        } else {
+            const float scale = 1.0f / static_cast<float>(channels);
+            for (; i < count; ++i) {
+                const std::byte* frame = src + i * m_frame_bytes;
+                int32_t sum = 0;
+                for (size_t c = 0; c < channels; ++c) {
+                    sum += load<int16_t>(frame + c * sizeof(int16_t));
+                }
+                dst[i] = static_cast<float>(sum) * scale;
+            }
+        }
+    } else {
+        // float32 in [-1, 1] is scaled to the int16 range the decoder expects
+        const float scale = 32768.0f / static_cast<float>(channels);
+        if (channels == 1) {
+            std::memcpy(dst, src, count * sizeof(float));
+            for (; i < count; ++i) {
+                dst[i] *= scale;
+            }
+        } else {
+            for (; i < count; ++i) {
+                const std::byte* frame = src + i * m_frame_bytes;
+                float sum = 0.0f;
+                for (size_t c = 0; c < channels; ++c) {
+                    sum += load<float>(frame + c * sizeof(float));
+                }
+                dst[i] = sum * scale;
+            }
+        }
+    }
+}
+
+void audio_converter::resample() {
+    const size_t available = m_buffer.size() > m_index
+        ? (m_buffer.size() - m_index) * m_up / m_down + 1
+        : 0;
+    m_output.reserve(available);
+
+    // Output n sits at n * M on the upsampled grid: input index (n * M) / L, branch (n * M) % L
+    size_t i = m_index;
+    while (i < m_buffer.size()) {
+        const float* window = m_buffer.data() + i + 1 - m_taps;
+        m_output.push_back(to_int16(dot(window, m_coeffs.data() + m_phase * m_taps, m_taps)));
+
+        m_phase += m_down;
+        i += m_phase / m_up;
+        m_phase %= m_up;
+    }
+
+    // Keep the taps - 1 samples the next window still needs
+    const size_t drop = std::min(i + 1 - m_taps, m_buffer.size());
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(drop));
+    m_index = i - drop;
+}
@@ -0,0 +1,152 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "audio_file.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::endian::native == std::endian::little,
+              "audio_file uses little-endian PCM samples in place");
+
+namespace {
+
+uint16_t read_u16(const uint8_t* p) {
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t read_u32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+} // namespace
+
+audio_file::audio_file(const std::string& path, int sample_rate)
+    : m_path(path), m_sample_rate(sample_rate) {
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open audio file: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat audio file: " + path);
+    }
+
+    m_map_size = static_cast<size_t>(st.st_size);
+    if (m_map_size > 0) {
+        m_map = ::mmap(nullptr, m_map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+
+    if (m_map == MAP_FAILED) {
+        m_map = nullptr;
+        throw std::runtime_error("Cannot map audio file: " + path);
+    }
+
+    if (m_map) {
+        // The decoder reads front to back exactly once
+        ::madvise(m_map, m_map_size, MADV_SEQUENTIAL);
+        ::madvise(m_map, m_map_size, MADV_WILLNEED);
+    }
+
+    std::span<const uint8_t> bytes(static_cast<const uint8_t*>(m_map), m_map_size);
+    try {
+        if (bytes.size() >= 12 && std::memcmp(bytes.data(), "RIFF", 4) == 0 &&
+            std::memcmp(bytes.data() + 8, "WAVE", 4) == 0) {
+            bytes = parse_wav(bytes, sample_rate);
+        }
+    } catch (...) {
+        ::munmap(m_map, m_map_size);
+        m_map = nullptr;
+        throw;
+    }
+
+    const size_t count = bytes.size() / sizeof(int16_t);
+    if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(int16_t) == 0) {
+        m_samples = std::span<const int16_t>(reinterpret_cast<const int16_t*>(bytes.data()), count);
+    } else {
+        m_copy.resize(count);
+        std::memcpy(m_copy.data(), bytes.data(), count * sizeof(int16_t));
+        m_samples = m_copy;
+    }
+}
+
+audio_file::~audio_file() {
+    if (m_map) {
+        ::munmap(m_map, m_map_size);
+    }
+}
+
+double audio_file::duration_ms() const {
+    return static_cast<double>(m_samples.size()) * 1000.0 / m_sample_rate;
+}
+
+bool audio_file::is_supported(const std::string& path) {
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".wav" || ext == ".raw" || ext == ".pcm";
+}
+
+std::span<const uint8_t> audio_file::parse_wav(std::span<const uint8_t> bytes, int sample_rate) const {
+    bool have_format = false;
+    size_t pos = 12;
+
+    while (pos + 8 <= bytes.size()) {
+        const uint8_t* chunk = bytes.data() + pos;
+        const size_t size = read_u32(chunk + 4);
+        const size_t body = pos + 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (size < 16 || body + 16 > bytes.size()) {
+                throw std::invalid_argument("Truncated WAV format chunk: " + m_path);
+            }
+            const uint16_t format = read_u16(bytes.data() + body);
+            const uint16_t channels = read_u16(bytes.data() + body + 2);
+            const uint32_t rate = read_u32(bytes.data() + body + 4);
+            const uint16_t bits = read_u16(bytes.data() + body + 14);
+
+            // 1 = PCM, 0xFFFE = WAVE_FORMAT_EXTENSIBLE (PCM sub-format assumed)
+            if ((format != 1 && format != 0xFFFE) || bits != 16 || channels != 1) {
+                throw std::invalid_argument("Unsupported WAV format (need 16-bit mono PCM): " + m_path);
+            }
+            if (static_cast<int>(rate) != sample_rate) {
+                throw std::invalid_argument("WAV sample rate " + std::to_string(rate) +
+                                            " Hz does not match " + std::to_string(sample_rate) +
+                                            " Hz: " + m_path);
+            }
+            have_format = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!have_format) {
+                throw std::invalid_argument("WAV data chunk before format chunk: " + m_path);
+            }
+            // Streamed WAVs may carry a placeholder size, clamp to the file
+            return bytes.subspan(body, std::min(size, bytes.size() - body));
+        }
+
+        // Chunks are padded to even sizes
+        pos = body + size + (size & 1);
+    }
+
+    throw std::invalid_argument("WAV file has no data chunk: " + m_path);
+}
@@ -12,93 +12,170 @@
 #include "audio_processor.h"
 #include "benchmark_manager.h"
 #include "logger.h"
-#include <nlohmann/json.hpp>
 #include <iostream>
 
-using json = nlohmann::json;
-
 audio_processor::audio_processor(vstream_engine* engine,
                                  hyni_websocket_server* server,
-                                 int finalize_interval_ms,
+                                 int max_utterance_ms,
                                  int buffer_ms,
                                  benchmark_manager* benchmark)
     : m_engine(engine)
     , m_server(server)
     , m_session_id("mic-capture")
-    , m_finalize_interval_ms(finalize_interval_ms)
     , m_buffer_ms(buffer_ms)
-    , m_last_finalize_time(std::chrono::steady_clock::now())
+    , m_cap(max_utterance_ms)
+    , m_chunk_time(std::chrono::steady_clock::now())
     , m_benchmark(benchmark) {
 
     m_show_partial = m_engine->has_partial_enabled();
 
-    // Pre-allocate string buffer
-    m_result_buffer.reserve(1024);
+    // Pre-allocate string buffers
     m_last_final_text.reserve(256);
     m_last_partial_text.reserve(256);
 
-    LOG_INFO("audio_processor initialized without VAD (time-based finalization every " +
-             std::to_string(m_finalize_interval_ms) + "ms)");
+    LOG_INFO("audio_processor initialized (endpoint finalization, utterances capped at " +
+             std::to_string(m_cap.max_ms()) + "ms)");
+}
+
+void audio_processor::enable_vad(const voice_activity_detector::config& cfg) {
+    m_vad = std::make_unique<voice_activity_detector>(cfg);
+    m_preroll.reserve(static_cast<size_t>(cfg.sample_rate) * m_buffer_ms / 1000);
+
+    LOG_INFO("audio_processor VAD enabled (threshold " + std::to_string(cfg.threshold_db) +
+             " dBFS, hangover " + std::to_string(cfg.hangover_ms) + "ms)");
+}
+
+void audio_processor::set_channel(int channel) {
+    m_stream = m_engine->create_stream();
+    m_session_id = "mic-capture/ch" + std::to_string(channel);
+    LOG_INFO("audio_processor transcribing capture channel " + std::to_string(channel));
 }
 
-void audio_processor::process_audio(const std::vector<int16_t>& audio) {
+void audio_processor::decode(std::span<const int16_t> audio) {
+    if (m_stream) {
+        m_stream->process_audio(audio, m_result);
+    } else {
+        m_engine->process_audio(audio, m_result);
+    }
+}
+
+void audio_processor::process_audio(std::span<const int16_t> audio,
+                                    std::chrono::steady_clock::time_point captured) {
     if (audio.empty()) {
         return;
     }
 
     auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                       now - m_last_finalize_time).count();
+    m_chunk_time = captured == std::chrono::steady_clock::time_point{} ? now : captured;
+
+    if (m_vad) {
+        auto vad = detect_speech(audio);
+
+        if (!vad.speech) {
+            // Speaker paused: close the utterance unless the model already did
+            if (vad.endpoint && m_cap.open()) {
+                LOG_INFO("VAD endpoint, finalizing utterance");
+                force_finalize();
+            }
+
+            // Keep the chunk as pre-roll; the decoder never sees silence
+            m_preroll.assign(audio.begin(), audio.end());
+            m_skipped_chunks++;
+            m_cap.restart(now);
+            return;
+        }
+
+        // Speech onset: decode the preceding chunk so the first phoneme is not clipped
+        if (!m_preroll.empty()) {
+            m_accumulated_audio_samples += m_preroll.size();
+            decode(m_preroll);
+            handle_speech_result(m_result);
+            m_preroll.clear();
+        }
+    }
+
+    auto elapsed = m_cap.elapsed_ms(now);
 
     m_accumulated_audio_samples += audio.size();
 
-    // Always process audio (no VAD)
-    m_result_buffer = m_engine->process_audio(audio);
-    handle_speech_result(m_result_buffer);
+    decode(audio);
+    handle_speech_result(m_result);
 
-    // Time-based finalization
-    if (elapsed >= m_finalize_interval_ms) {
-        LOG_INFO("Time-based finalization after " + std::to_string(elapsed) + "ms");
+    if (m_result.is_final()) {
+        // The model endpointed: the cap restarts with the next utterance
+        m_last_partial_text.clear();
+    }
+
+    auto action = m_cap.after_decode(now, m_result.is_final(), m_vad && !m_vad->in_speech(), [this]() {
+        return !m_last_partial_text.empty() ||
+               (m_stream ? m_stream->has_partial_result() : m_engine->has_partial_result());
+    });
+    if (action == utterance_cap::action::cap_reached) {
+        LOG_INFO("Utterance cap reached after " + std::to_string(elapsed) + "ms, finalizing");
+        force_finalize();
+    } else if (action == utterance_cap::action::speech_ended) {
+        LOG_INFO("VAD endpoint, finalizing utterance");
         force_finalize();
-        m_last_finalize_time = now;
     }
 }
 
-void audio_processor::handle_speech_result(const std::string& result_json) {
-    try {
-        auto result = json::parse(result_json);
+voice_activity_detector::decision audio_processor::detect_speech(std::span<const int16_t> audio) {
+    auto decision = m_vad->process(audio);
 
-        // Handle final result
-        if (result.contains("text") && !result["text"].is_null()) {
-            std::string text = result["text"].get<std::string>();
-            if (!text.empty() && text != m_last_final_text) {
-                handle_final_result(text);
+    if (m_benchmark) {
+        bool onset_reported = false;
+        for (uint8_t frame_speech : m_vad->frame_decisions()) {
+            int silence_before = 0;
+            if (frame_speech && !onset_reported) {
+                silence_before = decision.silence_frames_before;
+                onset_reported = true;
             }
+            m_benchmark->add_vad_decision(frame_speech != 0, silence_before);
         }
-        // Handle partial result
-        else if (m_show_partial && result.contains("partial") && !result["partial"].is_null()) {
-            std::string partial = result["partial"].get<std::string>();
-            if (!partial.empty() && partial != m_last_partial_text) {
-                handle_partial_result(partial);
-            }
+    }
+
+    return decision;
+}
+
+void audio_processor::handle_speech_result(const recognition_result& result) {
+    if (result.empty()) {
+        return;
+    }
+
+    // Handle final result
+    if (result.is_final()) {
+        if (result.text() != m_last_final_text) {
+            handle_final_result(std::string(result.text()));
+        }
+    }
+    // Handle partial result
+    else if (m_show_partial && result.is_partial()) {
+        if (result.text() != m_last_partial_text) {
+            handle_partial_result(std::string(result.text()));
         }
-    } catch (const std::exception& e) {
-        LOG_ERROR("Error parsing JSON: " + std::string(e.what()));
     }
 }
 
 void audio_processor::handle_final_result(const std::string& text) {
     m_last_final_text = text;
+
+    auto deliver_start = std::chrono::steady_clock::now();
     m_server->queue_transcription(text, m_session_id, 1.0f);
-    LOG_INFO("[FINAL] Recognized: " + text);
+    auto processing_end = std::chrono::steady_clock::now();
+
+    if (m_metrics) {
+        m_metrics->record(pipeline_metrics::stage::deliver, processing_end - deliver_start);
+        m_metrics->record(pipeline_metrics::stage::end_to_end, processing_end - m_chunk_time);
+    }
+    LOG_INFO("[FINAL] " + m_session_id + " recognized: " + text);
 
     // Always show final results
-    std::cout << "\n[FINAL] " << text << std::endl;
+    std::cout << "\n[FINAL] " << (m_stream ? "(" + m_session_id + ") " : "") << text << std::endl;
 
     if (m_benchmark) {
-        auto processing_end = std::chrono::steady_clock::now();
+        // From capture of the chunk that completed the utterance
         double latency_ms = std::chrono::duration<double, std::milli>(
-                                processing_end - m_last_finalize_time).count();
+                                processing_end - m_chunk_time).count();
 
         m_benchmark->add_transcription(text, "final", 1.0f,
                                        m_accumulated_audio_samples, latency_ms);
@@ -106,7 +183,7 @@ void audio_processor::handle_final_result(const std::string& text) {
     }
 
     // Reset finalize timer
-    m_last_finalize_time = std::chrono::steady_clock::now();
+    m_cap.restart(std::chrono::steady_clock::now());
 }
 
 void audio_processor::handle_partial_result(const std::string& partial) {
@@ -114,29 +191,25 @@ void audio_processor::handle_partial_result(const std::string& partial) {
     LOG_DEBUG("[PARTIAL] " + partial);
 
     // Only show partial results if enabled
-    std::cout << "\r[PARTIAL] " << partial << "...              " << std::flush;
+    std::cout << "\r[PARTIAL] " << (m_stream ? "(" + m_session_id + ") " : "") << partial << "...              " << std::flush;
 }
 
 void audio_processor::force_finalize() {
     // Force final result
-    m_result_buffer = m_engine->process_audio({}, true);
-
-    try {
-        auto result = json::parse(m_result_buffer);
-        if (result.contains("text") && !result["text"].is_null()) {
-            std::string text = result["text"].get<std::string>();
-            if (!text.empty() && text != m_last_final_text) {
-                handle_final_result(text);
-            }
-        }
-    } catch (const std::exception& e) {
-        LOG_ERROR("Error parsing final JSON: " + std::string(e.what()));
+    if (m_stream) {
+        m_stream->finalize(m_result);
+    } else {
+        m_engine->finalize(m_result);
     }
 
-    // Reset recognizer for next utterance
-    m_engine->reset();
-    m_last_partial_text.clear();
+    // Finals still queued by earlier chunks come out before the stream goes quiet
+    do {
+        if (m_result.is_final() && !m_result.empty() && m_result.text() != m_last_final_text) {
+            handle_final_result(std::string(m_result.text()));
+        }
+    } while (m_stream ? m_stream->next_final(m_result) : m_engine->next_final(m_result));
 
-    // Reset finalize timer
-    m_last_finalize_time = std::chrono::steady_clock::now();
+    // The stream starts its next utterance from a clean state on its own
+    m_last_partial_text.clear();
+    m_cap.close(std::chrono::steady_clock::now());
 }
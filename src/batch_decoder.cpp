@@ -0,0 +1,155 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "batch_decoder.h"
+#include "logger.h"
+#include <vosk_api.h>
+#include <stdexcept>
+
+batch_decoder::batch_decoder(const std::string& model_path, float sample_rate, const config& cfg)
+    : m_config(cfg)
+    , m_sample_rate(sample_rate) {
+
+    if (m_config.max_batch == 0) {
+        m_config.max_batch = 1;
+    }
+
+    vosk_gpu_init();
+
+    m_model = vosk_batch_model_new(model_path.c_str());
+    if (!m_model) {
+        throw std::runtime_error("Failed to load Vosk batch model from: " + model_path +
+                                 " (GPU decoding needs libvosk built with CUDA)");
+    }
+
+    m_pending.reserve(m_config.max_batch);
+    m_collector = std::thread(&batch_decoder::collector_loop, this);
+
+    LOG_INFO("GPU batch decoder ready: up to " + std::to_string(m_config.max_batch) +
+             " chunks per batch, " + std::to_string(m_config.max_wait_ms) + "ms max wait");
+}
+
+batch_decoder::~batch_decoder() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_collector_cv.notify_all();
+
+    if (m_collector.joinable()) {
+        m_collector.join();
+    }
+
+    if (m_model) {
+        vosk_batch_model_free(m_model);
+    }
+}
+
+VoskBatchRecognizer* batch_decoder::create_recognizer() {
+    VoskBatchRecognizer* recognizer = vosk_batch_recognizer_new(m_model, m_sample_rate);
+    if (!recognizer) {
+        throw std::runtime_error("Failed to create Vosk batch recognizer");
+    }
+    return recognizer;
+}
+
+void batch_decoder::free_recognizer(VoskBatchRecognizer* recognizer) {
+    vosk_batch_recognizer_free(recognizer);
+}
+
+std::string batch_decoder::decode(VoskBatchRecognizer* recognizer,
+                                  std::span<const int16_t> audio, bool finish) {
+    request req{recognizer, audio, finish, {}};
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        return {};
+    }
+
+    if (m_pending.empty()) {
+        m_oldest = std::chrono::steady_clock::now();
+        m_collector_cv.notify_one();
+    }
+    m_pending.push_back(&req);
+    if (m_pending.size() >= m_config.max_batch) {
+        m_collector_cv.notify_one();
+    }
+
+    m_done_cv.wait(lock, [&req] { return req.done; });
+    return std::move(req.result);
+}
+
+void batch_decoder::collector_loop() {
+    vosk_gpu_thread_init();
+
+    std::vector<request*> batch;
+    batch.reserve(m_config.max_batch);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_collector_cv.wait(lock, [this] { return !m_pending.empty() || !m_running; });
+        if (!m_running) {
+            break;
+        }
+
+        // Let the batch fill up, but never hold its oldest chunk past the deadline
+        auto deadline = m_oldest + std::chrono::milliseconds(m_config.max_wait_ms);
+        m_collector_cv.wait_until(lock, deadline, [this] {
+            return m_pending.size() >= m_config.max_batch || !m_running;
+        });
+
+        batch.swap(m_pending);
+        lock.unlock();
+
+        run_batch(batch);
+
+        lock.lock();
+        for (request* req : batch) {
+            req->done = true;
+        }
+        batch.clear();
+        m_done_cv.notify_all();
+    }
+
+    // Release callers that arrived while stopping
+    for (request* req : m_pending) {
+        req->done = true;
+    }
+    m_pending.clear();
+    m_done_cv.notify_all();
+}
+
+void batch_decoder::run_batch(const std::vector<request*>& batch) {
+    for (request* req : batch) {
+        if (!req->audio.empty()) {
+            vosk_batch_recognizer_accept_waveform(req->recognizer,
+                                                  reinterpret_cast<const char*>(req->audio.data()),
+                                                  static_cast<int>(req->audio.size_bytes()));
+        }
+        if (req->finish) {
+            vosk_batch_recognizer_finish_stream(req->recognizer);
+        }
+    }
+
+    // One GPU round for every stream in the batch
+    vosk_batch_model_wait(m_model);
+
+    for (request* req : batch) {
+        const char* result = vosk_batch_recognizer_front_result(req->recognizer);
+        if (result && *result) {
+            req->result = result;
+            vosk_batch_recognizer_pop(req->recognizer);
+        }
+    }
+
+    m_batches.fetch_add(1, std::memory_order_relaxed);
+    m_chunks.fetch_add(batch.size(), std::memory_order_relaxed);
+}
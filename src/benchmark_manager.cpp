@@ -19,7 +19,13 @@
 #include <iomanip>
 #include <numeric>
 #include <map>
+#include <unordered_map>
+#include <string_view>
+#include <limits>
+#include <cstdint>
+#include <cstdio>
 #include <regex>
+#include <stdexcept>
 #include <filesystem>
 #include <nlohmann/json.hpp>
 
@@ -39,26 +45,58 @@ benchmark_manager::~benchmark_manager() {
     if (m_is_running) {
         stop();
     }
+    stop_writer();
 }
 
 void benchmark_manager::set_reference_text(const std::string& text) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_reference_text = normalize_text(text);
+
+    // Interned once; hypothesis words are looked up as they arrive
+    m_reference_ids.clear();
+    std::vector<int> reference;
+    for (const auto& word : tokenize(m_reference_text)) {
+        reference.push_back(m_reference_ids.try_emplace(word, static_cast<int>(m_reference_ids.size())).first->second);
+    }
+    m_word_aligner.reset(std::move(reference));
+
+    m_reference_chars.clear();
+    for (char c : m_reference_text) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            m_reference_chars.push_back(c);
+        }
+    }
+    m_char_aligner.reset(m_reference_chars);
+
+    rebuild_hypothesis_words();
+
     LOG_INFO("Benchmark reference text set (" + std::to_string(m_reference_text.length()) + " characters)");
     std::cout << "[Benchmark] Reference text set ("
               << m_reference_text.length() << " characters)" << std::endl;
 }
 
 void benchmark_manager::set_vad_ground_truth(const std::vector<bool>& labels, double frame_duration_ms) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_vad_ground_truth = labels;
     m_vad_frame_duration_ms = frame_duration_ms;
+
+    m_vad_scored = 0;
+    m_vad_correct = m_vad_false_positives = m_vad_false_negatives = 0;
+    score_vad_decisions();
+
     LOG_INFO("VAD ground truth set (" + std::to_string(labels.size()) + " frames, " +
              std::to_string(frame_duration_ms) + "ms per frame)");
 }
 
 void benchmark_manager::start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_segments.clear();
+    m_arena.clear();
+    m_segment_count = 0;
+    m_segment_base = 0;
     m_vad_decisions.clear();
     m_total_samples = 0;
+    reset_aggregates();
     m_is_running = true;
     m_start_time = std::chrono::steady_clock::now();
     m_last_segment_time = m_start_time;
@@ -68,14 +106,26 @@ void benchmark_manager::start() {
 }
 
 benchmark_manager::benchmark_results benchmark_manager::stop() {
-    m_is_running = false;
-    auto end_time = std::chrono::steady_clock::now();
+    benchmark_results results;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_running = false;
+        auto end_time = std::chrono::steady_clock::now();
+
+        results = compute_results();
 
-    benchmark_results results = get_current_results();
+        if (m_stream_flush > 0) {
+            flush_segments(0);
+        }
 
-    // Calculate final timing metrics
-    results.total_processing_time_ms =
-        std::chrono::duration<double, std::milli>(end_time - m_start_time).count();
+        // Calculate final timing metrics
+        results.total_processing_time_ms =
+            std::chrono::duration<double, std::milli>(end_time - m_start_time).count();
+        if (results.total_audio_duration_ms > 0) {
+            results.real_time_factor = results.total_processing_time_ms / results.total_audio_duration_ms;
+        }
+    }
+    wait_for_writer();
 
     LOG_INFO("Benchmark completed - WER: " + std::to_string(results.word_error_rate) +
              "%, CER: " + std::to_string(results.character_error_rate) +
@@ -93,31 +143,80 @@ benchmark_manager::benchmark_results benchmark_manager::stop() {
 }
 
 void benchmark_manager::add_transcription(const std::string& text,
-                                          const std::string& type,
+                                          std::string_view type,
                                           double confidence,
                                           size_t audio_samples,
                                           double processing_latency_ms) {
+    std::unique_lock<std::mutex> lock(m_mutex);
     if (!m_is_running) return;
 
     auto now = std::chrono::steady_clock::now();
+    auto offset_ms = [this](std::chrono::steady_clock::time_point t) {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(t - m_start_time).count());
+    };
 
-    transcription_segment segment;
-    segment.text = normalize_text(text);
-    segment.type = type;
-    segment.start_time = m_last_segment_time;
-    segment.end_time = now;
-    segment.confidence = confidence;
-    segment.audio_samples = audio_samples;
+    std::string normalized = normalize_text(text);
+    bool is_final = type == "final";
 
-    if (processing_latency_ms > 0) {
-        segment.processing_latency_ms = processing_latency_ms;
-    } else {
+    if (processing_latency_ms <= 0) {
         // Fall back to time between calls (less accurate)
-        segment.processing_latency_ms = std::chrono::duration<double, std::milli>(
-                                            segment.end_time - segment.start_time).count();
+        processing_latency_ms = std::chrono::duration<double, std::milli>(now - m_last_segment_time).count();
     }
 
+    // Fold the segment into the running aggregates
+    if (is_final && !normalized.empty()) {
+        m_final_count++;
+
+        if (!m_hypothesis_text.empty()) {
+            m_hypothesis_text += ' ';
+        }
+        m_hypothesis_text += normalized;
+
+        for (char c : normalized) {
+            if (!std::isspace(static_cast<unsigned char>(c))) {
+                m_hypothesis_chars.push_back(c);
+            }
+        }
+        for (const auto& word : tokenize(normalized)) {
+            m_hypothesis_words.push_back(word_id(word));
+        }
+    } else if (type == "partial") {
+        m_partial_count++;
+    }
+
+    if (processing_latency_ms > 0) {
+        if (m_latency_count == 0) {
+            m_latency_min = m_latency_max = processing_latency_ms;
+        }
+        m_latency_count++;
+        m_latency_sum += processing_latency_ms;
+        m_latency_min = std::min(m_latency_min, processing_latency_ms);
+        m_latency_max = std::max(m_latency_max, processing_latency_ms);
+    }
+
+    if (m_segment_count == 0) {
+        m_confidence_min = m_confidence_max = confidence;
+    }
+    m_confidence_sum += confidence;
+    m_confidence_min = std::min(m_confidence_min, confidence);
+    m_confidence_max = std::max(m_confidence_max, confidence);
+
+    // The segment the VAD decisions update is held back from the stream
+    if (m_stream_flush > 0 && m_segments.size() >= m_stream_flush) {
+        flush_segments(1);
+    }
+
+    segment_record segment;
+    segment.text = m_arena.append(normalized);
+    segment.type = is_final ? segment_type::final : segment_type::partial;
+    segment.start_ms = offset_ms(m_last_segment_time);
+    segment.end_ms = offset_ms(now);
+    segment.confidence = static_cast<float>(confidence);
+    segment.processing_latency_ms = static_cast<float>(processing_latency_ms);
+    segment.audio_samples = static_cast<uint32_t>(audio_samples);
     m_segments.push_back(segment);
+    m_segment_count++;
+
     m_total_samples += audio_samples;
     m_last_segment_time = now;
 
@@ -129,139 +228,380 @@ void benchmark_manager::add_transcription(const std::string& text,
 
     // Call progress callback if set
     if (m_progress_callback) {
-        m_progress_callback(get_current_results());
+        auto results = compute_results();
+        lock.unlock();
+        m_progress_callback(results);
     }
 }
 
 void benchmark_manager::add_vad_decision(bool is_speech, int silence_frames_before) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (!m_is_running) return;
 
     m_vad_decisions.push_back(is_speech);
+    score_vad_decisions();
 
     // Update VAD-specific data in the last segment if available
     if (!m_segments.empty()) {
         auto& last_segment = m_segments.back();
+        add_silence_contribution(last_segment, -1);
         last_segment.vad_detected = is_speech;
         last_segment.silence_frames_before = silence_frames_before;
+        add_silence_contribution(last_segment, +1);
     }
 }
 
-benchmark_manager::benchmark_results benchmark_manager::get_current_results() const {
-    benchmark_results results;
+benchmark_manager::benchmark_results benchmark_manager::get_current_results(bool include_text) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return compute_results(include_text);
+}
 
-    // Build hypothesis text from final segments only
-    std::vector<std::string> final_texts;
-    int partial_count = 0, final_count = 0;
+std::vector<benchmark_manager::transcription_segment> benchmark_manager::get_segments(size_t first) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<transcription_segment> segments;
+    if (first >= m_segment_count) {
+        return segments;
+    }
 
-    for (const auto& segment : m_segments) {
-        if (segment.type == "final" && !segment.text.empty()) {
-            final_texts.push_back(segment.text);
-            final_count++;
-        } else if (segment.type == "partial") {
-            partial_count++;
-        }
+    size_t skip = first > m_segment_base ? static_cast<size_t>(first - m_segment_base) : 0;
+    segments.reserve(m_segments.size() - skip);
+    for (auto it = m_segments.begin() + static_cast<std::ptrdiff_t>(skip); it != m_segments.end(); ++it) {
+        segments.push_back(expand(*it));
     }
+    return segments;
+}
 
-    // Join final texts
-    results.hypothesis_text.clear();
-    for (size_t i = 0; i < final_texts.size(); ++i) {
-        if (i > 0) results.hypothesis_text += " ";
-        results.hypothesis_text += final_texts[i];
+benchmark_manager::transcription_segment benchmark_manager::expand(const segment_record& record) const {
+    transcription_segment segment;
+    segment.text = m_arena.view(record.text);
+    segment.type = record.type;
+    segment.start_offset = std::chrono::milliseconds(record.start_ms);
+    segment.end_offset = std::chrono::milliseconds(record.end_ms);
+    segment.confidence = record.confidence;
+    segment.audio_samples = record.audio_samples;
+    segment.processing_latency_ms = record.processing_latency_ms;
+    segment.vad_detected = record.vad_detected;
+    segment.silence_frames_before = record.silence_frames_before;
+    return segment;
+}
+
+const char* benchmark_manager::segment_type_name(segment_type type) {
+    return type == segment_type::final ? "final" : "partial";
+}
+
+void benchmark_manager::stream_segments(const std::string& path, const std::string& format,
+                                        size_t flush_segments) {
+    if (format != "jsonl" && format != "csv") {
+        throw std::invalid_argument("Unknown segment stream format: " + format);
     }
-    results.hypothesis_text = normalize_text(results.hypothesis_text);
 
-    results.reference_text = m_reference_text;
-    results.segments = m_segments;
-    results.partial_segments = partial_count;
-    results.final_segments = final_count;
-    results.partial_to_final_ratio = final_count > 0 ? static_cast<double>(partial_count) / final_count : 0.0;
+    // Finish a previous stream before the writer moves to the new file
+    stop_writer();
 
-    // Calculate accuracy metrics
-    if (!m_reference_text.empty() && !results.hypothesis_text.empty()) {
-        results.word_error_rate = calculate_wer(
-            m_reference_text,
-            results.hypothesis_text,
-            &results.word_substitutions,
-            &results.word_deletions,
-            &results.word_insertions
-            );
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_segment_stream.is_open()) {
+        m_segment_stream.close();
+    }
+    m_segment_stream.open(path, std::ios::out | std::ios::trunc);
+    if (!m_segment_stream.is_open()) {
+        m_stream_flush = 0;
+        throw std::runtime_error("Cannot open segment stream file: " + path);
+    }
 
-        results.character_error_rate = calculate_cer(
-            m_reference_text,
-            results.hypothesis_text
-            );
+    m_stream_csv = format == "csv";
+    m_stream_flush = std::max<size_t>(1, flush_segments);
+    m_streamed_segments = 0;
+    m_stream_failed = false;
+    if (m_stream_csv) {
+        m_segment_stream << "index,type,start_ms,end_ms,confidence,audio_samples,latency_ms,"
+                            "vad_detected,silence_frames_before,text\n";
+    }
+
+    m_writer_stop = false;
+    m_writer = std::thread(&benchmark_manager::writer_loop, this);
 
-        auto ref_words = tokenize(m_reference_text);
-        results.total_words = ref_words.size();
-        results.word_errors = results.word_substitutions +
-                              results.word_deletions +
-                              results.word_insertions;
+    LOG_INFO("Streaming benchmark segments to " + path + " (" + format + ")");
+}
+
+uint64_t benchmark_manager::get_streamed_segments() const {
+    return m_streamed_segments.load();
+}
+
+void benchmark_manager::flush_segments(size_t keep) {
+    if (m_stream_failed.load()) {
+        m_stream_flush = 0;
+        return;
+    }
+    if (m_segments.size() <= keep) {
+        return;
     }
 
-    // Calculate timing metrics
-    if (!m_segments.empty()) {
-        std::vector<double> latencies;
-        std::vector<double> confidences;
-        std::vector<double> silence_before_speech;
+    const size_t count = m_segments.size() - keep;
+    segment_batch batch;
+    batch.base = m_segment_base;
+    batch.records.assign(m_segments.begin(), m_segments.begin() + static_cast<std::ptrdiff_t>(count));
+    m_segments.erase(m_segments.begin(), m_segments.begin() + static_cast<std::ptrdiff_t>(count));
+    m_segment_base += count;
+
+    // The batch takes the arena; the held-back texts move to a fresh one
+    batch.arena = std::move(m_arena);
+    m_arena = text_arena{};
+    for (auto& segment : m_segments) {
+        segment.text = m_arena.append(batch.arena.view(segment.text));
+    }
 
-        for (const auto& segment : m_segments) {
-            if (segment.processing_latency_ms > 0) {
-                latencies.push_back(segment.processing_latency_ms);
-            }
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        m_write_queue.push_back(std::move(batch));
+    }
+    m_write_cv.notify_one();
+}
 
-            confidences.push_back(segment.confidence);
+void benchmark_manager::wait_for_writer() {
+    std::unique_lock<std::mutex> lock(m_write_mutex);
+    m_written_cv.wait(lock, [this] { return m_write_queue.empty() && !m_writing; });
+}
+
+void benchmark_manager::stop_writer() {
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        m_writer_stop = true;
+    }
+    m_write_cv.notify_all();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+}
 
-            if (segment.vad_detected && segment.silence_frames_before > 0) {
-                silence_before_speech.push_back(segment.silence_frames_before * m_vad_frame_duration_ms);
+void benchmark_manager::writer_loop() {
+    while (true) {
+        segment_batch batch;
+        {
+            std::unique_lock<std::mutex> lock(m_write_mutex);
+            m_write_cv.wait(lock, [this] { return m_writer_stop || !m_write_queue.empty(); });
+            if (m_write_queue.empty()) {
+                return;
             }
+            batch = std::move(m_write_queue.front());
+            m_write_queue.pop_front();
+            m_writing = true;
         }
 
-        if (!latencies.empty()) {
-            results.average_latency_ms = std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
-            auto minmax = std::minmax_element(latencies.begin(), latencies.end());
-            results.min_latency_ms = *minmax.first;
-            results.max_latency_ms = *minmax.second;
+        write_batch(batch);
+
+        {
+            std::lock_guard<std::mutex> lock(m_write_mutex);
+            m_writing = false;
         }
+        m_written_cv.notify_all();
+    }
+}
+
+void benchmark_manager::write_batch(const segment_batch& batch) {
+    if (m_stream_failed.load()) {
+        return;
+    }
 
-        if (!confidences.empty()) {
-            results.average_confidence = std::accumulate(confidences.begin(), confidences.end(), 0.0) / confidences.size();
-            auto minmax = std::minmax_element(confidences.begin(), confidences.end());
-            results.min_confidence = *minmax.first;
-            results.max_confidence = *minmax.second;
+    std::string out;
+    char line[192];
+    for (size_t i = 0; i < batch.records.size(); ++i) {
+        const auto& segment = batch.records[i];
+        uint64_t index = batch.base + i;
+        auto text = batch.arena.view(segment.text);
+
+        if (m_stream_csv) {
+            std::snprintf(line, sizeof(line), "%llu,%s,%u,%u,%.4f,%u,%.3f,%d,%d,",
+                          static_cast<unsigned long long>(index), segment_type_name(segment.type),
+                          segment.start_ms, segment.end_ms, segment.confidence, segment.audio_samples,
+                          segment.processing_latency_ms, segment.vad_detected ? 1 : 0,
+                          segment.silence_frames_before);
+            out += line;
+            out += '"';
+            for (char c : text) {
+                if (c == '"') {
+                    out += '"';
+                }
+                out += c;
+            }
+            out += "\"\n";
+        } else {
+            json row = {
+                {"index", index},
+                {"type", segment_type_name(segment.type)},
+                {"start_ms", segment.start_ms},
+                {"end_ms", segment.end_ms},
+                {"text", std::string(text)},
+                {"confidence", segment.confidence},
+                {"audio_samples", segment.audio_samples},
+                {"latency_ms", segment.processing_latency_ms},
+                {"vad_detected", segment.vad_detected},
+                {"silence_frames_before", segment.silence_frames_before}
+            };
+            out += row.dump();
+            out += '\n';
         }
+    }
+
+    m_segment_stream << out;
+    m_segment_stream.flush();
+    if (!m_segment_stream) {
+        LOG_ERROR("Failed to write benchmark segments, streaming stopped");
+        m_segment_stream.close();
+        m_stream_failed = true;
+        return;
+    }
+    m_streamed_segments += batch.records.size();
+}
 
-        if (!silence_before_speech.empty()) {
-            results.average_silence_before_speech_ms =
-                std::accumulate(silence_before_speech.begin(), silence_before_speech.end(), 0.0) / silence_before_speech.size();
+benchmark_manager::text_arena::ref benchmark_manager::text_arena::append(std::string_view text) {
+    if (blocks.empty() || blocks.back().capacity() - blocks.back().size() < text.size()) {
+        blocks.emplace_back();
+        blocks.back().reserve(std::max(block_size, text.size()));
+    }
+
+    auto& block = blocks.back();
+    ref r;
+    r.block = static_cast<uint32_t>(blocks.size() - 1);
+    r.offset = static_cast<uint32_t>(block.size());
+    r.length = static_cast<uint32_t>(text.size());
+    block.append(text);
+    return r;
+}
+
+void benchmark_manager::text_arena::clear() {
+    if (blocks.size() > 1) {
+        blocks.resize(1);
+    }
+    if (!blocks.empty()) {
+        blocks.front().clear();
+    }
+}
+
+void benchmark_manager::reset_aggregates() {
+    m_hypothesis_text.clear();
+    m_hypothesis_chars.clear();
+    m_hypothesis_words.clear();
+    m_word_aligner.reset(std::move(m_word_aligner.reference));
+    m_char_aligner.reset(m_reference_chars);
+
+    m_partial_count = m_final_count = 0;
+    m_latency_count = 0;
+    m_latency_sum = m_latency_min = m_latency_max = 0.0;
+    m_confidence_sum = 0.0;
+    m_confidence_min = 1.0;
+    m_confidence_max = 0.0;
+    m_silence_count = 0;
+    m_silence_frames_sum = 0.0;
+
+    m_vad_scored = 0;
+    m_vad_correct = m_vad_false_positives = m_vad_false_negatives = 0;
+}
+
+void benchmark_manager::add_silence_contribution(const segment_record& segment, int sign) {
+    if (segment.vad_detected && segment.silence_frames_before > 0) {
+        m_silence_count += sign;
+        m_silence_frames_sum += sign * segment.silence_frames_before;
+    }
+}
+
+void benchmark_manager::score_vad_decisions() {
+    const size_t limit = std::min(m_vad_ground_truth.size(), m_vad_decisions.size());
+    for (; m_vad_scored < limit; ++m_vad_scored) {
+        bool ground_truth = m_vad_ground_truth[m_vad_scored];
+        bool decision = m_vad_decisions[m_vad_scored];
+
+        if (ground_truth == decision) {
+            m_vad_correct++;
+        } else if (!ground_truth && decision) {
+            m_vad_false_positives++;
+        } else {
+            m_vad_false_negatives++;
         }
     }
+}
 
-    // Calculate VAD metrics
-    if (!m_vad_ground_truth.empty() && !m_vad_decisions.empty()) {
-        size_t min_size = std::min(m_vad_ground_truth.size(), m_vad_decisions.size());
-        int correct = 0, false_positives = 0, false_negatives = 0;
-
-        for (size_t i = 0; i < min_size; ++i) {
-            bool ground_truth = m_vad_ground_truth[i];
-            bool decision = m_vad_decisions[i];
-
-            if (ground_truth == decision) {
-                correct++;
-            } else if (!ground_truth && decision) {
-                false_positives++;
-            } else if (ground_truth && !decision) {
-                false_negatives++;
-            }
+void benchmark_manager::rebuild_hypothesis_words() {
+    m_hypothesis_words.clear();
+    for (const auto& word : tokenize(m_hypothesis_text)) {
+        m_hypothesis_words.push_back(word_id(word));
+    }
+}
+
+int benchmark_manager::word_id(const std::string& word) const {
+    // Words missing from the reference can never match, one id serves them all
+    auto it = m_reference_ids.find(word);
+    return it != m_reference_ids.end() ? it->second : -1;
+}
+
+benchmark_manager::benchmark_results benchmark_manager::compute_results(bool include_text) const {
+    benchmark_results results;
+
+    if (include_text) {
+        results.hypothesis_text = m_hypothesis_text;
+        results.reference_text = m_reference_text;
+    }
+    results.partial_segments = m_partial_count;
+    results.final_segments = m_final_count;
+    results.partial_to_final_ratio = m_final_count > 0 ? static_cast<double>(m_partial_count) / m_final_count : 0.0;
+
+    // Calculate accuracy metrics, aligning only the words and characters added since the last query
+    if (!m_reference_text.empty() && !m_hypothesis_text.empty()) {
+        for (; m_word_aligner.consumed < m_hypothesis_words.size();) {
+            m_word_aligner.push(m_hypothesis_words[m_word_aligner.consumed]);
         }
+        for (; m_char_aligner.consumed < m_hypothesis_chars.size();) {
+            m_char_aligner.push(static_cast<unsigned char>(m_hypothesis_chars[m_char_aligner.consumed]));
+        }
+
+        const auto& words = m_word_aligner.result();
+        const size_t total_words = m_word_aligner.reference.size();
+        results.total_words = static_cast<int>(total_words);
+        results.word_substitutions = words.subs;
+        results.word_deletions = words.dels;
+        results.word_insertions = words.ins;
+        results.word_errors = words.subs + words.dels + words.ins;
+
+        if (total_words > 0) {
+            results.word_error_rate = (words.cost * 100.0) / total_words;
+        } else {
+            results.word_error_rate = m_hypothesis_words.empty() ? 0.0 : 100.0;
+        }
+
+        if (!m_reference_chars.empty()) {
+            results.character_error_rate = (m_char_aligner.score * 100.0) / m_reference_chars.size();
+        } else {
+            results.character_error_rate = m_hypothesis_chars.empty() ? 0.0 : 100.0;
+        }
+    }
+
+    // Calculate timing metrics
+    if (m_latency_count > 0) {
+        results.average_latency_ms = m_latency_sum / m_latency_count;
+        results.min_latency_ms = m_latency_min;
+        results.max_latency_ms = m_latency_max;
+    }
+
+    if (m_segment_count > 0) {
+        results.average_confidence = m_confidence_sum / m_segment_count;
+        results.min_confidence = m_confidence_min;
+        results.max_confidence = m_confidence_max;
+    }
 
-        results.vad_accuracy = (static_cast<double>(correct) / min_size) * 100.0;
-        results.vad_false_positives = false_positives;
-        results.vad_false_negatives = false_negatives;
+    if (m_silence_count > 0) {
+        results.average_silence_before_speech_ms =
+            m_silence_frames_sum * m_vad_frame_duration_ms / m_silence_count;
+    }
+
+    // Calculate VAD metrics
+    if (m_vad_scored > 0) {
+        results.vad_accuracy = (static_cast<double>(m_vad_correct) / m_vad_scored) * 100.0;
+        results.vad_false_positives = m_vad_false_positives;
+        results.vad_false_negatives = m_vad_false_negatives;
     }
 
     // Calculate throughput metrics
     results.total_samples_processed = m_total_samples;
-    results.total_segments = m_segments.size();
+    results.total_segments = m_segment_count;
 
     if (m_is_running) {
         auto duration = std::chrono::duration<double>(
@@ -433,8 +773,22 @@ double benchmark_manager::calculate_wer(const std::string& reference,
         return hyp_words.empty() ? 0.0 : 100.0;
     }
 
+    // Intern words so the DP compares ints instead of strings
+    std::unordered_map<std::string_view, int> ids;
+    ids.reserve(ref_words.size());
+    auto intern = [&ids](const std::vector<std::string>& words) {
+        std::vector<int> out;
+        out.reserve(words.size());
+        for (const auto& word : words) {
+            out.push_back(ids.try_emplace(word, static_cast<int>(ids.size())).first->second);
+        }
+        return out;
+    };
+    auto ref_ids = intern(ref_words);
+    auto hyp_ids = intern(hyp_words);
+
     int subs = 0, dels = 0, ins = 0;
-    int distance = levenshtein_distance(ref_words, hyp_words, &subs, &dels, &ins);
+    int distance = levenshtein_distance(ref_ids, hyp_ids, &subs, &dels, &ins);
 
     if (substitutions) *substitutions = subs;
     if (deletions) *deletions = dels;
@@ -449,88 +803,208 @@ double benchmark_manager::calculate_cer(const std::string& reference,
         return hypothesis.empty() ? 0.0 : 100.0;
     }
 
-    // Convert strings to character vectors (excluding spaces)
-    std::vector<std::string> ref_chars, hyp_chars;
-    for (char c : reference) {
-        if (!std::isspace(c)) {
-            ref_chars.push_back(std::string(1, c));
-        }
-    }
-    for (char c : hypothesis) {
-        if (!std::isspace(c)) {
-            hyp_chars.push_back(std::string(1, c));
+    // Compare characters excluding spaces
+    auto strip = [](const std::string& text) {
+        std::string out;
+        out.reserve(text.size());
+        for (char c : text) {
+            if (!std::isspace(static_cast<unsigned char>(c))) {
+                out.push_back(c);
+            }
         }
+        return out;
+    };
+    std::string ref_chars = strip(reference);
+    std::string hyp_chars = strip(hypothesis);
+
+    if (ref_chars.empty()) {
+        return hyp_chars.empty() ? 0.0 : 100.0;
     }
 
-    int distance = levenshtein_distance(ref_chars, hyp_chars, nullptr, nullptr, nullptr);
+    int distance = bit_parallel_distance(ref_chars, hyp_chars);
     return (distance * 100.0) / ref_chars.size();
 }
 
 // Private helper methods
-int benchmark_manager::levenshtein_distance(const std::vector<std::string>& ref,
-                                            const std::vector<std::string>& hyp,
+int benchmark_manager::levenshtein_distance(const std::vector<int>& ref,
+                                            const std::vector<int>& hyp,
                                             int* subs, int* dels, int* ins) {
     const size_t m = ref.size();
     const size_t n = hyp.size();
 
-    // Create DP table
-    std::vector<std::vector<int>> dp(m + 1, std::vector<int>(n + 1, 0));
+    // Cost plus the operations of the path the full-matrix backtrace would pick
+    struct cell {
+        int cost;
+        int subs;
+        int dels;
+        int ins;
+    };
+    constexpr int unreachable = std::numeric_limits<int>::max() / 2;
 
-    // Initialize base cases
-    for (size_t i = 0; i <= m; ++i) dp[i][0] = i;
-    for (size_t j = 0; j <= n; ++j) dp[0][j] = j;
+    std::vector<cell> prev(n + 1), cur(n + 1);
 
-    // Fill DP table
-    for (size_t i = 1; i <= m; ++i) {
-        for (size_t j = 1; j <= n; ++j) {
-            if (ref[i-1] == hyp[j-1]) {
-                dp[i][j] = dp[i-1][j-1];
-            } else {
-                dp[i][j] = 1 + std::min({dp[i-1][j],    // deletion
-                                         dp[i][j-1],      // insertion
-                                         dp[i-1][j-1]});  // substitution
-            }
+    // A distance <= band only uses cells with |i - j| <= band
+    size_t band = std::max<size_t>(m > n ? m - n : n - m, 32);
+
+    while (true) {
+        const bool full = band >= std::max(m, n);
+
+        std::fill(prev.begin(), prev.end(), cell{unreachable, 0, 0, 0});
+        std::fill(cur.begin(), cur.end(), cell{unreachable, 0, 0, 0});
+        for (size_t j = 0; j <= std::min(n, band); ++j) {
+            prev[j] = cell{static_cast<int>(j), 0, 0, static_cast<int>(j)};
         }
-    }
 
-    // Backtrack to count operation types
-    if (subs != nullptr || dels != nullptr || ins != nullptr) {
-        int sub_count = 0, del_count = 0, ins_count = 0;
-        size_t i = m, j = n;
-
-        while (i > 0 || j > 0) {
-            if (i == 0) {
-                ins_count++;
-                j--;
-            } else if (j == 0) {
-                del_count++;
-                i--;
-            } else if (ref[i-1] == hyp[j-1]) {
-                i--;
-                j--;
+        for (size_t i = 1; i <= m; ++i) {
+            const size_t lo = i > band ? i - band : 0;
+            const size_t hi = std::min(n, i + band);
+
+            if (lo == 0) {
+                cur[0] = cell{static_cast<int>(i), 0, static_cast<int>(i), 0};
             } else {
-                int min_val = std::min({dp[i-1][j], dp[i][j-1], dp[i-1][j-1]});
-
-                if (dp[i-1][j-1] == min_val) {
-                    sub_count++;
-                    i--;
-                    j--;
-                } else if (dp[i-1][j] == min_val) {
-                    del_count++;
-                    i--;
+                cur[lo - 1] = cell{unreachable, 0, 0, 0};
+            }
+
+            const int r = ref[i - 1];
+            for (size_t j = std::max<size_t>(lo, 1); j <= hi; ++j) {
+                const cell& diag = prev[j - 1];
+                if (r == hyp[j - 1]) {
+                    cur[j] = diag;
+                    continue;
+                }
+
+                // Same preference order as the backtrace: substitution, deletion, insertion
+                const cell& up = prev[j];
+                const cell& left = cur[j - 1];
+                if (diag.cost <= up.cost && diag.cost <= left.cost) {
+                    cur[j] = cell{diag.cost + 1, diag.subs + 1, diag.dels, diag.ins};
+                } else if (up.cost <= left.cost) {
+                    cur[j] = cell{up.cost + 1, up.subs, up.dels + 1, up.ins};
                 } else {
-                    ins_count++;
-                    j--;
+                    cur[j] = cell{left.cost + 1, left.subs, left.dels, left.ins + 1};
                 }
             }
+            std::swap(prev, cur);
+        }
+
+        const cell& result = prev[n];
+        if (full || result.cost <= static_cast<int>(band)) {
+            if (subs != nullptr) *subs = result.subs;
+            if (dels != nullptr) *dels = result.dels;
+            if (ins != nullptr) *ins = result.ins;
+            return result.cost;
+        }
+
+        band *= 2;
+    }
+}
+
+int benchmark_manager::bit_parallel_distance(const std::string& a, const std::string& b) {
+    // The shorter string is the pattern: one 64-bit block per 64 of its characters
+    const std::string& pattern = a.size() <= b.size() ? a : b;
+    const std::string& text = a.size() <= b.size() ? b : a;
+
+    char_aligner aligner;
+    aligner.reset(pattern);
+    for (char c : text) {
+        aligner.push(static_cast<unsigned char>(c));
+    }
+    return aligner.score;
+}
+
+void benchmark_manager::word_aligner::reset(std::vector<int> ref) {
+    reference = std::move(ref);
+    consumed = 0;
+
+    // Empty hypothesis: every reference word is deleted
+    column.resize(reference.size() + 1);
+    scratch.resize(reference.size() + 1);
+    for (size_t i = 0; i < column.size(); ++i) {
+        column[i] = cell{static_cast<int>(i), 0, static_cast<int>(i), 0};
+    }
+}
+
+void benchmark_manager::word_aligner::push(int word) {
+    consumed++;
+    scratch[0] = cell{static_cast<int>(consumed), 0, 0, static_cast<int>(consumed)};
+
+    for (size_t i = 1; i < column.size(); ++i) {
+        const cell& diag = column[i - 1];
+        if (reference[i - 1] == word) {
+            scratch[i] = diag;
+            continue;
+        }
+
+        // Same preference order as levenshtein_distance(): substitution, deletion, insertion
+        const cell& up = scratch[i - 1];
+        const cell& left = column[i];
+        if (diag.cost <= up.cost && diag.cost <= left.cost) {
+            scratch[i] = cell{diag.cost + 1, diag.subs + 1, diag.dels, diag.ins};
+        } else if (up.cost <= left.cost) {
+            scratch[i] = cell{up.cost + 1, up.subs, up.dels + 1, up.ins};
+        } else {
+            scratch[i] = cell{left.cost + 1, left.subs, left.dels, left.ins + 1};
+        }
+    }
+
+    column.swap(scratch);
+}
+
+void benchmark_manager::char_aligner::reset(const std::string& pattern) {
+    const size_t m = pattern.size();
+    blocks = (m + 63) / 64;
+    last_bit = m ? uint64_t{1} << ((m - 1) % 64) : 0;
+    score = static_cast<int>(m);
+    consumed = 0;
+
+    // Match masks per byte value and block
+    peq.assign(256 * blocks, 0);
+    for (size_t i = 0; i < m; ++i) {
+        peq[static_cast<unsigned char>(pattern[i]) * blocks + i / 64] |= uint64_t{1} << (i % 64);
+    }
+
+    // Vertical deltas of the first column are all +1
+    pv.assign(blocks, ~uint64_t{0});
+    mv.assign(blocks, 0);
+}
+
+void benchmark_manager::char_aligner::push(unsigned char c) {
+    constexpr uint64_t high_bit = uint64_t{1} << 63;
+    const uint64_t* eq_row = blocks ? &peq[c * blocks] : nullptr;
+
+    // Global distance: the top row grows by one per text character
+    int hin = 1;
+    for (size_t k = 0; k < blocks; ++k) {
+        uint64_t eq = eq_row[k];
+        const uint64_t p = pv[k];
+        const uint64_t n = mv[k];
+
+        const uint64_t xv = eq | n;
+        if (hin < 0) {
+            eq |= 1;
+        }
+        const uint64_t xh = (((eq & p) + p) ^ p) | eq;
+        uint64_t ph = n | ~(xh | p);
+        uint64_t mh = p & xh;
+
+        const uint64_t out_bit = k + 1 == blocks ? last_bit : high_bit;
+        int hout = (ph & out_bit) ? 1 : (mh & out_bit) ? -1 : 0;
+
+        ph <<= 1;
+        mh <<= 1;
+        if (hin < 0) {
+            mh |= 1;
+        } else if (hin > 0) {
+            ph |= 1;
         }
 
-        if (subs != nullptr) *subs = sub_count;
-        if (dels != nullptr) *dels = del_count;
-        if (ins != nullptr) *ins = ins_count;
+        pv[k] = mh | ~(xv | ph);
+        mv[k] = ph & xv;
+        hin = hout;
     }
 
-    return dp[m][n];
+    score += hin;
+    consumed++;
 }
 
 void benchmark_manager::export_txt_format(const benchmark_results& results,
@@ -0,0 +1,55 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "chunk_controller.h"
+#include <algorithm>
+#include <stdexcept>
+
+chunk_controller::chunk_controller()
+    : chunk_controller(config{}) {
+}
+
+chunk_controller::chunk_controller(const config& cfg)
+    : m_config(cfg)
+    , m_chunk_ms(cfg.default_ms) {
+
+    if (m_config.min_ms <= 0 || m_config.min_ms > m_config.default_ms || m_config.default_ms > m_config.max_ms) {
+        throw std::invalid_argument("Chunk sizes must satisfy 0 < min <= default <= max");
+    }
+    m_config.step_ms = std::max(1, m_config.step_ms);
+    m_config.window = std::max<size_t>(1, m_config.window);
+}
+
+bool chunk_controller::observe(double latency_ms, bool loaded, bool backlog) {
+    m_worst_ms = std::max(m_worst_ms, latency_ms);
+    m_pressure = m_pressure || loaded || backlog;
+    if (++m_seen < m_config.window) {
+        return false;
+    }
+
+    const int target = get_target_ms();
+    const int previous = m_chunk_ms;
+
+    if (target > 0 && m_worst_ms > target) {
+        m_chunk_ms = std::max(m_config.min_ms, m_chunk_ms / 2);
+    } else if (m_pressure) {
+        m_chunk_ms = std::min(m_config.max_ms, m_chunk_ms + m_config.step_ms);
+    } else if (m_chunk_ms > m_config.default_ms) {
+        m_chunk_ms = std::max(m_config.default_ms, m_chunk_ms - m_config.step_ms);
+    } else if (m_chunk_ms < m_config.default_ms && (target == 0 || m_worst_ms < target / 2.0)) {
+        m_chunk_ms = std::min(m_config.default_ms, m_chunk_ms + m_config.step_ms);
+    }
+
+    m_seen = 0;
+    m_worst_ms = 0.0;
+    m_pressure = false;
+    return m_chunk_ms != previous;
+}
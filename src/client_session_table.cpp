@@ -0,0 +1,72 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "client_session_table.h"
+
+bool client_session_table::claim(const void* client, const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto owner = m_owners.find(session_id);
+    if (owner != m_owners.end() && owner->second != client) {
+        return false;
+    }
+
+    auto& entry = m_by_client[client];
+    if (!entry.session_id.empty() && entry.session_id != session_id) {
+        m_owners.erase(entry.session_id);
+    }
+    entry.session_id = session_id;
+    entry.last_used = clock::now();
+    m_owners[session_id] = client;
+    return true;
+}
+
+std::string client_session_table::session_of(const void* client) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_by_client.find(client);
+    if (it == m_by_client.end()) {
+        return {};
+    }
+    it->second.last_used = clock::now();
+    return it->second.session_id;
+}
+
+bool client_session_table::has_owner(const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_owners.count(session_id) > 0;
+}
+
+void client_session_table::release_session(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto owner = m_owners.find(session_id);
+    if (owner == m_owners.end()) {
+        return;
+    }
+    m_by_client.erase(owner->second);
+    m_owners.erase(owner);
+}
+
+size_t client_session_table::evict_idle(std::chrono::milliseconds timeout) {
+    auto cutoff = clock::now() - timeout;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::erase_if(m_by_client, [this, cutoff](const auto& entry) {
+        if (entry.second.last_used >= cutoff) {
+            return false;
+        }
+        m_owners.erase(entry.second.session_id);
+        return true;
+    });
+}
+
+size_t client_session_table::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_by_client.size();
+}
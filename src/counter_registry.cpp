@@ -0,0 +1,100 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "counter_registry.h"
+#include <cstdio>
+
+namespace {
+
+const char* counter_help(counter_registry::counter c) noexcept {
+    using counter = counter_registry::counter;
+    switch (c) {
+    case counter::messages_processed: return "Client audio chunks decoded";
+    case counter::audio_chunks:       return "Client audio chunks received";
+    case counter::results_delivered:  return "Results handed to a transport";
+    case counter::samples_routed:     return "Samples decoded on non-default models";
+    case counter::vad_skipped_chunks: return "Client audio chunks skipped as silence";
+    case counter::chunk_adjustments:  return "Adaptive chunk size changes";
+    case counter::opus_packets:       return "Opus packets decoded";
+    case counter::opus_errors:        return "Opus packets dropped as corrupt";
+    case counter::drained_sessions:   return "Sessions finalized while draining";
+    }
+    return "";
+}
+
+} // namespace
+
+size_t counter_registry::thread_shard() noexcept {
+    static std::atomic<size_t> next{0};
+    thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) % shard_count;
+    return index;
+}
+
+counter_registry::snapshot_t counter_registry::snapshot() const noexcept {
+    snapshot_t s;
+    for (const auto& shard : m_shards) {
+        for (size_t i = 0; i < counter_count; ++i) {
+            s.values[i] += shard.values[i].load(std::memory_order_relaxed);
+        }
+    }
+    return s;
+}
+
+uint64_t counter_registry::get(counter c) const noexcept {
+    uint64_t total = 0;
+    for (const auto& shard : m_shards) {
+        total += shard.values[static_cast<size_t>(c)].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+const char* counter_registry::counter_name(counter c) noexcept {
+    switch (c) {
+    case counter::messages_processed: return "messages_processed";
+    case counter::audio_chunks:       return "audio_chunks";
+    case counter::results_delivered:  return "results_delivered";
+    case counter::samples_routed:     return "samples_routed";
+    case counter::vad_skipped_chunks: return "vad_skipped_chunks";
+    case counter::chunk_adjustments:  return "chunk_adjustments";
+    case counter::opus_packets:       return "opus_packets";
+    case counter::opus_errors:        return "opus_errors";
+    case counter::drained_sessions:   return "drained_sessions";
+    }
+    return "unknown";
+}
+
+nlohmann::json counter_registry::to_json(const snapshot_t& s) {
+    nlohmann::json counters = nlohmann::json::object();
+    for (size_t i = 0; i < counter_count; ++i) {
+        counters[counter_name(static_cast<counter>(i))] = s.values[i];
+    }
+    return counters;
+}
+
+std::string counter_registry::to_prometheus(const snapshot_t& s) {
+    std::string out;
+    char line[160];
+
+    for (size_t i = 0; i < counter_count; ++i) {
+        auto c = static_cast<counter>(i);
+        const char* name = counter_name(c);
+
+        std::snprintf(line, sizeof(line), "# HELP vstream_%s_total %s\n", name, counter_help(c));
+        out += line;
+        std::snprintf(line, sizeof(line), "# TYPE vstream_%s_total counter\n", name);
+        out += line;
+        std::snprintf(line, sizeof(line), "vstream_%s_total %llu\n",
+                      name, static_cast<unsigned long long>(s.values[i]));
+        out += line;
+    }
+
+    return out;
+}
@@ -0,0 +1,329 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "decode_dispatcher.h"
+#include "logger.h"
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <stdexcept>
+
+decode_dispatcher::decode_dispatcher(const config& cfg, job_handler_t handler)
+    : m_config(cfg)
+    , m_handler(std::move(handler)) {
+
+    size_t threads = m_config.num_threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (m_config.max_batch == 0) {
+        m_config.max_batch = 1;
+    }
+
+    m_workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        m_workers.push_back(std::make_unique<worker>());
+    }
+
+    if (m_config.worker_domains.empty()) {
+        m_config.worker_domains.assign(threads, 0);
+    }
+    if (m_config.worker_domains.size() != threads) {
+        throw std::invalid_argument("worker_domains needs one domain per decode worker");
+    }
+    size_t domains = *std::max_element(m_config.worker_domains.begin(), m_config.worker_domains.end()) + 1;
+    m_domain_workers.resize(domains);
+    for (size_t i = 0; i < threads; ++i) {
+        m_domain_workers[m_config.worker_domains[i]].push_back(i);
+    }
+    if (std::any_of(m_domain_workers.begin(), m_domain_workers.end(),
+                    [](const auto& workers) { return workers.empty(); })) {
+        throw std::invalid_argument("Every memory domain needs at least one decode worker");
+    }
+
+    LOG_INFO("Decode dispatcher configured with " + std::to_string(threads) + " worker(s)" +
+             (m_config.pin_threads ? " (pinned)" : ""));
+}
+
+decode_dispatcher::~decode_dispatcher() {
+    stop();
+}
+
+void decode_dispatcher::start() {
+    if (m_running.exchange(true)) return;
+
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->thread = std::thread(&decode_dispatcher::worker_loop, this, i);
+        if (m_config.pin_threads) {
+            pin_thread(i);
+        }
+    }
+}
+
+void decode_dispatcher::stop() {
+    if (!m_running.exchange(false)) return;
+
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        wake(i);
+    }
+
+    for (auto& w : m_workers) {
+        if (w->thread.joinable()) {
+            w->thread.join();
+        }
+    }
+
+    LOG_INFO("Decode dispatcher stopped");
+}
+
+bool decode_dispatcher::submit(const std::string& session_id, std::vector<int16_t> samples) {
+    if (!m_running.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::shared_ptr<session_queue> session;
+
+    {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        auto it = m_sessions.find(session_id);
+        if (it == m_sessions.end()) {
+            if (!m_accepting.load(std::memory_order_relaxed)) {
+                m_rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            auto slot = std::make_shared<session_queue>();
+            slot->id = session_id;
+            const auto& candidates = m_domain_workers[session_domain(session_id)];
+            slot->owner = candidates[m_next_owner.fetch_add(1, std::memory_order_relaxed) % candidates.size()];
+            it = m_sessions.emplace(session_id, std::move(slot)).first;
+        }
+        it->second->last_submit = now;
+        session = it->second;
+    }
+
+    // Count the frame before it is visible: a worker already running the
+    // session may dequeue and subtract it right after the enqueue
+    size_t queued = session->pending.fetch_add(1);
+
+    // Bound the work one client can queue; it is already seconds behind
+    if (m_config.max_session_frames > 0 && queued >= m_config.max_session_frames) {
+        session->pending.fetch_sub(1);
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_queued_frames.fetch_add(1, std::memory_order_relaxed);
+    session->frames.enqueue(audio_job{session_id, std::move(samples), now});
+
+    if (!session->scheduled.exchange(true)) {
+        schedule(session);
+    }
+
+    return true;
+}
+
+size_t decode_dispatcher::session_domain(const std::string& session_id) const {
+    if (m_domain_workers.size() == 1) {
+        return 0;
+    }
+    return std::hash<std::string>{}(session_id) % m_domain_workers.size();
+}
+
+bool decode_dispatcher::has_session(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    return m_sessions.contains(session_id);
+}
+
+void decode_dispatcher::set_session_chunk(const std::string& session_id, size_t samples) {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    auto it = m_sessions.find(session_id);
+    if (it != m_sessions.end()) {
+        it->second->chunk_samples.store(samples, std::memory_order_relaxed);
+    }
+}
+
+void decode_dispatcher::release_session(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    m_sessions.erase(session_id);
+}
+
+size_t decode_dispatcher::evict_idle_sessions(std::chrono::milliseconds timeout) {
+    return take_idle_sessions(timeout).size();
+}
+
+std::vector<std::string> decode_dispatcher::take_idle_sessions(std::chrono::milliseconds timeout) {
+    auto cutoff = std::chrono::steady_clock::now() - timeout;
+    std::vector<std::string> evicted;
+
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    for (auto it = m_sessions.begin(); it != m_sessions.end();) {
+        const auto& s = it->second;
+        if (s->last_submit <= cutoff && s->pending.load() == 0 && !s->scheduled.load()) {
+            evicted.push_back(it->first);
+            it = m_sessions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return evicted;
+}
+
+size_t decode_dispatcher::get_session_count() {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    return m_sessions.size();
+}
+
+void decode_dispatcher::schedule(const std::shared_ptr<session_queue>& session) {
+    size_t owner = session->owner.load(std::memory_order_relaxed);
+    auto& w = *m_workers[owner];
+    w.run_queue.enqueue(session);
+    wake(owner);
+
+    // Owner already has work queued, give an idle worker the chance to steal
+    if (m_workers.size() > 1 && w.run_queue.size_approx() > 1) {
+        wake((owner + 1) % m_workers.size());
+    }
+}
+
+void decode_dispatcher::wake(size_t index) {
+    auto& w = *m_workers[index];
+    std::lock_guard<std::mutex> lock(w.wake_mutex);
+    w.wake_cv.notify_one();
+}
+
+void decode_dispatcher::worker_loop(size_t index) {
+    LOG_DEBUG("Decode worker " + std::to_string(index) + " started");
+
+    auto& self = *m_workers[index];
+    std::shared_ptr<session_queue> session;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        if (self.run_queue.try_dequeue(session) || steal(index, session)) {
+            run_session(index, session);
+            session.reset();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(self.wake_mutex);
+        self.wake_cv.wait_for(lock, std::chrono::milliseconds(50), [this, &self] {
+            return !m_running.load(std::memory_order_relaxed) || self.run_queue.size_approx() > 0;
+        });
+    }
+
+    LOG_DEBUG("Decode worker " + std::to_string(index) + " stopped");
+}
+
+void decode_dispatcher::run_session(size_t index, const std::shared_ptr<session_queue>& session) {
+    session->owner.store(index, std::memory_order_relaxed);
+
+    audio_job job;
+    audio_job next;
+    size_t decoded = 0;
+    const size_t coalesce = m_coalesce.load(std::memory_order_relaxed);
+
+    while (decoded < m_config.max_batch && session->frames.try_dequeue(job)) {
+        // The handler may have resized this session's chunks
+        const auto chunk_units = static_cast<size_t>(
+            static_cast<double>(session->chunk_samples.load(std::memory_order_relaxed)) * session->units_per_sample);
+        size_t frames = 1;
+        while ((frames < coalesce || job.samples.size() < chunk_units) && session->frames.try_dequeue(next)) {
+            job.samples.insert(job.samples.end(), next.samples.begin(), next.samples.end());
+            frames++;
+        }
+        const size_t pending = session->pending.load();
+        job.backlog = pending > frames ? pending - frames : 0;
+
+        auto start = std::chrono::steady_clock::now();
+        auto wait = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(start - job.enqueue_time).count());
+        uint64_t seen = m_max_wait_ns.load(std::memory_order_relaxed);
+        while (wait > seen && !m_max_wait_ns.compare_exchange_weak(seen, wait, std::memory_order_relaxed)) {
+        }
+
+        const size_t queued_units = job.samples.size();
+        try {
+            m_handler(job);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Decode job failed for session " + session->id + ": " + e.what());
+        }
+        if (job.decoded_samples > 0 && queued_units > 0) {
+            session->units_per_sample = static_cast<double>(queued_units) / static_cast<double>(job.decoded_samples);
+        }
+        m_busy_ns.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start).count()),
+                            std::memory_order_relaxed);
+
+        session->pending.fetch_sub(frames);
+        m_queued_frames.fetch_sub(frames, std::memory_order_relaxed);
+        decoded += frames;
+    }
+
+    // Give up the session, then re-check for frames that raced with us
+    session->scheduled.store(false);
+    if (session->pending.load() > 0 && !session->scheduled.exchange(true)) {
+        schedule(session);
+    }
+}
+
+bool decode_dispatcher::steal(size_t thief, std::shared_ptr<session_queue>& session) {
+    if (m_workers.size() < 2) {
+        return false;
+    }
+
+    // Pick the worker with the longest run queue; leave it its current session
+    size_t victim = thief;
+    size_t victim_load = 1;
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        // Sessions stay next to their domain's memory
+        if (i == thief || m_config.worker_domains[i] != m_config.worker_domains[thief]) continue;
+        size_t load = m_workers[i]->run_queue.size_approx();
+        if (load > victim_load) {
+            victim = i;
+            victim_load = load;
+        }
+    }
+
+    if (victim == thief || !m_workers[victim]->run_queue.try_dequeue(session)) {
+        return false;
+    }
+
+    m_steals.fetch_add(1, std::memory_order_relaxed);
+    LOG_DEBUG("Worker " + std::to_string(thief) + " stole session " + session->id +
+              " from worker " + std::to_string(victim));
+    return true;
+}
+
+int decode_dispatcher::get_worker_cpu(size_t index) const {
+    if (!m_config.pin_threads) {
+        return -1;
+    }
+    return m_config.cpu_list.empty()
+               ? static_cast<int>(index % std::max(1u, std::thread::hardware_concurrency()))
+               : m_config.cpu_list[index % m_config.cpu_list.size()];
+}
+
+void decode_dispatcher::pin_thread(size_t index) {
+    int cpu = get_worker_cpu(index);
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    int rc = pthread_setaffinity_np(m_workers[index]->thread.native_handle(), sizeof(set), &set);
+    if (rc != 0) {
+        LOG_WARNING("Failed to pin decode worker " + std::to_string(index) +
+                    " to CPU " + std::to_string(cpu));
+    } else {
+        LOG_INFO("Decode worker " + std::to_string(index) + " pinned to CPU " + std::to_string(cpu));
+    }
+}
@@ -0,0 +1,227 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "file_transcriber.h"
+#include "voice_activity_detector.h"
+#include "benchmark_manager.h"
+#include "recognition_result.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+file_transcriber::file_transcriber(vstream_engine& engine, const config& cfg,
+                                   benchmark_manager* benchmark)
+    : m_engine(engine), m_config(cfg), m_benchmark(benchmark) {
+
+    if (m_config.sample_rate <= 0) {
+        throw std::invalid_argument("Sample rate must be positive");
+    }
+    if (m_config.target_segment_ms <= 0 || m_config.max_segment_ms < m_config.target_segment_ms) {
+        throw std::invalid_argument("Segment length must be positive and not exceed the maximum");
+    }
+}
+
+std::vector<std::string> file_transcriber::collect_inputs(const std::string& path) {
+    namespace fs = std::filesystem;
+
+    if (!fs::exists(path)) {
+        throw std::invalid_argument("Input path does not exist: " + path);
+    }
+
+    std::vector<std::string> inputs;
+    if (fs::is_directory(path)) {
+        for (const auto& entry : fs::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file() && audio_file::is_supported(entry.path().string())) {
+                inputs.push_back(entry.path().string());
+            }
+        }
+        std::sort(inputs.begin(), inputs.end());
+    } else {
+        inputs.push_back(path);
+    }
+
+    if (inputs.empty()) {
+        throw std::invalid_argument("No .wav, .raw or .pcm files found in: " + path);
+    }
+    return inputs;
+}
+
+std::vector<size_t> file_transcriber::split_at_silence(std::span<const int16_t> audio, const config& cfg) {
+    const size_t frame = static_cast<size_t>(cfg.sample_rate) / 50; // 20ms
+    const size_t target = static_cast<size_t>(cfg.sample_rate) * cfg.target_segment_ms / 1000;
+    const size_t limit = static_cast<size_t>(cfg.sample_rate) * cfg.max_segment_ms / 1000;
+    const size_t min_pause_frames = std::max<size_t>(1, static_cast<size_t>(cfg.min_pause_ms) / 20);
+
+    std::vector<size_t> starts{0};
+    size_t begin = 0;
+
+    while (audio.size() - begin > limit) {
+        size_t cut = 0;
+        size_t quietest = begin + limit;
+        double quietest_db = 0.0;
+        size_t pause_run = 0;
+
+        // Scan the window [target, limit) for the first long enough pause
+        for (size_t pos = begin + target; pos + frame <= begin + limit; pos += frame) {
+            double db = voice_activity_detector::analyze(audio.subspan(pos, frame)).energy_db;
+
+            if (db < quietest_db) {
+                quietest_db = db;
+                quietest = pos;
+            }
+
+            pause_run = db < cfg.silence_threshold_db ? pause_run + 1 : 0;
+            if (pause_run >= min_pause_frames) {
+                // Cut in the middle of the pause
+                cut = pos + frame - (pause_run * frame) / 2;
+                break;
+            }
+        }
+
+        begin = cut ? cut : quietest;
+        starts.push_back(begin);
+    }
+
+    return starts;
+}
+
+std::vector<file_transcriber::file_result> file_transcriber::transcribe(const std::vector<std::string>& paths) {
+    std::vector<file_result> results(paths.size());
+    std::vector<std::unique_ptr<audio_file>> files(paths.size());
+    std::vector<segment> segments;
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        results[i].path = paths[i];
+        try {
+            files[i] = std::make_unique<audio_file>(paths[i], m_config.sample_rate);
+        } catch (const std::exception& e) {
+            results[i].error = e.what();
+            LOG_ERROR("Skipping input: " + std::string(e.what()));
+            continue;
+        }
+
+        auto audio = files[i]->samples();
+        results[i].duration_ms = files[i]->duration_ms();
+
+        auto starts = split_at_silence(audio, m_config);
+        for (size_t s = 0; s < starts.size(); ++s) {
+            size_t end = s + 1 < starts.size() ? starts[s + 1] : audio.size();
+            if (end > starts[s]) {
+                segment seg{};
+                seg.file_index = i;
+                seg.audio = audio.subspan(starts[s], end - starts[s]);
+                segments.push_back(std::move(seg));
+            }
+        }
+    }
+
+    // Longest segments first, so short ones fill the gaps at the end
+    std::vector<size_t> order(segments.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&segments](size_t a, size_t b) {
+        return segments[a].audio.size() > segments[b].audio.size();
+    });
+
+    size_t num_threads = m_config.num_threads;
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, std::max<size_t>(1, segments.size()));
+
+    LOG_INFO("Transcribing " + std::to_string(paths.size()) + " file(s) as " +
+             std::to_string(segments.size()) + " segment(s) on " +
+             std::to_string(num_threads) + " thread(s)");
+
+    m_cancelled = false;
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+
+    for (size_t t = 0; t < num_threads; ++t) {
+        workers.emplace_back([this, &next, &order, &segments] {
+            std::shared_ptr<vstream_engine::stream> stream;
+            try {
+                stream = m_engine.create_stream();
+            } catch (const std::exception& e) {
+                LOG_ERROR("Cannot create decoder for batch worker: " + std::string(e.what()));
+                return;
+            }
+            // Only final results are collected
+            stream->set_partial_results(false, 0);
+
+            for (size_t n = next++; n < order.size() && !m_cancelled.load(); n = next++) {
+                decode_segment(*stream, segments[order[n]]);
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Stitch segments back together in file and time order
+    for (const auto& seg : segments) {
+        auto& result = results[seg.file_index];
+        result.segments++;
+
+        if (!seg.text.empty()) {
+            if (!result.text.empty()) {
+                result.text += ' ';
+            }
+            result.text += seg.text;
+        }
+
+        if (m_benchmark) {
+            m_benchmark->add_transcription(seg.text, "final", seg.confidence,
+                                           seg.audio.size(), seg.latency_ms);
+        }
+    }
+
+    return results;
+}
+
+void file_transcriber::decode_segment(vstream_engine::stream& stream, segment& seg) const {
+    auto start = std::chrono::steady_clock::now();
+
+    recognition_result result;
+    const size_t chunk = static_cast<size_t>(m_config.sample_rate) / 10; // 100ms, one Vosk step
+    double confidence_sum = 0.0;
+    size_t finals = 0;
+
+    auto collect = [&]() {
+        if (result.is_final() && !result.empty()) {
+            if (!seg.text.empty()) {
+                seg.text += ' ';
+            }
+            seg.text += result.text();
+            confidence_sum += result.confidence();
+            finals++;
+        }
+    };
+
+    for (size_t pos = 0; pos < seg.audio.size(); pos += chunk) {
+        stream.process_audio(seg.audio.subspan(pos, std::min(chunk, seg.audio.size() - pos)), result);
+        collect();
+    }
+    stream.finalize(result);
+    collect();
+    while (stream.next_final(result)) {
+        collect();
+    }
+
+    seg.confidence = finals ? static_cast<float>(confidence_sum / finals) : 1.0f;
+    seg.latency_ms = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,87 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "grammar_cache.h"
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+grammar_cache::grammar_cache(size_t capacity, free_function free_recognizer)
+    : m_capacity(capacity)
+    , m_free(free_recognizer) {
+
+    if (!m_free) {
+        throw std::invalid_argument("grammar_cache needs a free function");
+    }
+}
+
+grammar_cache::~grammar_cache() {
+    clear();
+}
+
+VoskRecognizer* grammar_cache::acquire(const std::string& key, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->generation == generation && it->key == key) {
+            VoskRecognizer* recognizer = it->recognizer;
+            m_entries.erase(it);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return recognizer;
+        }
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void grammar_cache::release(const std::string& key, uint64_t generation, VoskRecognizer* recognizer) {
+    if (!recognizer) {
+        return;
+    }
+    if (m_capacity == 0) {
+        m_free(recognizer);
+        return;
+    }
+
+    std::list<entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.push_front({key, generation, recognizer});
+        if (m_entries.size() > m_capacity) {
+            evicted.splice(evicted.begin(), m_entries, std::prev(m_entries.end()));
+        }
+    }
+    for (auto& e : evicted) {
+        m_free(e.recognizer);
+    }
+}
+
+void grammar_cache::clear() {
+    std::list<entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entries.swap(m_entries);
+    }
+    for (auto& e : entries) {
+        m_free(e.recognizer);
+    }
+}
+
+size_t grammar_cache::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+std::string grammar_cache::normalize(const std::string& grammar) {
+    auto parsed = nlohmann::json::parse(grammar, nullptr, false);
+    if (parsed.is_discarded()) {
+        return grammar;
+    }
+    return parsed.dump();
+}
@@ -0,0 +1,114 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "huge_page_advisor.h"
+#include "logger.h"
+#include <sys/mman.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#ifndef MADV_COLLAPSE
+#define MADV_COLLAPSE 25
+#endif
+
+huge_page_advisor::huge_page_advisor()
+    : m_before(current_regions()) {
+}
+
+std::vector<huge_page_advisor::region> huge_page_advisor::current_regions() {
+    std::ifstream maps("/proc/self/maps");
+    return parse_maps(maps);
+}
+
+std::vector<huge_page_advisor::region> huge_page_advisor::parse_maps(std::istream& maps) {
+    std::vector<region> regions;
+    std::string line;
+
+    // start-end perms offset dev inode [path]
+    while (std::getline(maps, line)) {
+        std::istringstream fields(line);
+        std::string range, perms, offset, dev, inode, path;
+        if (!(fields >> range >> perms >> offset >> dev >> inode)) {
+            continue;
+        }
+        fields >> path;
+
+        // The heap or an unnamed mapping (large malloc blocks), private and writable
+        if (inode != "0" || perms.size() < 4 || perms[0] != 'r' || perms[1] != 'w' || perms[3] != 'p' ||
+            (!path.empty() && path != "[heap]")) {
+            continue;
+        }
+
+        auto dash = range.find('-');
+        if (dash == std::string::npos) {
+            continue;
+        }
+        try {
+            region r;
+            r.start = static_cast<uintptr_t>(std::stoull(range.substr(0, dash), nullptr, 16));
+            r.end = static_cast<uintptr_t>(std::stoull(range.substr(dash + 1), nullptr, 16));
+            if (r.end > r.start) {
+                regions.push_back(r);
+            }
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    return regions;
+}
+
+size_t huge_page_advisor::advise_new_regions(size_t min_bytes) {
+    size_t advised = 0;
+    size_t collapsed = 0;
+
+    for (const auto& r : current_regions()) {
+        size_t bytes = r.end - r.start;
+        if (bytes < min_bytes || std::find(m_before.begin(), m_before.end(), r) != m_before.end()) {
+            continue;
+        }
+
+        void* start = reinterpret_cast<void*>(r.start);
+        if (madvise(start, bytes, MADV_HUGEPAGE) != 0) {
+            continue;
+        }
+        advised += bytes;
+        if (madvise(start, bytes, MADV_COLLAPSE) == 0) {
+            collapsed += bytes;
+        }
+    }
+
+    LOG_INFO("Huge pages advised for " + std::to_string(advised >> 20) + " MB of model memory, " +
+             std::to_string(collapsed >> 20) + " MB collapsed now");
+    m_before = current_regions();
+    return advised;
+}
+
+size_t huge_page_advisor::huge_pages_kb(const std::string& smaps_rollup) {
+    std::ifstream file(smaps_rollup);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind("AnonHugePages:", 0) == 0) {
+            std::istringstream fields(line.substr(14));
+            size_t kb = 0;
+            fields >> kb;
+            return kb;
+        }
+    }
+    return 0;
+}
+
+bool huge_page_advisor::available() {
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string modes;
+    std::getline(file, modes);
+    return !modes.empty() && modes.find("[never]") == std::string::npos;
+}
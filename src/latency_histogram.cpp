@@ -0,0 +1,92 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+double bucket_midpoint_ms(size_t index) {
+    double lower = static_cast<double>(latency_histogram::bucket_lower_bound(index));
+    double width = static_cast<double>(latency_histogram::bucket_width(index));
+    return (lower + (width - 1.0) / 2.0) / 1000.0;
+}
+
+} // namespace
+
+double latency_histogram::percentile(double q) const noexcept {
+    std::array<uint64_t, bucket_count> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < bucket_count; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+
+    const double max_ms = static_cast<double>(m_max_us.load(std::memory_order_relaxed)) / 1000.0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucket_count; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(bucket_midpoint_ms(i), max_ms);
+        }
+    }
+    return max_ms;
+}
+
+latency_histogram::summary latency_histogram::snapshot() const noexcept {
+    std::array<uint64_t, bucket_count> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < bucket_count; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    summary s;
+    s.count = total;
+    if (total == 0) {
+        return s;
+    }
+
+    s.sum_ms = static_cast<double>(m_sum_us.load(std::memory_order_relaxed)) / 1000.0;
+    s.mean_ms = s.sum_ms / static_cast<double>(total);
+    s.max_ms = static_cast<double>(m_max_us.load(std::memory_order_relaxed)) / 1000.0;
+
+    // Walk the buckets once for all three ranks
+    const double quantiles[] = {0.5, 0.99, 0.999};
+    double* outputs[] = {&s.p50_ms, &s.p99_ms, &s.p999_ms};
+    size_t next = 0;
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < bucket_count && next < 3; ++i) {
+        seen += counts[i];
+        while (next < 3 && seen >= std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantiles[next] * total)))) {
+            // A midpoint can overshoot the largest recorded value
+            *outputs[next] = std::min(bucket_midpoint_ms(i), s.max_ms);
+            next++;
+        }
+    }
+
+    return s;
+}
+
+void latency_histogram::reset() noexcept {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum_us.store(0, std::memory_order_relaxed);
+    m_max_us.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,99 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "load_monitor.h"
+#include <algorithm>
+#include <stdexcept>
+
+load_monitor::load_monitor()
+    : load_monitor(config{}) {
+}
+
+load_monitor::load_monitor(const config& cfg)
+    : m_config(cfg) {
+
+    if (m_config.workers == 0 || m_config.sample_rate <= 0 || m_config.max_queue_wait_ms <= 0.0) {
+        throw std::invalid_argument("Load monitor needs workers, a sample rate and a queue wait limit");
+    }
+    if (!(m_config.no_partials_load <= m_config.coarse_load && m_config.coarse_load <= m_config.reject_load)) {
+        throw std::invalid_argument("Load shedding thresholds must be in escalation order");
+    }
+    m_config.smoothing = std::clamp(m_config.smoothing, 0.01, 1.0);
+}
+
+const char* load_monitor::level_name(level l) noexcept {
+    switch (l) {
+        case level::normal: return "normal";
+        case level::no_partials: return "no_partials";
+        case level::coarse: return "coarse";
+        case level::reject: return "reject";
+    }
+    return "unknown";
+}
+
+double load_monitor::threshold(level l) const {
+    switch (l) {
+        case level::no_partials: return m_config.no_partials_load;
+        case level::coarse: return m_config.coarse_load;
+        case level::reject: return m_config.reject_load;
+        case level::normal: break;
+    }
+    return 0.0;
+}
+
+load_monitor::level load_monitor::update(std::chrono::steady_clock::time_point now, const totals& current) {
+    if (!m_started || now <= m_last_time) {
+        m_started = true;
+        m_last_time = now;
+        m_last = current;
+        return get_level();
+    }
+
+    const double elapsed_ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_last_time).count());
+    const double busy_ns = static_cast<double>(current.busy_ns - m_last.busy_ns);
+    const double audio_ns = static_cast<double>(current.samples - m_last.samples) * 1e9 / m_config.sample_rate;
+    m_last_time = now;
+    m_last = current;
+
+    const double utilization = busy_ns / (elapsed_ns * static_cast<double>(m_config.workers));
+    const double wait_ms = std::chrono::duration<double, std::milli>(current.max_queue_wait).count();
+    const double sample_load = std::max(utilization, wait_ms / m_config.max_queue_wait_ms);
+
+    const double a = m_config.smoothing;
+    const double load = a * sample_load + (1.0 - a) * m_load.load(std::memory_order_relaxed);
+
+    m_utilization.store(utilization, std::memory_order_relaxed);
+    m_queue_wait_ms.store(wait_ms, std::memory_order_relaxed);
+    if (audio_ns > 0.0) {
+        m_rtf.store(busy_ns / audio_ns, std::memory_order_relaxed);
+    }
+    m_load.store(load, std::memory_order_relaxed);
+
+    // Escalate straight to the highest level reached
+    level target = level::normal;
+    for (level l : {level::no_partials, level::coarse, level::reject}) {
+        if (load >= threshold(l)) {
+            target = l;
+        }
+    }
+
+    level current_level = get_level();
+    if (target > current_level) {
+        current_level = target;
+    } else if (current_level != level::normal && load < threshold(current_level) - m_config.hysteresis) {
+        // Recover one step per interval
+        current_level = static_cast<level>(static_cast<int>(current_level) - 1);
+    }
+
+    m_level.store(current_level, std::memory_order_relaxed);
+    return current_level;
+}
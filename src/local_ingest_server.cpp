@@ -0,0 +1,462 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "local_ingest_server.h"
+#include "logger.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t max_session_id = 256;
+constexpr int max_events = 256;
+
+std::string make_frame(local_ingest_server::frame_type type, const std::string& payload) {
+    std::string frame(local_ingest_server::header_size, '\0');
+    auto length = static_cast<uint32_t>(payload.size());
+    frame[0] = static_cast<char>(type);
+    frame[4] = static_cast<char>(length & 0xff);
+    frame[5] = static_cast<char>((length >> 8) & 0xff);
+    frame[6] = static_cast<char>((length >> 16) & 0xff);
+    frame[7] = static_cast<char>((length >> 24) & 0xff);
+    frame += payload;
+    return frame;
+}
+
+bool is_abstract(const std::string& path) {
+    return !path.empty() && path[0] == '@';
+}
+
+} // namespace
+
+local_ingest_server::local_ingest_server(const std::string& path,
+                                         audio_handler_t on_audio,
+                                         command_handler_t on_command,
+                                         close_handler_t on_close)
+    : m_path(path)
+    , m_on_audio(std::move(on_audio))
+    , m_on_command(std::move(on_command))
+    , m_on_close(std::move(on_close)) {
+
+    sockaddr_un addr{};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        throw std::invalid_argument("Local socket path must be 1 to " +
+                                    std::to_string(sizeof(addr.sun_path) - 1) + " characters");
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    socklen_t addr_len = sizeof(addr);
+    if (is_abstract(path)) {
+        addr.sun_path[0] = '\0';
+        addr_len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+    } else {
+        // A socket file left behind by a previous run blocks the bind
+        ::unlink(path.c_str());
+    }
+
+    m_listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listen_fd < 0) {
+        throw std::runtime_error("Cannot create local socket: " + std::string(std::strerror(errno)));
+    }
+
+    if (::bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), addr_len) < 0 ||
+        ::listen(m_listen_fd, SOMAXCONN) < 0) {
+        std::string error = std::strerror(errno);
+        ::close(m_listen_fd);
+        throw std::runtime_error("Cannot listen on local socket " + path + ": " + error);
+    }
+
+    m_epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epoll_fd < 0 || m_wake_fd < 0) {
+        std::string error = std::strerror(errno);
+        if (m_epoll_fd >= 0) ::close(m_epoll_fd);
+        if (m_wake_fd >= 0) ::close(m_wake_fd);
+        ::close(m_listen_fd);
+        throw std::runtime_error("Cannot create local socket event loop: " + error);
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = m_listen_fd;
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_listen_fd, &event);
+    event.data.fd = m_wake_fd;
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wake_fd, &event);
+}
+
+local_ingest_server::~local_ingest_server() {
+    stop();
+    ::close(m_wake_fd);
+    ::close(m_epoll_fd);
+    ::close(m_listen_fd);
+    if (!is_abstract(m_path)) {
+        ::unlink(m_path.c_str());
+    }
+}
+
+void local_ingest_server::start() {
+    if (m_running.exchange(true)) {
+        return;
+    }
+    m_thread = std::thread(&local_ingest_server::serve_loop, this);
+    LOG_INFO("Local ingest listening on " + m_path);
+}
+
+void local_ingest_server::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    uint64_t one = 1;
+    [[maybe_unused]] auto n = ::write(m_wake_fd, &one, sizeof(one));
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool local_ingest_server::send(const std::string& session_id, frame_type type, const std::string& payload) {
+    std::shared_ptr<connection> conn;
+    {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        auto it = m_sessions.find(session_id);
+        if (it == m_sessions.end()) {
+            return false;
+        }
+        conn = it->second;
+    }
+
+    std::lock_guard<std::mutex> lock(conn->write_mutex);
+    if (conn->closed) {
+        return false;
+    }
+    write_frame_locked(*conn, type, payload);
+    return true;
+}
+
+bool local_ingest_server::has_session(const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    return m_sessions.count(session_id) > 0;
+}
+
+void local_ingest_server::serve_loop() {
+    epoll_event events[max_events];
+
+    while (m_running.load()) {
+        int ready = ::epoll_wait(m_epoll_fd, events, max_events, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("Local ingest event loop failed: " + std::string(std::strerror(errno)));
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == m_wake_fd) {
+                continue;
+            }
+            if (fd == m_listen_fd) {
+                accept_connections();
+                continue;
+            }
+
+            auto it = m_connections.find(fd);
+            if (it == m_connections.end()) {
+                continue;
+            }
+            auto conn = it->second;
+
+            if (events[i].events & EPOLLOUT) {
+                flush(*conn);
+            }
+            bool keep = !(events[i].events & EPOLLERR);
+            if (keep && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP))) {
+                keep = read_frames(*conn);
+            }
+            if (!keep) {
+                close_connection(conn);
+            }
+        }
+    }
+
+    while (!m_connections.empty()) {
+        close_connection(m_connections.begin()->second);
+    }
+}
+
+void local_ingest_server::accept_connections() {
+    while (true) {
+        int fd = ::accept4(m_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_WARNING("Local ingest accept failed: " + std::string(std::strerror(errno)));
+            }
+            return;
+        }
+
+        auto conn = std::make_shared<connection>();
+        conn->fd = fd;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            ::close(fd);
+            continue;
+        }
+        m_connections[fd] = std::move(conn);
+        m_connection_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool local_ingest_server::read_frames(connection& conn) {
+    while (true) {
+        char* target;
+        size_t wanted;
+        bool in_header = conn.header_read < header_size;
+
+        if (in_header) {
+            target = reinterpret_cast<char*>(conn.header) + conn.header_read;
+            wanted = header_size - conn.header_read;
+        } else {
+            // Audio is received directly into the buffer handed to the decoder
+            char* base = conn.type == frame_type::audio
+                ? reinterpret_cast<char*>(conn.samples.data())
+                : conn.text.data();
+            target = base + conn.payload_read;
+            wanted = conn.payload_size - conn.payload_read;
+        }
+
+        ssize_t n = ::recv(conn.fd, target, wanted, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (n == 0) {
+            return false;
+        }
+        m_bytes.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+
+        if (in_header) {
+            conn.header_read += static_cast<size_t>(n);
+            if (conn.header_read < header_size) {
+                continue;
+            }
+
+            conn.type = static_cast<frame_type>(conn.header[0]);
+            conn.payload_size = static_cast<size_t>(conn.header[4]) |
+                                static_cast<size_t>(conn.header[5]) << 8 |
+                                static_cast<size_t>(conn.header[6]) << 16 |
+                                static_cast<size_t>(conn.header[7]) << 24;
+            conn.payload_read = 0;
+
+            if (conn.payload_size > max_payload) {
+                fail(conn, "Frame exceeds " + std::to_string(max_payload) + " bytes");
+                return false;
+            }
+            switch (conn.type) {
+            case frame_type::hello:
+                if (!conn.session_id.empty()) {
+                    fail(conn, "Session already named");
+                    return false;
+                }
+                break;
+            case frame_type::audio:
+            case frame_type::command:
+                if (conn.session_id.empty()) {
+                    fail(conn, "First frame must be hello");
+                    return false;
+                }
+                break;
+            default:
+                fail(conn, "Unknown frame type " + std::to_string(conn.header[0]));
+                return false;
+            }
+
+            if (conn.type == frame_type::audio) {
+                if (conn.payload_size % sizeof(int16_t) != 0) {
+                    fail(conn, "Audio frame must hold whole 16-bit samples");
+                    return false;
+                }
+                conn.samples.resize(conn.payload_size / sizeof(int16_t));
+            } else {
+                conn.text.resize(conn.payload_size);
+            }
+        } else {
+            conn.payload_read += static_cast<size_t>(n);
+        }
+
+        if (conn.header_read == header_size && conn.payload_read == conn.payload_size) {
+            conn.header_read = 0;
+            m_frames.fetch_add(1, std::memory_order_relaxed);
+            if (!dispatch_frame(conn)) {
+                return false;
+            }
+        }
+    }
+}
+
+bool local_ingest_server::dispatch_frame(connection& conn) {
+    try {
+        switch (conn.type) {
+        case frame_type::hello: {
+            if (conn.text.empty() || conn.text.size() > max_session_id) {
+                fail(conn, "Session id must be 1 to " + std::to_string(max_session_id) + " characters");
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(m_sessions_mutex);
+            if (!m_sessions.emplace(conn.text, m_connections.at(conn.fd)).second) {
+                fail(conn, "Session " + conn.text + " is already connected");
+                return false;
+            }
+            conn.session_id = conn.text;
+            break;
+        }
+
+        case frame_type::audio:
+            if (!conn.samples.empty()) {
+                m_on_audio(conn.session_id, conn.samples);
+            }
+            break;
+
+        case frame_type::command: {
+            auto message = nlohmann::json::parse(conn.text);
+            if (!message.is_object() || !message.contains("command") || !message["command"].is_string()) {
+                fail(conn, "Command frame must be a JSON object with a command");
+                return false;
+            }
+            // A connection only ever controls its own session
+            message["session_id"] = conn.session_id;
+            auto response = m_on_command(message["command"].get<std::string>(), message);
+
+            std::lock_guard<std::mutex> lock(conn.write_mutex);
+            write_frame_locked(conn, frame_type::response, response.dump());
+            break;
+        }
+
+        default:
+            break;
+        }
+    } catch (const std::exception& e) {
+        fail(conn, e.what());
+        return false;
+    }
+
+    conn.text.clear();
+    return true;
+}
+
+void local_ingest_server::flush(connection& conn) {
+    std::lock_guard<std::mutex> lock(conn.write_mutex);
+    while (!conn.pending.empty()) {
+        ssize_t n = ::send(conn.fd, conn.pending.data(), conn.pending.size(), MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        conn.pending.erase(0, static_cast<size_t>(n));
+    }
+
+    if (conn.pending.empty()) {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = conn.fd;
+        ::epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, conn.fd, &event);
+    }
+}
+
+void local_ingest_server::fail(connection& conn, const std::string& message) {
+    m_errors.fetch_add(1, std::memory_order_relaxed);
+    LOG_WARNING("Local ingest" + (conn.session_id.empty() ? std::string() : " session " + conn.session_id) +
+                ": " + message);
+
+    // Best effort; the connection closes right after. Behind a partly
+    // written frame the error would corrupt the stream, so it is dropped.
+    std::lock_guard<std::mutex> lock(conn.write_mutex);
+    if (!conn.pending.empty()) {
+        return;
+    }
+    std::string frame = make_frame(frame_type::error, message);
+    ::send(conn.fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+}
+
+void local_ingest_server::close_connection(const std::shared_ptr<connection>& conn) {
+    ::epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, conn->fd, nullptr);
+
+    if (!conn->session_id.empty()) {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        auto it = m_sessions.find(conn->session_id);
+        if (it != m_sessions.end() && it->second == conn) {
+            m_sessions.erase(it);
+        }
+    }
+
+    {
+        // Senders holding the connection must not write to a reused descriptor
+        std::lock_guard<std::mutex> lock(conn->write_mutex);
+        conn->closed = true;
+        ::close(conn->fd);
+    }
+
+    m_connections.erase(conn->fd);
+    m_connection_count.fetch_sub(1, std::memory_order_relaxed);
+
+    if (!conn->session_id.empty() && m_on_close) {
+        try {
+            m_on_close(conn->session_id);
+        } catch (const std::exception& e) {
+            LOG_WARNING("Local ingest close handler failed: " + std::string(e.what()));
+        }
+    }
+}
+
+bool local_ingest_server::write_frame_locked(connection& conn, frame_type type, const std::string& payload) {
+    if (conn.pending.size() + header_size + payload.size() > max_pending_output) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::string frame = make_frame(type, payload);
+    size_t sent = 0;
+    if (conn.pending.empty()) {
+        while (sent < frame.size()) {
+            ssize_t n = ::send(conn.fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        if (sent == frame.size()) {
+            return true;
+        }
+
+        // The client is not keeping up; let the server thread finish the write
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+        event.data.fd = conn.fd;
+        ::epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, conn.fd, &event);
+    }
+
+    conn.pending.append(frame, sent, std::string::npos);
+    return true;
+}
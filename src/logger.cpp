@@ -10,10 +10,10 @@
 // -------------------------------------------------------------------------------------------------
 
 #include "logger.h"
-#include <filesystem>
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <cstring>
 #include <ctime>
 #include <fstream>
 #include <sstream>
@@ -29,6 +29,9 @@ logger::~logger() noexcept {
 }
 
 void logger::init(bool enable_file_logging, bool enable_console_logging) noexcept {
+    // Write out anything queued for the previous configuration first
+    stop_writer();
+
     std::lock_guard<std::mutex> lock(m_mutex);
 
     try {
@@ -42,6 +45,7 @@ void logger::init(bool enable_file_logging, bool enable_console_logging) noexcep
         m_state = std::make_unique<loggerState>();
         m_state->file_logging_enabled = enable_file_logging;
         m_state->console_logging_enabled = enable_console_logging;
+        m_min_level.store(static_cast<int>(Level::DEBUG), std::memory_order_relaxed);
 
         if (enable_file_logging) {
             m_state->log_file_name = generate_log_filename();
@@ -59,8 +63,17 @@ void logger::init(bool enable_file_logging, bool enable_console_logging) noexcep
                 m_state->log_file << "====" << std::endl << std::endl;
             }
         }
+
+        bool enabled = m_state->file_logging_enabled || m_state->console_logging_enabled;
+        if (enabled) {
+            m_writer_running.store(true, std::memory_order_release);
+            m_writer = std::thread(&logger::writer_loop, this);
+        }
+        m_enabled.store(enabled, std::memory_order_release);
     } catch (...) {
-        // Ensure we have some form of logging even if initialization partially fails
+        // Without a writer thread nothing would drain the queue
+        m_writer_running.store(false, std::memory_order_release);
+        m_enabled.store(false, std::memory_order_release);
         if (m_state) {
             m_state->file_logging_enabled = false;
             m_state->console_logging_enabled = enable_console_logging;
@@ -69,8 +82,7 @@ void logger::init(bool enable_file_logging, bool enable_console_logging) noexcep
 }
 
 bool logger::is_enabled() const noexcept {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_state && (m_state->file_logging_enabled || m_state->console_logging_enabled);
+    return m_enabled.load(std::memory_order_acquire);
 }
 
 std::string logger::generate_log_filename() noexcept {
@@ -101,66 +113,126 @@ std::string logger::level_to_string(Level level) const noexcept {
     }
 }
 
-std::string logger::current_time() const noexcept {
+const std::string& logger::format_time(std::chrono::system_clock::time_point time) noexcept {
     try {
-        auto now = std::chrono::system_clock::now();
-        auto in_time_t = std::chrono::system_clock::to_time_t(now);
+        auto in_time_t = std::chrono::system_clock::to_time_t(time);
+        if (in_time_t != m_cached_second || m_cached_time.empty()) {
+            std::tm tm_buf;
+            localtime_r(&in_time_t, &tm_buf);
+
+            char buffer[32];
+            size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %X", &tm_buf);
+            m_cached_time.assign(buffer, length);
+            m_cached_second = in_time_t;
+        }
+    } catch (...) {
+        m_cached_time = "[TIME_ERROR]";
+    }
+    return m_cached_time;
+}
 
-        std::tm tm_buf;
-        localtime_r(&in_time_t, &tm_buf);
+void logger::log(Level level, std::string message, const char* file, int line) noexcept {
+    try {
+        if (!should_log(level)) return;
 
-        std::stringstream ss;
-        ss << std::put_time(&tm_buf, "%Y-%m-%d %X");
-        return ss.str();
+        log_record record;
+        record.level = level;
+        record.time = std::chrono::system_clock::now();
+        record.file = file;
+        record.line = line;
+        record.message = std::move(message);
+
+        if (m_queue.enqueue(std::move(record))) {
+            m_enqueued.fetch_add(1, std::memory_order_release);
+        }
     } catch (...) {
-        return "[TIME_ERROR]";
+        // Dropping the message is preferable to throwing into the caller
     }
 }
 
-void logger::log(Level level, const std::string& message,
-                 const std::string& file, int line) noexcept {
-    std::lock_guard<std::mutex> lock(m_mutex);
+void logger::writer_loop() noexcept {
+    while (m_writer_running.load(std::memory_order_acquire)) {
+        if (write_batch() == 0) {
+            // Producers never signal; poll so log() stays a single enqueue
+            std::unique_lock<std::mutex> lock(m_writer_mutex);
+            m_writer_cv.wait_for(lock, std::chrono::milliseconds(50));
+        }
+    }
+
+    // Drain whatever was queued before the stop
+    while (write_batch() > 0) {
+    }
+}
+
+size_t logger::write_batch() noexcept {
+    constexpr size_t k_batch_size = 256;
 
     try {
-        if (!m_state || level < m_state->min_level) return;
-
-        std::stringstream log_entry;
-        log_entry << "[" << current_time() << "] "
-                  << "[" << level_to_string(level) << "] ";
-
-        if (!file.empty() && line != -1) {
-            try {
-                log_entry << "[" << std::filesystem::path(file).filename().string()
-                         << ":" << line << "] ";
-            } catch (...) {
-                // If filesystem operations fail, just use the raw filename
-                log_entry << "[" << file << ":" << line << "] ";
-            }
+        if (m_batch.size() < k_batch_size) {
+            m_batch.resize(k_batch_size);
         }
 
-        log_entry << message;
-
-        const std::string final_message = log_entry.str();
+        size_t count = m_queue.try_dequeue_bulk(m_batch.begin(), k_batch_size);
+        if (count == 0) {
+            return 0;
+        }
 
-        if (m_state->console_logging_enabled) {
-            try {
-                std::cerr << final_message << std::endl;
-            } catch (...) {
-                // Console output failed, but continue with file logging if available
+        m_buffer.clear();
+        for (size_t i = 0; i < count; ++i) {
+            auto& record = m_batch[i];
+
+            m_buffer += '[';
+            m_buffer += format_time(record.time);
+            m_buffer += "] [";
+            m_buffer += level_to_string(record.level);
+            m_buffer += "] ";
+
+            if (record.file && record.line != -1) {
+                const char* name = std::strrchr(record.file, '/');
+                m_buffer += '[';
+                m_buffer += name ? name + 1 : record.file;
+                m_buffer += ':';
+                m_buffer += std::to_string(record.line);
+                m_buffer += "] ";
             }
+
+            m_buffer += record.message;
+            m_buffer += '\n';
+
+            // Release the message memory now rather than on the next reuse
+            std::string().swap(record.message);
         }
 
-        if (m_state->file_logging_enabled && m_state->log_file.is_open()) {
-            try {
-                m_state->log_file << final_message << std::endl;
-            } catch (...) {
-                // File logging failed, disable it to prevent further errors
-                m_state->file_logging_enabled = false;
-                if (m_state->log_file.is_open()) {
-                    m_state->log_file.close();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_state && m_state->console_logging_enabled) {
+                try {
+                    std::cerr.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                } catch (...) {
+                    // Console output failed, but continue with file logging if available
+                }
+            }
+
+            if (m_state && m_state->file_logging_enabled && m_state->log_file.is_open()) {
+                try {
+                    m_state->log_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                    m_state->log_file.flush();
+                } catch (...) {
+                    // File logging failed, disable it to prevent further errors
+                    m_state->file_logging_enabled = false;
+                    if (m_state->log_file.is_open()) {
+                        m_state->log_file.close();
+                    }
                 }
             }
         }
+
+        m_written.fetch_add(count, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(m_writer_mutex);
+            m_flushed_cv.notify_all();
+        }
+        return count;
     } catch (...) {
         // Last resort: try to output error to stderr if possible
         try {
@@ -168,6 +240,22 @@ void logger::log(Level level, const std::string& message,
         } catch (...) {
             // Nothing more we can do
         }
+        return 0;
+    }
+}
+
+void logger::stop_writer() noexcept {
+    try {
+        if (m_writer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(m_writer_mutex);
+                m_writer_running.store(false, std::memory_order_release);
+                m_writer_cv.notify_one();
+            }
+            m_writer.join();
+        }
+    } catch (...) {
+        // Ignore errors while stopping the writer
     }
 }
 
@@ -175,7 +263,7 @@ void logger::log_section(const std::string& title,
                          const std::vector<std::string>& messages,
                          Level level) noexcept {
     try {
-        if (!m_state || level < m_state->min_level) return;
+        if (!should_log(level)) return;
 
         log(level, "\n==== " + title + " ====");
         for (const auto& msg : messages) {
@@ -189,14 +277,7 @@ void logger::log_section(const std::string& title,
 }
 
 void logger::set_min_level(Level level) noexcept {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    try {
-        if (m_state) {
-            m_state->min_level = level;
-        }
-    } catch (...) {
-        // Ignore errors in setting log level
-    }
+    m_min_level.store(static_cast<int>(level), std::memory_order_relaxed);
 }
 
 std::string logger::get_log_file_name() const noexcept {
@@ -209,8 +290,18 @@ std::string logger::get_log_file_name() const noexcept {
 }
 
 void logger::flush() noexcept {
-    std::lock_guard<std::mutex> lock(m_mutex);
     try {
+        const uint64_t target = m_enqueued.load(std::memory_order_acquire);
+        if (m_writer.joinable()) {
+            std::unique_lock<std::mutex> lock(m_writer_mutex);
+            m_writer_cv.notify_one();
+            m_flushed_cv.wait_for(lock, std::chrono::seconds(1), [this, target] {
+                return m_written.load(std::memory_order_acquire) >= target ||
+                       !m_writer_running.load(std::memory_order_acquire);
+            });
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
         if (m_state && m_state->file_logging_enabled && m_state->log_file.is_open()) {
             m_state->log_file.flush();
         }
@@ -220,6 +311,9 @@ void logger::flush() noexcept {
 }
 
 void logger::shutdown() noexcept {
+    m_enabled.store(false, std::memory_order_release);
+    stop_writer();
+
     std::lock_guard<std::mutex> lock(m_mutex);
     try {
         if (m_state) {
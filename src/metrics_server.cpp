@@ -0,0 +1,171 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "metrics_server.h"
+#include "logger.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+const char* status_text(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 503: return "Service Unavailable";
+    default:  return "Error";
+    }
+}
+
+void write_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+metrics_server::metrics_server(uint16_t port, handler_t handler)
+    : m_handler(std::move(handler)) {
+
+    m_listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listen_fd < 0) {
+        throw std::runtime_error("Cannot create metrics socket: " + std::string(std::strerror(errno)));
+    }
+
+    int reuse = 1;
+    ::setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+
+    if (::bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(m_listen_fd, 16) < 0) {
+        std::string error = std::strerror(errno);
+        ::close(m_listen_fd);
+        throw std::runtime_error("Cannot listen on metrics port " + std::to_string(port) + ": " + error);
+    }
+
+    socklen_t len = sizeof(addr);
+    ::getsockname(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    m_port = ntohs(addr.sin_port);
+}
+
+metrics_server::~metrics_server() {
+    stop();
+    if (m_listen_fd >= 0) {
+        ::close(m_listen_fd);
+    }
+}
+
+void metrics_server::start() {
+    if (m_running.exchange(true)) {
+        return;
+    }
+    m_thread = std::thread(&metrics_server::serve_loop, this);
+    LOG_INFO("Metrics endpoint listening on port " + std::to_string(m_port));
+}
+
+void metrics_server::stop() {
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void metrics_server::serve_loop() {
+    pollfd pfd{};
+    pfd.fd = m_listen_fd;
+    pfd.events = POLLIN;
+
+    while (m_running.load()) {
+        // Short timeout so stop() is noticed promptly
+        int ready = ::poll(&pfd, 1, 200);
+        if (ready <= 0 || !(pfd.revents & POLLIN)) {
+            continue;
+        }
+
+        int fd = ::accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+
+        handle_connection(fd);
+        ::close(fd);
+    }
+}
+
+void metrics_server::handle_connection(int fd) {
+    // A slow or silent client must not stall the next scrape for long
+    timeval timeout{1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    // Request line: METHOD PATH VERSION
+    auto method_end = request.find(' ');
+    auto path_end = method_end == std::string::npos ? std::string::npos : request.find(' ', method_end + 1);
+    if (path_end == std::string::npos) {
+        return;
+    }
+
+    std::string method = request.substr(0, method_end);
+    std::string path = request.substr(method_end + 1, path_end - method_end - 1);
+    path = path.substr(0, path.find('?'));
+
+    response reply;
+    if (method != "GET") {
+        reply.status = 405;
+    } else {
+        try {
+            reply = m_handler(path);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Metrics handler failed: " + std::string(e.what()));
+            reply = response{};
+            reply.status = 500;
+        }
+    }
+
+    std::string header = "HTTP/1.0 " + std::to_string(reply.status) + " " + status_text(reply.status) + "\r\n" +
+                         "Content-Type: " + reply.content_type + "\r\n" +
+                         "Content-Length: " + std::to_string(reply.body.size()) + "\r\n" +
+                         "Connection: close\r\n\r\n";
+    write_all(fd, header + reply.body);
+}
@@ -13,11 +13,26 @@
 #include "logger.h"
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 
-mic_capture::mic_capture() {}
+namespace {
+
+size_t chunk_samples_for(const mic_capture::config& cfg) {
+    size_t frames = static_cast<size_t>(cfg.sample_rate) * cfg.accumulate_ms / 1000;
+    return std::max<size_t>(1, frames) * std::max(1, cfg.channels);
+}
+
+} // namespace
+
+mic_capture::mic_capture()
+    : mic_capture(config{}) {
+}
 
 mic_capture::mic_capture(const config& cfg)
-    : m_config(cfg), m_audio_queue(cfg.queue_size) {
+    : m_config(cfg)
+    , m_chunk_samples(chunk_samples_for(cfg))
+    , m_ring(m_chunk_samples * std::max<size_t>(2, cfg.queue_size))
+    , m_chunk_times(std::max<size_t>(2, cfg.queue_size) + 1) {
 
     PaError err = Pa_Initialize();
     if (err != paNoError) {
@@ -25,10 +40,6 @@ mic_capture::mic_capture(const config& cfg)
                                  std::string(Pa_GetErrorText(err)));
     }
 
-    // Calculate frames needed for accumulation
-    m_frames_to_accumulate = (m_config.sample_rate * m_config.accumulate_ms) / 1000;
-    m_accumulation_buffer.reserve(m_frames_to_accumulate * m_config.channels);
-
     LOG_INFO("Mic capture initialized. Accumulating " +
              std::to_string(m_config.accumulate_ms) + "ms of audio");
 }
@@ -60,6 +71,11 @@ bool mic_capture::start() {
     inputParams.suggestedLatency = deviceInfo->defaultLowInputLatency;
     inputParams.hostApiSpecificStreamInfo = nullptr;
 
+    // Start from an empty ring; the callback is not running yet
+    m_ring.discard();
+    m_chunk_times.discard();
+    m_unpublished_samples = 0;
+
     PaError err = Pa_OpenStream(&m_stream,
                                 &inputParams,
                                 nullptr,
@@ -96,7 +112,10 @@ void mic_capture::stop() {
     if (!m_running) return;
 
     m_running = false;
-    m_data_cv.notify_all();  // Wake up the processing thread
+
+    // Wake up the processing thread
+    m_data_seq.fetch_add(1, std::memory_order_release);
+    m_data_seq.notify_all();
 
     if (m_processing_thread.joinable()) {
         m_processing_thread.join();
@@ -108,9 +127,9 @@ void mic_capture::stop() {
         m_stream = nullptr;
     }
 
-    // Clear queue
-    std::vector<int16_t> discard;
-    while (m_audio_queue.try_dequeue(discard)) {}
+    // Drop audio nobody consumed, including a partial chunk
+    m_ring.discard();
+    m_chunk_times.discard();
 
     LOG_INFO("Microphone capture stopped");
 }
@@ -124,25 +143,26 @@ int mic_capture::pa_callback(const void* input, void* /*output*/,
     const int16_t* samples = static_cast<const int16_t*>(input);
     const size_t sample_count = frameCount * self->m_config.channels;
 
-    // Add to accumulation buffer
-    self->m_accumulation_buffer.insert(self->m_accumulation_buffer.end(),
-                                       samples, samples + sample_count);
-    self->m_accumulated_frames += frameCount;
-
-    // Check if we have enough frames
-    if (self->m_accumulated_frames >= self->m_frames_to_accumulate) {
-        // Move accumulated audio to queue
-        if (!self->m_audio_queue.try_enqueue(std::move(self->m_accumulation_buffer))) {
-            self->m_dropped_frames.fetch_add(self->m_accumulated_frames);
-        } else {
-            // Notify the processing thread
-            self->m_data_cv.notify_one();
-        }
+    if (!samples) {
+        return paContinue;
+    }
+
+    // Wait-free copy into preallocated storage, drop the whole buffer when full
+    if (!self->m_ring.try_write(samples, sample_count)) {
+        self->m_dropped_frames.fetch_add(frameCount, std::memory_order_relaxed);
+        return paContinue;
+    }
 
-        // Reset accumulation
-        self->m_accumulation_buffer.clear();
-        self->m_accumulation_buffer.reserve(self->m_frames_to_accumulate * self->m_config.channels);
-        self->m_accumulated_frames = 0;
+    // Wake the processing thread once per completed chunk
+    self->m_unpublished_samples += sample_count;
+    if (self->m_unpublished_samples >= self->m_chunk_samples) {
+        const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        for (; self->m_unpublished_samples >= self->m_chunk_samples;
+             self->m_unpublished_samples -= self->m_chunk_samples) {
+            self->m_chunk_times.try_write(&now, 1);
+        }
+        self->m_data_seq.fetch_add(1, std::memory_order_release);
+        self->m_data_seq.notify_one();
     }
 
     return paContinue;
@@ -151,27 +171,47 @@ int mic_capture::pa_callback(const void* input, void* /*output*/,
 void mic_capture::processing_loop() {
     LOG_INFO("Processing thread started");
 
-    std::vector<int16_t> audio_data;
-
     while (m_running) {
-        // Try to dequeue first
-        if (m_audio_queue.try_dequeue(audio_data)) {
+        uint32_t seen = m_data_seq.load(std::memory_order_acquire);
+
+        // Deliver every complete chunk in place
+        for (auto chunk = m_ring.read_span(m_chunk_samples);
+             chunk.size() == m_chunk_samples && m_running;
+             chunk = m_ring.read_span(m_chunk_samples)) {
+            take_chunk_time();
             if (m_callback) {
-                m_callback(audio_data);
+                m_callback(chunk);
             }
-        } else {
-            // Wait for notification with timeout
-            std::unique_lock<std::mutex> lock(m_data_mutex);
-            m_data_cv.wait_for(lock, std::chrono::milliseconds(100),
-                               [this] { return !m_running || m_audio_queue.size_approx() > 0; });
+            m_ring.release(chunk.size());
         }
+
+        if (!m_running) break;
+        m_data_seq.wait(seen, std::memory_order_acquire);
     }
 
     LOG_INFO("Processing thread stopped");
 }
 
 bool mic_capture::dequeue_audio(std::vector<int16_t>& samples) {
-    return m_audio_queue.try_dequeue(samples);
+    auto chunk = m_ring.read_span(m_chunk_samples);
+    if (chunk.size() < m_chunk_samples) {
+        return false;
+    }
+
+    take_chunk_time();
+    samples.assign(chunk.begin(), chunk.end());
+    m_ring.release(chunk.size());
+    return true;
+}
+
+void mic_capture::take_chunk_time() {
+    auto time = m_chunk_times.read_span(1);
+    if (time.empty()) {
+        m_chunk_time = std::chrono::steady_clock::now();
+        return;
+    }
+    m_chunk_time = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(time[0]));
+    m_chunk_times.release(1);
 }
 
 void mic_capture::set_audio_callback(audio_callback_t callback) {
@@ -0,0 +1,243 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "model_registry.h"
+#include "logger.h"
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+model_registry::model_registry(size_t memory_budget_mb, factory create)
+    : m_budget_mb(memory_budget_mb)
+    , m_create(std::move(create)) {
+
+    if (!m_create) {
+        throw std::invalid_argument("model_registry needs an engine factory");
+    }
+}
+
+model_registry::~model_registry() {
+    // Engines still referenced elsewhere outlive the registry
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+void model_registry::add(model_spec spec) {
+    if (spec.name.empty() || spec.path.empty()) {
+        throw std::invalid_argument("Model needs a name and a path");
+    }
+    if (spec.memory_mb == 0) {
+        spec.memory_mb = estimate_memory_mb(spec.path);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.count(spec.name)) {
+        throw std::invalid_argument("Duplicate model name: " + spec.name);
+    }
+    std::string name = spec.name;
+    m_entries[name].spec = std::move(spec);
+}
+
+void model_registry::add_resident(model_spec spec, std::shared_ptr<vstream_engine> engine) {
+    if (!engine) {
+        throw std::invalid_argument("Resident model " + spec.name + " has no engine");
+    }
+    if (spec.name.empty()) {
+        throw std::invalid_argument("Model needs a name");
+    }
+    if (spec.memory_mb == 0) {
+        spec.memory_mb = estimate_memory_mb(spec.path);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.count(spec.name)) {
+        throw std::invalid_argument("Duplicate model name: " + spec.name);
+    }
+    std::string name = spec.name;
+    auto& e = m_entries[name];
+    e.spec = std::move(spec);
+    e.engine = std::move(engine);
+    e.resident = true;
+    e.last_used = std::chrono::steady_clock::now();
+    m_used_mb += e.spec.memory_mb;
+}
+
+std::shared_ptr<vstream_engine> model_registry::acquire(const std::string& name) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(name);
+    if (it == m_entries.end()) {
+        throw std::invalid_argument("Unknown model: " + name);
+    }
+    entry& e = it->second;
+
+    m_loaded.wait(lock, [&e] { return !e.loading; });
+    if (e.engine) {
+        e.last_used = std::chrono::steady_clock::now();
+        return e.engine;
+    }
+
+    std::vector<std::shared_ptr<vstream_engine>> unloaded;
+    if (!make_room(e.spec.memory_mb, unloaded)) {
+        throw std::runtime_error("Model " + name + " (" + std::to_string(e.spec.memory_mb) +
+                                 " MB) does not fit the " + std::to_string(m_budget_mb) +
+                                 " MB budget next to the models in use");
+    }
+    m_used_mb += e.spec.memory_mb;
+    e.loading = true;
+    model_spec spec = e.spec;
+    lock.unlock();
+
+    // Free the evicted models before the new one allocates
+    unloaded.clear();
+
+    auto started = std::chrono::steady_clock::now();
+    LOG_INFO("Loading model " + name + " from " + spec.path);
+
+    std::shared_ptr<vstream_engine> engine;
+    try {
+        engine = m_create(spec);
+        if (!engine) {
+            throw std::runtime_error("Engine factory returned no engine");
+        }
+    } catch (...) {
+        lock.lock();
+        m_used_mb -= spec.memory_mb;
+        e.loading = false;
+        lock.unlock();
+        m_loaded.notify_all();
+        throw;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - started).count();
+    LOG_INFO("Model " + name + " loaded in " + std::to_string(elapsed) + "ms");
+
+    lock.lock();
+    e.engine = engine;
+    e.loading = false;
+    e.last_used = std::chrono::steady_clock::now();
+    m_loads.fetch_add(1, std::memory_order_relaxed);
+    lock.unlock();
+    m_loaded.notify_all();
+    return engine;
+}
+
+bool model_registry::make_room(size_t need_mb, std::vector<std::shared_ptr<vstream_engine>>& unloaded) {
+    if (m_budget_mb == 0) {
+        return true;
+    }
+
+    while (m_used_mb + need_mb > m_budget_mb) {
+        // Only the registry holds an idle model
+        entry* victim = nullptr;
+        for (auto& [name, e] : m_entries) {
+            if (e.engine && !e.resident && e.engine.use_count() == 1 &&
+                (!victim || e.last_used < victim->last_used)) {
+                victim = &e;
+            }
+        }
+        if (!victim) {
+            return false;
+        }
+
+        LOG_INFO("Unloading idle model " + victim->spec.name + " to free " +
+                 std::to_string(victim->spec.memory_mb) + " MB");
+        unloaded.push_back(std::move(victim->engine));
+        victim->engine.reset();
+        m_used_mb -= victim->spec.memory_mb;
+        m_unloads.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool model_registry::contains(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.count(name) > 0;
+}
+
+std::vector<std::shared_ptr<vstream_engine>> model_registry::loaded_engines() const {
+    std::vector<std::shared_ptr<vstream_engine>> engines;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [name, e] : m_entries) {
+        if (e.engine) {
+            engines.push_back(e.engine);
+        }
+    }
+    return engines;
+}
+
+std::vector<model_registry::model_status> model_registry::status() const {
+    std::vector<model_status> models;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [name, e] : m_entries) {
+        model_status s;
+        s.name = name;
+        s.path = e.spec.path;
+        s.memory_mb = e.spec.memory_mb;
+        s.loaded = e.engine != nullptr;
+        s.resident = e.resident;
+        s.references = e.engine ? e.engine.use_count() - 1 : 0;
+        models.push_back(std::move(s));
+    }
+    return models;
+}
+
+size_t model_registry::memory_used_mb() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_used_mb;
+}
+
+model_registry::config model_registry::load_config(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open model list: " + path);
+    }
+
+    auto doc = nlohmann::json::parse(file, nullptr, false);
+    if (doc.is_discarded() || !doc.is_object() || !doc.contains("models") || !doc["models"].is_array()) {
+        throw std::invalid_argument("Model list " + path + " must be a JSON object with a \"models\" array");
+    }
+
+    config cfg;
+    try {
+        cfg.memory_budget_mb = doc.value("memory_budget_mb", size_t{0});
+        for (const auto& item : doc["models"]) {
+            model_spec spec;
+            spec.name = item.at("name").get<std::string>();
+            spec.path = item.at("path").get<std::string>();
+            spec.memory_mb = item.value("memory_mb", size_t{0});
+            spec.preload = item.value("preload", false);
+            cfg.models.push_back(std::move(spec));
+        }
+    } catch (const nlohmann::json::exception& e) {
+        throw std::invalid_argument("Invalid model list " + path + ": " + e.what());
+    }
+    return cfg;
+}
+
+size_t model_registry::estimate_memory_mb(const std::string& model_path) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    uintmax_t bytes = 0;
+    for (fs::recursive_directory_iterator it(model_path, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code size_ec;
+        if (it->is_regular_file(size_ec)) {
+            auto size = it->file_size(size_ec);
+            if (!size_ec) {
+                bytes += size;
+            }
+        }
+    }
+    constexpr uintmax_t mb = 1024 * 1024;
+    return static_cast<size_t>((bytes + mb - 1) / mb);
+}
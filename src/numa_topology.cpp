@@ -0,0 +1,221 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "numa_topology.h"
+#include "logger.h"
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+using node_mask = std::vector<unsigned long>;
+
+node_mask make_mask(const std::vector<int>& node_ids) {
+    constexpr int bits = static_cast<int>(sizeof(unsigned long) * CHAR_BIT);
+    int highest = *std::max_element(node_ids.begin(), node_ids.end());
+    node_mask mask(static_cast<size_t>(highest / bits + 1), 0);
+    for (int id : node_ids) {
+        mask[static_cast<size_t>(id / bits)] |= 1UL << (id % bits);
+    }
+    return mask;
+}
+
+bool set_policy(int mode, const std::vector<int>& node_ids) {
+    node_mask mask = make_mask(node_ids);
+    // The kernel takes the mask size in bits plus one
+    unsigned long max_node = mask.size() * sizeof(unsigned long) * CHAR_BIT + 1;
+    return syscall(SYS_set_mempolicy, mode, mask.data(), max_node) == 0;
+}
+
+} // anonymous namespace
+
+numa_topology::numa_topology() {
+    node all;
+    unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned cpu = 0; cpu < cpus; ++cpu) {
+        all.cpus.push_back(static_cast<int>(cpu));
+    }
+    m_nodes.push_back(std::move(all));
+}
+
+numa_topology::numa_topology(std::vector<node> nodes)
+    : m_nodes(std::move(nodes)) {
+
+    std::erase_if(m_nodes, [](const node& n) { return n.cpus.empty(); });
+    if (m_nodes.empty()) {
+        throw std::invalid_argument("NUMA topology has no node with CPUs");
+    }
+    std::sort(m_nodes.begin(), m_nodes.end(), [](const node& a, const node& b) { return a.id < b.id; });
+}
+
+numa_topology numa_topology::detect(const std::string& sysfs_root) {
+    namespace fs = std::filesystem;
+    std::vector<node> nodes;
+
+    std::error_code ec;
+    for (fs::directory_iterator it(sysfs_root, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+            continue;
+        }
+
+        std::ifstream file(it->path() / "cpulist");
+        std::string list;
+        if (!file || !std::getline(file, list)) {
+            continue;
+        }
+
+        try {
+            node n;
+            n.id = std::stoi(name.substr(4));
+            n.cpus = parse_cpu_list(list);
+            std::sort(n.cpus.begin(), n.cpus.end());
+            nodes.push_back(std::move(n));
+        } catch (const std::exception& e) {
+            LOG_WARNING("Ignoring NUMA " + name + ": " + e.what());
+        }
+    }
+
+    std::erase_if(nodes, [](const node& n) { return n.cpus.empty(); });
+    if (nodes.empty()) {
+        return numa_topology();
+    }
+    return numa_topology(std::move(nodes));
+}
+
+std::vector<int> numa_topology::parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string item;
+
+    while (std::getline(stream, item, ',')) {
+        if (item.empty()) continue;
+
+        try {
+            auto dash = item.find('-');
+            if (dash == std::string::npos) {
+                cpus.push_back(std::stoi(item));
+            } else {
+                int first = std::stoi(item.substr(0, dash));
+                int last = std::stoi(item.substr(dash + 1));
+                if (first < 0 || last < first) {
+                    throw std::invalid_argument(item);
+                }
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Invalid CPU list: " + list);
+        }
+    }
+
+    if (!cpus.empty() && *std::min_element(cpus.begin(), cpus.end()) < 0) {
+        throw std::invalid_argument("Invalid CPU list: " + list);
+    }
+
+    return cpus;
+}
+
+int numa_topology::node_index_of_cpu(int cpu) const {
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (std::binary_search(m_nodes[i].cpus.begin(), m_nodes[i].cpus.end(), cpu)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+numa_topology numa_topology::restrict_to(const std::vector<int>& cpus) const {
+    std::vector<node> nodes = m_nodes;
+    for (auto& n : nodes) {
+        std::erase_if(n.cpus, [&cpus](int cpu) {
+            return std::find(cpus.begin(), cpus.end(), cpu) == cpus.end();
+        });
+    }
+    std::erase_if(nodes, [](const node& n) { return n.cpus.empty(); });
+    if (nodes.empty()) {
+        throw std::invalid_argument("None of the decode CPUs belongs to a NUMA node");
+    }
+    return numa_topology(std::move(nodes));
+}
+
+numa_topology::worker_placement numa_topology::place_workers(size_t workers) const {
+    worker_placement placement;
+    placement.cpus.reserve(workers);
+    placement.domains.reserve(workers);
+
+    for (size_t i = 0; i < workers; ++i) {
+        size_t domain = i % m_nodes.size();
+        const auto& cpus = m_nodes[domain].cpus;
+        placement.cpus.push_back(cpus[(i / m_nodes.size()) % cpus.size()]);
+        placement.domains.push_back(domain);
+    }
+    return placement;
+}
+
+void numa_topology::run_on_node(size_t index, const std::function<void()>& fn) const {
+    const node& target = m_nodes.at(index);
+    std::exception_ptr error;
+
+    std::thread thread([&] {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : target.cpus) {
+            CPU_SET(cpu, &set);
+        }
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            LOG_WARNING("Failed to bind thread to NUMA node " + std::to_string(target.id));
+        }
+        if (is_numa() && !set_policy(MPOL_PREFERRED, {target.id})) {
+            LOG_WARNING("Failed to prefer memory of NUMA node " + std::to_string(target.id));
+        }
+
+        try {
+            fn();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    });
+    thread.join();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool numa_topology::interleave_memory() const {
+    std::vector<int> ids;
+    for (const auto& n : m_nodes) {
+        ids.push_back(n.id);
+    }
+    if (!set_policy(MPOL_INTERLEAVE, ids)) {
+        LOG_WARNING("Failed to interleave memory over NUMA nodes");
+        return false;
+    }
+    return true;
+}
+
+void numa_topology::reset_memory_policy() {
+    syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+}
@@ -0,0 +1,99 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "opus_packet_decoder.h"
+#include <opus.h>
+#include <bit>
+#include <stdexcept>
+#include <string>
+
+// Messages are read in place as bytes of the int16 words
+static_assert(std::endian::native == std::endian::little, "Opus framing assumes a little-endian host");
+
+opus_packet_decoder::opus_packet_decoder(int sample_rate)
+    : m_sample_rate(sample_rate)
+    , m_max_frame(static_cast<size_t>(sample_rate) * 120 / 1000) {
+
+    if (!supports_rate(sample_rate)) {
+        throw std::invalid_argument("Opus cannot decode at " + std::to_string(sample_rate) +
+                                    " Hz (8000, 12000, 16000, 24000 or 48000)");
+    }
+
+    int error = OPUS_OK;
+    m_decoder = opus_decoder_create(sample_rate, 1, &error);
+    if (error != OPUS_OK || !m_decoder) {
+        throw std::runtime_error(std::string("Failed to create Opus decoder: ") + opus_strerror(error));
+    }
+}
+
+opus_packet_decoder::~opus_packet_decoder() {
+    if (m_decoder) {
+        opus_decoder_destroy(m_decoder);
+    }
+}
+
+bool opus_packet_decoder::supports_rate(int sample_rate) {
+    return sample_rate == 8000 || sample_rate == 12000 || sample_rate == 16000 ||
+           sample_rate == 24000 || sample_rate == 48000;
+}
+
+void opus_packet_decoder::reset() {
+    opus_decoder_ctl(m_decoder, OPUS_RESET_STATE);
+}
+
+size_t opus_packet_decoder::decode(std::span<const int16_t> message, std::vector<int16_t>& pcm) {
+    auto bytes = std::as_bytes(message);
+    const auto* data = reinterpret_cast<const unsigned char*>(bytes.data());
+    const size_t size = bytes.size();
+
+    size_t decoded = 0;
+    size_t pos = 0;
+    while (pos + 2 <= size) {
+        const size_t length = static_cast<size_t>(data[pos]) | (static_cast<size_t>(data[pos + 1]) << 8);
+        pos += 2;
+        if (length == 0) {
+            break;
+        }
+        if (pos + length > size) {
+            m_errors++;
+            break;
+        }
+
+        // Decode straight into the caller's buffer
+        const size_t offset = pcm.size();
+        pcm.resize(offset + m_max_frame);
+        int samples = opus_decode(m_decoder, data + pos, static_cast<opus_int32>(length),
+                                  pcm.data() + offset, static_cast<int>(m_max_frame), 0);
+        if (samples < 0) {
+            pcm.resize(offset);
+            m_errors++;
+        } else {
+            pcm.resize(offset + static_cast<size_t>(samples));
+            m_packets++;
+            decoded++;
+        }
+        pos += length + (length & 1);
+    }
+
+    return decoded;
+}
+
+void opus_packet_decoder::frame(std::span<const uint8_t> packet, std::vector<uint8_t>& message) {
+    if (packet.empty() || packet.size() > 0xFFFF) {
+        throw std::invalid_argument("Opus packet must be 1 to 65535 bytes");
+    }
+    message.push_back(static_cast<uint8_t>(packet.size() & 0xFF));
+    message.push_back(static_cast<uint8_t>(packet.size() >> 8));
+    message.insert(message.end(), packet.begin(), packet.end());
+    if (packet.size() % 2 != 0) {
+        message.push_back(0);
+    }
+}
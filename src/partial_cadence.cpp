@@ -0,0 +1,27 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "partial_cadence.h"
+#include <algorithm>
+
+void partial_cadence::configure(bool enabled, size_t interval_samples) {
+    m_enabled = enabled;
+    m_interval = interval_samples;
+}
+
+bool partial_cadence::due(bool suspended) {
+    // Suspended or disabled streams keep counting, so the first partial after resuming is not late
+    if (!m_enabled || suspended || m_unreported < std::max<size_t>(1, m_interval)) {
+        return false;
+    }
+    m_unreported = 0;
+    return true;
+}
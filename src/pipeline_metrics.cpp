@@ -0,0 +1,84 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "pipeline_metrics.h"
+#include <cstdio>
+
+const char* pipeline_metrics::stage_name(stage s) noexcept {
+    switch (s) {
+    case stage::capture:    return "capture";
+    case stage::queue:      return "queue";
+    case stage::decode:     return "decode";
+    case stage::parse:      return "parse";
+    case stage::deliver:    return "deliver";
+    case stage::end_to_end: return "end_to_end";
+    }
+    return "unknown";
+}
+
+nlohmann::json pipeline_metrics::to_json() const {
+    nlohmann::json stages = nlohmann::json::object();
+
+    for (size_t i = 0; i < stage_count; ++i) {
+        auto s = m_stages[i].snapshot();
+        if (s.count == 0) {
+            continue;
+        }
+
+        stages[stage_name(static_cast<stage>(i))] = {
+            {"count", s.count},
+            {"mean_ms", s.mean_ms},
+            {"max_ms", s.max_ms},
+            {"p50_ms", s.p50_ms},
+            {"p99_ms", s.p99_ms},
+            {"p999_ms", s.p999_ms}
+        };
+    }
+
+    return stages;
+}
+
+std::string pipeline_metrics::to_prometheus() const {
+    std::string out;
+    out += "# HELP vstream_stage_latency_seconds Latency of each audio pipeline stage\n";
+    out += "# TYPE vstream_stage_latency_seconds summary\n";
+
+    char line[160];
+    for (size_t i = 0; i < stage_count; ++i) {
+        const char* name = stage_name(static_cast<stage>(i));
+        auto s = m_stages[i].snapshot();
+
+        const std::pair<const char*, double> quantiles[] = {
+            {"0.5", s.p50_ms}, {"0.99", s.p99_ms}, {"0.999", s.p999_ms}
+        };
+        for (const auto& [quantile, value_ms] : quantiles) {
+            std::snprintf(line, sizeof(line),
+                          "vstream_stage_latency_seconds{stage=\"%s\",quantile=\"%s\"} %.6f\n",
+                          name, quantile, value_ms / 1000.0);
+            out += line;
+        }
+
+        std::snprintf(line, sizeof(line), "vstream_stage_latency_seconds_sum{stage=\"%s\"} %.6f\n",
+                      name, s.sum_ms / 1000.0);
+        out += line;
+        std::snprintf(line, sizeof(line), "vstream_stage_latency_seconds_count{stage=\"%s\"} %llu\n",
+                      name, static_cast<unsigned long long>(s.count));
+        out += line;
+    }
+
+    return out;
+}
+
+void pipeline_metrics::reset() noexcept {
+    for (auto& histogram : m_stages) {
+        histogram.reset();
+    }
+}
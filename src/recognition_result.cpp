@@ -0,0 +1,416 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "recognition_result.h"
+#include <charconv>
+
+/**
+ * @brief Single-pass scanner for the JSON layout produced by Vosk
+ *
+ * Validates structure while skipping every member it does not need.
+ * Nesting is bounded so hostile input cannot exhaust the stack.
+ */
+class recognition_result::parser {
+public:
+    parser(recognition_result& result, bool with_words)
+        : m_result(result)
+        , m_begin(result.m_raw.data())
+        , m_pos(result.m_raw.data())
+        , m_end(result.m_raw.data() + result.m_raw.size())
+        , m_with_words(with_words) {
+    }
+
+    bool parse_document() {
+        slice text;
+        slice partial;
+        bool has_text = false;
+        bool has_partial = false;
+
+        skip_ws();
+        if (!consume('{')) return false;
+        skip_ws();
+        if (consume('}')) return finish(has_text, text, has_partial, partial);
+
+        for (;;) {
+            std::string_view key;
+            if (!parse_key(key)) return false;
+
+            if (key == "text" && peek('"')) {
+                if (!parse_string(text)) return false;
+                has_text = true;
+            } else if (key == "partial" && peek('"')) {
+                if (!parse_string(partial)) return false;
+                has_partial = true;
+            } else if (key == "alternatives" && peek('[')) {
+                if (!parse_alternatives()) return false;
+            } else if ((key == "result" || key == "partial_result") && m_with_words && peek('[')) {
+                if (!parse_words()) return false;
+            } else if (!skip_value(0)) {
+                return false;
+            }
+
+            skip_ws();
+            if (consume(',')) continue;
+            if (consume('}')) break;
+            return false;
+        }
+
+        skip_ws();
+        return m_pos == m_end && finish(has_text, text, has_partial, partial);
+    }
+
+private:
+    static constexpr int max_depth = 32;
+
+    recognition_result& m_result;
+    const char* m_begin;
+    const char* m_pos;
+    const char* m_end;
+    bool m_with_words;
+
+    bool finish(bool has_text, const slice& text, bool has_partial, const slice& partial) {
+        const auto& alternatives = m_result.m_alternatives;
+
+        if (has_text) {
+            m_result.m_kind = result_kind::final;
+            m_result.m_text = text;
+        } else if (has_partial) {
+            m_result.m_kind = result_kind::partial;
+            m_result.m_text = partial;
+        } else if (!alternatives.empty()) {
+            // N-best finals carry their text only inside the alternatives
+            m_result.m_kind = result_kind::final;
+            m_result.m_text = alternatives.front().text;
+        }
+
+        if (!alternatives.empty()) {
+            m_result.m_confidence = alternatives.front().confidence;
+        }
+        return true;
+    }
+
+    void skip_ws() {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t')) {
+            ++m_pos;
+        }
+    }
+
+    bool peek(char c) const {
+        return m_pos < m_end && *m_pos == c;
+    }
+
+    bool consume(char c) {
+        if (!peek(c)) return false;
+        ++m_pos;
+        return true;
+    }
+
+    bool parse_key(std::string_view& key) {
+        skip_ws();
+        if (!consume('"')) return false;
+
+        const char* start = m_pos;
+        while (m_pos < m_end && *m_pos != '"') {
+            if (*m_pos == '\\') {
+                // Escaped keys never match a field we read, validate and skip
+                m_pos = start - 1;
+                key = {};
+                if (!skip_string()) return false;
+                return colon();
+            }
+            ++m_pos;
+        }
+        if (m_pos >= m_end) return false;
+
+        key = std::string_view(start, static_cast<size_t>(m_pos - start));
+        ++m_pos;
+        return colon();
+    }
+
+    bool colon() {
+        skip_ws();
+        if (!consume(':')) return false;
+        skip_ws();
+        return true;
+    }
+
+    bool skip_string() {
+        if (!consume('"')) return false;
+        while (m_pos < m_end) {
+            char c = *m_pos++;
+            if (c == '"') return true;
+            if (c == '\\') {
+                if (m_pos >= m_end) return false;
+                ++m_pos;
+            }
+        }
+        return false;
+    }
+
+    bool parse_string(slice& out) {
+        if (!consume('"')) return false;
+
+        const char* start = m_pos;
+        while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\') {
+            ++m_pos;
+        }
+        if (m_pos >= m_end) return false;
+
+        if (*m_pos == '"') {
+            out.offset = static_cast<uint32_t>(start - m_begin);
+            out.length = static_cast<uint32_t>(m_pos - start);
+            out.decoded = false;
+            ++m_pos;
+            return true;
+        }
+
+        // Slow path: unescape into the side buffer
+        std::string& decoded = m_result.m_decoded;
+        size_t offset = decoded.size();
+        decoded.append(start, m_pos);
+
+        while (m_pos < m_end) {
+            char c = *m_pos++;
+            if (c == '"') {
+                out.offset = static_cast<uint32_t>(offset);
+                out.length = static_cast<uint32_t>(decoded.size() - offset);
+                out.decoded = true;
+                return true;
+            }
+            if (c != '\\') {
+                decoded.push_back(c);
+                continue;
+            }
+            if (m_pos >= m_end) return false;
+
+            switch (char e = *m_pos++) {
+            case '"': case '\\': case '/': decoded.push_back(e); break;
+            case 'b': decoded.push_back('\b'); break;
+            case 'f': decoded.push_back('\f'); break;
+            case 'n': decoded.push_back('\n'); break;
+            case 'r': decoded.push_back('\r'); break;
+            case 't': decoded.push_back('\t'); break;
+            case 'u': {
+                uint32_t cp = 0;
+                if (!parse_hex4(cp)) return false;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    uint32_t low = 0;
+                    if (m_end - m_pos < 2 || m_pos[0] != '\\' || m_pos[1] != 'u') return false;
+                    m_pos += 2;
+                    if (!parse_hex4(low) || low < 0xDC00 || low > 0xDFFF) return false;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                append_utf8(decoded, cp);
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool parse_hex4(uint32_t& value) {
+        if (m_end - m_pos < 4) return false;
+        auto [ptr, ec] = std::from_chars(m_pos, m_pos + 4, value, 16);
+        if (ec != std::errc() || ptr != m_pos + 4) return false;
+        m_pos = ptr;
+        return true;
+    }
+
+    static void append_utf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    bool parse_number(float& value) {
+        if (m_pos < m_end && *m_pos == '+') return false;
+        auto [ptr, ec] = std::from_chars(m_pos, m_end, value);
+        if (ec != std::errc() || ptr == m_pos) return false;
+        m_pos = ptr;
+        return true;
+    }
+
+    bool skip_literal(std::string_view literal) {
+        if (static_cast<size_t>(m_end - m_pos) < literal.size() ||
+            std::string_view(m_pos, literal.size()) != literal) {
+            return false;
+        }
+        m_pos += literal.size();
+        return true;
+    }
+
+    bool skip_value(int depth) {
+        if (depth > max_depth || m_pos >= m_end) return false;
+
+        switch (*m_pos) {
+        case '"':
+            return skip_string();
+        case '{':
+            ++m_pos;
+            skip_ws();
+            if (consume('}')) return true;
+            for (;;) {
+                std::string_view key;
+                if (!parse_key(key) || !skip_value(depth + 1)) return false;
+                skip_ws();
+                if (consume(',')) continue;
+                return consume('}');
+            }
+        case '[':
+            ++m_pos;
+            skip_ws();
+            if (consume(']')) return true;
+            for (;;) {
+                skip_ws();
+                if (!skip_value(depth + 1)) return false;
+                skip_ws();
+                if (consume(',')) continue;
+                return consume(']');
+            }
+        case 't':
+            return skip_literal("true");
+        case 'f':
+            return skip_literal("false");
+        case 'n':
+            return skip_literal("null");
+        default: {
+            float ignored = 0.0f;
+            return parse_number(ignored);
+        }
+        }
+    }
+
+    template<typename Element>
+    bool parse_array(Element&& parse_element) {
+        if (!consume('[')) return false;
+        skip_ws();
+        if (consume(']')) return true;
+        for (;;) {
+            skip_ws();
+            if (!parse_element()) return false;
+            skip_ws();
+            if (consume(',')) continue;
+            return consume(']');
+        }
+    }
+
+    template<typename Field>
+    bool parse_object(Field&& parse_field) {
+        if (!consume('{')) return false;
+        skip_ws();
+        if (consume('}')) return true;
+        for (;;) {
+            std::string_view key;
+            if (!parse_key(key) || !parse_field(key)) return false;
+            skip_ws();
+            if (consume(',')) continue;
+            return consume('}');
+        }
+    }
+
+    bool parse_words() {
+        auto& words = m_result.m_words;
+        words.clear();
+
+        return parse_array([this, &words] {
+            word w;
+            bool ok = parse_object([this, &w](std::string_view key) {
+                if (key == "word" && peek('"')) return parse_string(w.text);
+                if (key == "start" && !peek('n')) return parse_number(w.start);
+                if (key == "end" && !peek('n')) return parse_number(w.end);
+                if (key == "conf" && !peek('n')) return parse_number(w.confidence);
+                return skip_value(2);
+            });
+            if (ok) words.push_back(w);
+            return ok;
+        });
+    }
+
+    bool parse_alternatives() {
+        auto& alternatives = m_result.m_alternatives;
+
+        return parse_array([this, &alternatives] {
+            alternative alt;
+            bool first = alternatives.empty();
+            bool ok = parse_object([this, &alt, first](std::string_view key) {
+                if (key == "text" && peek('"')) return parse_string(alt.text);
+                if (key == "confidence" && !peek('n')) return parse_number(alt.confidence);
+                // Word timings of the best alternative, when the top level has none
+                if (key == "result" && first && m_with_words && m_result.m_words.empty() && peek('[')) {
+                    return parse_words();
+                }
+                return skip_value(2);
+            });
+            if (ok) alternatives.push_back(alt);
+            return ok;
+        });
+    }
+};
+
+recognition_result::recognition_result() {
+    m_raw.reserve(1024);
+    m_decoded.reserve(256);
+}
+
+bool recognition_result::assign(std::string_view json, bool with_words) {
+    clear();
+    m_raw.assign(json.data(), json.size());
+
+    if (m_raw.empty()) {
+        return true;
+    }
+
+    if (!parser(*this, with_words).parse_document()) {
+        m_kind = result_kind::none;
+        m_text = {};
+        m_confidence = 1.0f;
+        m_words.clear();
+        m_alternatives.clear();
+        return false;
+    }
+    return true;
+}
+
+void recognition_result::clear() {
+    m_raw.clear();
+    m_decoded.clear();
+    m_kind = result_kind::none;
+    m_text = {};
+    m_confidence = 1.0f;
+    m_words.clear();
+    m_alternatives.clear();
+}
+
+std::string_view recognition_result::view(const slice& s) const {
+    const std::string& buffer = s.decoded ? m_decoded : m_raw;
+    if (static_cast<size_t>(s.offset) + s.length > buffer.size()) {
+        return {};
+    }
+    return std::string_view(buffer.data() + s.offset, s.length);
+}
+
+const char* recognition_result::type_name() const {
+    return m_kind == result_kind::final ? "final" : "partial";
+}
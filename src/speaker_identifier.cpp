@@ -0,0 +1,326 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "speaker_identifier.h"
+#include "logger.h"
+#include <vosk_api.h>
+#include <nlohmann/json.hpp>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// ---- utterance_buffer ----
+
+utterance_buffer::utterance_buffer(size_t capacity)
+    : m_ring(std::max<size_t>(1, capacity)) {
+}
+
+void utterance_buffer::append(std::span<const int16_t> samples) {
+    const size_t capacity = m_ring.size();
+    if (samples.size() >= capacity) {
+        // Only the tail fits
+        samples = samples.subspan(samples.size() - capacity);
+        std::copy(samples.begin(), samples.end(), m_ring.begin());
+        m_head = 0;
+        m_size = capacity;
+        return;
+    }
+
+    size_t first = std::min(samples.size(), capacity - m_head);
+    std::copy_n(samples.begin(), first, m_ring.begin() + static_cast<std::ptrdiff_t>(m_head));
+    std::copy(samples.begin() + static_cast<std::ptrdiff_t>(first), samples.end(), m_ring.begin());
+    m_head = (m_head + samples.size()) % capacity;
+    m_size = std::min(capacity, m_size + samples.size());
+}
+
+std::vector<int16_t> utterance_buffer::take() {
+    std::vector<int16_t> out;
+    out.reserve(m_size);
+
+    size_t start = (m_head + m_ring.size() - m_size) % m_ring.size();
+    for (size_t i = 0; i < m_size; ++i) {
+        out.push_back(m_ring[(start + i) % m_ring.size()]);
+    }
+
+    m_head = 0;
+    m_size = 0;
+    return out;
+}
+
+// ---- speaker_tracker ----
+
+speaker_tracker::speaker_tracker(double threshold, size_t max_speakers)
+    : m_threshold(threshold)
+    , m_max_speakers(std::max<size_t>(1, max_speakers)) {
+}
+
+double speaker_tracker::cosine(std::span<const float> a, std::span<const float> b) {
+    if (a.size() != b.size() || a.empty()) {
+        return 0.0;
+    }
+
+    double dot = 0.0, norm_a = 0.0, norm_b = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        dot += static_cast<double>(a[i]) * b[i];
+        norm_a += static_cast<double>(a[i]) * a[i];
+        norm_b += static_cast<double>(b[i]) * b[i];
+    }
+    if (norm_a == 0.0 || norm_b == 0.0) {
+        return 0.0;
+    }
+    return dot / std::sqrt(norm_a * norm_b);
+}
+
+std::string speaker_tracker::assign(std::span<const float> embedding, double& similarity) {
+    size_t best = m_speakers.size();
+    double best_similarity = -1.0;
+    for (size_t i = 0; i < m_speakers.size(); ++i) {
+        double s = cosine(embedding, m_speakers[i].centroid);
+        if (s > best_similarity) {
+            best_similarity = s;
+            best = i;
+        }
+    }
+
+    bool is_new = best == m_speakers.size() ||
+                  (best_similarity < m_threshold && m_speakers.size() < m_max_speakers);
+    if (is_new) {
+        m_speakers.push_back({std::vector<float>(embedding.begin(), embedding.end()), 1});
+        similarity = 1.0;
+        return "S" + std::to_string(m_speakers.size());
+    }
+
+    auto& match = m_speakers[best];
+    match.members++;
+    if (match.centroid.size() == embedding.size()) {
+        for (size_t i = 0; i < embedding.size(); ++i) {
+            match.centroid[i] += (embedding[i] - match.centroid[i]) / static_cast<float>(match.members);
+        }
+    }
+    similarity = best_similarity;
+    return "S" + std::to_string(best + 1);
+}
+
+// ---- speaker_identifier ----
+
+speaker_identifier::session_state::session_state(const config& cfg)
+    : audio(static_cast<size_t>(cfg.sample_rate) * static_cast<size_t>(cfg.max_utterance_ms) / 1000)
+    , tracker(cfg.match_threshold)
+    , last_used(std::chrono::steady_clock::now()) {
+}
+
+speaker_identifier::recognizer_cache::~recognizer_cache() {
+    if (recognizer) {
+        vosk_recognizer_free(recognizer);
+    }
+}
+
+speaker_identifier::speaker_identifier(const config& cfg, label_handler_t on_label, embedder_t embedder)
+    : m_config(cfg)
+    , m_on_label(std::move(on_label))
+    , m_embedder(std::move(embedder)) {
+
+    if (m_config.threads == 0) {
+        throw std::invalid_argument("Speaker identification needs at least one thread");
+    }
+
+    if (!m_embedder) {
+        m_spk_model = vosk_spk_model_new(m_config.model_path.c_str());
+        if (!m_spk_model) {
+            throw std::runtime_error("Failed to load speaker model from: " + m_config.model_path);
+        }
+    }
+
+    for (size_t i = 0; i < m_config.threads; ++i) {
+        m_threads.emplace_back(&speaker_identifier::worker_loop, this);
+    }
+    LOG_INFO("Speaker identification running on " + std::to_string(m_config.threads) + " thread(s)");
+}
+
+speaker_identifier::~speaker_identifier() {
+    stop();
+    if (m_spk_model) {
+        vosk_spk_model_free(m_spk_model);
+    }
+}
+
+void speaker_identifier::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+        m_pending.fetch_sub(m_queue.size(), std::memory_order_relaxed);
+        m_queue.clear();
+    }
+    m_queue_cv.notify_all();
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+std::shared_ptr<speaker_identifier::session_state> speaker_identifier::get_session(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    auto& entry = m_sessions[session_id];
+    if (!entry) {
+        entry = std::make_shared<session_state>(m_config);
+    }
+    entry->last_used = std::chrono::steady_clock::now();
+    return entry;
+}
+
+void speaker_identifier::append(const std::string& session_id, std::span<const int16_t> samples) {
+    if (samples.empty()) {
+        return;
+    }
+    get_session(session_id)->audio.append(samples);
+}
+
+uint64_t speaker_identifier::end_utterance(const std::string& session_id, std::shared_ptr<VoskModel> model,
+                                           std::string text) {
+    auto session = get_session(session_id);
+    uint64_t utterance_id = ++session->utterances;
+    auto audio = session->audio.take();
+
+    if (audio.size() * 1000 < static_cast<size_t>(m_config.sample_rate) * static_cast<size_t>(m_config.min_utterance_ms)) {
+        m_short.fetch_add(1, std::memory_order_relaxed);
+        return utterance_id;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (!m_running || m_queue.size() >= m_config.max_pending) {
+            m_skipped.fetch_add(1, std::memory_order_relaxed);
+            return utterance_id;
+        }
+        m_queue.push_back({std::move(session), session_id, utterance_id, std::move(text),
+                           std::move(audio), std::move(model)});
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_queue_cv.notify_one();
+    return utterance_id;
+}
+
+std::vector<speaker_identifier::label> speaker_identifier::recent_labels(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    auto it = m_sessions.find(session_id);
+    if (it == m_sessions.end()) {
+        return {};
+    }
+    return {it->second->recent.begin(), it->second->recent.end()};
+}
+
+void speaker_identifier::release_session(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    m_sessions.erase(session_id);
+}
+
+size_t speaker_identifier::evict_idle_sessions(std::chrono::milliseconds timeout) {
+    auto cutoff = std::chrono::steady_clock::now() - timeout;
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    return std::erase_if(m_sessions, [cutoff](const auto& entry) {
+        return entry.second->last_used < cutoff;
+    });
+}
+
+void speaker_identifier::worker_loop() {
+    // Embeddings are never urgent; leave the CPU to the decode workers
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), m_config.nice) != 0) {
+        LOG_DEBUG("Failed to lower speaker identification thread priority");
+    }
+
+    recognizer_cache cache;
+
+    while (true) {
+        job next;
+        {
+            std::unique_lock<std::mutex> lock(m_queue_mutex);
+            m_queue_cv.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+            if (!m_running) {
+                return;
+            }
+            next = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        int frames = 0;
+        std::vector<float> embedding;
+        try {
+            embedding = m_embedder ? m_embedder(next.model.get(), next.audio, frames)
+                                   : vosk_embedding(cache, next.model.get(), next.audio, frames);
+        } catch (const std::exception& e) {
+            LOG_WARNING("Speaker embedding failed for session " + next.session_id + ": " + e.what());
+        }
+        m_pending.fetch_sub(1, std::memory_order_relaxed);
+
+        if (embedding.empty()) {
+            continue;
+        }
+
+        label result;
+        result.session_id = next.session_id;
+        result.utterance_id = next.utterance_id;
+        result.text = std::move(next.text);
+        result.frames = frames;
+        {
+            std::lock_guard<std::mutex> lock(m_sessions_mutex);
+            result.speaker = next.session->tracker.assign(embedding, result.similarity);
+            next.session->recent.push_back(result);
+            if (next.session->recent.size() > recent_label_count) {
+                next.session->recent.pop_front();
+            }
+        }
+        m_labelled.fetch_add(1, std::memory_order_relaxed);
+
+        if (m_on_label) {
+            try {
+                m_on_label(result);
+            } catch (const std::exception& e) {
+                LOG_WARNING("Speaker label handler failed: " + std::string(e.what()));
+            }
+        }
+    }
+}
+
+std::vector<float> speaker_identifier::vosk_embedding(recognizer_cache& cache, VoskModel* model,
+                                                      std::span<const int16_t> audio, int& frames) {
+    if (!model) {
+        return {};
+    }
+
+    if (cache.model != model) {
+        if (cache.recognizer) {
+            vosk_recognizer_free(cache.recognizer);
+        }
+        cache.recognizer = vosk_recognizer_new_spk(model, static_cast<float>(m_config.sample_rate), m_spk_model);
+        cache.model = cache.recognizer ? model : nullptr;
+        if (!cache.recognizer) {
+            throw std::runtime_error("Failed to create speaker recognizer");
+        }
+    }
+
+    vosk_recognizer_accept_waveform_s(cache.recognizer, audio.data(), static_cast<int>(audio.size()));
+    auto result = nlohmann::json::parse(vosk_recognizer_final_result(cache.recognizer), nullptr, false);
+    vosk_recognizer_reset(cache.recognizer);
+
+    if (!result.is_object() || !result.contains("spk") || !result["spk"].is_array()) {
+        return {};
+    }
+    frames = result.value("spk_frames", 0);
+    return result["spk"].get<std::vector<float>>();
+}
@@ -0,0 +1,182 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "voice_activity_detector.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+voice_activity_detector::voice_activity_detector()
+    : voice_activity_detector(config{}) {
+}
+
+voice_activity_detector::voice_activity_detector(const config& cfg)
+    : m_config(cfg) {
+
+    if (m_config.sample_rate <= 0 || m_config.frame_ms <= 0) {
+        throw std::invalid_argument("VAD sample rate and frame length must be positive");
+    }
+
+    m_frame_samples = static_cast<size_t>(m_config.sample_rate) * m_config.frame_ms / 1000;
+    if (m_frame_samples == 0) {
+        throw std::invalid_argument("VAD frame is shorter than one sample");
+    }
+
+    m_hangover_frames = std::max(0, m_config.hangover_ms / m_config.frame_ms);
+    m_min_speech_frames = std::max(1, m_config.min_speech_ms / m_config.frame_ms);
+
+    m_pending.reserve(m_frame_samples);
+    m_frame_decisions.reserve(64);
+}
+
+void voice_activity_detector::reset() {
+    m_in_speech = false;
+    m_speech_run = 0;
+    m_hangover_left = 0;
+    m_silence_frames = 0;
+    m_pending.clear();
+    m_frame_decisions.clear();
+}
+
+voice_activity_detector::decision voice_activity_detector::process(std::span<const int16_t> audio) {
+    decision result;
+    m_frame_decisions.clear();
+
+    // Complete the frame left over from the previous chunk
+    if (!m_pending.empty()) {
+        size_t needed = std::min(m_frame_samples - m_pending.size(), audio.size());
+        m_pending.insert(m_pending.end(), audio.begin(), audio.begin() + needed);
+        audio = audio.subspan(needed);
+
+        if (m_pending.size() < m_frame_samples) {
+            return result;
+        }
+        process_frame(m_pending, result);
+        m_pending.clear();
+    }
+
+    // Whole frames are analyzed in place
+    while (audio.size() >= m_frame_samples) {
+        process_frame(audio.first(m_frame_samples), result);
+        audio = audio.subspan(m_frame_samples);
+    }
+
+    m_pending.assign(audio.begin(), audio.end());
+    return result;
+}
+
+void voice_activity_detector::process_frame(std::span<const int16_t> frame, decision& result) {
+    bool raw_speech = classify(analyze(frame));
+    m_speech_run = raw_speech ? m_speech_run + 1 : 0;
+
+    bool frame_speech = false;
+    if (m_in_speech) {
+        if (raw_speech) {
+            m_hangover_left = m_hangover_frames;
+            frame_speech = true;
+        } else if (m_hangover_left > 0) {
+            m_hangover_left--;
+            frame_speech = true;
+        } else {
+            m_in_speech = false;
+            result.endpoint = true;
+        }
+    } else if (m_speech_run >= m_min_speech_frames) {
+        m_in_speech = true;
+        m_hangover_left = m_hangover_frames;
+        frame_speech = true;
+        if (!result.speech) {
+            result.silence_frames_before = m_silence_frames;
+        }
+        m_silence_frames = 0;
+    }
+
+    if (!m_in_speech) {
+        m_silence_frames++;
+    }
+
+    result.speech = result.speech || frame_speech;
+    m_frame_decisions.push_back(frame_speech ? 1 : 0);
+}
+
+bool voice_activity_detector::classify(const frame_features& features) {
+    const double threshold = std::max<double>(m_config.threshold_db,
+                                              m_noise_floor_db + m_config.noise_margin_db);
+    const bool loud = features.energy_db > threshold;
+
+    // Quiet but very "busy" frames are broadband noise, loud ones are speech regardless
+    const bool speech = loud && (features.zero_crossing_rate <= m_config.max_zero_crossing_rate ||
+                                 features.energy_db > threshold + 15.0);
+
+    if (!speech && !m_in_speech) {
+        // Follow the noise floor down quickly and up slowly
+        double rate = features.energy_db < m_noise_floor_db ? 0.2 : 0.02;
+        m_noise_floor_db += rate * (features.energy_db - m_noise_floor_db);
+        m_noise_floor_db = std::clamp(m_noise_floor_db, -90.0, -20.0);
+    }
+
+    return speech;
+}
+
+voice_activity_detector::frame_features voice_activity_detector::analyze(std::span<const int16_t> frame) {
+    frame_features features;
+    const size_t n = frame.size();
+    if (n == 0) {
+        return features;
+    }
+
+    const int16_t* data = frame.data();
+    uint64_t sum_squares = 0;
+    size_t crossings = 0;
+    size_t i = 0;
+
+#if defined(__AVX512BW__)
+    // 32 samples per step; madd pairs fit in uint32, widen before accumulating
+    __m512i acc = _mm512_setzero_si512();
+    for (; i + 32 <= n; i += 32) {
+        __m512i v = _mm512_loadu_si512(data + i);
+        __m512i sq = _mm512_madd_epi16(v, v);
+        acc = _mm512_add_epi64(acc, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(sq)));
+        acc = _mm512_add_epi64(acc, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(sq, 1)));
+    }
+    sum_squares = static_cast<uint64_t>(_mm512_reduce_add_epi64(acc));
+
+    // Sign of a ^ b is set where neighbouring samples differ in sign
+    size_t j = 0;
+    for (; j + 33 <= n; j += 32) {
+        __m512i a = _mm512_loadu_si512(data + j);
+        __m512i b = _mm512_loadu_si512(data + j + 1);
+        crossings += static_cast<size_t>(__builtin_popcount(
+            _mm512_movepi16_mask(_mm512_xor_si512(a, b))));
+    }
+    for (size_t k = j + 1; k < n; ++k) {
+        crossings += (data[k - 1] ^ data[k]) < 0;
+    }
+#else
+    for (size_t j = 1; j < n; ++j) {
+        crossings += (data[j - 1] ^ data[j]) < 0;
+    }
+#endif
+
+    for (; i < n; ++i) {
+        int32_t s = data[i];
+        sum_squares += static_cast<uint32_t>(s * s);
+    }
+
+    const double mean_square = static_cast<double>(sum_squares) / static_cast<double>(n);
+    features.energy_db = 10.0 * std::log10(mean_square / (32768.0 * 32768.0) + 1e-12);
+    features.zero_crossing_rate = static_cast<float>(crossings) / static_cast<float>(n);
+    return features;
+}
@@ -12,6 +12,7 @@
 #include "vstream_app.h"
 #include "benchmark_manager.h"
 #include "logger.h"
+#include "huge_page_advisor.h"
 #include <vosk_api.h>
 #include <iostream>
 #include <csignal>
@@ -20,21 +21,49 @@
 #include <algorithm>
 #include <fstream>
 #include <sstream>
+#include <filesystem>
+#include <iomanip>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 // Global pointer for signal handling
 static vstream_app* g_app_instance = nullptr;
 
-// Signal handler
-void signal_handler(int signal) {
-    LOG_INFO("Received signal " + std::to_string(signal) + ", shutting down...");
+// The handlers only set flags and write the wake eventfd; the main loop does the rest
+static_assert(std::atomic<bool>::is_always_lock_free, "Signal handlers need lock-free flags");
+
+// SIGINT: stop from the main loop
+void signal_handler(int /*signal*/) {
+    if (g_app_instance) {
+        g_app_instance->request_stop();
+    }
+}
+
+// SIGTERM: finish open sessions before exiting
+void drain_signal_handler(int /*signal*/) {
+    if (g_app_instance) {
+        g_app_instance->request_drain();
+    }
+}
+
+// SIGHUP: reload the model from the main loop
+void reload_signal_handler(int /*signal*/) {
     if (g_app_instance) {
-        g_app_instance->stop();
+        g_app_instance->request_model_reload();
     }
 }
 
 vstream_app::vstream_app(const config& cfg) : m_config(cfg) {
     validate_config(m_config);
 
+    m_wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wake_fd < 0) {
+        throw std::runtime_error("Cannot create main loop event: " + std::string(std::strerror(errno)));
+    }
+
     // Initialize logger
     logger::instance().init(false, false);
     logger::instance().set_min_level(logger::Level::DEBUG);
@@ -46,11 +75,15 @@ vstream_app::vstream_app(const config& cfg) : m_config(cfg) {
 
     // Record start time
     m_start_time = std::chrono::steady_clock::now();
+    m_last_eviction_check = m_start_time;
+    m_last_stats_log = m_start_time;
 }
 
 vstream_app::~vstream_app() {
     stop();
+    join_reload_thread();
     g_app_instance = nullptr;
+    ::close(m_wake_fd);
 }
 
 int vstream_app::run() {
@@ -71,7 +104,16 @@ int vstream_app::run() {
 
         // Initialize components
         initialize_engine();
+
+        if (!m_config.input_path.empty()) {
+            return run_file_transcription();
+        }
+
+        initialize_dispatcher();
         initialize_server();
+        initialize_metrics_server();
+        initialize_local_ingest();
+        initialize_speaker_identifier();
 
         if (m_config.benchmark_enabled) {
             initialize_benchmark();
@@ -98,38 +140,34 @@ int vstream_app::run() {
         // Mark as running
         m_running = true;
 
-        // Main application loop
+        // Main application loop: periodic upkeep, or sooner when woken by stop, drain or reload
         while (m_running.load()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            wait_for_wakeup(std::chrono::milliseconds(1000));
+            if (m_stop_requested.exchange(false)) {
+                stop();
+                break;
+            }
+            evict_idle_sessions();
+            update_load();
             print_periodic_stats();
-        }
 
-        LOG_INFO("Shutting down...");
-
-        // Stop benchmark and export results
-        if (m_benchmark && m_config.benchmark_enabled) {
-            LOG_INFO("Finalizing benchmark results...");
-            auto results = m_benchmark->stop();
+            if (m_reload_requested.exchange(false)) {
+                reload_model(m_engine->get_model_path());
+            }
 
-            std::string output_file = m_config.benchmark_output_file;
-            if (output_file.empty()) {
-                output_file = "benchmark_results_" +
-                              std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
-                                                 std::chrono::system_clock::now().time_since_epoch()).count()) + ".txt";
+            if (m_drain_requested.load() && !m_draining.load()) {
+                begin_drain();
+            }
+            if (m_draining.load()) {
+                drain_sessions();
             }
+        }
 
-            m_benchmark->export_results(results, output_file, m_config.model_path);
+        LOG_INFO("Shutting down...");
+        join_reload_thread();
 
-            // Print summary to console
-            std::cout << "\n=== BENCHMARK SUMMARY ===\n";
-            std::cout << "Word Error Rate: " << std::fixed << std::setprecision(2)
-                      << results.word_error_rate << "%\n";
-            std::cout << "Character Error Rate: " << results.character_error_rate << "%\n";
-            std::cout << "Real-time Factor: " << results.real_time_factor << "x\n";
-            std::cout << "Average Latency: " << results.average_latency_ms << " ms\n";
-            std::cout << "Average Confidence: " << results.average_confidence << "\n";
-            std::cout << "Results exported to: " << output_file << "\n";
-        }
+        // Stop benchmark and export results
+        finish_benchmark();
 
         // Cleanup microphone
         if (m_mic) {
@@ -143,6 +181,22 @@ int vstream_app::run() {
         std::cout << "Stopping server...\n";
         m_server->stop();
 
+        if (m_local_ingest) {
+            m_local_ingest->stop();
+        }
+
+        if (m_dispatcher) {
+            m_dispatcher->stop();
+        }
+
+        if (m_speakers) {
+            m_speakers->stop();
+        }
+
+        if (m_metrics_server) {
+            m_metrics_server->stop();
+        }
+
         LOG_INFO("Server stopped successfully");
         std::cout << "Server stopped successfully.\n";
 
@@ -158,24 +212,444 @@ int vstream_app::run() {
 void vstream_app::stop() {
     LOG_INFO("Stop requested");
     m_running = false;
+    wake_main_loop();
+
+    if (m_transcriber) {
+        m_transcriber->cancel();
+    }
+}
+
+void vstream_app::request_stop() {
+    m_stop_requested = true;
+    wake_main_loop();
+}
+
+void vstream_app::request_drain() {
+    // A second request stops right away; so does one in batch mode (see watch_file_transcription)
+    if (m_drain_requested.exchange(true)) {
+        m_stop_requested = true;
+    }
+    wake_main_loop();
+}
+
+void vstream_app::request_model_reload() {
+    m_reload_requested = true;
+    wake_main_loop();
+}
+
+void vstream_app::wake_main_loop() {
+    uint64_t one = 1;
+    [[maybe_unused]] auto n = ::write(m_wake_fd, &one, sizeof(one));
+}
+
+void vstream_app::wait_for_wakeup(std::chrono::milliseconds timeout) {
+    pollfd pfd{};
+    pfd.fd = m_wake_fd;
+    pfd.events = POLLIN;
+    if (::poll(&pfd, 1, static_cast<int>(timeout.count())) > 0) {
+        uint64_t count;
+        [[maybe_unused]] auto n = ::read(m_wake_fd, &count, sizeof(count));
+    }
+}
+
+void vstream_app::begin_drain() {
+    m_draining = true;
+    if (m_config.drain_timeout_ms == 0) {
+        LOG_INFO("Drain requested without a timeout, stopping");
+        m_running = false;
+        return;
+    }
+
+    m_drain_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_config.drain_timeout_ms);
+    if (m_dispatcher) {
+        m_dispatcher->set_accepting_sessions(false);
+    }
+
+    LOG_INFO("Draining " + std::to_string(active_client_sessions()) + " session(s), up to " +
+             std::to_string(m_config.drain_timeout_ms) + " ms");
+    std::cout << "Draining sessions...\n";
+}
+
+void vstream_app::drain_sessions() {
+    // A session is done once it sent nothing for this long and has no queued audio
+    constexpr auto quiet = std::chrono::milliseconds(1000);
+
+    bool expired = std::chrono::steady_clock::now() >= m_drain_deadline;
+    if (m_dispatcher) {
+        for (const auto& session_id : m_dispatcher->take_idle_sessions(expired ? std::chrono::milliseconds(0) : quiet)) {
+            finalize_session(session_id);
+        }
+    }
+
+    size_t remaining = active_client_sessions();
+    if (remaining == 0) {
+        LOG_INFO("Drain complete, " + std::to_string(m_counters.get(counter_registry::counter::drained_sessions)) + " session(s) finalized");
+        m_running = false;
+    } else if (expired) {
+        LOG_WARNING("Drain deadline passed with " + std::to_string(remaining) + " session(s) still decoding");
+        m_running = false;
+    }
+}
+
+void vstream_app::finalize_session(const std::string& session_id) {
+    // Capture channels flush through their own processor
+    if (find_mic_channel(session_id)) {
+        return;
+    }
+
+    try {
+        auto engine = engine_for_session(session_id);
+        if (!engine->has_session(session_id)) {
+            return;
+        }
+
+        recognition_result result;
+        engine->process_audio(session_id, std::span<const int16_t>{}, result, true);
+        do {
+            deliver_websocket_result(session_id, result, 0, 0.0);
+        } while (engine->next_final(session_id, result));
+        engine->release_session(session_id);
+
+        // The client went quiet, its queued final results go out as plain transcripts
+        for (const auto& message : m_websocket_outbox.take(session_id)) {
+            if (message.transcript) {
+                m_server->queue_transcription(message.text, session_id, message.confidence);
+            }
+        }
+        m_counters.add(counter_registry::counter::drained_sessions);
+    } catch (const std::exception& e) {
+        LOG_WARNING("Failed to finalize session " + session_id + ": " + e.what());
+    }
+}
+
+size_t vstream_app::active_client_sessions() const {
+    if (!m_dispatcher) {
+        return 0;
+    }
+
+    size_t sessions = m_dispatcher->get_session_count();
+    for (const auto& channel : m_mic_channels) {
+        if (sessions > 0 && m_dispatcher->has_session(channel.processor->get_session_id())) {
+            sessions--;
+        }
+    }
+    return sessions;
+}
+
+json vstream_app::get_health() const {
+    json health;
+    bool saturated = m_load && m_load->get_level() == load_monitor::level::reject;
+
+    health["status"] = is_draining() ? "draining" : saturated ? "saturated" : "ok";
+    health["active_sessions"] = active_client_sessions();
+    health["queue_depth"] = m_dispatcher ? m_dispatcher->get_queue_depth() : 0;
+    health["decode_threads"] = m_dispatcher ? m_dispatcher->get_thread_count() : 0;
+
+    if (m_load) {
+        health["load"] = m_load->get_load();
+        health["load_level"] = load_monitor::level_name(m_load->get_level());
+        health["real_time_factor"] = m_load->get_real_time_factor();
+    }
+
+    if (m_draining.load() && m_config.drain_timeout_ms > 0) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            m_drain_deadline - std::chrono::steady_clock::now()).count();
+        health["drain_remaining_ms"] = std::max<int64_t>(0, left);
+    }
+
+    return health;
+}
+
+int vstream_app::run_file_transcription() {
+    auto inputs = file_transcriber::collect_inputs(m_config.input_path);
+
+    if (m_config.benchmark_enabled) {
+        initialize_benchmark();
+    }
+
+    file_transcriber::config batch_config;
+    batch_config.num_threads = decode_thread_count();
+    batch_config.sample_rate = m_config.sample_rate;
+    batch_config.silence_threshold_db = m_config.vad_threshold_db;
+
+    m_transcriber = std::make_unique<file_transcriber>(
+        *m_engine, batch_config, m_config.benchmark_enabled ? m_benchmark.get() : nullptr);
+
+    std::cout << "Transcribing " << inputs.size() << " file(s) from " << m_config.input_path << "...\n";
+
+    m_running = true;
+    std::thread watcher(&vstream_app::watch_file_transcription, this);
+    auto start = std::chrono::steady_clock::now();
+    auto results = m_transcriber->transcribe(inputs);
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start).count();
+    m_running = false;
+    wake_main_loop();
+    watcher.join();
+
+    if (!m_config.transcript_dir.empty()) {
+        std::filesystem::create_directories(m_config.transcript_dir);
+    }
+
+    double audio_ms = 0.0;
+    size_t failed = 0;
+    for (const auto& result : results) {
+        if (!result.error.empty()) {
+            std::cerr << "Failed: " << result.path << ": " << result.error << "\n";
+            failed++;
+            continue;
+        }
+        audio_ms += result.duration_ms;
+
+        if (m_config.transcript_dir.empty()) {
+            std::cout << "[FILE] " << result.path << "\n";
+            std::cout << "[FINAL] " << result.text << "\n";
+        } else {
+            auto out_path = std::filesystem::path(m_config.transcript_dir) /
+                            std::filesystem::path(result.path).filename().replace_extension(".txt");
+            std::ofstream out(out_path);
+            if (!out) {
+                throw std::runtime_error("Cannot write transcript: " + out_path.string());
+            }
+            out << result.text << "\n";
+        }
+    }
+
+    LOG_INFO("Transcribed " + std::to_string(results.size() - failed) + " file(s), " +
+             std::to_string(audio_ms / 1000.0) + " s of audio in " +
+             std::to_string(elapsed_ms / 1000.0) + " s");
+    std::cout << "Transcribed " << results.size() - failed << " file(s): "
+              << std::fixed << std::setprecision(1) << audio_ms / 1000.0 << " s of audio in "
+              << elapsed_ms / 1000.0 << " s (" << std::setprecision(2)
+              << (elapsed_ms > 0 ? audio_ms / elapsed_ms : 0.0) << "x real time)\n";
+
+    finish_benchmark();
+    m_transcriber.reset();
+
+    return failed == 0 ? 0 : 1;
+}
+
+void vstream_app::watch_file_transcription() {
+    // The main thread is busy transcribing, so signals are acted on here
+    while (m_running.load()) {
+        wait_for_wakeup(std::chrono::milliseconds(1000));
+        if (m_stop_requested.exchange(false) || m_drain_requested.load()) {
+            stop();
+        }
+    }
+}
+
+void vstream_app::finish_benchmark() {
+    if (m_benchmark && m_config.benchmark_enabled) {
+        LOG_INFO("Finalizing benchmark results...");
+        auto results = m_benchmark->stop();
+
+        std::string output_file = m_config.benchmark_output_file;
+        if (output_file.empty()) {
+            output_file = "benchmark_results_" +
+                          std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+                                             std::chrono::system_clock::now().time_since_epoch()).count()) + ".txt";
+        }
+
+        m_benchmark->export_results(results, output_file, m_config.model_path);
+
+        // Print summary to console
+        std::cout << "\n=== BENCHMARK SUMMARY ===\n";
+        std::cout << "Word Error Rate: " << std::fixed << std::setprecision(2)
+                  << results.word_error_rate << "%\n";
+        std::cout << "Character Error Rate: " << results.character_error_rate << "%\n";
+        std::cout << "Real-time Factor: " << results.real_time_factor << "x\n";
+        std::cout << "Average Latency: " << results.average_latency_ms << " ms\n";
+        std::cout << "Average Confidence: " << results.average_confidence << "\n";
+        std::cout << "Results exported to: " << output_file << "\n";
+    }
+}
+
+bool vstream_app::reload_model(const std::string& model_path) {
+    if (!m_engine || m_reloading.exchange(true)) {
+        return false;
+    }
+
+    join_reload_thread();
+
+    LOG_INFO("Reloading model in the background: " + model_path);
+    std::cout << "Loading model " << model_path << " in the background...\n";
+
+    m_reload_thread = std::thread([this, model_path] {
+        try {
+            for (size_t node = 0; node < m_replicas.size(); ++node) {
+                place_model_load(static_cast<int>(node), [&] { m_replicas[node]->load_model(model_path); });
+            }
+            if (m_replicas.empty()) {
+                place_model_load(-1, [&] { m_engine->load_model(model_path); });
+            }
+            std::cout << "Model " << model_path << " active for new utterances\n";
+        } catch (const std::exception& e) {
+            LOG_ERROR("Model reload failed, keeping the current model: " + std::string(e.what()));
+            std::cerr << "Model reload failed: " << e.what() << "\n";
+        }
+        m_reloading = false;
+    });
+    return true;
+}
+
+void vstream_app::join_reload_thread() {
+    if (m_reload_thread.joinable()) {
+        m_reload_thread.join();
+    }
 }
 
 json vstream_app::get_stats() const {
     auto uptime = std::chrono::steady_clock::now() - m_start_time;
 
+    auto counters = m_counters.snapshot();
+
     json stats;
     stats["uptime_seconds"] = std::chrono::duration_cast<std::chrono::seconds>(uptime).count();
-    stats["messages_processed"] = m_messages_processed.load();
+    stats["messages_processed"] = counters[counter_registry::counter::messages_processed];
+    stats["audio_chunks"] = counters[counter_registry::counter::audio_chunks];
+    stats["results_delivered"] = counters[counter_registry::counter::results_delivered];
     stats["running"] = m_running.load();
 
     if (m_engine) {
-        stats["samples_processed"] = m_engine->get_total_samples_processed();
+        stats["samples_processed"] = total_samples_processed();
+        size_t sessions = 0;
+        for (const auto& engine : m_models ? m_models->loaded_engines() : std::vector{m_engine}) {
+            sessions += engine->get_session_count();
+        }
+        stats["active_sessions"] = sessions;
+        stats["model_path"] = m_engine->get_model_path();
+        stats["model_generation"] = m_engine->get_model_generation();
+        stats["model_reloading"] = m_reloading.load();
+
+        if (m_models) {
+            json models = json::array();
+            for (const auto& model : m_models->status()) {
+                models.push_back({
+                    {"name", model.name},
+                    {"path", model.path},
+                    {"loaded", model.loaded},
+                    {"resident", model.resident},
+                    {"references", model.references},
+                    {"memory_mb", model.memory_mb}
+                });
+            }
+            stats["models"] = std::move(models);
+            stats["model_memory_mb"] = m_models->memory_used_mb();
+            stats["model_memory_budget_mb"] = m_models->memory_budget_mb();
+            stats["model_loads"] = m_models->get_load_count();
+            stats["model_unloads"] = m_models->get_unload_count();
+        }
+
+        const auto& grammars = m_engine->get_grammar_cache();
+        stats["grammar_cache"] = {
+            {"size", grammars.size()},
+            {"capacity", grammars.capacity()},
+            {"hits", grammars.get_hit_count()},
+            {"misses", grammars.get_miss_count()}
+        };
+
+        json placement = {
+            {"numa_mode", m_config.numa_mode},
+            {"numa_nodes", m_topology.node_count()},
+            {"model_replicas", std::max<size_t>(1, m_replicas.size())},
+            {"huge_pages", m_config.huge_pages},
+            {"huge_pages_advised_mb", m_huge_pages_advised_mb.load()},
+            {"huge_pages_mb", huge_page_advisor::huge_pages_kb() / 1024}
+        };
+        if (!m_worker_cpus.empty()) {
+            json workers = json::array();
+            for (size_t i = 0; i < m_worker_cpus.size(); ++i) {
+                int cpu = m_worker_cpus[i];
+                int node = m_topology.node_index_of_cpu(cpu);
+                workers.push_back({
+                    {"worker", i},
+                    {"cpu", cpu},
+                    {"node", node >= 0 ? m_topology.nodes()[static_cast<size_t>(node)].id : -1}
+                });
+            }
+            placement["workers"] = std::move(workers);
+        }
+        stats["placement"] = std::move(placement);
+
+        stats["backend"] = m_config.backend;
+        if (auto* gpu = m_engine->get_batch_decoder()) {
+            uint64_t batches = gpu->get_batch_count();
+            stats["gpu_batches"] = batches;
+            stats["gpu_mean_batch_size"] = batches > 0
+                ? static_cast<double>(gpu->get_chunk_count()) / static_cast<double>(batches)
+                : 0.0;
+        }
     }
 
     if (m_server) {
         stats["connected_clients"] = m_server->get_client_count();
     }
 
+    stats["draining"] = is_draining();
+    stats["drained_sessions"] = counters[counter_registry::counter::drained_sessions];
+
+    if (m_speakers) {
+        stats["speaker_id"] = {
+            {"threads", m_speakers->get_thread_count()},
+            {"pending", m_speakers->get_pending()},
+            {"labelled", m_speakers->get_labelled_count()},
+            {"skipped", m_speakers->get_skipped_count()},
+            {"too_short", m_speakers->get_short_count()}
+        };
+    }
+
+    if (m_local_ingest) {
+        stats["local_ingest"] = {
+            {"path", m_local_ingest->path()},
+            {"connections", m_local_ingest->get_connection_count()},
+            {"frames", m_local_ingest->get_frames_received()},
+            {"bytes", m_local_ingest->get_bytes_received()},
+            {"protocol_errors", m_local_ingest->get_protocol_errors()},
+            {"dropped_results", m_local_ingest->get_dropped_results()}
+        };
+    }
+
+    if (m_dispatcher) {
+        stats["decode_threads"] = m_dispatcher->get_thread_count();
+        stats["decode_queue_depth"] = m_dispatcher->get_queue_depth();
+        stats["decode_steals"] = m_dispatcher->get_steal_count();
+    }
+
+    if (m_load && m_dispatcher) {
+        stats["load"] = {
+            {"level", load_monitor::level_name(m_load->get_level())},
+            {"load", m_load->get_load()},
+            {"utilization", m_load->get_utilization()},
+            {"real_time_factor", m_load->get_real_time_factor()},
+            {"queue_wait_ms", m_load->get_queue_wait_ms()},
+            {"shedding_enabled", m_config.load_shedding},
+            {"accepting_sessions", m_dispatcher->is_accepting_sessions()},
+            {"dropped_chunks", m_dispatcher->get_dropped_count()},
+            {"rejected_chunks", m_dispatcher->get_rejected_count()}
+        };
+    }
+
+    stats["latency"] = m_metrics.to_json();
+
+    stats["vad_enabled"] = m_config.vad_enabled;
+    if (m_config.vad_enabled) {
+        size_t skipped = counters[counter_registry::counter::vad_skipped_chunks];
+        if (m_processor) {
+            skipped += m_processor->get_skipped_chunks();
+        }
+        for (const auto& channel : m_mic_channels) {
+            skipped += channel.processor->get_skipped_chunks();
+        }
+        stats["vad_skipped_chunks"] = skipped;
+    }
+
+    stats["adaptive_chunks"] = m_config.adaptive_chunks;
+    stats["chunk_adjustments"] = counters[counter_registry::counter::chunk_adjustments];
+
+    stats["opus_packets"] = counters[counter_registry::counter::opus_packets];
+    stats["opus_errors"] = counters[counter_registry::counter::opus_errors];
+
     if (m_mic) {
         stats["microphone_enabled"] = true;
         stats["dropped_frames"] = m_mic->get_dropped_frames();
@@ -185,7 +659,7 @@ json vstream_app::get_stats() const {
 
     // Add benchmark stats if enabled
     if (m_benchmark && m_config.benchmark_enabled) {
-        auto benchmark_results = m_benchmark->get_current_results();
+        auto benchmark_results = m_benchmark->get_current_results(false);
         stats["benchmark"] = {
             {"enabled", true},
             {"word_error_rate", benchmark_results.word_error_rate},
@@ -196,6 +670,9 @@ json vstream_app::get_stats() const {
             {"partial_segments", benchmark_results.partial_segments},
             {"final_segments", benchmark_results.final_segments}
         };
+        if (!m_config.benchmark_segments_file.empty()) {
+            stats["benchmark"]["streamed_segments"] = m_benchmark->get_streamed_segments();
+        }
     } else {
         stats["benchmark"] = {{"enabled", false}};
     }
@@ -203,6 +680,62 @@ json vstream_app::get_stats() const {
     return stats;
 }
 
+std::string vstream_app::get_prometheus_metrics() const {
+    std::string out = m_metrics.to_prometheus();
+
+    auto gauge = [&out](const char* name, const char* type, const char* help, double value) {
+        out += std::string("# HELP ") + name + " " + help + "\n";
+        out += std::string("# TYPE ") + name + " " + type + "\n";
+        std::ostringstream line;
+        line << name << " " << value << "\n";
+        out += line.str();
+    };
+
+    gauge("vstream_uptime_seconds", "gauge", "Seconds since start",
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count());
+    out += counter_registry::to_prometheus(m_counters.snapshot());
+
+    if (m_engine) {
+        gauge("vstream_samples_processed_total", "counter", "Audio samples decoded",
+              static_cast<double>(total_samples_processed()));
+        gauge("vstream_active_sessions", "gauge", "Pooled session recognizers",
+              static_cast<double>(m_engine->get_session_count()));
+    }
+    if (m_models) {
+        gauge("vstream_models_loaded", "gauge", "Speech models in memory",
+              static_cast<double>(m_models->loaded_engines().size()));
+        gauge("vstream_model_memory_mb", "gauge", "Memory charged to loaded models",
+              static_cast<double>(m_models->memory_used_mb()));
+    }
+    if (m_server) {
+        gauge("vstream_connected_clients", "gauge", "Connected WebSocket clients",
+              static_cast<double>(m_server->get_client_count()));
+    }
+    if (m_dispatcher) {
+        gauge("vstream_decode_queue_depth", "gauge", "Audio chunks waiting for a decode worker",
+              static_cast<double>(m_dispatcher->get_queue_depth()));
+        gauge("vstream_decode_dropped_total", "counter", "Audio chunks dropped on a full session queue",
+              static_cast<double>(m_dispatcher->get_dropped_count()));
+        gauge("vstream_decode_rejected_total", "counter", "Audio chunks of sessions refused under load",
+              static_cast<double>(m_dispatcher->get_rejected_count()));
+    }
+    gauge("vstream_draining", "gauge", "1 while finishing sessions before exit",
+          is_draining() ? 1.0 : 0.0);
+    if (m_load) {
+        gauge("vstream_load", "gauge", "Smoothed decode load (1 = saturated)", m_load->get_load());
+        gauge("vstream_load_level", "gauge", "Load shedding level (0 normal .. 3 reject)",
+              static_cast<double>(m_load->get_level()));
+        gauge("vstream_real_time_factor", "gauge", "Decode time per second of audio",
+              m_load->get_real_time_factor());
+    }
+    if (m_mic) {
+        gauge("vstream_dropped_frames_total", "counter", "Microphone frames dropped on a full ring",
+              static_cast<double>(m_mic->get_dropped_frames()));
+    }
+
+    return out;
+}
+
 vstream_app::config vstream_app::parse_command_line(int argc, char* argv[]) {
     config cfg;
 
@@ -211,26 +744,95 @@ vstream_app::config vstream_app::parse_command_line(int argc, char* argv[]) {
 
         if (arg == "--model" && i + 1 < argc) {
             cfg.model_path = argv[++i];
+        } else if (arg == "--models" && i + 1 < argc) {
+            cfg.models_file = argv[++i];
         } else if (arg == "--port" && i + 1 < argc) {
             cfg.port = static_cast<uint16_t>(std::stoi(argv[++i]));
         } else if (arg == "--spk-model" && i + 1 < argc) {
             cfg.speaker_model_path = argv[++i];
+        } else if (arg == "--spk-threads" && i + 1 < argc) {
+            cfg.spk_threads = static_cast<size_t>(std::stoul(argv[++i]));
         } else if (arg == "--alternatives" && i + 1 < argc) {
             cfg.max_alternatives = std::stoi(argv[++i]);
         } else if (arg == "--no-partial") {
             cfg.enable_partial_words = false;
+        } else if (arg == "--partial-ms" && i + 1 < argc) {
+            cfg.partial_interval_ms = std::stoi(argv[++i]);
+        } else if (arg == "--partials-opt-in") {
+            cfg.partials_opt_in = true;
         } else if (arg == "--grammar" && i + 1 < argc) {
             cfg.grammar = argv[++i];
+        } else if (arg == "--grammar-cache" && i + 1 < argc) {
+            cfg.grammar_cache_size = static_cast<size_t>(std::stoul(argv[++i]));
         } else if (arg == "--log-level" && i + 1 < argc) {
             cfg.log_level = std::stoi(argv[++i]);
+        } else if (arg == "--max-sessions" && i + 1 < argc) {
+            cfg.max_sessions = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--session-idle-ms" && i + 1 < argc) {
+            cfg.session_idle_ms = std::stoi(argv[++i]);
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            cfg.metrics_port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--local-socket" && i + 1 < argc) {
+            cfg.local_socket = argv[++i];
+        } else if (arg == "--drain-timeout-ms" && i + 1 < argc) {
+            cfg.drain_timeout_ms = std::stoi(argv[++i]);
+        } else if (arg == "--backend" && i + 1 < argc) {
+            cfg.backend = argv[++i];
+        } else if (arg == "--gpu-batch" && i + 1 < argc) {
+            cfg.gpu_batch_size = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--gpu-wait-ms" && i + 1 < argc) {
+            cfg.gpu_batch_wait_ms = std::stoi(argv[++i]);
+        } else if (arg == "--decode-threads" && i + 1 < argc) {
+            cfg.decode_threads = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--pin-threads") {
+            cfg.pin_decode_threads = true;
+        } else if (arg == "--decode-cpus" && i + 1 < argc) {
+            cfg.decode_cpus = parse_cpu_list(argv[++i]);
+            cfg.pin_decode_threads = true;
+        } else if (arg == "--numa" && i + 1 < argc) {
+            cfg.numa_mode = argv[++i];
+        } else if (arg == "--huge-pages") {
+            cfg.huge_pages = true;
+        } else if (arg == "--max-session-queue" && i + 1 < argc) {
+            cfg.max_session_queue = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--no-load-shedding") {
+            cfg.load_shedding = false;
+        } else if (arg == "--no-adaptive-chunks") {
+            cfg.adaptive_chunks = false;
+        } else if (arg == "--latency-target-ms" && i + 1 < argc) {
+            cfg.latency_target_ms = std::stoi(argv[++i]);
         } else if (arg == "--mic") {
             cfg.use_mic = true;
         } else if (arg == "--finalize-ms" && i + 1 < argc) {
             cfg.finalize_ms = std::stoi(argv[++i]);
+        } else if (arg == "--endpoint-mode" && i + 1 < argc) {
+            cfg.endpoint_mode = argv[++i];
+        } else if (arg == "--endpoint-start-ms" && i + 1 < argc) {
+            cfg.endpoint_start_ms = std::stoi(argv[++i]);
+        } else if (arg == "--endpoint-silence-ms" && i + 1 < argc) {
+            cfg.endpoint_silence_ms = std::stoi(argv[++i]);
+        } else if (arg == "--endpoint-max-ms" && i + 1 < argc) {
+            cfg.endpoint_max_ms = std::stoi(argv[++i]);
+        } else if (arg == "--vad") {
+            cfg.vad_enabled = true;
+        } else if (arg == "--vad-threshold" && i + 1 < argc) {
+            cfg.vad_threshold_db = std::stof(argv[++i]);
+        } else if (arg == "--vad-hangover-ms" && i + 1 < argc) {
+            cfg.vad_hangover_ms = std::stoi(argv[++i]);
         } else if (arg == "--mic-device" && i + 1 < argc) {
             cfg.mic_device = std::stoi(argv[++i]);
+        } else if (arg == "--mic-rate" && i + 1 < argc) {
+            cfg.mic_rate = std::stoi(argv[++i]);
+        } else if (arg == "--mic-channels" && i + 1 < argc) {
+            cfg.mic_channels = std::stoi(argv[++i]);
+        } else if (arg == "--mic-split-channels") {
+            cfg.mic_split_channels = true;
         } else if (arg == "--buffer-ms" && i + 1 < argc) {
             cfg.buffer_ms = std::stoi(argv[++i]);
+        } else if (arg == "--input" && i + 1 < argc) {
+            cfg.input_path = argv[++i];
+        } else if (arg == "--output-dir" && i + 1 < argc) {
+            cfg.transcript_dir = argv[++i];
         } else if (arg == "--benchmark" && i + 1 < argc) {
             cfg.benchmark_reference_file = argv[++i];
             cfg.benchmark_enabled = true;
@@ -241,6 +843,8 @@ vstream_app::config vstream_app::parse_command_line(int argc, char* argv[]) {
             cfg.benchmark_live = true;
         } else if (arg == "--benchmark-format" && i + 1 < argc) {
             cfg.benchmark_format = argv[++i];
+        } else if (arg == "--benchmark-segments" && i + 1 < argc) {
+            cfg.benchmark_segments_file = argv[++i];
         } else if (arg == "--help" || arg == "-h") {
             // Help is handled by caller
             continue;
@@ -260,36 +864,78 @@ void vstream_app::print_usage(const char* program_name) {
               << "Usage: " << program_name << " [options]\n"
               << "Options:\n"
               << "  --model PATH       Path to Vosk model directory (required)\n"
+              << "  --models FILE      JSON list of more named models sessions can select\n"
               << "  --port PORT        WebSocket server port (default: 8080)\n"
               << "  --mic              Enable microphone capture\n"
               << "  --mic-device N     Specify microphone device index\n"
+              << "  --mic-rate HZ      Capture rate, resampled to the model rate (default: model rate)\n"
+              << "  --mic-channels N   Capture channels, downmixed to mono (default: 1)\n"
+              << "  --mic-split-channels  Transcribe each capture channel on its own (session mic-capture/chN)\n"
               << "  --buffer-ms MS     Audio buffer size in milliseconds (default: 100)\n"
               << "                     Lower = less latency, Higher = better efficiency\n"
-              << "  --finalize-ms MS   Finalization interval in milliseconds (default: 2000)\n"
-              << "                     Controls how often results are finalized\n"
-              << "                     Lower = more frequent results, Higher = longer context\n"
+              << "                     WebSocket sessions start here and adapt (see --latency-target-ms)\n"
+              << "  --finalize-ms MS   Longest utterance before it is finalized (default: 15000)\n"
+              << "                     Results are normally finalized when the model detects an endpoint\n"
+              << "  --endpoint-mode M  Endpoint rules: default, short, long, very-long (default: default)\n"
+              << "                     short = commands, long/very-long = dictation with pauses\n"
+              << "  --endpoint-start-ms MS   Silence before speech that ends an utterance (default: model)\n"
+              << "  --endpoint-silence-ms MS Silence after speech that ends an utterance (default: model)\n"
+              << "  --endpoint-max-ms MS     Utterance length at which the model ends it (default: model)\n"
+              << "  --vad              Skip decoding during silence, finalize when the speaker pauses\n"
+              << "  --vad-threshold DB Speech detection level in dBFS (default: -40)\n"
+              << "  --vad-hangover-ms MS  Pause length that ends an utterance (default: 300)\n"
               << "  --list-devices     List available audio input devices\n"
-              << "  --spk-model PATH   Path to speaker model (optional)\n"
+              << "  --spk-model PATH   Label the speaker of each final result with this model (optional)\n"
+              << "  --spk-threads N    Low-priority threads computing speaker labels (default: 1)\n"
               << "  --alternatives N   Enable N-best results (default: 0)\n"
               << "  --no-partial       Disable partial results\n"
+              << "  --partial-ms MS    Minimum audio between partial results (default: 200, 0 = every chunk)\n"
+              << "  --partials-opt-in  Sessions only get partials after a \"partials\" command\n"
               << "  --grammar JSON     Set grammar as JSON array\n"
+              << "  --grammar-cache N  Built grammar recognizers kept for fast switching (default: 16, 0 = off)\n"
               << "  --log-level N      Set Vosk log level (default: 0)\n"
+              << "  --max-sessions N   Maximum concurrent WebSocket sessions (default: 64)\n"
+              << "  --session-idle-ms MS  Release idle session recognizers after MS (default: 60000, 0 = never)\n"
+              << "  --metrics-port PORT  Serve Prometheus metrics on http://HOST:PORT/metrics (default: off)\n"
+              << "  --local-socket PATH  Accept audio from local producers on a Unix socket (default: off)\n"
+              << "  --drain-timeout-ms MS  On SIGTERM, wait up to MS for sessions to finish (default: 30000, 0 = stop at once)\n"
+              << "  --decode-threads N Decode worker threads (default: 0 = one per CPU)\n"
+              << "  --pin-threads      Pin each decode worker to one CPU\n"
+              << "  --decode-cpus LIST CPUs for decode workers, e.g. 0,2,4-7 (implies --pin-threads)\n"
+              << "  --numa MODE        Model memory on NUMA machines: off, replicate (one copy per node,\n"
+              << "                     workers pinned next to it) or interleave (default: off)\n"
+              << "  --huge-pages       Back model memory with transparent huge pages\n"
+              << "  --max-session-queue N  Queued chunks per session before new ones are dropped\n"
+              << "                     (default: 50, 0 = unlimited)\n"
+              << "  --no-load-shedding Keep partials, cadence and admission fixed under overload\n"
+              << "  --latency-target-ms MS  Audio-to-result latency sessions aim for (default: 0 = none)\n"
+              << "  --no-adaptive-chunks  Decode WebSocket audio in fixed --buffer-ms chunks\n"
+              << "  --backend NAME     Decoder backend: cpu or gpu (Vosk batch, needs CUDA; default: cpu)\n"
+              << "  --gpu-batch N      Maximum chunks per GPU batch (default: 64)\n"
+              << "  --gpu-wait-ms MS   Longest a chunk waits for its GPU batch to fill (default: 10)\n"
+              << "\n"
+              << "File Transcription Options:\n"
+              << "  --input PATH       Transcribe a WAV/raw file or a directory of them and exit\n"
+              << "                     (16-bit mono PCM, decoded on --decode-threads workers)\n"
+              << "  --output-dir DIR   Write one <name>.txt transcript per input (default: stdout)\n"
               << "\n"
               << "Benchmark Options:\n"
               << "  --benchmark FILE   Enable benchmarking with reference text file\n"
               << "  --benchmark-live   Enable live benchmarking (no reference file)\n"
               << "  --benchmark-output FILE  Output file for benchmark results\n"
               << "  --benchmark-format FMT   Output format: txt, json, csv (default: txt)\n"
+              << "  --benchmark-segments FILE  Write segments to FILE as they arrive (.csv, else JSON lines)\n"
               << "\n"
               << "  --help             Show this help message\n"
               << "\n"
               << "Examples:\n"
-              << "  Fast response:     --buffer-ms 50 --finalize-ms 1000\n"
-              << "  Balanced:          --buffer-ms 100 --finalize-ms 2000\n"
-              << "  Long context:      --buffer-ms 200 --finalize-ms 5000\n"
+              << "  Fast response:     --buffer-ms 50 --endpoint-mode short\n"
+              << "  Balanced:          --buffer-ms 100\n"
+              << "  Long context:      --buffer-ms 200 --endpoint-mode long --finalize-ms 30000\n"
               << "\n"
               << "Benchmark Examples:\n"
-              << "  File benchmark:    --model model --benchmark reference.txt --mic\n"
+              << "  File benchmark:    --model model --benchmark reference.txt --input audio.wav\n"
+              << "  Mic benchmark:     --model model --benchmark reference.txt --mic\n"
               << "  Live benchmark:    --model model --benchmark-live --mic\n"
               << "  JSON output:       --benchmark ref.txt --benchmark-format json\n";
 }
@@ -311,15 +957,119 @@ void vstream_app::validate_config(const config& cfg) {
         throw std::invalid_argument("Finalize interval must be between 1 and 30000 ms");
     }
 
+    if (cfg.endpoint_mode != "default" && cfg.endpoint_mode != "short" &&
+        cfg.endpoint_mode != "long" && cfg.endpoint_mode != "very-long") {
+        throw std::invalid_argument("Invalid endpoint mode. Must be: default, short, long or very-long");
+    }
+
+    for (int ms : {cfg.endpoint_start_ms, cfg.endpoint_silence_ms, cfg.endpoint_max_ms}) {
+        if (ms < 0 || ms > 60000) {
+            throw std::invalid_argument("Endpoint delays must be between 0 and 60000 ms");
+        }
+    }
+
     if (cfg.max_alternatives < 0 || cfg.max_alternatives > 10) {
         throw std::invalid_argument("Max alternatives must be between 0 and 10");
     }
 
+    if (cfg.mic_rate != 0 && (cfg.mic_rate < 8000 || cfg.mic_rate > 192000)) {
+        throw std::invalid_argument("Microphone rate must be between 8000 and 192000 Hz");
+    }
+
+    if (cfg.mic_channels < 1 || cfg.mic_channels > 8) {
+        throw std::invalid_argument("Microphone channels must be between 1 and 8");
+    }
+
+    if (cfg.partial_interval_ms < 0 || cfg.partial_interval_ms > 10000) {
+        throw std::invalid_argument("Partial interval must be between 0 and 10000 ms");
+    }
+
+    if (cfg.grammar_cache_size > 1024) {
+        throw std::invalid_argument("Grammar cache size must be between 0 and 1024");
+    }
+
+    if (cfg.max_sessions == 0 || cfg.max_sessions > 10000) {
+        throw std::invalid_argument("Max sessions must be between 1 and 10000");
+    }
+
+    if (cfg.vad_threshold_db < -90.0f || cfg.vad_threshold_db > 0.0f) {
+        throw std::invalid_argument("Voice activity threshold must be between -90 and 0 dBFS");
+    }
+
+    if (cfg.vad_hangover_ms < 0 || cfg.vad_hangover_ms > 10000) {
+        throw std::invalid_argument("Voice activity hangover must be between 0 and 10000 ms");
+    }
+
+    if (cfg.metrics_port != 0 && cfg.metrics_port == cfg.port) {
+        throw std::invalid_argument("Metrics port must differ from the WebSocket port");
+    }
+
+    if (cfg.local_socket.size() > 107) {
+        throw std::invalid_argument("Local socket path must be at most 107 characters");
+    }
+
+    if (cfg.spk_threads == 0 || cfg.spk_threads > 64) {
+        throw std::invalid_argument("Speaker threads must be between 1 and 64");
+    }
+
+    if (cfg.drain_timeout_ms < 0 || cfg.drain_timeout_ms > 3600000) {
+        throw std::invalid_argument("Drain timeout must be between 0 and 3600000 ms");
+    }
+
+    if (cfg.session_idle_ms < 0) {
+        throw std::invalid_argument("Session idle timeout must not be negative");
+    }
+
+    if (cfg.numa_mode != "off" && cfg.numa_mode != "replicate" && cfg.numa_mode != "interleave") {
+        throw std::invalid_argument("Invalid NUMA mode. Must be: off, replicate or interleave");
+    }
+
+    if (cfg.decode_threads > 1024) {
+        throw std::invalid_argument("Decode threads must be between 0 and 1024");
+    }
+
+    if (cfg.latency_target_ms < 0 || cfg.latency_target_ms > 60000) {
+        throw std::invalid_argument("Latency target must be between 0 and 60000 ms");
+    }
+
+    if (cfg.max_session_queue > 100000) {
+        throw std::invalid_argument("Max session queue must be between 0 and 100000");
+    }
+
+    if (cfg.backend != "cpu" && cfg.backend != "gpu") {
+        throw std::invalid_argument("Invalid backend. Must be: cpu or gpu");
+    }
+
+    if (cfg.gpu_batch_size == 0 || cfg.gpu_batch_size > 1024) {
+        throw std::invalid_argument("GPU batch size must be between 1 and 1024");
+    }
+
+    if (cfg.gpu_batch_wait_ms < 0 || cfg.gpu_batch_wait_ms > 1000) {
+        throw std::invalid_argument("GPU batch wait must be between 0 and 1000 ms");
+    }
+
+    if (cfg.backend == "gpu" &&
+        (!cfg.grammar.empty() || !cfg.speaker_model_path.empty() || cfg.max_alternatives > 0)) {
+        throw std::invalid_argument("The GPU backend does not support --grammar, --spk-model or --alternatives");
+    }
+
     if (cfg.sample_rate != 8000 && cfg.sample_rate != 16000 &&
         cfg.sample_rate != 32000 && cfg.sample_rate != 48000) {
         throw std::invalid_argument("Sample rate must be 8000, 16000, 32000, or 48000 Hz");
     }
 
+    if (!cfg.input_path.empty() && cfg.use_mic) {
+        throw std::invalid_argument("--input cannot be combined with --mic");
+    }
+
+    if (!cfg.models_file.empty() && !cfg.input_path.empty()) {
+        throw std::invalid_argument("--models cannot be combined with --input");
+    }
+
+    if (!cfg.transcript_dir.empty() && cfg.input_path.empty()) {
+        throw std::invalid_argument("--output-dir requires --input");
+    }
+
     // Validate benchmark options
     if (cfg.benchmark_enabled && !cfg.benchmark_live && cfg.benchmark_reference_file.empty()) {
         throw std::invalid_argument("Benchmark enabled but no reference file specified");
@@ -330,33 +1080,313 @@ void vstream_app::validate_config(const config& cfg) {
             throw std::invalid_argument("Invalid benchmark format. Must be: txt, json, or csv");
         }
     }
+
+    if (!cfg.benchmark_segments_file.empty() && !cfg.benchmark_enabled) {
+        throw std::invalid_argument("--benchmark-segments requires --benchmark or --benchmark-live");
+    }
 }
 
-void vstream_app::initialize_engine() {
-    LOG_INFO("Initializing Vosk engine with model: " + m_config.model_path);
+std::vector<int> vstream_app::parse_cpu_list(const std::string& list) {
+    auto cpus = numa_topology::parse_cpu_list(list);
+    if (cpus.empty()) {
+        throw std::invalid_argument("Invalid CPU list: " + list);
+    }
+    return cpus;
+}
 
-    // Create engine configuration
+vstream_engine::config vstream_app::make_engine_config() const {
     vstream_engine::config engine_config;
     engine_config.sample_rate = m_config.sample_rate;
-    engine_config.enable_speaker_id = !m_config.speaker_model_path.empty();
-    engine_config.speaker_model_path = m_config.speaker_model_path;
+    // Speakers are labelled per utterance by m_speakers, not on every decoded chunk
+    engine_config.enable_speaker_id = false;
     engine_config.max_alternatives = m_config.max_alternatives;
+    if (m_config.endpoint_mode == "short") {
+        engine_config.endpointer = vstream_engine::endpointer_mode::short_answers;
+    } else if (m_config.endpoint_mode == "long") {
+        engine_config.endpointer = vstream_engine::endpointer_mode::long_answers;
+    } else if (m_config.endpoint_mode == "very-long") {
+        engine_config.endpointer = vstream_engine::endpointer_mode::very_long_answers;
+    }
+    engine_config.endpoint_start_max_ms = m_config.endpoint_start_ms;
+    engine_config.endpoint_end_ms = m_config.endpoint_silence_ms;
+    engine_config.endpoint_max_ms = m_config.endpoint_max_ms;
     engine_config.enable_partial_words = m_config.enable_partial_words;
+    engine_config.enable_partial_results = m_config.enable_partial_words;
+    engine_config.partial_interval_ms = m_config.partial_interval_ms;
+    engine_config.chunk_ms = m_config.buffer_ms;
+    engine_config.partial_results_opt_in = m_config.partials_opt_in;
+    engine_config.max_sessions = m_config.max_sessions;
+    engine_config.grammar_cache_size = m_config.grammar_cache_size;
+    engine_config.session_idle_timeout_ms = m_config.session_idle_ms;
+    if (m_config.backend == "gpu") {
+        engine_config.backend = vstream_engine::backend_type::gpu_batch;
+        engine_config.gpu_batch_size = m_config.gpu_batch_size;
+        engine_config.gpu_batch_wait_ms = m_config.gpu_batch_wait_ms;
+    }
+    return engine_config;
+}
+
+void vstream_app::initialize_engine() {
+    LOG_INFO("Initializing Vosk engine with model: " + m_config.model_path);
 
-    m_engine = std::make_unique<vstream_engine>(m_config.model_path, engine_config);
+    m_topology = numa_topology::detect();
+    if (!m_config.decode_cpus.empty() && m_config.numa_mode != "off") {
+        m_topology = m_topology.restrict_to(m_config.decode_cpus);
+    }
+    if (m_config.numa_mode != "off") {
+        LOG_INFO("NUMA placement " + m_config.numa_mode + " over " +
+                 std::to_string(m_topology.node_count()) + " node(s)");
+    }
+
+    // The default model of node 0; initialize_replicas() adds the other nodes
+    bool replicate = m_config.numa_mode == "replicate" && m_topology.is_numa() && m_config.input_path.empty();
+    place_model_load(replicate ? 0 : -1, [this] {
+        m_engine = std::make_shared<vstream_engine>(m_config.model_path, make_engine_config());
+    });
+    m_engine->set_metrics(&m_metrics);
 
     if (!m_config.grammar.empty()) {
         m_engine->set_grammar(m_config.grammar);
         LOG_INFO("Grammar set: " + m_config.grammar);
     }
 
+    initialize_models();
+
+    if (replicate) {
+        initialize_replicas();
+    }
+
     LOG_INFO("Vosk engine initialized successfully");
 }
 
-void vstream_app::initialize_server() {
-    LOG_INFO("Initializing WebSocket server on port " + std::to_string(m_config.port));
+void vstream_app::initialize_models() {
+    model_registry::config models_config;
+    if (!m_config.models_file.empty()) {
+        models_config = model_registry::load_config(m_config.models_file);
+    }
 
-    m_server = std::make_unique<hyni_websocket_server>(m_config.port);
+    // Models loaded on demand share the default engine's settings, but not its --grammar
+    m_models = std::make_unique<model_registry>(
+        models_config.memory_budget_mb,
+        [this](const model_registry::model_spec& spec) {
+            // Named models are shared by all domains: interleaved under --numa
+            std::shared_ptr<vstream_engine> engine;
+            place_model_load(-1, [&] {
+                engine = std::make_shared<vstream_engine>(spec.path, make_engine_config());
+            });
+            engine->set_metrics(&m_metrics);
+            engine->suspend_partial_results(m_engine->partial_results_suspended());
+            return engine;
+        });
+
+    model_registry::model_spec default_spec;
+    default_spec.name = "default";
+    default_spec.path = m_config.model_path;
+    m_models->add_resident(default_spec, m_engine);
+
+    for (auto& spec : models_config.models) {
+        m_models->add(spec);
+    }
+
+    for (const auto& spec : models_config.models) {
+        if (spec.preload) {
+            m_models->acquire(spec.name);
+        }
+    }
+
+    if (!models_config.models.empty()) {
+        LOG_INFO("Serving " + std::to_string(models_config.models.size() + 1) + " models, budget " +
+                 (models_config.memory_budget_mb > 0 ? std::to_string(models_config.memory_budget_mb) + " MB"
+                                                     : std::string("unlimited")));
+        std::cout << "Models: default";
+        for (const auto& spec : models_config.models) {
+            std::cout << ", " << spec.name;
+        }
+        std::cout << "\n";
+    }
+}
+
+void vstream_app::initialize_replicas() {
+    size_t workers = decode_thread_count();
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t domains = std::min(m_topology.node_count(), workers);
+
+    m_replicas.push_back(m_engine);
+    for (size_t node = 1; node < domains; ++node) {
+        std::shared_ptr<vstream_engine> replica;
+        place_model_load(static_cast<int>(node), [&] {
+            replica = std::make_shared<vstream_engine>(m_config.model_path, make_engine_config());
+        });
+        replica->set_metrics(&m_metrics);
+        if (!m_config.grammar.empty()) {
+            replica->set_grammar(m_config.grammar);
+        }
+
+        // Resident in the registry, so idle sessions and load shedding cover it
+        model_registry::model_spec spec;
+        spec.name = "default@node" + std::to_string(m_topology.nodes()[node].id);
+        spec.path = m_config.model_path;
+        m_models->add_resident(spec, replica);
+        m_replicas.push_back(std::move(replica));
+    }
+
+    LOG_INFO("Default model replicated on " + std::to_string(m_replicas.size()) + " NUMA node(s)");
+    std::cout << "Model replicas: " << m_replicas.size() << " (one per NUMA node)\n";
+}
+
+void vstream_app::place_model_load(int node, const std::function<void()>& load) {
+    auto placed = [this, &load] {
+        if (!m_config.huge_pages) {
+            load();
+            return;
+        }
+        huge_page_advisor advisor;
+        load();
+        m_huge_pages_advised_mb += advisor.advise_new_regions() >> 20;
+    };
+
+    if (m_config.numa_mode == "off" || !m_topology.is_numa()) {
+        placed();
+    } else if (node >= 0) {
+        // First touch on the node's CPUs keeps the model in its memory
+        m_topology.run_on_node(static_cast<size_t>(node), placed);
+    } else {
+        m_topology.interleave_memory();
+        try {
+            placed();
+        } catch (...) {
+            numa_topology::reset_memory_policy();
+            throw;
+        }
+        numa_topology::reset_memory_policy();
+    }
+}
+
+size_t vstream_app::decode_thread_count() const {
+    if (m_config.decode_threads == 0 && m_config.backend == "gpu") {
+        return m_config.gpu_batch_size;
+    }
+    return m_config.decode_threads;
+}
+
+void vstream_app::initialize_dispatcher() {
+    decode_dispatcher::config dispatcher_config;
+    dispatcher_config.num_threads = decode_thread_count();
+    dispatcher_config.pin_threads = m_config.pin_decode_threads;
+    dispatcher_config.cpu_list = m_config.decode_cpus;
+
+    if (m_config.numa_mode != "off") {
+        size_t workers = decode_thread_count();
+        if (workers == 0) {
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        auto placement = m_topology.place_workers(workers);
+        dispatcher_config.num_threads = workers;
+        dispatcher_config.pin_threads = true;
+        dispatcher_config.cpu_list = placement.cpus;
+        if (m_replicas.size() > 1) {
+            dispatcher_config.worker_domains = placement.domains;
+        }
+    }
+    dispatcher_config.max_session_frames = m_config.max_session_queue;
+
+    m_dispatcher = std::make_unique<decode_dispatcher>(
+        dispatcher_config,
+        [this](decode_dispatcher::audio_job& job) {
+            process_websocket_job(job);
+        });
+    m_dispatcher->start();
+
+    for (size_t i = 0; dispatcher_config.pin_threads && i < m_dispatcher->get_thread_count(); ++i) {
+        m_worker_cpus.push_back(m_dispatcher->get_worker_cpu(i));
+    }
+
+    load_monitor::config load_config;
+    load_config.workers = m_dispatcher->get_thread_count();
+    load_config.sample_rate = m_config.sample_rate;
+    m_load = std::make_unique<load_monitor>(load_config);
+}
+
+void vstream_app::initialize_metrics_server() {
+    if (m_config.metrics_port == 0) {
+        return;
+    }
+
+    m_metrics_server = std::make_unique<metrics_server>(
+        m_config.metrics_port,
+        [this](const std::string& path) {
+            metrics_server::response response;
+            if (path == "/metrics") {
+                response.body = get_prometheus_metrics();
+            } else if (path == "/health") {
+                // Balancers take non-2xx as "send no new traffic"
+                auto health = get_health();
+                response.status = health["status"] == "ok" ? 200 : 503;
+                response.content_type = "application/json";
+                response.body = health.dump() + "\n";
+            } else {
+                response.status = 404;
+                response.body = "Not found\n";
+            }
+            return response;
+        });
+    m_metrics_server->start();
+
+    std::cout << "Metrics endpoint: http://localhost:" << m_metrics_server->port() << "/metrics\n";
+}
+
+void vstream_app::initialize_local_ingest() {
+    if (m_config.local_socket.empty()) {
+        return;
+    }
+
+    m_local_ingest = std::make_unique<local_ingest_server>(
+        m_config.local_socket,
+        [this](const std::string& session_id, std::vector<int16_t>& samples) {
+            if (find_mic_channel(session_id)) {
+                throw std::invalid_argument("Session id " + session_id + " is reserved for a capture channel");
+            }
+            if (m_client_sessions.has_owner(session_id)) {
+                throw std::invalid_argument("Session " + session_id + " belongs to a WebSocket client");
+            }
+            submit_session_audio(session_id, std::move(samples));
+        },
+        [this](const std::string& command, const json& params) {
+            return handle_websocket_command(command, params, nullptr);
+        },
+        [this](const std::string& session_id) {
+            // The remaining per-session state is released by the idle sweep
+            m_dispatcher->release_session(session_id);
+            if (m_speakers) {
+                m_speakers->release_session(session_id);
+            }
+        });
+    m_local_ingest->start();
+
+    std::cout << "Local ingest socket: " << m_config.local_socket << "\n";
+}
+
+void vstream_app::initialize_speaker_identifier() {
+    if (m_config.speaker_model_path.empty()) {
+        return;
+    }
+
+    speaker_identifier::config spk_config;
+    spk_config.model_path = m_config.speaker_model_path;
+    spk_config.threads = m_config.spk_threads;
+    spk_config.sample_rate = m_config.sample_rate;
+    m_speakers = std::make_unique<speaker_identifier>(
+        spk_config, [this](const speaker_identifier::label& label) { deliver_speaker_label(label); });
+
+    std::cout << "Speaker labels: " << m_config.spk_threads << " thread(s)\n";
+}
+
+void vstream_app::initialize_server() {
+    LOG_INFO("Initializing WebSocket server on port " + std::to_string(m_config.port));
+
+    m_server = std::make_unique<hyni_websocket_server>(m_config.port);
 
     // Set audio callback
     m_server->set_audio_callback([this](const hyni_audio_data& audio,
@@ -402,6 +1432,13 @@ void vstream_app::initialize_benchmark() {
         std::cout << "Benchmark mode: Live performance monitoring\n";
     }
 
+    if (!m_config.benchmark_segments_file.empty()) {
+        const auto& path = m_config.benchmark_segments_file;
+        bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        m_benchmark->stream_segments(path, csv ? "csv" : "jsonl");
+        std::cout << "Benchmark segments: " << path << "\n";
+    }
+
     // Set up progress callback for live updates
     if (m_config.benchmark_live) {
         m_benchmark->set_progress_callback([](const benchmark_manager::benchmark_results& results) {
@@ -433,17 +1470,86 @@ void vstream_app::initialize_microphone() {
 
     // Mic configuration
     mic_capture::config mic_cfg;
-    mic_cfg.sample_rate = m_config.sample_rate;
+    mic_cfg.sample_rate = m_config.mic_rate > 0 ? m_config.mic_rate : m_config.sample_rate;
+    mic_cfg.channels = m_config.mic_channels;
     mic_cfg.device_index = m_config.mic_device;
-    mic_cfg.frames_per_buffer = m_config.buffer_ms * 16;  // Convert ms to samples
+    mic_cfg.frames_per_buffer = m_config.buffer_ms * mic_cfg.sample_rate / 1000;  // Convert ms to frames
     mic_cfg.accumulate_ms = m_config.buffer_ms;
 
     LOG_INFO("Microphone configuration: sample_rate=" + std::to_string(mic_cfg.sample_rate) +
+             ", channels=" + std::to_string(mic_cfg.channels) +
              ", buffer_ms=" + std::to_string(m_config.buffer_ms));
 
     m_mic = std::make_unique<mic_capture>(mic_cfg);
 
-    // Create simplified audio processor (no VAD)
+    if (m_config.mic_split_channels && mic_cfg.channels > 1) {
+        // One pipeline per channel, decoded on the dispatcher's workers in parallel
+        audio_converter::config converter_cfg;
+        converter_cfg.input_rate = mic_cfg.sample_rate;
+        converter_cfg.output_rate = m_config.sample_rate;
+
+        for (int c = 0; c < mic_cfg.channels; ++c) {
+            mic_channel channel;
+            auto converter = std::make_unique<audio_converter>(converter_cfg);
+            if (!converter->passthrough()) {
+                channel.converter = std::move(converter);
+            }
+            channel.processor = std::make_unique<audio_processor>(
+                m_engine.get(), m_server.get(), m_config.finalize_ms, m_config.buffer_ms, m_benchmark.get());
+            channel.processor->set_channel(c);
+            if (m_config.vad_enabled) {
+                channel.processor->enable_vad(make_vad_config());
+            }
+            channel.processor->set_metrics(&m_metrics);
+            m_mic_channels.push_back(std::move(channel));
+        }
+        m_mic_planes.resize(m_mic_channels.size());
+
+        m_mic->set_audio_callback([this](std::span<const int16_t> audio) {
+            if (!audio.empty()) {
+                m_metrics.record_since(pipeline_metrics::stage::capture, m_mic->chunk_time());
+                submit_mic_channels(audio);
+            }
+        });
+
+        LOG_INFO("Transcribing " + std::to_string(m_mic_channels.size()) +
+                 " microphone channels separately");
+    } else {
+        initialize_mic_processor(mic_cfg);
+    }
+
+    if (!m_mic->start()) {
+        throw std::runtime_error("Failed to start microphone capture");
+    }
+
+    LOG_INFO("Microphone capture started successfully");
+
+    // Log configuration summary
+    LOG_INFO("Configuration summary:");
+    LOG_INFO("  Buffer size: " + std::to_string(m_config.buffer_ms) + "ms");
+    LOG_INFO("  Endpointing: " + m_config.endpoint_mode + " rules, utterances capped at " +
+             std::to_string(m_config.finalize_ms) + "ms");
+    LOG_INFO("  Voice activity gating: " + std::string(m_config.vad_enabled ? "enabled" : "disabled"));
+    LOG_INFO("  Partial results: " + std::string(m_config.enable_partial_words ? "enabled" : "disabled") +
+             (m_config.enable_partial_words ? ", every " + std::to_string(m_config.partial_interval_ms) + "ms" +
+                                                  (m_config.partials_opt_in ? " (opt-in)" : "")
+                                            : ""));
+    LOG_INFO("  Benchmark enabled: " + std::string(m_config.benchmark_enabled ? "yes" : "no"));
+}
+
+void vstream_app::initialize_mic_processor(const mic_capture::config& mic_cfg) {
+    // Downmix and resample in front of the decoder when the device format differs
+    audio_converter::config converter_cfg;
+    converter_cfg.input_rate = mic_cfg.sample_rate;
+    converter_cfg.input_channels = mic_cfg.channels;
+    converter_cfg.output_rate = m_config.sample_rate;
+    auto converter = std::make_unique<audio_converter>(converter_cfg);
+    if (!converter->passthrough()) {
+        m_mic_converter = std::move(converter);
+        LOG_INFO("Converting microphone audio to mono " + std::to_string(m_config.sample_rate) + " Hz");
+    }
+
+    // Create audio processor, optionally gated by voice activity
     m_processor = std::make_unique<audio_processor>(
         m_engine.get(),
         m_server.get(),
@@ -451,101 +1557,475 @@ void vstream_app::initialize_microphone() {
         m_config.buffer_ms,
         m_benchmark.get());
 
+    if (m_config.vad_enabled) {
+        m_processor->enable_vad(make_vad_config());
+    }
+    m_processor->set_metrics(&m_metrics);
+
     // Set callback
-    m_mic->set_audio_callback([this](const std::vector<int16_t>& audio) {
+    m_mic->set_audio_callback([this](std::span<const int16_t> audio) {
         if (m_processor && !audio.empty()) {
-            m_processor->process_audio(audio);
+            auto captured = m_mic->chunk_time();
+            m_metrics.record_since(pipeline_metrics::stage::capture, captured);
+            if (m_mic_converter) {
+                audio = m_mic_converter->process(audio);
+            }
+            m_processor->process_audio(audio, captured);
         }
     });
+}
 
-    if (!m_mic->start()) {
-        throw std::runtime_error("Failed to start microphone capture");
-    }
+void vstream_app::submit_mic_channels(std::span<const int16_t> interleaved) {
+    audio_converter::deinterleave(interleaved, m_mic_planes);
 
-    LOG_INFO("Microphone capture started successfully");
+    for (size_t c = 0; c < m_mic_channels.size(); ++c) {
+        const auto& session_id = m_mic_channels[c].processor->get_session_id();
+        if (!m_dispatcher->submit(session_id, std::move(m_mic_planes[c]))) {
+            LOG_DEBUG("Overloaded, dropping audio for " + session_id);
+        }
+        m_mic_planes[c] = {};
+    }
+}
 
-    // Log configuration summary
-    LOG_INFO("Configuration summary:");
-    LOG_INFO("  Buffer size: " + std::to_string(m_config.buffer_ms) + "ms");
-    LOG_INFO("  Finalization interval: " + std::to_string(m_config.finalize_ms) + "ms");
-    LOG_INFO("  Partial results: " + std::string(m_config.enable_partial_words ? "enabled" : "disabled"));
-    LOG_INFO("  Benchmark enabled: " + std::string(m_config.benchmark_enabled ? "yes" : "no"));
+vstream_app::mic_channel* vstream_app::find_mic_channel(const std::string& session_id) {
+    if (m_mic_channels.empty() || !session_id.starts_with("mic-capture/")) {
+        return nullptr;
+    }
+    for (auto& channel : m_mic_channels) {
+        if (channel.processor->get_session_id() == session_id) {
+            return &channel;
+        }
+    }
+    return nullptr;
 }
 
 void vstream_app::setup_signal_handlers() {
     std::signal(SIGINT, signal_handler);
-    std::signal(SIGTERM, signal_handler);
+    std::signal(SIGTERM, drain_signal_handler);
+    std::signal(SIGHUP, reload_signal_handler);
 
     LOG_INFO("Signal handlers installed");
 }
 
 void vstream_app::handle_websocket_audio(const hyni_audio_data& audio,
-                                         websocket::stream<tcp::socket>* /*client_ws*/) {
+                                         websocket::stream<tcp::socket>* client_ws) {
+    if (auto conflict = websocket_session_conflict(audio.session_id, client_ws); !conflict.empty()) {
+        LOG_WARNING(conflict + ", dropping audio");
+        return;
+    }
+    flush_websocket_outbox(audio.session_id, client_ws);
+
+    if (audio.samples.empty()) {
+        return;
+    }
+
+    submit_session_audio(audio.session_id, audio.samples);
+}
+
+void vstream_app::submit_session_audio(const std::string& session_id, std::vector<int16_t> samples) {
+    m_counters.add(counter_registry::counter::audio_chunks);
+    if (!m_dispatcher->submit(session_id, std::move(samples))) {
+        if (!m_dispatcher->is_running()) {
+            LOG_WARNING("Decode workers stopped, dropping audio for session " + session_id);
+        } else {
+            LOG_DEBUG("Overloaded, dropping audio for session " + session_id);
+        }
+    }
+}
+
+void vstream_app::process_websocket_job(decode_dispatcher::audio_job& job) {
     auto processing_start = std::chrono::steady_clock::now();
+    m_metrics.record(pipeline_metrics::stage::queue, processing_start - job.enqueue_time);
+
+    if (auto* channel = find_mic_channel(job.session_id)) {
+        // Capture channel: queued right after capture, so latency counts from enqueue
+        std::span<const int16_t> audio = job.samples;
+        if (channel->converter) {
+            audio = channel->converter->process(audio);
+        }
+        channel->processor->process_audio(audio, job.enqueue_time);
+        return;
+    }
+
+    // One result per worker thread keeps its buffers warm across jobs
+    thread_local recognition_result result;
+
+    if (auto format = find_session_format(job.session_id)) {
+        if (format->opus) {
+            uint64_t errors = format->opus->get_error_count();
+            format->pcm.clear();
+            m_counters.add(counter_registry::counter::opus_packets, format->opus->decode(job.samples, format->pcm));
+            m_counters.add(counter_registry::counter::opus_errors, format->opus->get_error_count() - errors);
+            job.samples.swap(format->pcm);
+        }
+        if (!format->converter.passthrough()) {
+            auto converted = format->converter.process(job.samples);
+            job.samples.assign(converted.begin(), converted.end());
+        }
+        // Lets the dispatcher size this session's chunks by audio length
+        job.decoded_samples = job.samples.size();
+        if (job.samples.empty()) {
+            return;
+        }
+    }
+
+    std::shared_ptr<session_vad> vad;
+    bool endpoint = false;
+    if (m_config.vad_enabled) {
+        vad = get_session_vad(job.session_id);
+        auto decision = vad->detector.process(job.samples);
+        endpoint = decision.endpoint || (decision.speech && !vad->detector.in_speech());
+
+        if (!decision.speech) {
+            m_counters.add(counter_registry::counter::vad_skipped_chunks);
+            vad->preroll.swap(job.samples);
+            if (!endpoint) {
+                return;
+            }
+            job.samples.clear();
+        }
+    }
+
+    std::shared_ptr<vstream_engine> engine;
+    try {
+        engine = engine_for_session(job.session_id);
 
-    auto result_json = m_engine->process_audio(audio.samples);
-    m_messages_processed++;
+        if (vad && !job.samples.empty() && !vad->preroll.empty()) {
+            // Speech onset: decode the preceding silent chunk first
+            engine->process_audio(job.session_id, vad->preroll, result);
+            if (m_speakers) {
+                m_speakers->append(job.session_id, vad->preroll);
+            }
+            deliver_websocket_result(job.session_id, result, vad->preroll.size(), 0.0);
+            vad->preroll.clear();
+        }
+
+        if (!job.samples.empty()) {
+            engine->process_audio(job.session_id, job.samples, result);
+            if (m_speakers) {
+                m_speakers->append(job.session_id, job.samples);
+            }
+        }
+
+        if (endpoint) {
+            if (!job.samples.empty()) {
+                deliver_websocket_result(job.session_id, result, job.samples.size(), 0.0);
+            }
+            engine->process_audio(job.session_id, std::span<const int16_t>{}, result, true);
+        }
+
+        if (engine != m_engine) {
+            m_counters.add(counter_registry::counter::samples_routed, job.samples.size());
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("Dropping audio for session " + job.session_id + ": " + e.what());
+        return;
+    }
+    m_counters.add(counter_registry::counter::messages_processed);
 
     auto processing_end = std::chrono::steady_clock::now();
     double processing_latency_ms = std::chrono::duration<double, std::milli>(
                                        processing_end - processing_start).count();
 
+    deliver_websocket_result(job.session_id, result, job.samples.size(), processing_latency_ms);
+
+    // A coalesced job can span several endpoints, each utterance gets its result now
+    while (engine->next_final(job.session_id, result)) {
+        deliver_websocket_result(job.session_id, result, 0, processing_latency_ms);
+    }
+    m_metrics.record_since(pipeline_metrics::stage::end_to_end, job.enqueue_time);
+
+    if (m_config.adaptive_chunks) {
+        adapt_session_chunk(job.session_id, *engine, job);
+    }
+}
+
+void vstream_app::adapt_session_chunk(const std::string& session_id, vstream_engine& engine,
+                                      const decode_dispatcher::audio_job& job) {
+    auto chunking = get_session_chunking(session_id);
+    double latency_ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - job.enqueue_time).count();
+    bool loaded = m_load && m_load->get_level() != load_monitor::level::normal;
+
+    if (!chunking->controller.observe(latency_ms, loaded, job.backlog > 0)) {
+        return;
+    }
+
+    int chunk_ms = chunking->controller.chunk_ms();
     try {
-        auto result = json::parse(result_json);
+        engine.set_chunk_ms(session_id, chunk_ms);
+    } catch (const std::exception& e) {
+        LOG_WARNING("Cannot resize chunks of session " + session_id + ": " + e.what());
+        return;
+    }
+    m_dispatcher->set_session_chunk(session_id, static_cast<size_t>(chunk_ms) * m_config.sample_rate / 1000);
+    m_counters.add(counter_registry::counter::chunk_adjustments);
+    LOG_DEBUG("Session " + session_id + " decodes " + std::to_string(chunk_ms) + "ms chunks");
+}
+
+std::shared_ptr<vstream_app::session_chunking> vstream_app::get_session_chunking(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_session_chunking_mutex);
+    auto& entry = m_session_chunking[session_id];
+    if (!entry) {
+        chunk_controller::config chunk_config;
+        chunk_config.default_ms = m_config.buffer_ms;
+        chunk_config.min_ms = std::min(20, m_config.buffer_ms);
+        chunk_config.max_ms = std::max(1000, m_config.buffer_ms);
+        entry = std::make_shared<session_chunking>(chunk_config);
+        entry->controller.set_target_ms(m_config.latency_target_ms);
+    }
+    entry->last_used = std::chrono::steady_clock::now();
+    return entry;
+}
+
+void vstream_app::deliver_websocket_result(const std::string& session_id,
+                                           const recognition_result& result,
+                                           size_t samples,
+                                           double processing_latency_ms) {
+    if (result.empty()) {
+        return;
+    }
 
-        // Check for text in various fields
-        std::string text;
-        std::string type = "partial";
-        float confidence = 1.0f;
+    std::string text(result.text());
+    float confidence = result.confidence();
 
-        if (result.contains("text") && !result["text"].is_null()) {
-            text = result["text"].get<std::string>();
-            type = "final";
-        } else if (result.contains("partial") && !result["partial"].is_null()) {
-            text = result["partial"].get<std::string>();
-            type = "partial";
+    // The speaker label follows once the pool has embedded this utterance
+    uint64_t utterance_id = 0;
+    if (m_speakers && result.is_final()) {
+        utterance_id = m_speakers->end_utterance(session_id, engine_for_session(session_id)->get_model(), text);
+    }
+
+    auto deliver_start = std::chrono::steady_clock::now();
+    if (m_local_ingest && m_local_ingest->has_session(session_id)) {
+        json message = {
+            {"type", result.type_name()},
+            {"session_id", session_id},
+            {"text", text},
+            {"confidence", confidence}
+        };
+        if (utterance_id > 0) {
+            message["utterance_id"] = utterance_id;
         }
+        m_local_ingest->send(session_id, local_ingest_server::frame_type::result, message.dump());
+    } else if (utterance_id > 0) {
+        // The server's own transcript frame has no utterance_id, the client's next message picks this up
+        json message = {
+            {"type", "transcribe"},
+            {"content", text},
+            {"session_id", session_id},
+            {"confidence", confidence},
+            {"is_final", true},
+            {"utterance_id", utterance_id}
+        };
+        m_websocket_outbox.push(session_id, {message.dump(), true, text, confidence, {}});
+    } else {
+        m_server->queue_transcription(text, session_id, confidence);
+    }
+    m_metrics.record_since(pipeline_metrics::stage::deliver, deliver_start);
+    m_counters.add(counter_registry::counter::results_delivered);
+    LOG_DEBUG("Transcription queued: " + text);
+
+    // Add to benchmark if enabled
+    if (m_benchmark && m_config.benchmark_enabled) {
+        m_benchmark->add_transcription(text, result.type_name(), confidence,
+                                       samples, processing_latency_ms);
+    }
+}
 
-        // If alternatives are present, extract confidence
-        if (result.contains("alternatives") && result["alternatives"].is_array()
-            && !result["alternatives"].empty()) {
-            auto& alt = result["alternatives"][0];
-            if (alt.contains("confidence")) {
-                confidence = alt["confidence"].get<float>();
+void vstream_app::deliver_speaker_label(const speaker_identifier::label& label) {
+    LOG_DEBUG("Session " + label.session_id + " utterance " + std::to_string(label.utterance_id) +
+              ": speaker " + label.speaker);
+
+    bool local = m_local_ingest && m_local_ingest->has_session(label.session_id);
+    if (!local && !m_client_sessions.has_owner(label.session_id)) {
+        return;
+    }
+
+    json message = {
+        {"type", "speaker"},
+        {"session_id", label.session_id},
+        {"utterance_id", label.utterance_id},
+        {"text", label.text},
+        {"speaker", label.speaker},
+        {"similarity", label.similarity},
+        {"frames", label.frames}
+    };
+    if (local) {
+        m_local_ingest->send(label.session_id, local_ingest_server::frame_type::result, message.dump());
+    } else {
+        m_websocket_outbox.push(label.session_id, {message.dump(), false, {}, 0.0f, {}});
+    }
+}
+
+void vstream_app::flush_websocket_outbox(const std::string& session_id,
+                                         websocket::stream<tcp::socket>* client_ws) {
+    if (!client_ws) {
+        return;
+    }
+
+    auto messages = m_websocket_outbox.take(session_id);
+    if (messages.empty()) {
+        return;
+    }
+
+    try {
+        client_ws->text(true);
+        for (const auto& message : messages) {
+            client_ws->write(boost::asio::buffer(message.json));
+        }
+    } catch (const std::exception& e) {
+        LOG_WARNING("Cannot send " + std::to_string(messages.size()) + " queued message(s) to session " +
+                    session_id + ": " + e.what());
+    }
+}
+
+std::shared_ptr<vstream_engine> vstream_app::engine_for_session(const std::string& session_id) {
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(m_session_models_mutex);
+        auto it = m_session_models.find(session_id);
+        if (it == m_session_models.end()) {
+            if (m_replicas.size() > 1 && m_dispatcher) {
+                // The replica next to the workers of the session's domain
+                return m_replicas[m_dispatcher->session_domain(session_id)];
             }
+            return m_engine;
         }
+        it->second.last_used = std::chrono::steady_clock::now();
+        if (it->second.engine) {
+            return it->second.engine;
+        }
+        name = it->second.name;
+    }
 
-        if (!text.empty()) {
-            m_server->queue_transcription(text, audio.session_id, confidence);
-            LOG_DEBUG("WebSocket transcription queued: " + text);
+    // First use: only this session's worker waits for the load
+    auto engine = m_models->acquire(name);
 
-            // Add to benchmark if enabled
-            if (m_benchmark && m_config.benchmark_enabled) {
-                m_benchmark->add_transcription(text, type, confidence,
-                                               audio.samples.size(), processing_latency_ms);
-            }
+    std::lock_guard<std::mutex> lock(m_session_models_mutex);
+    auto it = m_session_models.find(session_id);
+    if (it != m_session_models.end() && it->second.name == name) {
+        it->second.engine = engine;
+    }
+    return engine;
+}
+
+void vstream_app::select_session_model(const std::string& session_id, const std::string& model_name) {
+    if (!m_models->contains(model_name)) {
+        throw std::invalid_argument("Unknown model: " + model_name);
+    }
+
+    std::shared_ptr<vstream_engine> previous;
+    {
+        std::lock_guard<std::mutex> lock(m_session_models_mutex);
+        auto it = m_session_models.find(session_id);
+        std::string current = it == m_session_models.end() ? "default" : it->second.name;
+        if (current == model_name) {
+            return;
         }
+        previous = it == m_session_models.end() ? m_engine : it->second.engine;
 
-    } catch (const std::exception& e) {
-        LOG_ERROR("Error processing WebSocket audio result: " + std::string(e.what()));
+        if (model_name == "default") {
+            m_session_models.erase(it);
+        } else {
+            m_session_models[session_id] = session_model{model_name, nullptr, std::chrono::steady_clock::now()};
+        }
+    }
+
+    // Null if the previous model was selected but never used
+    if (previous) {
+        previous->release_session(session_id);
+    }
+}
+
+size_t vstream_app::total_samples_processed() const {
+    // Routed models may be unloaded, so their audio is counted here rather than summed
+    return m_engine->get_total_samples_processed() + m_counters.get(counter_registry::counter::samples_routed);
+}
+
+voice_activity_detector::config vstream_app::make_vad_config() const {
+    voice_activity_detector::config vad_config;
+    vad_config.sample_rate = m_config.sample_rate;
+    vad_config.threshold_db = m_config.vad_threshold_db;
+    vad_config.hangover_ms = m_config.vad_hangover_ms;
+    return vad_config;
+}
+
+std::shared_ptr<vstream_app::session_format> vstream_app::find_session_format(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_session_formats_mutex);
+    if (m_session_formats.empty()) {
+        return nullptr;
     }
+    auto it = m_session_formats.find(session_id);
+    if (it == m_session_formats.end()) {
+        return nullptr;
+    }
+    it->second->last_used = std::chrono::steady_clock::now();
+    return it->second;
+}
+
+std::shared_ptr<vstream_app::session_vad> vstream_app::get_session_vad(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_session_vads_mutex);
+    auto& entry = m_session_vads[session_id];
+    if (!entry) {
+        entry = std::make_shared<session_vad>(make_vad_config());
+    }
+    entry->last_used = std::chrono::steady_clock::now();
+    return entry;
 }
 
 json vstream_app::handle_websocket_command(const std::string& command,
                                            const json& params,
-                                           websocket::stream<tcp::socket>* /*client_ws*/) {
+                                           websocket::stream<tcp::socket>* client_ws) {
     LOG_DEBUG("Received command: " + command);
     json response;
     response["command"] = command;
 
+    std::string session_id;
+    try {
+        session_id = resolve_session_id(params, client_ws);
+    } catch (const std::invalid_argument& e) {
+        response["status"] = "error";
+        response["message"] = e.what();
+        LOG_WARNING("Rejected " + command + " command: " + e.what());
+        return response;
+    }
+    if (!session_id.empty()) {
+        flush_websocket_outbox(session_id, client_ws);
+    }
+
+    // Under the reject level, new sessions are turned away before they create state
+    if (m_dispatcher && !m_dispatcher->is_accepting_sessions() && !session_id.empty() &&
+        command != "stats" && command != "health" && command != "drain" &&
+        !m_dispatcher->has_session(session_id)) {
+        if (is_draining()) {
+            response["status"] = "draining";
+            response["message"] = "Server draining, not accepting new sessions; connect to another node";
+        } else {
+            response["status"] = "overloaded";
+            response["message"] = "Server overloaded, not accepting new sessions; retry later";
+        }
+        return response;
+    }
+
     if (command == "reset") {
-        m_engine->reset();
+        if (session_id.empty()) {
+            m_engine->reset();
+        } else {
+            engine_for_session(session_id)->reset(session_id);
+        }
         response["status"] = "ok";
         response["message"] = "Recognizer reset";
         LOG_INFO("Recognizer reset via command");
     } else if (command == "set_grammar") {
         if (params.contains("grammar")) {
-            m_engine->set_grammar(params["grammar"].dump());
+            if (session_id.empty()) {
+                m_engine->set_grammar(params["grammar"].dump());
+                for (size_t r = 1; r < m_replicas.size(); ++r) {
+                    m_replicas[r]->set_grammar(params["grammar"].dump());
+                }
+            } else {
+                engine_for_session(session_id)->set_grammar(session_id, params["grammar"].dump());
+            }
             response["status"] = "ok";
             response["message"] = "Grammar updated";
             LOG_INFO("Grammar updated via command");
@@ -554,13 +2034,161 @@ json vstream_app::handle_websocket_command(const std::string& command,
             response["message"] = "Missing grammar parameter";
             LOG_WARNING("set_grammar command missing grammar parameter");
         }
+    } else if (command == "partials") {
+        bool enabled = !params.is_object() || params.value("enabled", true);
+        int interval_ms = params.is_object() ? params.value("interval_ms", m_config.partial_interval_ms)
+                                             : m_config.partial_interval_ms;
+        if (interval_ms < 0) {
+            interval_ms = 0;
+        }
+        if (session_id.empty()) {
+            m_engine->set_partial_results(enabled, interval_ms);
+            for (size_t r = 1; r < m_replicas.size(); ++r) {
+                m_replicas[r]->set_partial_results(enabled, interval_ms);
+            }
+        } else {
+            engine_for_session(session_id)->set_partial_results(session_id, enabled, interval_ms);
+        }
+        response["status"] = "ok";
+        response["message"] = enabled ? "Partial results every " + std::to_string(interval_ms) + "ms"
+                                      : "Partial results disabled";
+        LOG_DEBUG("Partial results " + std::string(enabled ? "enabled" : "disabled") + " via command");
+    } else if (command == "latency_target") {
+        int target_ms = params.is_object() ? params.value("target_ms", 0) : 0;
+        if (session_id.empty()) {
+            response["status"] = "error";
+            response["message"] = "latency_target needs a session_id";
+        } else if (target_ms < 0 || target_ms > 60000) {
+            response["status"] = "error";
+            response["message"] = "target_ms must be between 0 and 60000";
+        } else {
+            get_session_chunking(session_id)->controller.set_target_ms(target_ms);
+            response["status"] = "ok";
+            response["message"] = target_ms > 0 ? "Latency target " + std::to_string(target_ms) + "ms"
+                                                : "Latency target cleared";
+            LOG_DEBUG("Session " + session_id + " latency target " + std::to_string(target_ms) + "ms");
+        }
+    } else if (command == "select_model") {
+        std::string name = params.is_object() ? params.value("model", std::string()) : std::string();
+        if (session_id.empty() || name.empty()) {
+            response["status"] = "error";
+            response["message"] = "select_model needs a session_id and a model";
+        } else {
+            try {
+                select_session_model(session_id, name);
+                response["status"] = "ok";
+                response["message"] = "Session uses model " + name;
+                LOG_INFO("Session " + session_id + " selected model " + name);
+            } catch (const std::exception& e) {
+                response["status"] = "error";
+                response["message"] = e.what();
+                LOG_WARNING("select_model command rejected: " + std::string(e.what()));
+            }
+        }
+    } else if (command == "audio_format") {
+        if (session_id.empty()) {
+            response["status"] = "error";
+            response["message"] = "audio_format needs a session_id";
+        } else {
+            try {
+                audio_converter::config format_cfg;
+                format_cfg.input_rate = params.value("sample_rate", m_config.sample_rate);
+                format_cfg.input_channels = params.value("channels", 1);
+                format_cfg.format = audio_converter::parse_format(params.value("format", std::string("s16")));
+                format_cfg.output_rate = m_config.sample_rate;
+
+                // Opus decodes to mono at any of its rates: pick the model rate when it can
+                std::string codec = params.value("codec", std::string("pcm"));
+                if (codec == "opus") {
+                    format_cfg.input_rate = opus_packet_decoder::supports_rate(m_config.sample_rate)
+                                                ? m_config.sample_rate : 48000;
+                    format_cfg.input_channels = 1;
+                    format_cfg.format = audio_converter::sample_format::int16;
+                } else if (codec != "pcm") {
+                    throw std::invalid_argument("Unknown codec: " + codec + " (expected pcm or opus)");
+                }
+
+                // Clients announce their model together with their format when they connect
+                if (params.contains("model") && params["model"].is_string()) {
+                    select_session_model(session_id, params["model"].get<std::string>());
+                }
+
+                auto format = std::make_shared<session_format>(format_cfg);
+                format->last_used = std::chrono::steady_clock::now();
+                if (codec == "opus") {
+                    format->opus = std::make_unique<opus_packet_decoder>(format_cfg.input_rate);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(m_session_formats_mutex);
+                    if (!format->opus && format->converter.passthrough()) {
+                        m_session_formats.erase(session_id);
+                    } else {
+                        m_session_formats[session_id] = std::move(format);
+                    }
+                }
+                response["status"] = "ok";
+                response["message"] = "Audio format set";
+                LOG_INFO("Session " + session_id + " audio: " + codec + ", " +
+                         std::to_string(format_cfg.input_rate) + " Hz, " +
+                         std::to_string(format_cfg.input_channels) + " channel(s)");
+            } catch (const std::exception& e) {
+                response["status"] = "error";
+                response["message"] = std::string("Invalid audio format: ") + e.what();
+                LOG_WARNING("audio_format command rejected: " + std::string(e.what()));
+            }
+        }
+    } else if (command == "load_model") {
+        std::string path = params.is_object() && params.contains("path") && params["path"].is_string()
+                               ? params["path"].get<std::string>()
+                               : m_engine->get_model_path();
+        if (reload_model(path)) {
+            response["status"] = "ok";
+            response["message"] = "Loading model " + path;
+            LOG_INFO("Model reload requested via command: " + path);
+        } else {
+            response["status"] = "error";
+            response["message"] = "Model reload already in progress";
+            LOG_WARNING("load_model command rejected, reload in progress");
+        }
     } else if (command == "stats") {
         response["status"] = "ok";
         response["stats"] = get_stats();
         LOG_DEBUG("Stats requested via command");
+    } else if (command == "health") {
+        response["status"] = "ok";
+        response["health"] = get_health();
+    } else if (command == "drain") {
+        // Unlike a repeated SIGTERM, a repeated command never forces the exit
+        m_drain_requested = true;
+        response["status"] = "ok";
+        response["message"] = "Draining " + std::to_string(active_client_sessions()) +
+                              " session(s), up to " + std::to_string(m_config.drain_timeout_ms) + " ms";
+        LOG_INFO("Drain requested via command");
+    } else if (command == "speakers") {
+        if (!m_speakers) {
+            response["status"] = "error";
+            response["message"] = "Speaker identification not enabled";
+        } else if (session_id.empty()) {
+            response["status"] = "error";
+            response["message"] = "speakers needs a session_id";
+        } else {
+            json labels = json::array();
+            for (const auto& label : m_speakers->recent_labels(session_id)) {
+                labels.push_back({
+                    {"utterance_id", label.utterance_id},
+                    {"text", label.text},
+                    {"speaker", label.speaker},
+                    {"similarity", label.similarity},
+                    {"frames", label.frames}
+                });
+            }
+            response["status"] = "ok";
+            response["session_id"] = session_id;
+            response["labels"] = labels;
+        }
     } else if (command == "benchmark_results") {
         if (m_benchmark && m_config.benchmark_enabled) {
-            auto benchmark_results = m_benchmark->get_current_results();
+            auto benchmark_results = m_benchmark->get_current_results(false);
             response["status"] = "ok";
             response["benchmark"] = {
                 {"word_error_rate", benchmark_results.word_error_rate},
@@ -590,21 +2218,146 @@ json vstream_app::handle_websocket_command(const std::string& command,
     return response;
 }
 
-void vstream_app::print_periodic_stats() {
-    static auto last_stats = std::chrono::steady_clock::now();
+std::string vstream_app::resolve_session_id(const json& params,
+                                            websocket::stream<tcp::socket>* client_ws) {
+    if (params.is_object() && params.contains("session_id") && params["session_id"].is_string()) {
+        auto session_id = params["session_id"].get<std::string>();
+        if (auto conflict = websocket_session_conflict(session_id, client_ws); !conflict.empty()) {
+            throw std::invalid_argument(conflict);
+        }
+        return session_id;
+    }
+
+    return client_ws ? m_client_sessions.session_of(client_ws) : std::string();
+}
+
+std::string vstream_app::websocket_session_conflict(const std::string& session_id,
+                                                    websocket::stream<tcp::socket>* client_ws) {
+    // Local socket connections and internal callers own their session already
+    if (!client_ws) {
+        return {};
+    }
+
+    if (find_mic_channel(session_id)) {
+        return "Session id " + session_id + " is reserved for a capture channel";
+    }
+    if (m_local_ingest && m_local_ingest->has_session(session_id)) {
+        return "Session " + session_id + " belongs to a local socket connection";
+    }
+    if (!m_client_sessions.claim(client_ws, session_id)) {
+        return "Session " + session_id + " belongs to another client";
+    }
+    return {};
+}
+
+void vstream_app::evict_idle_sessions() {
     auto now = std::chrono::steady_clock::now();
 
-    if (std::chrono::duration_cast<std::chrono::seconds>(now - last_stats).count() >= 30) {
-        auto stats = get_stats();
-        LOG_INFO("Stats: " + std::to_string(stats["connected_clients"].get<size_t>()) + " clients, " +
-                 std::to_string(stats["messages_processed"].get<size_t>()) + " messages processed");
+    if (m_engine && now - m_last_eviction_check >= std::chrono::seconds(1)) {
+        size_t evicted = 0;
+        for (const auto& engine : m_models->loaded_engines()) {
+            evicted += engine->evict_idle_sessions();
+        }
+        if (evicted > 0) {
+            LOG_INFO("Released " + std::to_string(evicted) + " idle session(s)");
+        }
+
+        if (m_dispatcher && m_config.session_idle_ms > 0) {
+            m_dispatcher->evict_idle_sessions(std::chrono::milliseconds(m_config.session_idle_ms));
+        }
 
-        // Print benchmark stats if enabled
-        if (m_config.benchmark_enabled && stats.contains("benchmark") && stats["benchmark"]["enabled"]) {
-            LOG_INFO("Benchmark: WER=" + std::to_string(stats["benchmark"]["word_error_rate"].get<double>()) +
-                     "%, RTF=" + std::to_string(stats["benchmark"]["real_time_factor"].get<double>()) + "x");
+        if (m_speakers && m_config.session_idle_ms > 0) {
+            m_speakers->evict_idle_sessions(std::chrono::milliseconds(m_config.session_idle_ms));
+        }
+
+        // Clients that stopped sending get their final results as plain transcripts
+        for (const auto& [session_id, message] : m_websocket_outbox.take_stale(std::chrono::milliseconds(1000))) {
+            if (message.transcript) {
+                m_server->queue_transcription(message.text, session_id, message.confidence);
+            }
+        }
+
+        if (m_config.session_idle_ms > 0) {
+            m_client_sessions.evict_idle(std::chrono::milliseconds(m_config.session_idle_ms));
+        }
+
+        if (m_config.session_idle_ms > 0) {
+            auto cutoff = now - std::chrono::milliseconds(m_config.session_idle_ms);
+            {
+                std::lock_guard<std::mutex> lock(m_session_vads_mutex);
+                std::erase_if(m_session_vads, [cutoff](const auto& entry) {
+                    return entry.second->last_used < cutoff;
+                });
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_session_formats_mutex);
+                std::erase_if(m_session_formats, [cutoff](const auto& entry) {
+                    return entry.second->last_used < cutoff;
+                });
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_session_chunking_mutex);
+                std::erase_if(m_session_chunking, [cutoff](const auto& entry) {
+                    return entry.second->last_used < cutoff;
+                });
+            }
+            // Dropping the reference lets an unused model be unloaded
+            std::lock_guard<std::mutex> lock(m_session_models_mutex);
+            std::erase_if(m_session_models, [cutoff](const auto& entry) {
+                return entry.second.last_used < cutoff;
+            });
         }
+        m_last_eviction_check = now;
+    }
+}
+
+void vstream_app::update_load() {
+    auto now = std::chrono::steady_clock::now();
+    if (!m_load || !m_dispatcher || now - m_last_load_check < std::chrono::seconds(1)) {
+        return;
+    }
+    m_last_load_check = now;
+
+    load_monitor::totals totals;
+    totals.busy_ns = m_dispatcher->get_busy_ns();
+    totals.samples = total_samples_processed();
+    totals.max_queue_wait = m_dispatcher->take_max_queue_wait();
 
-        last_stats = now;
+    auto before = m_load->get_level();
+    auto level = m_load->update(now, totals);
+    if (level == before || !m_config.load_shedding) {
+        return;
+    }
+
+    // Each level keeps the measures of the levels below it
+    for (const auto& engine : m_models->loaded_engines()) {
+        engine->suspend_partial_results(level >= load_monitor::level::no_partials);
+    }
+    m_dispatcher->set_coalesce(level >= load_monitor::level::coarse ? 4 : 1);
+    m_dispatcher->set_accepting_sessions(level < load_monitor::level::reject && !m_draining.load());
+
+    std::ostringstream load;
+    load << std::fixed << std::setprecision(2) << m_load->get_load();
+    LOG_WARNING(std::string("Load ") + load.str() + ": shedding level " + load_monitor::level_name(before) +
+                " -> " + load_monitor::level_name(level));
+}
+
+void vstream_app::print_periodic_stats() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_last_stats_log < std::chrono::seconds(30)) {
+        return;
+    }
+    m_last_stats_log = now;
+
+    // Only counters here; the full stats object is built when a client asks for it
+    size_t clients = m_server ? m_server->get_client_count() : 0;
+    LOG_INFO("Stats: " + std::to_string(clients) + " clients, " +
+             std::to_string(m_counters.get(counter_registry::counter::messages_processed)) +
+             " messages processed");
+
+    if (m_benchmark && m_config.benchmark_enabled) {
+        auto results = m_benchmark->get_current_results(false);
+        LOG_INFO("Benchmark: WER=" + std::to_string(results.word_error_rate) +
+                 "%, RTF=" + std::to_string(results.real_time_factor) + "x");
     }
 }
@@ -11,10 +11,26 @@
 
 #include "vstream_engine.h"
 #include "logger.h"
+#include "slice_feeder.h"
 #include <vosk_api.h>
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace {
+
+std::shared_ptr<VoskModel> load_vosk_model(const std::string& model_path) {
+    VoskModel* model = vosk_model_new(model_path.c_str());
+    if (!model) {
+        throw std::runtime_error("Failed to load Vosk model from: " + model_path);
+    }
+    return std::shared_ptr<VoskModel>(model, vosk_model_free);
+}
+
+} // namespace
 
 // Constructor with default config
 vstream_engine::vstream_engine(const std::string& model_path)
@@ -23,16 +39,30 @@ vstream_engine::vstream_engine(const std::string& model_path)
 
 // Constructor with custom config
 vstream_engine::vstream_engine(const std::string& model_path, const config& cfg)
-    : m_config(cfg) {
+    : m_config(cfg), m_sessions(cfg.max_sessions) {
 
     // Set Vosk log level (0 = info/error, -1 = errors only)
     vosk_set_log_level(0);
 
+    m_grammar_cache = std::make_shared<grammar_cache>(m_config.grammar_cache_size, vosk_recognizer_free);
+
     // Load main model
-    m_model = vosk_model_new(model_path.c_str());
-    if (!m_model) {
-        throw std::runtime_error("Failed to load Vosk model from: " + model_path);
+    if (m_config.backend == backend_type::gpu_batch) {
+        batch_decoder::config batch_config;
+        batch_config.max_batch = m_config.gpu_batch_size;
+        batch_config.max_wait_ms = m_config.gpu_batch_wait_ms;
+        m_batch = std::make_shared<batch_decoder>(model_path, static_cast<float>(m_config.sample_rate),
+                                                  batch_config);
+
+        if (m_config.enable_speaker_id || m_config.max_alternatives > 0) {
+            LOG_WARNING("GPU batch backend ignores speaker identification and alternatives");
+            m_config.enable_speaker_id = false;
+            m_config.max_alternatives = 0;
+        }
+    } else {
+        m_model = load_vosk_model(model_path);
     }
+    m_model_path = model_path;
 
     // Load speaker model if requested
     if (m_config.enable_speaker_id && !m_config.speaker_model_path.empty()) {
@@ -44,142 +74,717 @@ vstream_engine::vstream_engine(const std::string& model_path, const config& cfg)
         }
     }
 
-    initialize_recognizer();
+    m_default_stream = create_stream();
 
     std::cout << "vstream engine initialized successfully" << std::endl;
     std::cout << "  Model: " << model_path << std::endl;
     std::cout << "  Sample rate: " << m_config.sample_rate << " Hz" << std::endl;
     std::cout << "  Speaker ID: " << (m_config.enable_speaker_id ? "enabled" : "disabled") << std::endl;
+    std::cout << "  Backend: " << (m_batch ? "GPU batch" : "CPU") << std::endl;
 }
 
 vstream_engine::~vstream_engine() {
-    if (m_recognizer) {
-        vosk_recognizer_free(m_recognizer);
+    // Stream recognizers reference the model, release them first
+    {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        m_sessions.clear();
     }
+
+    m_default_stream.reset();
+    m_grammar_cache->clear();
+    m_batch.reset();
+
     if (m_spk_model) {
         vosk_spk_model_free(m_spk_model);
     }
-    if (m_model) {
-        vosk_model_free(m_model);
+    m_model.reset();
+}
+
+vstream_engine::stream::stream(vstream_engine& engine, std::shared_ptr<VoskModel> model,
+                               uint64_t generation, VoskRecognizer* recognizer)
+    : m_engine(engine)
+    , m_recognizers(engine.m_grammar_cache)
+    , m_engine_generation(engine.m_model_generation)
+    , m_batch(engine.m_batch)
+    , m_default_alternatives(engine.m_config.max_alternatives)
+    , m_model(std::move(model))
+    , m_model_generation(generation)
+    , m_recognizer(recognizer) {
+}
+
+vstream_engine::stream::~stream() {
+    if (m_recognizer) {
+        recycle_recognizer();
     }
+    close_batch_stream();
 }
 
-void vstream_engine::initialize_recognizer() {
+void vstream_engine::stream::recycle_recognizer() {
+    if (m_model_generation != m_engine_generation->load(std::memory_order_acquire)) {
+        // Built from a replaced model, nobody can reuse it
+        vosk_recognizer_free(m_recognizer);
+        m_recognizer = nullptr;
+        return;
+    }
+
+    vosk_recognizer_reset(m_recognizer);
+    if (m_max_alternatives >= 0) {
+        vosk_recognizer_set_max_alternatives(m_recognizer, m_default_alternatives);
+    }
+    if (m_nlsml) {
+        vosk_recognizer_set_nlsml(m_recognizer, 0);
+    }
+    m_recognizers->release(m_grammar_key, m_model_generation, m_recognizer);
+    m_recognizer = nullptr;
+}
+
+VoskRecognizer* vstream_engine::create_recognizer(VoskModel* model) const {
+    VoskRecognizer* recognizer = nullptr;
+
     // Create recognizer with or without speaker model
     if (m_config.enable_speaker_id && m_spk_model) {
-        m_recognizer = vosk_recognizer_new_spk(m_model,
-                                              static_cast<float>(m_config.sample_rate),
-                                              m_spk_model);
+        recognizer = vosk_recognizer_new_spk(model,
+                                             static_cast<float>(m_config.sample_rate),
+                                             m_spk_model);
     } else {
-        m_recognizer = vosk_recognizer_new(m_model,
-                                          static_cast<float>(m_config.sample_rate));
+        recognizer = vosk_recognizer_new(model,
+                                         static_cast<float>(m_config.sample_rate));
     }
 
-    if (!m_recognizer) {
+    if (!recognizer) {
         throw std::runtime_error("Failed to create Vosk recognizer");
     }
 
     // Configure recognizer
     if (m_config.enable_word_times) {
-        vosk_recognizer_set_words(m_recognizer, 1);
+        vosk_recognizer_set_words(recognizer, 1);
     }
 
     if (m_config.enable_partial_words) {
-        vosk_recognizer_set_partial_words(m_recognizer, 1);
+        vosk_recognizer_set_partial_words(recognizer, 1);
     } else {
-        vosk_recognizer_set_partial_words(m_recognizer, 0);
+        vosk_recognizer_set_partial_words(recognizer, 0);
     }
 
     if (m_config.max_alternatives > 0) {
-        vosk_recognizer_set_max_alternatives(m_recognizer, m_config.max_alternatives);
+        vosk_recognizer_set_max_alternatives(recognizer, m_config.max_alternatives);
     }
+
+    if (m_config.endpointer != endpointer_mode::model_default) {
+        vosk_recognizer_set_endpointer_mode(recognizer,
+                                            static_cast<VoskEndpointerMode>(m_config.endpointer));
+    }
+
+    if (m_config.endpoint_start_max_ms > 0 || m_config.endpoint_end_ms > 0 || m_config.endpoint_max_ms > 0) {
+        // Vosk takes all three; unset ones keep Kaldi's defaults
+        auto seconds = [](int ms, float fallback) { return ms > 0 ? static_cast<float>(ms) / 1000.0f : fallback; };
+        vosk_recognizer_set_endpointer_delays(recognizer,
+                                              seconds(m_config.endpoint_start_max_ms, 5.0f),
+                                              seconds(m_config.endpoint_end_ms, 0.5f),
+                                              seconds(m_config.endpoint_max_ms, 20.0f));
+    }
+
+    return recognizer;
 }
 
-std::string vstream_engine::process_audio(const std::vector<int16_t>& audio_data, bool is_final) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+std::shared_ptr<VoskModel> vstream_engine::current_model(uint64_t& generation) const {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    generation = m_model_generation->load(std::memory_order_relaxed);
+    return m_model;
+}
+
+std::shared_ptr<vstream_engine::stream> vstream_engine::create_stream() {
+    std::string grammar;
+    std::shared_ptr<VoskModel> model;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        grammar = m_default_grammar;
+        model = m_model;
+        generation = m_model_generation->load(std::memory_order_relaxed);
+    }
+
+    // Recognizer creation is the expensive part, done without any engine lock.
+    // Batch streams create their recognizer on first audio instead.
+    std::string key = grammar_cache::normalize(grammar);
+    VoskRecognizer* recognizer = nullptr;
+    if (!m_batch) {
+        recognizer = m_grammar_cache->acquire(key, generation);
+        if (!recognizer) {
+            recognizer = create_recognizer(model.get());
+            if (!grammar.empty()) {
+                vosk_recognizer_set_grm(recognizer, grammar.c_str());
+            }
+        }
+    }
+    std::shared_ptr<stream> created(new stream(*this, std::move(model), generation, recognizer));
+    created->m_grammar = grammar;
+    created->m_grammar_key = std::move(key);
+    created->m_cadence.configure(m_config.enable_partial_results,
+        static_cast<size_t>(std::max(0, m_config.partial_interval_ms)) * m_config.sample_rate / 1000);
+    created->m_chunk_samples = static_cast<size_t>(std::max(10, m_config.chunk_ms)) * m_config.sample_rate / 1000;
+    return created;
+}
+
+void vstream_engine::load_model(const std::string& model_path) {
+    if (m_batch) {
+        throw std::runtime_error("Model reload is not supported by the GPU batch backend");
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    LOG_INFO("Loading model: " + model_path);
+
+    auto model = load_vosk_model(model_path);
+
+    // Fail here rather than on every new session if the model is unusable
+    vosk_recognizer_free(create_recognizer(model.get()));
+
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        m_model.swap(model);
+        m_model_path = model_path;
+        generation = m_model_generation->fetch_add(1, std::memory_order_release) + 1;
+    }
+
+    // Cached recognizers belong to the previous model
+    m_grammar_cache->clear();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - started).count();
+    LOG_INFO("Model " + model_path + " active (generation " + std::to_string(generation) +
+             ", loaded in " + std::to_string(elapsed) + "ms); streams switch at their next utterance");
+
+    // The previous model is freed here unless streams still decode on it
+}
+
+std::string vstream_engine::get_model_path() const {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    return m_model_path;
+}
+
+std::shared_ptr<VoskModel> vstream_engine::get_model() const {
+    uint64_t generation;
+    return current_model(generation);
+}
 
+namespace {
+
+int accept_waveform(VoskRecognizer* recognizer, const int16_t* data, size_t count) {
+    return vosk_recognizer_accept_waveform_s(recognizer, data, static_cast<int>(count));
+}
+
+int accept_waveform(VoskRecognizer* recognizer, const float* data, size_t count) {
+    return vosk_recognizer_accept_waveform_f(recognizer, data, static_cast<int>(count));
+}
+
+} // namespace
+
+std::string vstream_engine::process_audio(std::span<const int16_t> audio_data, bool is_final) {
+    return m_default_stream->process_audio(audio_data, is_final);
+}
+
+std::string vstream_engine::process_audio(std::span<const float> audio_data, bool is_final) {
+    return m_default_stream->process_audio(audio_data, is_final);
+}
+
+std::string vstream_engine::finalize() {
+    return m_default_stream->finalize();
+}
+
+void vstream_engine::process_audio(std::span<const int16_t> audio_data,
+                                   recognition_result& result,
+                                   bool is_final) {
+    m_default_stream->process_audio(audio_data, result, is_final);
+}
+
+void vstream_engine::finalize(recognition_result& result) {
+    m_default_stream->finalize(result);
+}
+
+bool vstream_engine::next_final(recognition_result& result) {
+    return m_default_stream->next_final(result);
+}
+
+bool vstream_engine::next_final(const std::string& session_id, recognition_result& result) {
+    auto session = find_session(session_id);
+    return session && session->next_final(result);
+}
+
+std::string vstream_engine::process_audio(const std::string& session_id,
+                                          std::span<const int16_t> audio_data,
+                                          bool is_final) {
+    if (audio_data.empty() && !is_final) {
+        return "{}";
+    }
+
+    return acquire_session(session_id)->process_audio(audio_data, is_final);
+}
+
+std::string vstream_engine::process_audio(const std::string& session_id,
+                                          std::span<const float> audio_data,
+                                          bool is_final) {
     if (audio_data.empty() && !is_final) {
         return "{}";
     }
 
-    m_total_samples += audio_data.size();
+    return acquire_session(session_id)->process_audio(audio_data, is_final);
+}
+
+void vstream_engine::process_audio(const std::string& session_id,
+                                   std::span<const int16_t> audio_data,
+                                   recognition_result& result,
+                                   bool is_final) {
+    if (audio_data.empty() && !is_final) {
+        result.clear();
+        return;
+    }
+
+    acquire_session(session_id)->process_audio(audio_data, result, is_final);
+}
+
+std::string vstream_engine::stream::process_audio(std::span<const int16_t> audio_data, bool is_final) {
+    decode_info info;
+    std::string json;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto start = std::chrono::steady_clock::now();
+        json = decode(audio_data, is_final, info);
+        if (auto* metrics = m_engine.m_metrics) {
+            metrics->record_since(pipeline_metrics::stage::decode, start);
+        }
+    }
+    log_decode(info, json);
+    return json;
+}
 
-    static int process_count = 0;
-    static bool just_got_final = false;  // Track if we just got a final result
-    process_count++;
+std::string vstream_engine::stream::process_audio(std::span<const float> audio_data, bool is_final) {
+    decode_info info;
+    std::string json;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto start = std::chrono::steady_clock::now();
+        json = decode(audio_data, is_final, info);
+        if (auto* metrics = m_engine.m_metrics) {
+            metrics->record_since(pipeline_metrics::stage::decode, start);
+        }
+    }
+    log_decode(info, json);
+    return json;
+}
+
+std::string vstream_engine::stream::finalize() {
+    return process_audio(std::span<const int16_t>{}, true);
+}
+
+void vstream_engine::stream::process_audio(std::span<const int16_t> audio_data,
+                                           recognition_result& result,
+                                           bool is_final) {
+    decode_info info;
+    bool parsed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto start = std::chrono::steady_clock::now();
+        const char* json = decode(audio_data, is_final, info);
+        auto decoded = std::chrono::steady_clock::now();
+
+        // The Vosk buffer is only valid until the next call, copy it under the lock
+        parsed = result.assign(json, m_engine.m_config.enable_word_times);
+
+        if (auto* metrics = m_engine.m_metrics) {
+            metrics->record(pipeline_metrics::stage::decode, decoded - start);
+            metrics->record_since(pipeline_metrics::stage::parse, decoded);
+        }
+    }
+    if (!parsed) {
+        LOG_ERROR("Malformed Vosk result: " + logger::truncate_text(std::string(result.json()), 200));
+    }
+    log_decode(info, result.json());
+}
+
+void vstream_engine::stream::finalize(recognition_result& result) {
+    process_audio(std::span<const int16_t>{}, result, true);
+}
+
+bool vstream_engine::stream::next_final(recognition_result& result) {
+    decode_info info;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_finals.empty()) {
+            return false;
+        }
+        result.assign(take_final(info), m_engine.m_config.enable_word_times);
+    }
+    log_decode(info, result.json());
+    return true;
+}
+
+template<typename Sample>
+const char* vstream_engine::stream::decode(std::span<const Sample> audio_data, bool is_final,
+                                           decode_info& info) {
+    if (audio_data.empty() && !is_final) {
+        return "{}";
+    }
+
+    m_engine.m_total_samples += audio_data.size();
+
+    if (m_batch) {
+        if constexpr (std::is_same_v<Sample, int16_t>) {
+            return decode_batch(audio_data, is_final, info);
+        } else {
+            m_batch_samples.resize(audio_data.size());
+            std::transform(audio_data.begin(), audio_data.end(), m_batch_samples.begin(), [](float v) {
+                return static_cast<int16_t>(std::lrint(std::clamp(v, -32768.0f, 32767.0f)));
+            });
+            return decode_batch(m_batch_samples, is_final, info);
+        }
+    }
 
     if (!audio_data.empty()) {
-        // If we just got a final result, skip some audio to avoid echoes
-        if (just_got_final) {
-            just_got_final = false;
-            // Optionally reset the recognizer to ensure clean state
-            vosk_recognizer_reset(m_recognizer);
-            LOG_DEBUG("Reset recognizer after final result");
-        }
-
-        const size_t chunk_size = 1600; // 100ms at 16kHz
-        size_t processed = 0;
-        std::string last_result;
-
-        while (processed < audio_data.size()) {
-            size_t current_chunk = std::min(chunk_size, audio_data.size() - processed);
-
-            int result = vosk_recognizer_accept_waveform_s(
-                m_recognizer,
-                audio_data.data() + processed,
-                current_chunk
-                );
-
-            if (result > 0) {
-                // Complete utterance
-                std::string final_result = vosk_recognizer_result(m_recognizer);
-                LOG_INFO("Vosk final result: " + logger::truncate_text(final_result, 200));
-                just_got_final = true;  // Mark that we got a final result
-                return final_result;
-            } else if (result == 0) {
-                last_result = vosk_recognizer_partial_result(m_recognizer);
-            } else {
-                LOG_ERROR("Vosk error processing audio, result code: " + std::to_string(result));
-            }
+        // Audio after an endpoint belongs to the next utterance, its final is queued
+        size_t tail = feed_slices(audio_data, m_chunk_samples,
+            [&](std::span<const Sample> slice) {
+                // Start the next utterance from a clean recognizer state
+                if (m_just_finalized) {
+                    m_just_finalized = false;
+                    begin_utterance();
+                }
+                int result = accept_waveform(m_recognizer, slice.data(), slice.size());
+                if (result < 0) {
+                    info.error = result;
+                }
+                return result;
+            },
+            [&]() {
+                m_just_finalized = true;
+                m_finals.emplace_back(vosk_recognizer_result(m_recognizer));
+            });
+
+        // The partial cadence restarts with the utterance after an endpoint
+        if (tail < audio_data.size()) {
+            m_cadence.reset();
+        }
+        m_cadence.add(tail);
+        if (!m_finals.empty()) {
+            return take_final(info);
+        }
 
-            processed += current_chunk;
+        // One partial for the whole call, and only when it is due
+        if (!m_cadence.due(m_engine.m_partials_suspended.load(std::memory_order_relaxed))) {
+            return "{}";
         }
+        return vosk_recognizer_partial_result(m_recognizer);
+    }
+
+    m_just_finalized = true;
+    m_cadence.reset();
+    const char* json = vosk_recognizer_final_result(m_recognizer);
+    if (!m_finals.empty()) {
+        // Results of earlier utterances go out first
+        m_finals.emplace_back(json);
+        return take_final(info);
+    }
+    info.finalized = true;
+    info.forced = true;
+    return json;
+}
 
-        return last_result;
+const char* vstream_engine::stream::take_final(decode_info& info) {
+    m_final = std::move(m_finals.front());
+    m_finals.pop_front();
+    info.finalized = true;
+    return m_final.c_str();
+}
+
+void vstream_engine::stream::log_decode(const decode_info& info, std::string_view json) const {
+    if (info.error) {
+        LOG_ERROR("Vosk error processing audio, result code: " + std::to_string(info.error));
+    }
+    if (info.finalized) {
+        LOG_INFO(std::string(info.forced ? "Vosk final result (forced): " : "Vosk final result: ") +
+                 logger::truncate_text(std::string(json), 200));
+    }
+}
+
+const char* vstream_engine::stream::decode_batch(std::span<const int16_t> audio_data, bool is_final,
+                                                 decode_info& info) {
+    if (!m_batch_recognizer) {
+        m_batch_recognizer = m_batch->create_recognizer();
+        if (m_nlsml) {
+            vosk_batch_recognizer_set_nlsml(m_batch_recognizer, 1);
+        }
     }
 
+    m_batch_result = m_batch->decode(m_batch_recognizer, audio_data, is_final);
+
     if (is_final) {
-        std::string final_result = vosk_recognizer_final_result(m_recognizer);
-        LOG_INFO("Vosk final result (forced): " + logger::truncate_text(final_result, 200));
-        just_got_final = true;
-        return final_result;
+        // A finished batch stream takes no more audio, the next chunk opens a new one
+        batch_decoder::free_recognizer(m_batch_recognizer);
+        m_batch_recognizer = nullptr;
+        info.forced = true;
+        if (m_batch_result.empty()) {
+            m_batch_result = "{\"text\" : \"\"}";
+        }
+    } else if (m_batch_result.empty()) {
+        // The batch recognizer has no partial results
+        return "{\"partial\" : \"\"}";
     }
 
-    return "{}";
+    m_just_finalized = true;
+    info.finalized = true;
+    return m_batch_result.c_str();
 }
 
-void vstream_engine::reset() {
+void vstream_engine::stream::close_batch_stream() {
+    if (!m_batch_recognizer) {
+        return;
+    }
+    // Let the GPU pipeline drain this stream before the recognizer goes away
+    m_batch->decode(m_batch_recognizer, {}, true);
+    batch_decoder::free_recognizer(m_batch_recognizer);
+    m_batch_recognizer = nullptr;
+}
+
+void vstream_engine::stream::begin_utterance() {
+    if (!m_recognizer) {
+        // Batch streams endpoint on their own
+        return;
+    }
+
+    if (m_model_generation == m_engine_generation->load(std::memory_order_acquire)) {
+        vosk_recognizer_reset(m_recognizer);
+        return;
+    }
+
+    uint64_t generation;
+    auto model = m_engine.current_model(generation);
+
+    VoskRecognizer* recognizer = nullptr;
+    try {
+        recognizer = m_engine.create_recognizer(model.get());
+    } catch (const std::exception& e) {
+        // Keep decoding on the old model rather than dropping the stream
+        LOG_ERROR("Cannot switch stream to model generation " + std::to_string(generation) +
+                  ": " + e.what());
+        m_model_generation = generation;
+        vosk_recognizer_reset(m_recognizer);
+        return;
+    }
+
+    if (!m_grammar.empty()) {
+        vosk_recognizer_set_grm(recognizer, m_grammar.c_str());
+    }
+    if (m_max_alternatives >= 0) {
+        vosk_recognizer_set_max_alternatives(recognizer, m_max_alternatives);
+    }
+    if (m_nlsml) {
+        vosk_recognizer_set_nlsml(recognizer, 1);
+    }
+
+    vosk_recognizer_free(m_recognizer);
+    m_recognizer = recognizer;
+    m_model = std::move(model);
+    m_model_generation = generation;
+}
+
+void vstream_engine::stream::reset() {
     std::lock_guard<std::mutex> lock(m_mutex);
-    vosk_recognizer_reset(m_recognizer);
+    close_batch_stream();
+    begin_utterance();
+    m_finals.clear();
+    m_just_finalized = false;
+    m_cadence.reset();
 }
 
-void vstream_engine::set_grammar(const std::string& grammar) {
+void vstream_engine::stream::set_grammar(const std::string& grammar) {
     std::lock_guard<std::mutex> lock(m_mutex);
-    vosk_recognizer_set_grm(m_recognizer, grammar.c_str());
+    if (!m_recognizer) {
+        m_grammar = grammar;
+        LOG_WARNING("Grammar ignored by the GPU batch backend");
+        return;
+    }
+
+    // Only this stream waits while a grammar graph is built on a miss
+    std::string key = grammar_cache::normalize(grammar);
+    VoskRecognizer* recognizer = m_recognizers->acquire(key, m_model_generation);
+    if (!recognizer) {
+        recognizer = m_engine.create_recognizer(m_model.get());
+        if (!grammar.empty()) {
+            vosk_recognizer_set_grm(recognizer, grammar.c_str());
+        }
+    }
+    if (m_max_alternatives >= 0) {
+        vosk_recognizer_set_max_alternatives(recognizer, m_max_alternatives);
+    }
+    if (m_nlsml) {
+        vosk_recognizer_set_nlsml(recognizer, 1);
+    }
+
+    recycle_recognizer();
+    m_recognizer = recognizer;
+    m_grammar = grammar;
+    m_grammar_key = std::move(key);
+    m_just_finalized = false;
+    m_cadence.reset();
 }
 
-void vstream_engine::set_max_alternatives(int max) {
+void vstream_engine::stream::set_max_alternatives(int max) {
     std::lock_guard<std::mutex> lock(m_mutex);
-    vosk_recognizer_set_max_alternatives(m_recognizer, max);
+    m_max_alternatives = max;
+    if (m_recognizer) {
+        vosk_recognizer_set_max_alternatives(m_recognizer, max);
+    }
 }
 
-void vstream_engine::enable_nlsml_output(bool enable) {
+void vstream_engine::stream::set_partial_results(bool enabled, int interval_ms) {
     std::lock_guard<std::mutex> lock(m_mutex);
-    vosk_recognizer_set_nlsml(m_recognizer, enable ? 1 : 0);
+    m_cadence.configure(enabled, static_cast<size_t>(std::max(0, interval_ms)) * m_engine.m_config.sample_rate / 1000);
 }
 
-bool vstream_engine::has_partial_result() const {
+void vstream_engine::stream::set_chunk_ms(int chunk_ms) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_chunk_samples = static_cast<size_t>(std::max(10, chunk_ms)) * m_engine.m_config.sample_rate / 1000;
+}
+
+void vstream_engine::stream::enable_nlsml_output(bool enable) {
     std::lock_guard<std::mutex> lock(m_mutex);
+    m_nlsml = enable;
+    if (m_recognizer) {
+        vosk_recognizer_set_nlsml(m_recognizer, enable ? 1 : 0);
+    } else if (m_batch_recognizer) {
+        vosk_batch_recognizer_set_nlsml(m_batch_recognizer, enable ? 1 : 0);
+    }
+}
+
+bool vstream_engine::stream::has_partial_result() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_recognizer) {
+        return false;
+    }
     std::string partial = vosk_recognizer_partial_result(m_recognizer);
     return partial.find("\"partial\" : \"\"") == std::string::npos;
 }
+
+bool vstream_engine::stream::just_finalized() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_just_finalized;
+}
+
+std::shared_ptr<vstream_engine::stream>
+vstream_engine::acquire_session(const std::string& session_id) {
+    {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+
+        if (auto found = m_sessions.find(session_id)) {
+            return found;
+        }
+
+        // Evicts the least recently used session nobody is decoding on
+        auto evicted = m_sessions.make_room();
+        if (!evicted.empty()) {
+            LOG_INFO("Session pool full, evicting session: " + evicted);
+        }
+    }
+
+    auto created = create_stream();
+    if (m_config.partial_results_opt_in) {
+        created->m_cadence.configure(false, created->m_cadence.interval());
+    }
+
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    auto [pooled, inserted] = m_sessions.insert(session_id, created);
+    if (inserted) {
+        LOG_INFO("Created recognizer for session: " + session_id +
+                 " (" + std::to_string(m_sessions.size()) + " active)");
+    }
+    // If another thread raced us, use its stream and drop ours
+    return pooled;
+}
+
+std::shared_ptr<vstream_engine::stream>
+vstream_engine::find_session(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    return m_sessions.find(session_id);
+}
+
+void vstream_engine::release_session(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    if (m_sessions.erase(session_id)) {
+        LOG_INFO("Released recognizer for session: " + session_id);
+    }
+}
+
+size_t vstream_engine::evict_idle_sessions() {
+    if (m_config.session_idle_timeout_ms <= 0) {
+        return 0;
+    }
+
+    auto cutoff = std::chrono::steady_clock::now() -
+                  std::chrono::milliseconds(m_config.session_idle_timeout_ms);
+
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    auto evicted = m_sessions.evict_idle(cutoff);
+    for (const auto& session_id : evicted) {
+        LOG_INFO("Evicting idle session: " + session_id);
+    }
+
+    return evicted.size();
+}
+
+size_t vstream_engine::get_session_count() const {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    return m_sessions.size();
+}
+
+bool vstream_engine::has_session(const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(m_sessions_mutex);
+    return m_sessions.contains(session_id);
+}
+
+void vstream_engine::reset() {
+    m_default_stream->reset();
+}
+
+void vstream_engine::reset(const std::string& session_id) {
+    auto session = find_session(session_id);
+    if (session) {
+        session->reset();
+    }
+}
+
+void vstream_engine::set_grammar(const std::string& grammar) {
+    {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        m_default_grammar = grammar;
+    }
+
+    m_default_stream->set_grammar(grammar);
+}
+
+void vstream_engine::set_grammar(const std::string& session_id, const std::string& grammar) {
+    acquire_session(session_id)->set_grammar(grammar);
+}
+
+void vstream_engine::set_partial_results(bool enabled, int interval_ms) {
+    m_default_stream->set_partial_results(enabled, interval_ms);
+}
+
+void vstream_engine::set_partial_results(const std::string& session_id, bool enabled, int interval_ms) {
+    acquire_session(session_id)->set_partial_results(enabled, interval_ms);
+}
+
+void vstream_engine::set_chunk_ms(const std::string& session_id, int chunk_ms) {
+    acquire_session(session_id)->set_chunk_ms(chunk_ms);
+}
+
+void vstream_engine::set_max_alternatives(int max) {
+    m_default_stream->set_max_alternatives(max);
+}
+
+void vstream_engine::enable_nlsml_output(bool enable) {
+    m_default_stream->enable_nlsml_output(enable);
+}
+
+bool vstream_engine::has_partial_result() const {
+    return m_default_stream->has_partial_result();
+}
@@ -0,0 +1,75 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include "websocket_outbox.h"
+#include <algorithm>
+
+websocket_outbox::websocket_outbox(size_t max_per_session)
+    : m_max_per_session(std::max<size_t>(1, max_per_session)) {
+}
+
+void websocket_outbox::push(const std::string& session_id, message msg) {
+    msg.queued = clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& queue = m_queues[session_id];
+    if (queue.size() >= m_max_per_session) {
+        queue.pop_front();
+        m_dropped++;
+    } else {
+        m_size++;
+    }
+    queue.push_back(std::move(msg));
+}
+
+std::vector<websocket_outbox::message> websocket_outbox::take(const std::string& session_id) {
+    std::vector<message> messages;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_queues.find(session_id);
+    if (it == m_queues.end()) {
+        return messages;
+    }
+    messages.assign(std::make_move_iterator(it->second.begin()), std::make_move_iterator(it->second.end()));
+    m_size -= messages.size();
+    m_queues.erase(it);
+    return messages;
+}
+
+std::vector<std::pair<std::string, websocket_outbox::message>>
+websocket_outbox::take_stale(std::chrono::milliseconds age) {
+    std::vector<std::pair<std::string, message>> messages;
+    auto cutoff = clock::now() - age;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_queues.begin(); it != m_queues.end();) {
+        if (it->second.front().queued > cutoff) {
+            ++it;
+            continue;
+        }
+        for (auto& msg : it->second) {
+            messages.emplace_back(it->first, std::move(msg));
+        }
+        m_size -= it->second.size();
+        it = m_queues.erase(it);
+    }
+    return messages;
+}
+
+size_t websocket_outbox::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+uint64_t websocket_outbox::get_dropped() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped;
+}
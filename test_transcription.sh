@@ -3,13 +3,19 @@
 
 MODEL="models/vosk-model-en-us-0.42-gigaspeech"
 REFERENCE="benchmark.wav.txt"
+AUDIO="benchmark.wav"
 OUTPUT="transcribed_$(date +%Y%m%d_%H%M%S).txt"
 
 echo "Starting transcription test..."
 echo "Output will be saved to: $OUTPUT"
 
-# Run vstream and capture all output
-./build_rel/vstream --model $MODEL --mic --buffer-ms 100 --silence-ms 100 --finalize-ms 5000 --no-partial > raw_output.txt 2>/dev/null
+# Run vstream and capture all output; decode the recording directly when
+# it is available, otherwise play it into the microphone
+if [ -f "$AUDIO" ]; then
+    ./build_rel/vstream --model $MODEL --input "$AUDIO" --no-partial > raw_output.txt 2>/dev/null
+else
+    ./build_rel/vstream --model $MODEL --mic --buffer-ms 100 --finalize-ms 5000 --no-partial > raw_output.txt 2>/dev/null
+fi
 
 # Extract just the final results
 grep "\[FINAL\]" raw_output.txt | sed 's/\[FINAL\] //' > $OUTPUT
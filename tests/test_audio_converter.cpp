@@ -0,0 +1,225 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "audio_converter.h"
+#include <cmath>
+#include <vector>
+#include <cstdint>
+
+class AudioConverterTest : public ::testing::Test {
+protected:
+    static std::vector<float> tone(size_t samples, int rate, double frequency, double amplitude) {
+        std::vector<float> out(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            out[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * i / rate));
+        }
+        return out;
+    }
+
+    static std::vector<int16_t> to_pcm(const std::vector<float>& samples) {
+        std::vector<int16_t> out(samples.size());
+        for (size_t i = 0; i < samples.size(); ++i) {
+            out[i] = static_cast<int16_t>(std::lrint(samples[i] * 32767.0f));
+        }
+        return out;
+    }
+
+    // RMS of the second half, past the filter start-up
+    static double rms(std::span<const int16_t> samples) {
+        auto tail = samples.subspan(samples.size() / 2);
+        double sum = 0.0;
+        for (int16_t s : tail) {
+            sum += static_cast<double>(s) * s;
+        }
+        return std::sqrt(sum / static_cast<double>(tail.size()));
+    }
+
+    static audio_converter::config make_config(int input_rate, int channels = 1,
+                                               audio_converter::sample_format format =
+                                                   audio_converter::sample_format::int16) {
+        audio_converter::config cfg;
+        cfg.input_rate = input_rate;
+        cfg.input_channels = channels;
+        cfg.format = format;
+        cfg.output_rate = 16000;
+        return cfg;
+    }
+};
+
+TEST_F(AudioConverterTest, RejectsInvalidConfig) {
+    EXPECT_THROW(audio_converter{make_config(0)}, std::invalid_argument);
+    EXPECT_THROW(audio_converter{make_config(16000, 0)}, std::invalid_argument);
+
+    auto cfg = make_config(16000);
+    cfg.taps_per_phase = 0;
+    EXPECT_THROW(audio_converter{cfg}, std::invalid_argument);
+
+    // Coprime rates would need an enormous filter bank
+    EXPECT_THROW(audio_converter{make_config(44101)}, std::invalid_argument);
+
+    EXPECT_EQ(audio_converter::parse_format("f32"), audio_converter::sample_format::float32);
+    EXPECT_EQ(audio_converter::parse_format("s16"), audio_converter::sample_format::int16);
+    EXPECT_THROW(audio_converter::parse_format("u8"), std::invalid_argument);
+}
+
+TEST_F(AudioConverterTest, PassthroughReturnsInput) {
+    audio_converter converter(make_config(16000));
+    EXPECT_TRUE(converter.passthrough());
+    EXPECT_FALSE(converter.resampling());
+
+    auto pcm = to_pcm(tone(1600, 16000, 440.0, 0.5));
+    auto out = converter.process(std::span<const int16_t>(pcm));
+    EXPECT_EQ(out.data(), pcm.data());
+    EXPECT_EQ(out.size(), pcm.size());
+}
+
+TEST_F(AudioConverterTest, DownmixesStereo) {
+    audio_converter converter(make_config(16000, 2));
+    EXPECT_FALSE(converter.passthrough());
+
+    std::vector<int16_t> stereo = {1000, 3000, -2000, -4000, 32767, 32767};
+    auto out = converter.process(std::span<const int16_t>(stereo));
+    ASSERT_EQ(out.size(), 3u);
+    EXPECT_EQ(out[0], 2000);
+    EXPECT_EQ(out[1], -3000);
+    EXPECT_EQ(out[2], 32767);
+}
+
+TEST_F(AudioConverterTest, DeinterleavesChannels) {
+    // 37 stereo frames cover the vector loop and its scalar tail
+    std::vector<int16_t> stereo;
+    for (int16_t i = 0; i < 37; ++i) {
+        stereo.push_back(i);
+        stereo.push_back(static_cast<int16_t>(-i));
+    }
+    stereo.push_back(99);  // partial frame
+
+    std::vector<std::vector<int16_t>> planes(2);
+    audio_converter::deinterleave(stereo, planes);
+    ASSERT_EQ(planes[0].size(), 37u);
+    ASSERT_EQ(planes[1].size(), 37u);
+    for (int16_t i = 0; i < 37; ++i) {
+        EXPECT_EQ(planes[0][i], i);
+        EXPECT_EQ(planes[1][i], -i);
+    }
+
+    std::vector<int16_t> three = {1, 2, 3, 4, 5, 6};
+    planes.assign(3, {});
+    audio_converter::deinterleave(three, planes);
+    EXPECT_EQ(planes[0], (std::vector<int16_t>{1, 4}));
+    EXPECT_EQ(planes[1], (std::vector<int16_t>{2, 5}));
+    EXPECT_EQ(planes[2], (std::vector<int16_t>{3, 6}));
+}
+
+TEST_F(AudioConverterTest, ConvertsFloatWithSaturation) {
+    audio_converter converter(make_config(16000, 1, audio_converter::sample_format::float32));
+
+    std::vector<float> samples = {0.0f, 0.5f, -0.5f, 2.0f, -2.0f};
+    auto out = converter.process(std::as_bytes(std::span<const float>(samples)));
+    ASSERT_EQ(out.size(), 5u);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[1], 16384);
+    EXPECT_EQ(out[2], -16384);
+    EXPECT_EQ(out[3], 32767);
+    EXPECT_EQ(out[4], -32768);
+}
+
+TEST_F(AudioConverterTest, CarriesPartialFrames) {
+    audio_converter converter(make_config(16000, 2, audio_converter::sample_format::float32));
+
+    std::vector<float> frames = {0.25f, 0.75f, -0.5f, -0.5f};
+    auto bytes = std::as_bytes(std::span<const float>(frames));
+
+    // Split in the middle of a sample: nothing until the first frame completes
+    EXPECT_TRUE(converter.process(bytes.first(5)).empty());
+    auto first = converter.process(bytes.subspan(5, 7));
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first[0], 16384);
+
+    auto second = converter.process(bytes.subspan(12));
+    ASSERT_EQ(second.size(), 1u);
+    EXPECT_EQ(second[0], -16384);
+}
+
+TEST_F(AudioConverterTest, DownsamplesCommonRates) {
+    for (int rate : {48000, 44100, 32000, 22050}) {
+        audio_converter converter(make_config(rate));
+        EXPECT_TRUE(converter.resampling());
+
+        // One second of a 1 kHz tone keeps its level and the output rate
+        auto pcm = to_pcm(tone(static_cast<size_t>(rate), rate, 1000.0, 0.5));
+        std::vector<int16_t> out;
+        auto converted = converter.process(std::span<const int16_t>(pcm));
+        out.assign(converted.begin(), converted.end());
+
+        EXPECT_NEAR(static_cast<double>(out.size()), 16000.0, 2.0) << rate;
+        EXPECT_NEAR(rms(out), 0.5 * 32767.0 / std::sqrt(2.0), 300.0) << rate;
+    }
+}
+
+TEST_F(AudioConverterTest, RemovesContentAboveOutputNyquist) {
+    audio_converter converter(make_config(48000));
+
+    // 12 kHz cannot be represented at 16 kHz and would alias to 4 kHz
+    auto pcm = to_pcm(tone(48000, 48000, 12000.0, 0.5));
+    auto out = converter.process(std::span<const int16_t>(pcm));
+    EXPECT_LT(rms(out), 0.5 * 32767.0 * 0.01);
+}
+
+TEST_F(AudioConverterTest, UpsamplesNarrowband) {
+    audio_converter converter(make_config(8000));
+
+    auto pcm = to_pcm(tone(8000, 8000, 500.0, 0.5));
+    auto out = converter.process(std::span<const int16_t>(pcm));
+    EXPECT_EQ(out.size(), 16000u);
+    EXPECT_NEAR(rms(out), 0.5 * 32767.0 / std::sqrt(2.0), 300.0);
+}
+
+TEST_F(AudioConverterTest, ChunkingDoesNotChangeOutput) {
+    auto cfg = make_config(44100, 2, audio_converter::sample_format::float32);
+    auto mono = tone(44100, 44100, 700.0, 0.4);
+    std::vector<float> stereo;
+    for (float s : mono) {
+        stereo.push_back(s);
+        stereo.push_back(-s * 0.5f);
+    }
+    auto bytes = std::as_bytes(std::span<const float>(stereo));
+
+    audio_converter whole(cfg);
+    auto reference_span = whole.process(bytes);
+    std::vector<int16_t> reference(reference_span.begin(), reference_span.end());
+
+    // Odd chunk sizes split frames and samples alike
+    audio_converter chunked(cfg);
+    std::vector<int16_t> pieces;
+    for (size_t pos = 0; pos < bytes.size(); pos += 1237) {
+        auto out = chunked.process(bytes.subspan(pos, std::min<size_t>(1237, bytes.size() - pos)));
+        pieces.insert(pieces.end(), out.begin(), out.end());
+    }
+
+    EXPECT_EQ(pieces, reference);
+}
+
+TEST_F(AudioConverterTest, ResetClearsHistory) {
+    audio_converter converter(make_config(48000));
+
+    auto loud = to_pcm(tone(4800, 48000, 1000.0, 0.9));
+    converter.process(std::span<const int16_t>(loud));
+    converter.reset();
+
+    std::vector<int16_t> silence(4800, 0);
+    auto out = converter.process(std::span<const int16_t>(silence));
+    ASSERT_FALSE(out.empty());
+    for (int16_t s : out) {
+        EXPECT_EQ(s, 0);
+    }
+}
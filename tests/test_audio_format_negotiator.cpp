@@ -0,0 +1,72 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "../examples/cpp/audio_format_negotiator.h"
+#include "opus_packet_decoder.h"
+
+TEST(AudioFormatNegotiatorTest, AgreesWithServerOnOpusRates) {
+    for (int rate : {8000, 11025, 12000, 16000, 22050, 24000, 32000, 44100, 48000}) {
+        EXPECT_EQ(AudioFormatNegotiator::opusSupportsRate(rate), opus_packet_decoder::supports_rate(rate))
+            << rate << " Hz";
+    }
+}
+
+TEST(AudioFormatNegotiatorTest, AnnouncesOnceBeforeFirstAudio) {
+    AudioFormatNegotiator negotiator;
+    negotiator.setOpusEnabled(true);
+
+    bool announce = false;
+    auto format = negotiator.formatFor(16000, announce);
+    EXPECT_TRUE(announce);
+    EXPECT_TRUE(format.opus);
+
+    negotiator.formatFor(16000, announce);
+    EXPECT_FALSE(announce);
+}
+
+TEST(AudioFormatNegotiatorTest, FallsBackToAnnouncedPcm) {
+    AudioFormatNegotiator negotiator;
+    negotiator.setOpusEnabled(true);
+
+    bool announce = false;
+    negotiator.formatFor(16000, announce);
+
+    // 32 kHz cannot be Opus-encoded: the server must switch to PCM at that rate
+    auto format = negotiator.formatFor(32000, announce);
+    EXPECT_TRUE(announce);
+    EXPECT_FALSE(format.opus);
+    EXPECT_EQ(format.sample_rate, 32000);
+
+    negotiator.formatFor(32000, announce);
+    EXPECT_FALSE(announce);
+
+    // And back to Opus when the rate allows it again
+    format = negotiator.formatFor(48000, announce);
+    EXPECT_TRUE(announce);
+    EXPECT_TRUE(format.opus);
+}
+
+TEST(AudioFormatNegotiatorTest, ReannouncesAfterCodecChangeOrReconnect) {
+    AudioFormatNegotiator negotiator;
+
+    bool announce = false;
+    EXPECT_FALSE(negotiator.formatFor(16000, announce).opus);
+    EXPECT_TRUE(announce);
+
+    negotiator.setOpusEnabled(true);
+    EXPECT_TRUE(negotiator.formatFor(16000, announce).opus);
+    EXPECT_TRUE(announce);
+
+    negotiator.reset();
+    negotiator.formatFor(16000, announce);
+    EXPECT_TRUE(announce);
+}
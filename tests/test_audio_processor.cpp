@@ -12,6 +12,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "audio_processor.h"
+#include "utterance_cap.h"
 #include <thread>
 #include <chrono>
 #include <nlohmann/json.hpp>
@@ -63,9 +64,8 @@ public:
         , m_session_id("mic-capture")
         , m_silence_frames_threshold(silence_frames_threshold)
         , m_use_vad(use_vad)
-        , m_finalize_interval_ms(finalize_interval_ms)
         , m_buffer_ms(buffer_ms)
-        , m_last_finalize_time(std::chrono::steady_clock::now())
+        , m_cap(finalize_interval_ms)
         , m_last_debug_time(std::chrono::steady_clock::now()) {
 
         m_show_partial = engine->has_partial_enabled();
@@ -88,15 +88,18 @@ public:
 
             // Process with mock engine
             m_result_buffer = m_mock_engine->process_audio(audio, false);
-            handle_speech_result(m_result_buffer);
-
-            // Add periodic finalization even during speech for more frequent results
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                               now - m_last_finalize_time).count();
+            bool endpointed = handle_speech_result(m_result_buffer);
+            if (endpointed) {
+                // The model endpointed: the cap restarts with the next utterance
+                m_last_partial_text.clear();
+            }
 
-            if (elapsed >= m_finalize_interval_ms) {
+            // Same decision as audio_processor::process_audio() (utterance_cap)
+            auto action = m_cap.after_decode(now, endpointed, false, [this]() {
+                return !m_last_partial_text.empty();
+            });
+            if (action != utterance_cap::action::none) {
                 force_finalize();
-                m_last_finalize_time = now;
             }
         } else {
             // Silence detected (only happens when VAD is enabled)
@@ -111,7 +114,8 @@ public:
     }
 
 private:
-    void handle_speech_result(const std::string& result_json) {
+    // Returns true when the result is final
+    bool handle_speech_result(const std::string& result_json) {
         try {
             auto result = nlohmann::json::parse(result_json);
 
@@ -121,6 +125,7 @@ private:
                 if (!text.empty() && text != m_last_final_text) {
                     handle_final_result(text);
                 }
+                return true;
             }
             // Handle partial result
             else if (m_show_partial && result.contains("partial") && !result["partial"].is_null()) {
@@ -132,12 +137,13 @@ private:
         } catch (const std::exception& e) {
             // Error handling
         }
+        return false;
     }
 
     void handle_final_result(const std::string& text) {
         m_last_final_text = text;
         m_mock_server->queue_transcription(text, m_session_id, 1.0f);
-        m_last_finalize_time = std::chrono::steady_clock::now();
+        m_cap.restart(std::chrono::steady_clock::now());
     }
 
     void handle_partial_result(const std::string& partial) {
@@ -167,7 +173,7 @@ private:
         m_last_partial_text.clear();
 
         // Reset finalize timer
-        m_last_finalize_time = std::chrono::steady_clock::now();
+        m_cap.close(std::chrono::steady_clock::now());
     }
 
     // Member variables (same as audio_processor)
@@ -179,10 +185,9 @@ private:
     bool m_show_partial;
     int m_silence_frames_threshold;
     bool m_use_vad;
-    int m_finalize_interval_ms;
     int m_buffer_ms;
 
-    std::chrono::steady_clock::time_point m_last_finalize_time;
+    utterance_cap m_cap;
     std::chrono::steady_clock::time_point m_last_debug_time;
 
     // State tracking
@@ -359,6 +364,61 @@ TEST_F(AudioProcessorTest, PeriodicFinalizationDuringSpeech) {
     processor->process_audio(audio);
 }
 
+// Test that a model endpoint finalizes on its own and restarts the cap
+TEST_F(AudioProcessorTest, ModelEndpointRestartsUtteranceCap) {
+    EXPECT_CALL(*engine, has_partial_enabled()).WillOnce(Return(true));
+    EXPECT_CALL(*vad, process(_)).WillRepeatedly(Return(true));
+
+    processor = std::make_unique<testable_audio_processor>(
+        engine.get(), server.get(), vad.get(),
+        3, true, 100, 50  // 100ms cap
+        );
+
+    auto audio = create_audio_data(800);
+
+    EXPECT_CALL(*engine, process_audio(audio, false))
+        .WillOnce(Return(R"({"partial": "hello"})"))
+        .WillOnce(Return(R"({"text": "hello world"})"))
+        .WillOnce(Return(R"({"partial": "next"})"));
+
+    // The endpoint is delivered as is; nothing is forced
+    EXPECT_CALL(*engine, process_audio(std::vector<int16_t>{}, true)).Times(0);
+    EXPECT_CALL(*engine, reset()).Times(0);
+    EXPECT_CALL(*server, queue_transcription("hello world", "mic-capture", 1.0f))
+        .Times(1);
+
+    processor->process_audio(audio);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    processor->process_audio(audio);
+
+    // 120ms since the first chunk, but only 60ms into the new utterance
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    processor->process_audio(audio);
+}
+
+// Test that the cap only finalizes when there is text to finalize
+TEST_F(AudioProcessorTest, UtteranceCapSkipsEmptyUtterances) {
+    EXPECT_CALL(*engine, has_partial_enabled()).WillOnce(Return(true));
+    EXPECT_CALL(*vad, process(_)).WillRepeatedly(Return(true));
+
+    processor = std::make_unique<testable_audio_processor>(
+        engine.get(), server.get(), vad.get(),
+        3, true, 50, 50  // 50ms cap
+        );
+
+    auto audio = create_audio_data(800);
+
+    EXPECT_CALL(*engine, process_audio(audio, false))
+        .WillRepeatedly(Return("{}"));
+    EXPECT_CALL(*engine, process_audio(std::vector<int16_t>{}, true)).Times(0);
+    EXPECT_CALL(*engine, reset()).Times(0);
+    EXPECT_CALL(*server, queue_transcription(_, _, _)).Times(0);
+
+    processor->process_audio(audio);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    processor->process_audio(audio);
+}
+
 // Test no VAD mode
 TEST_F(AudioProcessorTest, NoVADMode) {
     EXPECT_CALL(*engine, has_partial_enabled()).WillOnce(Return(true));
@@ -0,0 +1,356 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "benchmark_manager.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct edit_counts {
+    int distance = 0;
+    int subs = 0;
+    int dels = 0;
+    int ins = 0;
+};
+
+// Full-matrix DP with backtrace, the straightforward definition
+template<typename T>
+edit_counts reference_distance(const std::vector<T>& ref, const std::vector<T>& hyp) {
+    const size_t m = ref.size(), n = hyp.size();
+    std::vector<std::vector<int>> dp(m + 1, std::vector<int>(n + 1, 0));
+    for (size_t i = 0; i <= m; ++i) dp[i][0] = static_cast<int>(i);
+    for (size_t j = 0; j <= n; ++j) dp[0][j] = static_cast<int>(j);
+
+    for (size_t i = 1; i <= m; ++i) {
+        for (size_t j = 1; j <= n; ++j) {
+            dp[i][j] = ref[i - 1] == hyp[j - 1]
+                           ? dp[i - 1][j - 1]
+                           : 1 + std::min({dp[i - 1][j], dp[i][j - 1], dp[i - 1][j - 1]});
+        }
+    }
+
+    edit_counts counts;
+    counts.distance = dp[m][n];
+    size_t i = m, j = n;
+    while (i > 0 || j > 0) {
+        if (i == 0) { counts.ins++; j--; }
+        else if (j == 0) { counts.dels++; i--; }
+        else if (ref[i - 1] == hyp[j - 1]) { i--; j--; }
+        else {
+            int min_val = std::min({dp[i - 1][j], dp[i][j - 1], dp[i - 1][j - 1]});
+            if (dp[i - 1][j - 1] == min_val) { counts.subs++; i--; j--; }
+            else if (dp[i - 1][j] == min_val) { counts.dels++; i--; }
+            else { counts.ins++; j--; }
+        }
+    }
+    return counts;
+}
+
+std::string join(const std::vector<std::string>& words) {
+    std::string out;
+    for (const auto& w : words) {
+        if (!out.empty()) out += ' ';
+        out += w;
+    }
+    return out;
+}
+
+// Copy of words with random substitutions, deletions and insertions
+std::vector<std::string> corrupt(const std::vector<std::string>& words,
+                                 const std::vector<std::string>& vocab,
+                                 double rate, std::mt19937& rng) {
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<size_t> pick(0, vocab.size() - 1);
+    std::vector<std::string> out;
+    for (const auto& w : words) {
+        double r = coin(rng);
+        if (r < rate / 3) {
+            out.push_back(vocab[pick(rng)]);
+        } else if (r < 2 * rate / 3) {
+            continue;
+        } else if (r < rate) {
+            out.push_back(w);
+            out.push_back(vocab[pick(rng)]);
+        } else {
+            out.push_back(w);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(BenchmarkManagerTest, WerOfIdenticalAndEmptyText) {
+    EXPECT_DOUBLE_EQ(benchmark_manager::calculate_wer("hello world", "hello world"), 0.0);
+    EXPECT_DOUBLE_EQ(benchmark_manager::calculate_wer("", ""), 0.0);
+    EXPECT_DOUBLE_EQ(benchmark_manager::calculate_wer("", "noise"), 100.0);
+
+    int subs = -1, dels = -1, ins = -1;
+    EXPECT_DOUBLE_EQ(benchmark_manager::calculate_wer("one two three", "", &subs, &dels, &ins), 100.0);
+    EXPECT_EQ(subs, 0);
+    EXPECT_EQ(dels, 3);
+    EXPECT_EQ(ins, 0);
+}
+
+TEST(BenchmarkManagerTest, WerBreakdown) {
+    int subs = 0, dels = 0, ins = 0;
+    double wer = benchmark_manager::calculate_wer("the cat sat on the mat",
+                                                  "the bat sat on mat today",
+                                                  &subs, &dels, &ins);
+    EXPECT_EQ(subs + dels + ins, 3);
+    EXPECT_DOUBLE_EQ(wer, 50.0);
+
+    benchmark_manager::calculate_wer("one two three", "one three four", &subs, &dels, &ins);
+    EXPECT_EQ(subs + dels + ins, 2);
+    EXPECT_EQ(dels, ins);
+}
+
+TEST(BenchmarkManagerTest, WerIgnoresCaseAndPunctuation) {
+    EXPECT_DOUBLE_EQ(benchmark_manager::calculate_wer("Hello, World!", "hello world"), 0.0);
+}
+
+TEST(BenchmarkManagerTest, WerMatchesFullMatrix) {
+    std::mt19937 rng(7);
+    std::vector<std::string> vocab = {"a", "the", "cat", "dog", "sat", "on", "mat", "ran", "far", "away"};
+    std::uniform_int_distribution<size_t> pick(0, vocab.size() - 1);
+
+    // Low error rates stay in the first band, high ones force it to grow
+    for (double rate : {0.0, 0.05, 0.3, 0.9}) {
+        for (size_t len : {1u, 10u, 200u, 1500u}) {
+            std::vector<std::string> ref(len);
+            for (auto& w : ref) w = vocab[pick(rng)];
+            auto hyp = corrupt(ref, vocab, rate, rng);
+
+            auto expected = reference_distance(ref, hyp);
+            int subs = 0, dels = 0, ins = 0;
+            double wer = benchmark_manager::calculate_wer(join(ref), join(hyp), &subs, &dels, &ins);
+
+            EXPECT_NEAR(wer, expected.distance * 100.0 / len, 1e-9) << "rate=" << rate << " len=" << len;
+            EXPECT_EQ(subs, expected.subs) << "rate=" << rate << " len=" << len;
+            EXPECT_EQ(dels, expected.dels) << "rate=" << rate << " len=" << len;
+            EXPECT_EQ(ins, expected.ins) << "rate=" << rate << " len=" << len;
+        }
+    }
+}
+
+TEST(BenchmarkManagerTest, CerIgnoresSpaces) {
+    EXPECT_DOUBLE_EQ(benchmark_manager::calculate_cer("ab cd", "abcd"), 0.0);
+    EXPECT_DOUBLE_EQ(benchmark_manager::calculate_cer("abcd", "abxd"), 25.0);
+    EXPECT_DOUBLE_EQ(benchmark_manager::calculate_cer("abcd", ""), 100.0);
+    EXPECT_DOUBLE_EQ(benchmark_manager::calculate_cer("", ""), 0.0);
+}
+
+TEST(BenchmarkManagerTest, CerMatchesFullMatrix) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> letter('a', 'f');
+    std::uniform_int_distribution<size_t> length(0, 300);
+
+    // Lengths around the 64-character block size exercise the block carries
+    std::vector<size_t> lengths = {1, 63, 64, 65, 127, 128, 129, 500};
+    for (int i = 0; i < 20; ++i) {
+        lengths.push_back(length(rng));
+    }
+
+    for (size_t ref_len : lengths) {
+        size_t hyp_len = length(rng);
+        std::string ref, hyp;
+        for (size_t k = 0; k < ref_len; ++k) ref.push_back(static_cast<char>(letter(rng)));
+        for (size_t k = 0; k < hyp_len; ++k) hyp.push_back(static_cast<char>(letter(rng)));
+
+        std::vector<char> ref_chars(ref.begin(), ref.end());
+        std::vector<char> hyp_chars(hyp.begin(), hyp.end());
+        auto expected = reference_distance(ref_chars, hyp_chars);
+
+        double expected_cer = ref_len ? expected.distance * 100.0 / ref_len : (hyp_len ? 100.0 : 0.0);
+        EXPECT_NEAR(benchmark_manager::calculate_cer(ref, hyp), expected_cer, 1e-9)
+            << "ref_len=" << ref_len << " hyp_len=" << hyp_len;
+    }
+}
+
+TEST(BenchmarkManagerTest, IncrementalResultsMatchFullRecomputation) {
+    benchmark_manager benchmark;
+    const std::string reference = "the quick brown fox jumps over the lazy dog and runs far away";
+    benchmark.set_reference_text(reference);
+    benchmark.start();
+
+    const std::vector<std::string> finals = {"the quick", "brown box jumps", "over lazy dog", "and runs very far away"};
+    std::string hypothesis;
+
+    for (const auto& text : finals) {
+        benchmark.add_transcription(text + " ...", "partial", 0.5);
+        benchmark.add_transcription(text, "final", 0.9, 1600, 10.0);
+        hypothesis += (hypothesis.empty() ? "" : " ") + text;
+
+        // Query after every segment; each query only extends the alignment
+        auto results = benchmark.get_current_results();
+        int subs = 0, dels = 0, ins = 0;
+        double wer = benchmark_manager::calculate_wer(reference, hypothesis, &subs, &dels, &ins);
+
+        EXPECT_EQ(results.hypothesis_text, hypothesis);
+        EXPECT_DOUBLE_EQ(results.word_error_rate, wer);
+        EXPECT_EQ(results.word_substitutions, subs);
+        EXPECT_EQ(results.word_deletions, dels);
+        EXPECT_EQ(results.word_insertions, ins);
+        EXPECT_DOUBLE_EQ(results.character_error_rate, benchmark_manager::calculate_cer(reference, hypothesis));
+    }
+
+    auto results = benchmark.stop();
+    EXPECT_EQ(results.total_segments, 8u);
+    EXPECT_EQ(results.final_segments, 4);
+    EXPECT_EQ(results.partial_segments, 4);
+    EXPECT_EQ(results.total_words, 13);
+    EXPECT_NEAR(results.average_confidence, 0.7, 1e-9);
+    EXPECT_DOUBLE_EQ(results.min_confidence, 0.5);
+    EXPECT_DOUBLE_EQ(results.max_confidence, 0.9);
+    EXPECT_EQ(results.total_samples_processed, 4u * 1600);
+    EXPECT_GT(results.real_time_factor, 0.0);
+}
+
+TEST(BenchmarkManagerTest, ReferenceSetAfterTranscriptions) {
+    benchmark_manager benchmark;
+    benchmark.start();
+    benchmark.add_transcription("hello there world", "final");
+
+    benchmark.set_reference_text("hello world");
+    auto results = benchmark.get_current_results();
+
+    EXPECT_DOUBLE_EQ(results.word_error_rate, 50.0);
+    EXPECT_EQ(results.word_insertions, 1);
+}
+
+TEST(BenchmarkManagerTest, SegmentHistoryIsFetchedIncrementally) {
+    benchmark_manager benchmark;
+    benchmark.start();
+    benchmark.add_transcription("one", "final");
+    benchmark.add_transcription("two", "final");
+
+    ASSERT_EQ(benchmark.get_segments().size(), 2u);
+
+    benchmark.add_transcription("three", "final");
+    auto fresh = benchmark.get_segments(2);
+    ASSERT_EQ(fresh.size(), 1u);
+    EXPECT_EQ(fresh[0].text, "three");
+    EXPECT_EQ(fresh[0].type, benchmark_manager::segment_type::final);
+    EXPECT_LE(fresh[0].start_offset, fresh[0].end_offset);
+    EXPECT_TRUE(benchmark.get_segments(5).empty());
+}
+
+TEST(BenchmarkManagerTest, LongTextsSpanArenaBlocks) {
+    benchmark_manager benchmark;
+    benchmark.start();
+
+    std::string long_text(100000, 'a');
+    benchmark.add_transcription("short", "partial");
+    benchmark.add_transcription(long_text, "final");
+    benchmark.add_transcription("after", "unknown");
+
+    auto segments = benchmark.get_segments();
+    ASSERT_EQ(segments.size(), 3u);
+    EXPECT_EQ(segments[0].text, "short");
+    EXPECT_EQ(segments[0].type, benchmark_manager::segment_type::partial);
+    EXPECT_EQ(segments[1].text, long_text);
+    EXPECT_EQ(segments[2].text, "after");
+    EXPECT_EQ(segments[2].type, benchmark_manager::segment_type::partial);
+
+    auto results = benchmark.get_current_results(false);
+    EXPECT_EQ(results.partial_segments, 1);
+    EXPECT_EQ(results.final_segments, 1);
+    EXPECT_EQ(results.total_segments, 3u);
+}
+
+TEST(BenchmarkManagerTest, StreamsSegmentsWithBoundedMemory) {
+    auto path = std::filesystem::temp_directory_path() / ("segments_" + std::to_string(getpid()) + ".jsonl");
+
+    benchmark_manager benchmark;
+    benchmark.stream_segments(path.string(), "jsonl", 4);
+    benchmark.start();
+    for (int i = 0; i < 10; ++i) {
+        benchmark.add_transcription("word " + std::to_string(i), i % 2 ? "final" : "partial", 0.5);
+    }
+    benchmark.add_vad_decision(true, 3);
+
+    // Handed to the writer in batches, the latest segment held back
+    EXPECT_LE(benchmark.get_streamed_segments(), 6u);
+    auto buffered = benchmark.get_segments();
+    ASSERT_EQ(buffered.size(), 4u);
+    EXPECT_EQ(buffered[0].text, "word 6");
+    EXPECT_EQ(buffered[3].text, "word 9");
+    EXPECT_EQ(benchmark.get_segments(9).size(), 1u);
+
+    auto results = benchmark.stop();
+    EXPECT_EQ(results.total_segments, 10u);
+    EXPECT_EQ(benchmark.get_streamed_segments(), 10u);
+
+    std::ifstream file(path);
+    std::string line;
+    std::vector<nlohmann::json> rows;
+    while (std::getline(file, line)) {
+        rows.push_back(nlohmann::json::parse(line));
+    }
+    ASSERT_EQ(rows.size(), 10u);
+    EXPECT_EQ(rows[0]["index"], 0);
+    EXPECT_EQ(rows[0]["type"], "partial");
+    EXPECT_EQ(rows[3]["text"], "word 3");
+    EXPECT_EQ(rows[9]["type"], "final");
+    EXPECT_EQ(rows[9]["vad_detected"], true);
+    EXPECT_EQ(rows[9]["silence_frames_before"], 3);
+
+    std::filesystem::remove(path);
+}
+
+TEST(BenchmarkManagerTest, StreamsCsvAndRejectsUnknownFormats) {
+    auto path = std::filesystem::temp_directory_path() / ("segments_" + std::to_string(getpid()) + ".csv");
+
+    benchmark_manager benchmark;
+    EXPECT_THROW(benchmark.stream_segments(path.string(), "xml"), std::invalid_argument);
+    EXPECT_THROW(benchmark.stream_segments("/nonexistent/dir/segments.csv", "csv"), std::runtime_error);
+
+    benchmark.stream_segments(path.string(), "csv");
+    benchmark.start();
+    benchmark.add_transcription("hello world", "final");
+    benchmark.stop();
+
+    std::ifstream file(path);
+    std::string header, row;
+    std::getline(file, header);
+    std::getline(file, row);
+    EXPECT_EQ(header.rfind("index,type,", 0), 0u);
+    EXPECT_EQ(row.rfind("0,final,", 0), 0u);
+    EXPECT_NE(row.find(",\"hello world\""), std::string::npos);
+
+    std::filesystem::remove(path);
+}
+
+TEST(BenchmarkManagerTest, VadMetricsAccumulate) {
+    benchmark_manager benchmark;
+    benchmark.set_vad_ground_truth({true, true, false, false});
+    benchmark.start();
+
+    benchmark.add_vad_decision(true);
+    benchmark.add_vad_decision(false);
+    benchmark.add_vad_decision(true);
+    benchmark.add_vad_decision(false);
+    benchmark.add_vad_decision(true); // Beyond the ground truth, not scored
+
+    auto results = benchmark.get_current_results();
+    EXPECT_DOUBLE_EQ(results.vad_accuracy, 50.0);
+    EXPECT_EQ(results.vad_false_positives, 1);
+    EXPECT_EQ(results.vad_false_negatives, 1);
+}
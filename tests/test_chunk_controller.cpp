@@ -0,0 +1,119 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "chunk_controller.h"
+
+class ChunkControllerTest : public ::testing::Test {
+protected:
+    // One full window of identical observations
+    static bool window(chunk_controller& controller, double latency_ms, bool loaded = false, bool backlog = false) {
+        bool changed = false;
+        for (size_t i = 0; i < chunk_controller::config{}.window; ++i) {
+            changed = controller.observe(latency_ms, loaded, backlog);
+        }
+        return changed;
+    }
+};
+
+TEST_F(ChunkControllerTest, RejectsInconsistentBounds) {
+    chunk_controller::config cfg;
+    cfg.min_ms = 200;
+    EXPECT_THROW(chunk_controller{cfg}, std::invalid_argument);
+
+    cfg = {};
+    cfg.max_ms = 50;
+    EXPECT_THROW(chunk_controller{cfg}, std::invalid_argument);
+}
+
+TEST_F(ChunkControllerTest, StaysAtDefaultWithoutPressure) {
+    chunk_controller controller;
+    EXPECT_EQ(controller.chunk_ms(), 100);
+    EXPECT_FALSE(window(controller, 40.0));
+    EXPECT_EQ(controller.chunk_ms(), 100);
+}
+
+TEST_F(ChunkControllerTest, DecidesOncePerWindow) {
+    chunk_controller controller;
+    controller.set_target_ms(100);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_FALSE(controller.observe(500.0, false, false));
+    }
+    EXPECT_EQ(controller.chunk_ms(), 100);
+    EXPECT_TRUE(controller.observe(10.0, false, false));
+    EXPECT_EQ(controller.chunk_ms(), 50);
+}
+
+TEST_F(ChunkControllerTest, ShrinksOverTargetDownToMinimum) {
+    chunk_controller controller;
+    controller.set_target_ms(150);
+    window(controller, 400.0);
+    EXPECT_EQ(controller.chunk_ms(), 50);
+    window(controller, 400.0);
+    window(controller, 400.0);
+    EXPECT_EQ(controller.chunk_ms(), 20);
+
+    // The target wins over load
+    window(controller, 400.0, true, true);
+    EXPECT_EQ(controller.chunk_ms(), 20);
+}
+
+TEST_F(ChunkControllerTest, GrowsBackOnlyWellUnderTarget) {
+    chunk_controller controller;
+    controller.set_target_ms(200);
+    window(controller, 300.0);
+    EXPECT_EQ(controller.chunk_ms(), 50);
+
+    // Under target, but not by half: hold
+    window(controller, 150.0);
+    EXPECT_EQ(controller.chunk_ms(), 50);
+
+    window(controller, 60.0);
+    EXPECT_EQ(controller.chunk_ms(), 100);
+    window(controller, 60.0);
+    EXPECT_EQ(controller.chunk_ms(), 100);
+}
+
+TEST_F(ChunkControllerTest, GrowsUnderLoadOrBacklog) {
+    chunk_controller controller;
+    window(controller, 40.0, true, false);
+    EXPECT_EQ(controller.chunk_ms(), 150);
+    window(controller, 40.0, false, true);
+    EXPECT_EQ(controller.chunk_ms(), 200);
+
+    for (int i = 0; i < 50; ++i) {
+        window(controller, 40.0, true, true);
+    }
+    EXPECT_EQ(controller.chunk_ms(), 1000);
+
+    // Pressure gone: step back to the default
+    window(controller, 40.0);
+    EXPECT_EQ(controller.chunk_ms(), 950);
+    for (int i = 0; i < 50; ++i) {
+        window(controller, 40.0);
+    }
+    EXPECT_EQ(controller.chunk_ms(), 100);
+}
+
+TEST_F(ChunkControllerTest, ClearedTargetStopsShrinking) {
+    chunk_controller controller;
+    controller.set_target_ms(100);
+    window(controller, 300.0);
+    EXPECT_EQ(controller.chunk_ms(), 50);
+
+    controller.set_target_ms(0);
+    EXPECT_EQ(controller.get_target_ms(), 0);
+    window(controller, 300.0);
+    EXPECT_EQ(controller.chunk_ms(), 100);
+
+    controller.set_target_ms(-5);
+    EXPECT_EQ(controller.get_target_ms(), 0);
+}
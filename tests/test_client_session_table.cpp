@@ -0,0 +1,64 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "client_session_table.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+
+int client_a;
+int client_b;
+
+} // namespace
+
+TEST(ClientSessionTableTest, OwnerKeepsItsSession) {
+    client_session_table table;
+
+    EXPECT_TRUE(table.claim(&client_a, "s1"));
+    EXPECT_TRUE(table.claim(&client_a, "s1"));
+    EXPECT_FALSE(table.claim(&client_b, "s1"));
+    EXPECT_TRUE(table.claim(&client_b, "s2"));
+
+    EXPECT_EQ(table.session_of(&client_a), "s1");
+    EXPECT_EQ(table.session_of(&client_b), "s2");
+    EXPECT_TRUE(table.session_of(nullptr).empty());
+    EXPECT_TRUE(table.has_owner("s1"));
+}
+
+TEST(ClientSessionTableTest, SwitchingSessionsReleasesThePrevious) {
+    client_session_table table;
+
+    ASSERT_TRUE(table.claim(&client_a, "s1"));
+    ASSERT_TRUE(table.claim(&client_a, "s2"));
+    EXPECT_FALSE(table.has_owner("s1"));
+    EXPECT_TRUE(table.claim(&client_b, "s1"));
+    EXPECT_EQ(table.size(), 2u);
+}
+
+TEST(ClientSessionTableTest, IdleAndReleasedClaimsAreDropped) {
+    client_session_table table;
+
+    ASSERT_TRUE(table.claim(&client_a, "s1"));
+    ASSERT_TRUE(table.claim(&client_b, "s2"));
+    table.release_session("s2");
+    EXPECT_FALSE(table.has_owner("s2"));
+    EXPECT_TRUE(table.session_of(&client_b).empty());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(table.evict_idle(std::chrono::milliseconds(10)), 1u);
+    EXPECT_EQ(table.size(), 0u);
+
+    // A new connection at a reused address starts without a session
+    EXPECT_TRUE(table.session_of(&client_a).empty());
+    EXPECT_TRUE(table.claim(&client_b, "s1"));
+}
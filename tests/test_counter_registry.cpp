@@ -0,0 +1,73 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "counter_registry.h"
+#include <thread>
+#include <vector>
+
+using counter = counter_registry::counter;
+
+TEST(CounterRegistryTest, StartsAtZero) {
+    counter_registry counters;
+    auto s = counters.snapshot();
+    for (size_t i = 0; i < counter_registry::counter_count; ++i) {
+        EXPECT_EQ(s.values[i], 0u);
+    }
+}
+
+TEST(CounterRegistryTest, SumsAcrossThreads) {
+    counter_registry counters;
+    constexpr int threads = 40;     // More than the shards, so some share one
+    constexpr int adds = 10000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&counters] {
+            for (int i = 0; i < adds; ++i) {
+                counters.add(counter::messages_processed);
+                counters.add(counter::samples_routed, 160);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    auto s = counters.snapshot();
+    EXPECT_EQ(s[counter::messages_processed], uint64_t{threads} * adds);
+    EXPECT_EQ(s[counter::samples_routed], uint64_t{threads} * adds * 160);
+    EXPECT_EQ(s[counter::opus_errors], 0u);
+    EXPECT_EQ(counters.get(counter::messages_processed), uint64_t{threads} * adds);
+}
+
+TEST(CounterRegistryTest, ShardsDoNotShareCacheLines) {
+    EXPECT_GE(alignof(counter_registry), 64u);
+    EXPECT_EQ(sizeof(counter_registry) % 64, 0u);
+}
+
+TEST(CounterRegistryTest, Serializes) {
+    counter_registry counters;
+    counters.add(counter::opus_packets, 3);
+    counters.add(counter::drained_sessions);
+
+    auto s = counters.snapshot();
+    auto json = counter_registry::to_json(s);
+    EXPECT_EQ(json.size(), counter_registry::counter_count);
+    EXPECT_EQ(json["opus_packets"], 3);
+    EXPECT_EQ(json["drained_sessions"], 1);
+    EXPECT_EQ(json["messages_processed"], 0);
+
+    auto text = counter_registry::to_prometheus(s);
+    EXPECT_NE(text.find("# TYPE vstream_opus_packets_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("\nvstream_opus_packets_total 3\n"), std::string::npos);
+    EXPECT_NE(text.find("\nvstream_messages_processed_total 0\n"), std::string::npos);
+}
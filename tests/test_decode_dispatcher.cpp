@@ -0,0 +1,468 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "decode_dispatcher.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <thread>
+#include <chrono>
+
+class DecodeDispatcherTest : public ::testing::Test {
+protected:
+    std::mutex m_mutex;
+    std::map<std::string, std::vector<int16_t>> m_seen;     ///< First sample of each job, per session
+    std::atomic<size_t> m_processed{0};
+    std::atomic<int> m_concurrent{0};
+    std::atomic<bool> m_overlap{false};
+
+    decode_dispatcher::job_handler_t make_handler() {
+        return [this](decode_dispatcher::audio_job& job) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_seen[job.session_id].push_back(job.samples.front());
+            }
+            m_processed++;
+        };
+    }
+
+    bool wait_for(size_t count, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (m_processed.load() < count) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+};
+
+TEST_F(DecodeDispatcherTest, SubmitRequiresStart) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 2;
+    decode_dispatcher dispatcher(cfg, make_handler());
+
+    EXPECT_EQ(dispatcher.get_thread_count(), 2u);
+    EXPECT_FALSE(dispatcher.is_running());
+    EXPECT_FALSE(dispatcher.submit("s", {1}));
+
+    dispatcher.start();
+    EXPECT_TRUE(dispatcher.is_running());
+    EXPECT_TRUE(dispatcher.submit("s", {1}));
+    EXPECT_TRUE(wait_for(1));
+
+    dispatcher.stop();
+    EXPECT_FALSE(dispatcher.is_running());
+    EXPECT_FALSE(dispatcher.submit("s", {1}));
+}
+
+TEST_F(DecodeDispatcherTest, PreservesPerSessionOrder) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 4;
+    cfg.max_batch = 2;
+    decode_dispatcher dispatcher(cfg, make_handler());
+    dispatcher.start();
+
+    const int sessions = 6;
+    const int16_t frames = 200;
+
+    // One submitting thread per session, like one WebSocket connection each
+    std::vector<std::thread> producers;
+    for (int s = 0; s < sessions; ++s) {
+        producers.emplace_back([&dispatcher, s] {
+            for (int16_t i = 0; i < frames; ++i) {
+                dispatcher.submit("session-" + std::to_string(s), {i});
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+
+    ASSERT_TRUE(wait_for(sessions * frames));
+    EXPECT_EQ(dispatcher.get_queue_depth(), 0u);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ASSERT_EQ(m_seen.size(), static_cast<size_t>(sessions));
+    for (const auto& [id, order] : m_seen) {
+        ASSERT_EQ(order.size(), static_cast<size_t>(frames)) << id;
+        for (int16_t i = 0; i < frames; ++i) {
+            EXPECT_EQ(order[i], i) << id;
+        }
+    }
+}
+
+TEST_F(DecodeDispatcherTest, SessionNeverDecodedConcurrently) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 4;
+    cfg.max_batch = 1;
+
+    decode_dispatcher dispatcher(cfg, [this](decode_dispatcher::audio_job&) {
+        if (m_concurrent.fetch_add(1) != 0) {
+            m_overlap = true;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        m_concurrent.fetch_sub(1);
+        m_processed++;
+    });
+    dispatcher.start();
+
+    for (int16_t i = 0; i < 100; ++i) {
+        dispatcher.submit("single", {i});
+    }
+
+    ASSERT_TRUE(wait_for(100));
+    EXPECT_FALSE(m_overlap.load());
+}
+
+TEST_F(DecodeDispatcherTest, HandlerExceptionDoesNotStopWorker) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 1;
+
+    decode_dispatcher dispatcher(cfg, [this](decode_dispatcher::audio_job& job) {
+        m_processed++;
+        if (job.samples.front() == 0) {
+            throw std::runtime_error("decode failed");
+        }
+    });
+    dispatcher.start();
+
+    dispatcher.submit("s", {0});
+    dispatcher.submit("s", {1});
+
+    EXPECT_TRUE(wait_for(2));
+}
+
+TEST_F(DecodeDispatcherTest, EvictIdleSessions) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 2;
+    decode_dispatcher dispatcher(cfg, make_handler());
+    dispatcher.start();
+
+    dispatcher.submit("a", {1});
+    dispatcher.submit("b", {1});
+    ASSERT_TRUE(wait_for(2));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(dispatcher.evict_idle_sessions(std::chrono::milliseconds(10)), 2u);
+    EXPECT_EQ(dispatcher.evict_idle_sessions(std::chrono::milliseconds(10)), 0u);
+
+    // Evicted sessions are recreated transparently
+    EXPECT_TRUE(dispatcher.submit("a", {2}));
+    EXPECT_TRUE(wait_for(3));
+}
+
+TEST_F(DecodeDispatcherTest, TakeIdleSessionsReturnsIds) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 2;
+    decode_dispatcher dispatcher(cfg, make_handler());
+    dispatcher.start();
+
+    dispatcher.submit("a", {1});
+    dispatcher.submit("b", {1});
+    ASSERT_TRUE(wait_for(2));
+    EXPECT_EQ(dispatcher.get_session_count(), 2u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(dispatcher.take_idle_sessions(std::chrono::seconds(10)).empty());
+
+    auto ids = dispatcher.take_idle_sessions(std::chrono::milliseconds(0));
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(ids, (std::vector<std::string>{"a", "b"}));
+    EXPECT_EQ(dispatcher.get_session_count(), 0u);
+}
+
+TEST_F(DecodeDispatcherTest, SessionQueueLimitDropsFrames) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 1;
+    cfg.max_session_frames = 3;
+
+    std::atomic<bool> release{false};
+    decode_dispatcher dispatcher(cfg, [&](decode_dispatcher::audio_job&) {
+        m_concurrent = 1;
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        m_processed++;
+    });
+    dispatcher.start();
+
+    // The frame being decoded still counts against the session
+    EXPECT_TRUE(dispatcher.submit("slow", {0}));
+    while (m_concurrent.load() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(dispatcher.submit("slow", {1}));
+    EXPECT_TRUE(dispatcher.submit("slow", {2}));
+    EXPECT_FALSE(dispatcher.submit("slow", {3}));
+    EXPECT_EQ(dispatcher.get_dropped_count(), 1u);
+
+    // Other sessions have their own budget
+    EXPECT_TRUE(dispatcher.submit("other", {0}));
+
+    release = true;
+    EXPECT_TRUE(wait_for(4));
+}
+
+TEST_F(DecodeDispatcherTest, QueueDepthNeverWrapsWhileDecoding) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 2;
+    cfg.max_session_frames = 1000000;
+    std::atomic<size_t> max_depth{0};
+    std::atomic<size_t> max_backlog{0};
+    decode_dispatcher* self = nullptr;
+
+    decode_dispatcher dispatcher(cfg, [&](decode_dispatcher::audio_job& job) {
+        size_t depth = self->get_queue_depth();
+        size_t seen = max_depth.load();
+        while (depth > seen && !max_depth.compare_exchange_weak(seen, depth)) {
+        }
+        seen = max_backlog.load();
+        while (job.backlog > seen && !max_backlog.compare_exchange_weak(seen, job.backlog)) {
+        }
+        m_processed++;
+    });
+    self = &dispatcher;
+    dispatcher.start();
+
+    // Frames land while a worker is draining the same session
+    constexpr size_t frames = 20000;
+    for (size_t i = 0; i < frames; ++i) {
+        ASSERT_TRUE(dispatcher.submit("s", {1}));
+    }
+    ASSERT_TRUE(wait_for(1));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (dispatcher.get_queue_depth() > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(dispatcher.get_queue_depth(), 0u);
+    EXPECT_LE(max_depth.load(), frames);
+    EXPECT_LE(max_backlog.load(), frames);
+    EXPECT_EQ(dispatcher.get_dropped_count(), 0u);
+}
+
+TEST_F(DecodeDispatcherTest, RefusesNewSessionsWhenNotAccepting) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 2;
+    decode_dispatcher dispatcher(cfg, make_handler());
+    dispatcher.start();
+
+    EXPECT_TRUE(dispatcher.submit("known", {1}));
+    EXPECT_TRUE(dispatcher.has_session("known"));
+
+    dispatcher.set_accepting_sessions(false);
+    EXPECT_FALSE(dispatcher.is_accepting_sessions());
+    EXPECT_TRUE(dispatcher.submit("known", {2}));
+    EXPECT_FALSE(dispatcher.submit("new", {1}));
+    EXPECT_FALSE(dispatcher.has_session("new"));
+    EXPECT_EQ(dispatcher.get_rejected_count(), 1u);
+
+    dispatcher.set_accepting_sessions(true);
+    EXPECT_TRUE(dispatcher.submit("new", {1}));
+    EXPECT_TRUE(wait_for(3));
+}
+
+TEST_F(DecodeDispatcherTest, CoalescesQueuedFrames) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 1;
+
+    std::atomic<bool> release{false};
+    std::vector<size_t> sizes;
+    std::vector<int16_t> decoded;
+    decode_dispatcher dispatcher(cfg, [&](decode_dispatcher::audio_job& job) {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sizes.push_back(job.samples.size());
+            decoded.insert(decoded.end(), job.samples.begin(), job.samples.end());
+        }
+        m_processed++;
+    });
+    dispatcher.set_coalesce(3);
+    EXPECT_EQ(dispatcher.get_coalesce(), 3u);
+    dispatcher.start();
+
+    // Queue 7 frames while the worker is held on the first call
+    for (int16_t i = 0; i < 7; ++i) {
+        dispatcher.submit("s", {i, i});
+    }
+    release = true;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (dispatcher.get_queue_depth() > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t total = 0;
+    for (size_t size : sizes) {
+        EXPECT_LE(size, 6u);
+        total += size;
+    }
+    EXPECT_EQ(total, 14u);
+    EXPECT_LT(sizes.size(), 7u);
+
+    // Merged jobs carry every frame, in submission order
+    EXPECT_EQ(decoded, (std::vector<int16_t>{0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6}));
+}
+
+TEST_F(DecodeDispatcherTest, SessionChunkCoalescesByAudioLength) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 1;
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    std::vector<std::pair<std::string, size_t>> calls;
+    std::vector<size_t> backlogs;
+    decode_dispatcher dispatcher(cfg, [&](decode_dispatcher::audio_job& job) {
+        entered = true;
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            calls.emplace_back(job.session_id, job.samples.size());
+            backlogs.push_back(job.backlog);
+        }
+        m_processed++;
+    });
+    dispatcher.start();
+
+    // Hold the worker on the first frame so the rest queue up
+    dispatcher.submit("s", {0, 0});
+    while (!entered.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    dispatcher.set_session_chunk("s", 5);
+    dispatcher.set_session_chunk("unknown", 5);
+    for (int16_t i = 1; i < 7; ++i) {
+        dispatcher.submit("s", {i, i});
+    }
+    release = true;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (m_processed.load() < 3 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // The held first frame, then 6 queued samples per call until the queue runs out
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ASSERT_EQ(calls.size(), 3u);
+    EXPECT_EQ(calls[0].second, 2u);
+    EXPECT_EQ(calls[1].second, 6u);
+    EXPECT_EQ(calls[2].second, 6u);
+    EXPECT_EQ(backlogs[1], 3u);
+    EXPECT_EQ(backlogs[2], 0u);
+}
+
+TEST_F(DecodeDispatcherTest, SessionChunkCountsDecodedAudio) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 1;
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    std::vector<size_t> calls;
+    decode_dispatcher dispatcher(cfg, [&](decode_dispatcher::audio_job& job) {
+        entered = true;
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            calls.push_back(job.samples.size());
+        }
+        // Like an Opus session: every queued unit decodes to 4 samples
+        job.decoded_samples = job.samples.size() * 4;
+        m_processed++;
+    });
+    dispatcher.start();
+
+    dispatcher.submit("s", {0, 0});
+    while (!entered.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    dispatcher.set_session_chunk("s", 16);
+    for (int16_t i = 1; i < 7; ++i) {
+        dispatcher.submit("s", {i, i});
+    }
+    release = true;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (m_processed.load() < 4 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 16 decoded samples are 4 queued units, not 16
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ASSERT_EQ(calls.size(), 4u);
+    EXPECT_EQ(calls[0], 2u);
+    EXPECT_EQ(calls[1], 4u);
+    EXPECT_EQ(calls[2], 4u);
+    EXPECT_EQ(calls[3], 4u);
+}
+
+TEST_F(DecodeDispatcherTest, TracksBusyTimeAndQueueWait) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 1;
+    decode_dispatcher dispatcher(cfg, [this](decode_dispatcher::audio_job&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        m_processed++;
+    });
+    dispatcher.start();
+
+    for (int16_t i = 0; i < 4; ++i) {
+        dispatcher.submit("s", {i});
+    }
+    ASSERT_TRUE(wait_for(4));
+
+    // The last frame waited behind three 5ms decodes
+    EXPECT_GE(dispatcher.get_busy_ns(), 15'000'000u);
+    EXPECT_GE(dispatcher.take_max_queue_wait(), std::chrono::milliseconds(10));
+    EXPECT_EQ(dispatcher.take_max_queue_wait(), std::chrono::nanoseconds(0));
+}
+
+TEST_F(DecodeDispatcherTest, WorkerDomainsKeepSessionsInTheirDomain) {
+    decode_dispatcher::config cfg;
+    cfg.num_threads = 2;
+    cfg.worker_domains = {0, 1};
+
+    std::mutex mutex;
+    std::map<size_t, std::set<std::thread::id>> threads;   ///< Domain -> threads that decoded it
+    decode_dispatcher* self = nullptr;
+    decode_dispatcher dispatcher(cfg, [&](decode_dispatcher::audio_job& job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads[self->session_domain(job.session_id)].insert(std::this_thread::get_id());
+        m_processed++;
+    });
+    self = &dispatcher;
+    EXPECT_EQ(dispatcher.get_domain_count(), 2u);
+    dispatcher.start();
+
+    // Stealing is tempting: many sessions, the idle worker must still leave the other domain alone
+    for (int frame = 0; frame < 20; ++frame) {
+        for (int s = 0; s < 16; ++s) {
+            ASSERT_TRUE(dispatcher.submit("s" + std::to_string(s), {1}));
+        }
+    }
+    ASSERT_TRUE(wait_for(320));
+
+    ASSERT_EQ(threads.size(), 2u);
+    ASSERT_EQ(threads[0].size(), 1u);
+    ASSERT_EQ(threads[1].size(), 1u);
+    EXPECT_NE(*threads[0].begin(), *threads[1].begin());
+    EXPECT_EQ(dispatcher.get_steal_count(), 0u);
+    EXPECT_EQ(dispatcher.session_domain("s3"), dispatcher.session_domain("s3"));
+
+    cfg.worker_domains = {0};
+    EXPECT_THROW(decode_dispatcher(cfg, make_handler()), std::invalid_argument);
+    cfg.worker_domains = {0, 2};
+    EXPECT_THROW(decode_dispatcher(cfg, make_handler()), std::invalid_argument);
+}
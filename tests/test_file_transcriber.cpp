@@ -0,0 +1,187 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "file_transcriber.h"
+#include "audio_file.h"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <unistd.h>
+
+class FileTranscriberTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / ("test_files_" + std::to_string(getpid()));
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_dir);
+    }
+
+    static void put_u16(std::string& out, uint16_t v) { out.append(reinterpret_cast<const char*>(&v), 2); }
+    static void put_u32(std::string& out, uint32_t v) { out.append(reinterpret_cast<const char*>(&v), 4); }
+
+    // Build a WAV file; extra_chunk inserts a LIST chunk of that size before "data"
+    std::string write_wav(const std::string& name, const std::vector<int16_t>& samples,
+                          uint32_t rate = 16000, uint16_t channels = 1, uint16_t bits = 16,
+                          uint32_t extra_chunk = 0) {
+        std::string body = "WAVE";
+        body += "fmt ";
+        put_u32(body, 16);
+        put_u16(body, 1);
+        put_u16(body, channels);
+        put_u32(body, rate);
+        put_u32(body, rate * channels * bits / 8);
+        put_u16(body, static_cast<uint16_t>(channels * bits / 8));
+        put_u16(body, bits);
+
+        if (extra_chunk) {
+            body += "LIST";
+            put_u32(body, extra_chunk);
+            body.append(extra_chunk + (extra_chunk & 1), 'x');
+        }
+
+        body += "data";
+        put_u32(body, static_cast<uint32_t>(samples.size() * 2));
+        body.append(reinterpret_cast<const char*>(samples.data()), samples.size() * 2);
+
+        std::string file = "RIFF";
+        put_u32(file, static_cast<uint32_t>(body.size()));
+        file += body;
+
+        auto path = (m_dir / name).string();
+        std::ofstream(path, std::ios::binary) << file;
+        return path;
+    }
+
+    std::string write_raw(const std::string& name, const std::vector<int16_t>& samples) {
+        auto path = (m_dir / name).string();
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(samples.data()),
+                                                    static_cast<std::streamsize>(samples.size() * 2));
+        return path;
+    }
+
+    static std::vector<int16_t> tone(size_t samples, double amplitude = 8000.0) {
+        std::vector<int16_t> out(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            out[i] = static_cast<int16_t>(amplitude * std::sin(2.0 * M_PI * 220.0 * i / 16000.0));
+        }
+        return out;
+    }
+
+    std::filesystem::path m_dir;
+};
+
+TEST_F(FileTranscriberTest, MapsWavSamples) {
+    std::vector<int16_t> samples = {1, -2, 3, -4, 32767, -32768};
+    audio_file file(write_wav("a.wav", samples), 16000);
+
+    ASSERT_EQ(file.samples().size(), samples.size());
+    EXPECT_TRUE(std::equal(samples.begin(), samples.end(), file.samples().begin()));
+    EXPECT_EQ(file.sample_rate(), 16000);
+}
+
+TEST_F(FileTranscriberTest, SkipsUnknownChunks) {
+    std::vector<int16_t> samples = {10, 20, 30};
+
+    // Odd-sized chunk is padded; 7 + 1 keeps the data even
+    audio_file padded(write_wav("padded.wav", samples, 16000, 1, 16, 7), 16000);
+    ASSERT_EQ(padded.samples().size(), 3u);
+    EXPECT_EQ(padded.samples()[2], 30);
+}
+
+TEST_F(FileTranscriberTest, RejectsUnsupportedWav) {
+    std::vector<int16_t> samples(100, 0);
+
+    EXPECT_THROW(audio_file(write_wav("rate.wav", samples, 44100), 16000), std::invalid_argument);
+    EXPECT_THROW(audio_file(write_wav("stereo.wav", samples, 16000, 2), 16000), std::invalid_argument);
+    EXPECT_THROW(audio_file(write_wav("8bit.wav", samples, 16000, 1, 8), 16000), std::invalid_argument);
+    EXPECT_THROW(audio_file((m_dir / "missing.wav").string(), 16000), std::runtime_error);
+}
+
+TEST_F(FileTranscriberTest, MapsRawAndEmptyFiles) {
+    std::vector<int16_t> samples = tone(1600);
+    audio_file raw(write_raw("a.raw", samples), 16000);
+    ASSERT_EQ(raw.samples().size(), 1600u);
+    EXPECT_EQ(raw.samples()[100], samples[100]);
+    EXPECT_DOUBLE_EQ(raw.duration_ms(), 100.0);
+
+    audio_file empty(write_raw("empty.pcm", {}), 16000);
+    EXPECT_TRUE(empty.samples().empty());
+}
+
+TEST_F(FileTranscriberTest, CollectsSortedAudioFiles) {
+    write_raw("b.raw", {1});
+    write_raw("a.wav", {1});
+    write_raw("notes.txt", {1});
+    std::filesystem::create_directories(m_dir / "sub");
+    write_raw("sub/c.pcm", {1});
+
+    auto inputs = file_transcriber::collect_inputs(m_dir.string());
+    ASSERT_EQ(inputs.size(), 3u);
+    EXPECT_EQ(std::filesystem::path(inputs[0]).filename(), "a.wav");
+    EXPECT_EQ(std::filesystem::path(inputs[1]).filename(), "b.raw");
+    EXPECT_EQ(std::filesystem::path(inputs[2]).filename(), "c.pcm");
+
+    EXPECT_THROW(file_transcriber::collect_inputs((m_dir / "missing").string()), std::invalid_argument);
+    std::filesystem::create_directories(m_dir / "empty");
+    EXPECT_THROW(file_transcriber::collect_inputs((m_dir / "empty").string()), std::invalid_argument);
+}
+
+TEST_F(FileTranscriberTest, ShortAudioIsOneSegment) {
+    file_transcriber::config cfg;
+    auto starts = file_transcriber::split_at_silence(tone(16000 * 10), cfg);
+
+    ASSERT_EQ(starts.size(), 1u);
+    EXPECT_EQ(starts[0], 0u);
+}
+
+TEST_F(FileTranscriberTest, SplitsAtPauses) {
+    file_transcriber::config cfg;
+    cfg.target_segment_ms = 2000;
+    cfg.max_segment_ms = 4000;
+
+    // Speech with a 500ms pause starting at 2.5s of every 3s
+    std::vector<int16_t> audio;
+    for (int i = 0; i < 4; ++i) {
+        auto speech = tone(16000 * 5 / 2);
+        audio.insert(audio.end(), speech.begin(), speech.end());
+        audio.insert(audio.end(), 8000, 0);
+    }
+
+    auto starts = file_transcriber::split_at_silence(audio, cfg);
+    ASSERT_GE(starts.size(), 4u);
+    for (size_t i = 1; i < starts.size(); ++i) {
+        // Every cut lands inside a pause
+        size_t offset = starts[i] % 48000;
+        EXPECT_GE(offset, 40000u) << "cut " << i;
+        EXPECT_LT(starts[i] - starts[i - 1], 16000u * 4 + 1);
+    }
+}
+
+TEST_F(FileTranscriberTest, CutsContinuousSpeechAtMaximum) {
+    file_transcriber::config cfg;
+    cfg.target_segment_ms = 1000;
+    cfg.max_segment_ms = 2000;
+
+    // Without pauses every cut falls between target and maximum
+    auto starts = file_transcriber::split_at_silence(tone(16000 * 7), cfg);
+    ASSERT_GE(starts.size(), 4u);
+    ASSERT_LE(starts.size(), 7u);
+    for (size_t i = 1; i < starts.size(); ++i) {
+        EXPECT_GE(starts[i] - starts[i - 1], 16000u);
+        EXPECT_LE(starts[i] - starts[i - 1], 32000u);
+    }
+}
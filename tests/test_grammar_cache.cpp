@@ -0,0 +1,111 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "grammar_cache.h"
+#include <set>
+#include <vector>
+
+namespace {
+
+// Stand-ins for Vosk recognizers; the cache never dereferences them
+std::vector<VoskRecognizer*> g_freed;
+
+void record_free(VoskRecognizer* recognizer) {
+    g_freed.push_back(recognizer);
+}
+
+VoskRecognizer* fake(uintptr_t id) {
+    return reinterpret_cast<VoskRecognizer*>(id * 16);
+}
+
+} // namespace
+
+class GrammarCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override { g_freed.clear(); }
+};
+
+TEST_F(GrammarCacheTest, NormalizesEquivalentGrammars) {
+    EXPECT_EQ(grammar_cache::normalize("[\"yes\", \"no\"]"), grammar_cache::normalize("[ \"yes\",\"no\" ]"));
+    EXPECT_NE(grammar_cache::normalize("[\"yes\", \"no\"]"), grammar_cache::normalize("[\"no\", \"yes\"]"));
+    EXPECT_EQ(grammar_cache::normalize(""), "");
+    EXPECT_EQ(grammar_cache::normalize("not json ["), "not json [");
+}
+
+TEST_F(GrammarCacheTest, ReleasedRecognizerIsReused) {
+    grammar_cache cache(4, record_free);
+    const std::string menu = grammar_cache::normalize("[\"billing\", \"support\"]");
+
+    EXPECT_EQ(cache.acquire(menu, 0), nullptr);
+    EXPECT_EQ(cache.get_miss_count(), 1u);
+
+    cache.release(menu, 0, fake(1));
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.acquire(menu, 0), fake(1));
+    EXPECT_EQ(cache.get_hit_count(), 1u);
+
+    // Owned by the caller again
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.acquire(menu, 0), nullptr);
+    EXPECT_TRUE(g_freed.empty());
+}
+
+TEST_F(GrammarCacheTest, KeyAndGenerationMustMatch) {
+    grammar_cache cache(4, record_free);
+    cache.release("[\"a\"]", 1, fake(1));
+
+    EXPECT_EQ(cache.acquire("[\"b\"]", 1), nullptr);
+    EXPECT_EQ(cache.acquire("[\"a\"]", 2), nullptr);
+    EXPECT_EQ(cache.acquire("[\"a\"]", 1), fake(1));
+}
+
+TEST_F(GrammarCacheTest, EvictsLeastRecentlyReleased) {
+    grammar_cache cache(2, record_free);
+    cache.release("a", 0, fake(1));
+    cache.release("b", 0, fake(2));
+    cache.release("c", 0, fake(3));
+
+    ASSERT_EQ(g_freed.size(), 1u);
+    EXPECT_EQ(g_freed[0], fake(1));
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.acquire("a", 0), nullptr);
+    EXPECT_EQ(cache.acquire("c", 0), fake(3));
+}
+
+TEST_F(GrammarCacheTest, SeveralRecognizersPerGrammar) {
+    grammar_cache cache(4, record_free);
+    cache.release("a", 0, fake(1));
+    cache.release("a", 0, fake(2));
+
+    std::set<VoskRecognizer*> taken{cache.acquire("a", 0), cache.acquire("a", 0)};
+    EXPECT_EQ(taken, (std::set<VoskRecognizer*>{fake(1), fake(2)}));
+}
+
+TEST_F(GrammarCacheTest, ZeroCapacityFreesImmediately) {
+    grammar_cache cache(0, record_free);
+    cache.release("a", 0, fake(1));
+    EXPECT_EQ(g_freed.size(), 1u);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(GrammarCacheTest, ClearAndDestructorFreeEverything) {
+    {
+        grammar_cache cache(4, record_free);
+        cache.release("a", 0, fake(1));
+        cache.release("b", 0, fake(2));
+        cache.clear();
+        EXPECT_EQ(g_freed.size(), 2u);
+
+        cache.release("c", 0, fake(3));
+    }
+    EXPECT_EQ(g_freed.size(), 3u);
+}
@@ -0,0 +1,63 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "huge_page_advisor.h"
+#include <sys/mman.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+TEST(HugePageAdvisorTest, ParsesAnonymousWritableMappings) {
+    std::istringstream maps(
+        "55d0c0a00000-55d0c0a21000 rw-p 00000000 00:00 0                          [heap]\n"
+        "7f0000000000-7f0000400000 rw-p 00000000 00:00 0 \n"
+        "7f0000400000-7f0000500000 r--p 00000000 00:00 0 \n"
+        "7f0000500000-7f0000600000 rw-s 00000000 00:05 1234                       /dev/shm/x\n"
+        "7f0000600000-7f0000700000 rw-p 00001000 08:01 5678                       /usr/lib/libvosk.so\n"
+        "7ffc00000000-7ffc00021000 rw-p 00000000 00:00 0                          [stack]\n"
+        "garbage\n");
+
+    auto regions = huge_page_advisor::parse_maps(maps);
+    ASSERT_EQ(regions.size(), 2u);
+    EXPECT_EQ(regions[0].start, 0x55d0c0a00000u);
+    EXPECT_EQ(regions[0].end, 0x55d0c0a21000u);
+    EXPECT_EQ(regions[1].start, 0x7f0000000000u);
+    EXPECT_EQ(regions[1].end, 0x7f0000400000u);
+}
+
+TEST(HugePageAdvisorTest, AdvisesOnlyNewMappings) {
+    huge_page_advisor advisor;
+    EXPECT_EQ(advisor.advise_new_regions(size_t{1} << 40), 0u);
+
+    // A fresh 8 MB mapping, as a large model allocation gets from malloc
+    constexpr size_t bytes = 8 * 1024 * 1024;
+    void* block = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(block, MAP_FAILED);
+
+    size_t advised = advisor.advise_new_regions(bytes);
+    if (huge_page_advisor::available()) {
+        EXPECT_GE(advised, bytes);
+    }
+    EXPECT_EQ(advisor.advise_new_regions(bytes), 0u);
+
+    munmap(block, bytes);
+}
+
+TEST(HugePageAdvisorTest, ReadsHugePageUsage) {
+    auto path = std::filesystem::temp_directory_path() / "vstream_smaps_rollup";
+    std::ofstream(path) << "Rss:             1048576 kB\n"
+                        << "AnonHugePages:    524288 kB\n";
+    EXPECT_EQ(huge_page_advisor::huge_pages_kb(path.string()), 524288u);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(huge_page_advisor::huge_pages_kb("/nonexistent/smaps_rollup"), 0u);
+}
@@ -0,0 +1,96 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "latency_histogram.h"
+#include "pipeline_metrics.h"
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+TEST(LatencyHistogramTest, BucketsCoverTheRange) {
+    for (uint64_t value : {0ull, 1ull, 63ull, 64ull, 65ull, 1000ull, 123456ull, 4294967295ull}) {
+        size_t index = latency_histogram::bucket_index(value);
+        ASSERT_LT(index, latency_histogram::bucket_count) << value;
+        EXPECT_LE(latency_histogram::bucket_lower_bound(index), value) << value;
+        EXPECT_GT(latency_histogram::bucket_lower_bound(index) + latency_histogram::bucket_width(index), value)
+            << value;
+    }
+
+    // Adjacent buckets tile the range without gaps
+    for (size_t i = 0; i + 1 < latency_histogram::bucket_count; ++i) {
+        ASSERT_EQ(latency_histogram::bucket_lower_bound(i) + latency_histogram::bucket_width(i),
+                  latency_histogram::bucket_lower_bound(i + 1)) << i;
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketPrecision) {
+    latency_histogram histogram;
+    std::mt19937 rng(3);
+    std::lognormal_distribution<double> latency(8.0, 1.0); // ~3ms median, long tail
+
+    std::vector<uint64_t> values(100000);
+    for (auto& v : values) {
+        v = static_cast<uint64_t>(latency(rng));
+        histogram.record_us(v);
+    }
+    std::sort(values.begin(), values.end());
+
+    auto s = histogram.snapshot();
+    ASSERT_EQ(s.count, values.size());
+    EXPECT_NEAR(s.p50_ms, values[values.size() / 2] / 1000.0, values[values.size() / 2] / 1000.0 * 0.04);
+    EXPECT_NEAR(s.p99_ms, values[values.size() * 99 / 100] / 1000.0, values[values.size() * 99 / 100] / 1000.0 * 0.04);
+    EXPECT_NEAR(s.p999_ms, values[values.size() * 999 / 1000] / 1000.0, values[values.size() * 999 / 1000] / 1000.0 * 0.04);
+    EXPECT_DOUBLE_EQ(s.max_ms, values.back() / 1000.0);
+    EXPECT_NEAR(histogram.percentile(0.5), s.p50_ms, 1e-9);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordsAreAllCounted) {
+    latency_histogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram] {
+            for (int i = 0; i < 10000; ++i) {
+                histogram.record(std::chrono::microseconds(i % 500));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(histogram.count(), 40000u);
+    EXPECT_DOUBLE_EQ(histogram.snapshot().max_ms, 0.499);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.snapshot().count, 0u);
+}
+
+TEST(LatencyHistogramTest, PipelineMetricsExport) {
+    pipeline_metrics metrics;
+    metrics.record(pipeline_metrics::stage::decode, std::chrono::milliseconds(12));
+    metrics.record(pipeline_metrics::stage::decode, std::chrono::milliseconds(14));
+    metrics.record(pipeline_metrics::stage::queue, std::chrono::microseconds(40));
+
+    auto stats = metrics.to_json();
+    ASSERT_TRUE(stats.contains("decode"));
+    EXPECT_EQ(stats["decode"]["count"], 2);
+    EXPECT_NEAR(stats["decode"]["max_ms"].get<double>(), 14.0, 1e-9);
+    EXPECT_FALSE(stats.contains("parse"));
+
+    auto text = metrics.to_prometheus();
+    EXPECT_NE(text.find("# TYPE vstream_stage_latency_seconds summary"), std::string::npos);
+    EXPECT_NE(text.find("vstream_stage_latency_seconds{stage=\"queue\",quantile=\"0.5\"} 0.000040"),
+              std::string::npos);
+    EXPECT_NE(text.find("vstream_stage_latency_seconds_count{stage=\"decode\"} 2"), std::string::npos);
+    EXPECT_NE(text.find("vstream_stage_latency_seconds_count{stage=\"end_to_end\"} 0"), std::string::npos);
+}
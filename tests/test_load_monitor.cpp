@@ -0,0 +1,105 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "load_monitor.h"
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+class LoadMonitorTest : public ::testing::Test {
+protected:
+    static load_monitor::config unsmoothed() {
+        load_monitor::config cfg;
+        cfg.workers = 2;
+        cfg.smoothing = 1.0;
+        return cfg;
+    }
+
+    // Advance one second with both workers busy for busy_fraction of it
+    load_monitor::level step(load_monitor& monitor, double busy_fraction,
+                             std::chrono::milliseconds wait = 0ms) {
+        m_now += 1s;
+        m_totals.busy_ns += static_cast<uint64_t>(busy_fraction * 2e9);
+        m_totals.samples += 16000 * 4;  // four real-time streams
+        m_totals.max_queue_wait = wait;
+        return monitor.update(m_now, m_totals);
+    }
+
+    std::chrono::steady_clock::time_point m_now{};
+    load_monitor::totals m_totals;
+};
+
+TEST_F(LoadMonitorTest, RejectsInvalidConfig) {
+    load_monitor::config cfg;
+    cfg.workers = 0;
+    EXPECT_THROW(load_monitor{cfg}, std::invalid_argument);
+
+    cfg = load_monitor::config{};
+    cfg.coarse_load = 0.5;  // below no_partials_load
+    EXPECT_THROW(load_monitor{cfg}, std::invalid_argument);
+
+    EXPECT_NO_THROW(load_monitor{});
+}
+
+TEST_F(LoadMonitorTest, FirstUpdateSetsBaseline) {
+    load_monitor monitor(unsmoothed());
+    m_totals.busy_ns = 50'000'000'000;  // history before the monitor started
+    EXPECT_EQ(monitor.update(m_now, m_totals), load_monitor::level::normal);
+    EXPECT_DOUBLE_EQ(monitor.get_load(), 0.0);
+
+    EXPECT_EQ(step(monitor, 0.5), load_monitor::level::normal);
+    EXPECT_NEAR(monitor.get_utilization(), 0.5, 1e-9);
+    // 1s of busy time for 4s of audio
+    EXPECT_NEAR(monitor.get_real_time_factor(), 0.25, 1e-9);
+}
+
+TEST_F(LoadMonitorTest, EscalatesStraightToLevel) {
+    load_monitor monitor(unsmoothed());
+    monitor.update(m_now, m_totals);
+
+    EXPECT_EQ(step(monitor, 0.75), load_monitor::level::no_partials);
+    EXPECT_EQ(step(monitor, 1.0), load_monitor::level::reject);
+    EXPECT_STREQ(load_monitor::level_name(monitor.get_level()), "reject");
+}
+
+TEST_F(LoadMonitorTest, QueueWaitCountsAsLoad) {
+    load_monitor monitor(unsmoothed());
+    monitor.update(m_now, m_totals);
+
+    // Workers look idle, but a chunk waited 900ms of the 1000ms budget
+    EXPECT_EQ(step(monitor, 0.1, 900ms), load_monitor::level::coarse);
+    EXPECT_NEAR(monitor.get_queue_wait_ms(), 900.0, 1e-9);
+}
+
+TEST_F(LoadMonitorTest, RecoversOneStepWithHysteresis) {
+    load_monitor monitor(unsmoothed());
+    monitor.update(m_now, m_totals);
+    ASSERT_EQ(step(monitor, 1.0), load_monitor::level::reject);
+
+    // Just under the reject threshold is within the hysteresis band
+    EXPECT_EQ(step(monitor, 0.95), load_monitor::level::reject);
+
+    EXPECT_EQ(step(monitor, 0.1), load_monitor::level::coarse);
+    EXPECT_EQ(step(monitor, 0.1), load_monitor::level::no_partials);
+    EXPECT_EQ(step(monitor, 0.1), load_monitor::level::normal);
+}
+
+TEST_F(LoadMonitorTest, SmoothingDampsSpikes) {
+    load_monitor::config cfg = unsmoothed();
+    cfg.smoothing = 0.5;
+    load_monitor monitor(cfg);
+    monitor.update(m_now, m_totals);
+
+    // One saturated second after idle averages to 0.5
+    EXPECT_EQ(step(monitor, 1.0), load_monitor::level::normal);
+    EXPECT_NEAR(monitor.get_load(), 0.5, 1e-9);
+}
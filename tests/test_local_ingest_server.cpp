@@ -0,0 +1,278 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "local_ingest_server.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+namespace {
+
+using frame_type = local_ingest_server::frame_type;
+
+std::string socket_path(const std::string& name) {
+    return "/tmp/vstream-test-" + std::to_string(::getpid()) + "-" + name + ".sock";
+}
+
+int connect_to(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    socklen_t len = sizeof(addr);
+    if (path[0] == '@') {
+        addr.sun_path[0] = '\0';
+        len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size());
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), len) < 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    timeval timeout{2, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+}
+
+std::string frame(frame_type type, const void* payload, size_t size) {
+    std::string out(local_ingest_server::header_size, '\0');
+    out[0] = static_cast<char>(type);
+    for (int b = 0; b < 4; ++b) {
+        out[4 + b] = static_cast<char>((size >> (8 * b)) & 0xff);
+    }
+    out.append(static_cast<const char*>(payload), size);
+    return out;
+}
+
+std::string frame(frame_type type, const std::string& payload) {
+    return frame(type, payload.data(), payload.size());
+}
+
+void send_all(int fd, const std::string& data) {
+    ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+}
+
+bool recv_exact(int fd, char* out, size_t size) {
+    size_t got = 0;
+    while (got < size) {
+        ssize_t n = ::recv(fd, out + got, size - got, 0);
+        if (n <= 0) return false;
+        got += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Read one frame; type 0 on end of stream
+std::pair<int, std::string> read_frame(int fd) {
+    uint8_t header[local_ingest_server::header_size];
+    if (!recv_exact(fd, reinterpret_cast<char*>(header), sizeof(header))) {
+        return {0, ""};
+    }
+    size_t size = header[4] | header[5] << 8 | header[6] << 16 | static_cast<size_t>(header[7]) << 24;
+    std::string payload(size, '\0');
+    if (!recv_exact(fd, payload.data(), size)) {
+        return {0, ""};
+    }
+    return {header[0], payload};
+}
+
+// Collects what the handlers see on the server thread
+struct recorder {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::string audio_session;
+    std::vector<int16_t> samples;
+    std::vector<std::string> closed;
+
+    template <typename Pred>
+    bool wait(Pred pred) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(2), pred);
+    }
+};
+
+std::unique_ptr<local_ingest_server> make_server(const std::string& path, recorder& rec) {
+    return std::make_unique<local_ingest_server>(
+        path,
+        [&rec](const std::string& session_id, std::vector<int16_t>& samples) {
+            std::lock_guard<std::mutex> lock(rec.mutex);
+            rec.audio_session = session_id;
+            rec.samples.insert(rec.samples.end(), samples.begin(), samples.end());
+            rec.changed.notify_all();
+        },
+        [](const std::string& command, const nlohmann::json& params) {
+            return nlohmann::json{{"command", command}, {"session_id", params["session_id"]}, {"status", "ok"}};
+        },
+        [&rec](const std::string& session_id) {
+            std::lock_guard<std::mutex> lock(rec.mutex);
+            rec.closed.push_back(session_id);
+            rec.changed.notify_all();
+        });
+}
+
+} // namespace
+
+TEST(LocalIngestServerTest, StreamsAudioCommandsAndResults) {
+    recorder rec;
+    auto server = make_server(socket_path("stream"), rec);
+    server->start();
+
+    int fd = connect_to(server->path());
+    ASSERT_GE(fd, 0);
+    send_all(fd, frame(frame_type::hello, "call-7"));
+
+    // Split the audio frame so the server has to resume mid-payload
+    int16_t samples[] = {1, -2, 300, -32768};
+    std::string audio = frame(frame_type::audio, samples, sizeof(samples));
+    send_all(fd, audio.substr(0, 11));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    send_all(fd, audio.substr(11));
+
+    ASSERT_TRUE(rec.wait([&] { return rec.samples.size() == 4; }));
+    EXPECT_EQ(rec.audio_session, "call-7");
+    EXPECT_EQ(rec.samples, std::vector<int16_t>(samples, samples + 4));
+    EXPECT_TRUE(server->has_session("call-7"));
+
+    send_all(fd, frame(frame_type::command, R"({"command":"reset"})"));
+    auto [type, payload] = read_frame(fd);
+    EXPECT_EQ(type, static_cast<int>(frame_type::response));
+    auto response = nlohmann::json::parse(payload);
+    EXPECT_EQ(response["command"], "reset");
+    EXPECT_EQ(response["session_id"], "call-7");
+
+    EXPECT_TRUE(server->send("call-7", frame_type::result, R"({"text":"hello"})"));
+    EXPECT_FALSE(server->send("other", frame_type::result, "{}"));
+    std::tie(type, payload) = read_frame(fd);
+    EXPECT_EQ(type, static_cast<int>(frame_type::result));
+    EXPECT_EQ(payload, R"({"text":"hello"})");
+
+    EXPECT_EQ(server->get_connection_count(), 1u);
+    EXPECT_EQ(server->get_frames_received(), 3u);
+
+    ::close(fd);
+    ASSERT_TRUE(rec.wait([&] { return rec.closed.size() == 1; }));
+    EXPECT_EQ(rec.closed[0], "call-7");
+    EXPECT_FALSE(server->has_session("call-7"));
+    EXPECT_EQ(server->get_connection_count(), 0u);
+
+    server->stop();
+}
+
+TEST(LocalIngestServerTest, RejectsProtocolViolations) {
+    recorder rec;
+    auto server = make_server(socket_path("errors"), rec);
+    server->start();
+
+    // Audio before hello
+    int fd = connect_to(server->path());
+    int16_t sample = 5;
+    send_all(fd, frame(frame_type::audio, &sample, sizeof(sample)));
+    EXPECT_EQ(read_frame(fd).first, static_cast<int>(frame_type::error));
+    EXPECT_EQ(read_frame(fd).first, 0);
+    ::close(fd);
+
+    // Half a sample
+    fd = connect_to(server->path());
+    send_all(fd, frame(frame_type::hello, "a"));
+    send_all(fd, frame(frame_type::audio, "x"));
+    EXPECT_EQ(read_frame(fd).first, static_cast<int>(frame_type::error));
+    ::close(fd);
+
+    // A session can only be connected once
+    int first = connect_to(server->path());
+    send_all(first, frame(frame_type::hello, "dup"));
+    for (int i = 0; i < 200 && !server->has_session("dup"); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    int second = connect_to(server->path());
+    send_all(second, frame(frame_type::hello, "dup"));
+    auto [type, message] = read_frame(second);
+    EXPECT_EQ(type, static_cast<int>(frame_type::error));
+    EXPECT_NE(message.find("already connected"), std::string::npos);
+    EXPECT_TRUE(server->has_session("dup"));
+    ::close(second);
+    ::close(first);
+
+    EXPECT_EQ(server->get_protocol_errors(), 3u);
+    EXPECT_TRUE(rec.samples.empty());
+    server->stop();
+}
+
+TEST(LocalIngestServerTest, ErrorNeverSplitsAPendingFrame) {
+    recorder rec;
+    auto server = make_server(socket_path("backlog"), rec);
+    server->start();
+
+    int fd = connect_to(server->path());
+    ASSERT_GE(fd, 0);
+    send_all(fd, frame(frame_type::hello, "slow"));
+    for (int i = 0; i < 200 && !server->has_session("slow"); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    // The client reads nothing until results are dropped, so a frame is left half written
+    const std::string result(1001, 'r');
+    for (size_t sent = 0; server->get_dropped_results() == 0; ++sent) {
+        ASSERT_LT(sent, 10000u);
+        ASSERT_TRUE(server->send("slow", frame_type::result, result));
+    }
+    send_all(fd, frame(frame_type::audio, "x"));
+
+    // Whole result frames, then at most the start of one, and no error frame in between
+    std::string expected = frame(frame_type::result, result);
+    std::string received;
+    char buffer[65536];
+    ssize_t n;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        received.append(buffer, static_cast<size_t>(n));
+    }
+    ASSERT_GT(received.size(), 0u);
+    for (size_t offset = 0; offset < received.size(); offset += expected.size()) {
+        size_t length = std::min(expected.size(), received.size() - offset);
+        ASSERT_EQ(received.compare(offset, length, expected, 0, length), 0) << "at byte " << offset;
+    }
+
+    ::close(fd);
+    EXPECT_EQ(server->get_protocol_errors(), 1u);
+    server->stop();
+}
+
+TEST(LocalIngestServerTest, ListensInAbstractNamespace) {
+    recorder rec;
+    auto server = make_server("@vstream-test-" + std::to_string(::getpid()), rec);
+    server->start();
+
+    int fd = connect_to(server->path());
+    ASSERT_GE(fd, 0);
+    send_all(fd, frame(frame_type::hello, "abstract"));
+    ::close(fd);
+    ASSERT_TRUE(rec.wait([&] { return rec.closed.size() == 1; }));
+    server->stop();
+}
+
+TEST(LocalIngestServerTest, RejectsInvalidPaths) {
+    auto noop_audio = [](const std::string&, std::vector<int16_t>&) {};
+    auto noop_command = [](const std::string&, const nlohmann::json&) { return nlohmann::json(); };
+
+    EXPECT_THROW(local_ingest_server("", noop_audio, noop_command), std::invalid_argument);
+    EXPECT_THROW(local_ingest_server("/tmp/" + std::string(200, 'x'), noop_audio, noop_command),
+                 std::invalid_argument);
+    EXPECT_THROW(local_ingest_server("/nonexistent-dir/vstream.sock", noop_audio, noop_command),
+                 std::runtime_error);
+}
@@ -0,0 +1,81 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "logger.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+class LoggerTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        // Leave the logger as the rest of the suite expects it
+        logger::instance().init(false, false);
+    }
+
+    static std::string costly(int& calls) {
+        calls++;
+        return "message";
+    }
+};
+
+TEST_F(LoggerTest, DisabledLoggerSkipsMessageConstruction) {
+    logger::instance().init(false, false);
+
+    int calls = 0;
+    LOG_ERROR(costly(calls));
+    EXPECT_EQ(calls, 0);
+    EXPECT_FALSE(logger::instance().should_log(logger::Level::ERROR));
+}
+
+TEST_F(LoggerTest, FiltersBelowMinimumLevel) {
+    logger::instance().init(false, true);
+    logger::instance().set_min_level(logger::Level::WARNING);
+
+    int calls = 0;
+    testing::internal::CaptureStderr();
+    LOG_INFO(costly(calls));
+    LOG_WARNING("kept " + costly(calls));
+    logger::instance().flush();
+    std::string output = testing::internal::GetCapturedStderr();
+
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(output.find("[INFO]"), std::string::npos);
+    EXPECT_NE(output.find("[WARNING] [test_logger.cpp:"), std::string::npos);
+    EXPECT_NE(output.find("kept message"), std::string::npos);
+}
+
+TEST_F(LoggerTest, FlushWritesMessagesFromAllThreads) {
+    logger::instance().init(false, true);
+
+    testing::internal::CaptureStderr();
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([t] {
+            for (int i = 0; i < 100; ++i) {
+                LOG_INFO("producer " + std::to_string(t) + " line " + std::to_string(i));
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    logger::instance().flush();
+    std::string output = testing::internal::GetCapturedStderr();
+
+    size_t lines = 0;
+    for (size_t pos = output.find("producer "); pos != std::string::npos; pos = output.find("producer ", pos + 1)) {
+        lines++;
+    }
+    EXPECT_EQ(lines, 400u);
+    EXPECT_NE(output.find("producer 3 line 99"), std::string::npos);
+}
@@ -0,0 +1,79 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "metrics_server.h"
+#include <cstring>
+#include <string>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// Send one request on a fresh connection and read the whole reply
+std::string http_request(uint16_t port, const std::string& request) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return "";
+    }
+
+    ::send(fd, request.data(), request.size(), 0);
+    std::string reply;
+    char buffer[512];
+    for (ssize_t n; (n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0;) {
+        reply.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return reply;
+}
+
+} // namespace
+
+TEST(MetricsServerTest, ServesHandlerResponses) {
+    metrics_server server(0, [](const std::string& path) {
+        metrics_server::response response;
+        if (path == "/metrics") {
+            response.body = "vstream_up 1\n";
+        } else {
+            response.status = 404;
+        }
+        return response;
+    });
+    ASSERT_NE(server.port(), 0);
+    server.start();
+
+    auto reply = http_request(server.port(), "GET /metrics?x=1 HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    EXPECT_EQ(reply.rfind("HTTP/1.0 200 OK\r\n", 0), 0u) << reply;
+    EXPECT_NE(reply.find("Content-Type: text/plain; version=0.0.4"), std::string::npos);
+    EXPECT_NE(reply.find("Content-Length: 13"), std::string::npos);
+    EXPECT_NE(reply.find("\r\n\r\nvstream_up 1\n"), std::string::npos);
+
+    reply = http_request(server.port(), "GET /other HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(reply.rfind("HTTP/1.0 404", 0), 0u) << reply;
+
+    reply = http_request(server.port(), "POST /metrics HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(reply.rfind("HTTP/1.0 405", 0), 0u) << reply;
+
+    server.stop();
+}
+
+TEST(MetricsServerTest, RejectsPortInUse) {
+    metrics_server first(0, [](const std::string&) { return metrics_server::response{}; });
+    EXPECT_THROW(metrics_server(first.port(), [](const std::string&) { return metrics_server::response{}; }),
+                 std::runtime_error);
+}
@@ -12,6 +12,9 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "mic_capture.h"
+#include <moodycamel/concurrentqueue.h>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <chrono>
 #include <atomic>
@@ -0,0 +1,215 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "model_registry.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+// The registry never dereferences an engine, so tests hand out stand-ins
+class ModelRegistryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / ("vstream_models_" + std::to_string(getpid()));
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_dir);
+    }
+
+    model_registry::factory counting_factory() {
+        return [this](const model_registry::model_spec& spec) {
+            if (spec.path == "broken") {
+                throw std::runtime_error("Failed to load Vosk model from: broken");
+            }
+            m_loads++;
+            return fake_engine();
+        };
+    }
+
+    std::shared_ptr<vstream_engine> fake_engine() {
+        auto owner = std::shared_ptr<int>(new int(0), [this](int* p) {
+            delete p;
+            m_unloads++;
+        });
+        return std::shared_ptr<vstream_engine>(owner, reinterpret_cast<vstream_engine*>(owner.get()));
+    }
+
+    static model_registry::model_spec spec(const std::string& name, size_t memory_mb,
+                                           const std::string& path = "models/any") {
+        model_registry::model_spec s;
+        s.name = name;
+        s.path = path;
+        s.memory_mb = memory_mb;
+        return s;
+    }
+
+    std::filesystem::path m_dir;
+    std::atomic<int> m_loads{0};
+    std::atomic<int> m_unloads{0};
+};
+
+TEST_F(ModelRegistryTest, LoadsOnFirstUseOnly) {
+    model_registry models(0, counting_factory());
+    models.add(spec("commands", 50));
+    EXPECT_EQ(m_loads, 0);
+    EXPECT_EQ(models.memory_used_mb(), 0u);
+
+    auto first = models.acquire("commands");
+    auto second = models.acquire("commands");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(m_loads, 1);
+    EXPECT_EQ(models.get_load_count(), 1u);
+    EXPECT_EQ(models.memory_used_mb(), 50u);
+
+    auto status = models.status();
+    ASSERT_EQ(status.size(), 1u);
+    EXPECT_TRUE(status[0].loaded);
+    EXPECT_EQ(status[0].references, 2);
+}
+
+TEST_F(ModelRegistryTest, RejectsUnknownAndDuplicateNames) {
+    model_registry models(0, counting_factory());
+    models.add(spec("commands", 50));
+    EXPECT_THROW(models.add(spec("commands", 10)), std::invalid_argument);
+    EXPECT_THROW(models.add(spec("", 10)), std::invalid_argument);
+    EXPECT_THROW(models.add_resident(spec("commands", 10), fake_engine()), std::invalid_argument);
+    EXPECT_THROW(models.acquire("dictation"), std::invalid_argument);
+    EXPECT_TRUE(models.contains("commands"));
+    EXPECT_FALSE(models.contains("dictation"));
+}
+
+TEST_F(ModelRegistryTest, UnloadsLeastRecentlyUsedIdleModel) {
+    model_registry models(100, counting_factory());
+    models.add(spec("a", 40));
+    models.add(spec("b", 40));
+    models.add(spec("c", 40));
+
+    models.acquire("a");
+    models.acquire("b");
+    EXPECT_EQ(m_unloads, 0);
+
+    // Both idle, "a" used longest ago
+    models.acquire("c");
+    EXPECT_EQ(m_unloads, 1);
+    EXPECT_EQ(models.get_unload_count(), 1u);
+    EXPECT_EQ(models.memory_used_mb(), 80u);
+
+    for (const auto& s : models.status()) {
+        EXPECT_EQ(s.loaded, s.name != "a") << s.name;
+    }
+}
+
+TEST_F(ModelRegistryTest, ReferencedModelsStayLoaded) {
+    model_registry models(100, counting_factory());
+    models.add(spec("a", 60));
+    models.add(spec("b", 60));
+
+    auto in_use = models.acquire("a");
+    EXPECT_THROW(models.acquire("b"), std::runtime_error);
+    EXPECT_EQ(m_unloads, 0);
+    EXPECT_EQ(models.memory_used_mb(), 60u);
+
+    // Once released, "a" makes way
+    in_use.reset();
+    EXPECT_NO_THROW(models.acquire("b"));
+    EXPECT_EQ(m_unloads, 1);
+}
+
+TEST_F(ModelRegistryTest, ResidentModelIsNeverUnloaded) {
+    model_registry models(100, counting_factory());
+    models.add_resident(spec("default", 60), fake_engine());
+    models.add(spec("dictation", 60));
+
+    EXPECT_EQ(models.memory_used_mb(), 60u);
+    EXPECT_THROW(models.acquire("dictation"), std::runtime_error);
+    EXPECT_EQ(m_unloads, 0);
+    EXPECT_EQ(models.loaded_engines().size(), 1u);
+}
+
+TEST_F(ModelRegistryTest, FailedLoadReleasesItsBudget) {
+    model_registry models(100, counting_factory());
+    models.add(spec("bad", 80, "broken"));
+    models.add(spec("good", 80));
+
+    EXPECT_THROW(models.acquire("bad"), std::runtime_error);
+    EXPECT_EQ(models.memory_used_mb(), 0u);
+    EXPECT_NO_THROW(models.acquire("good"));
+}
+
+TEST_F(ModelRegistryTest, ConcurrentFirstUseLoadsOnce) {
+    model_registry models(0, [this](const model_registry::model_spec&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        m_loads++;
+        return fake_engine();
+    });
+    models.add(spec("dictation", 10));
+
+    std::vector<std::shared_ptr<vstream_engine>> engines(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < engines.size(); ++i) {
+        threads.emplace_back([&, i] { engines[i] = models.acquire("dictation"); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(m_loads, 1);
+    for (const auto& engine : engines) {
+        EXPECT_EQ(engine, engines[0]);
+    }
+}
+
+TEST_F(ModelRegistryTest, LoadsConfigFile) {
+    auto path = m_dir / "models.json";
+    std::ofstream(path) << R"({
+        "memory_budget_mb": 6144,
+        "models": [
+            {"name": "commands", "path": "models/small", "preload": true},
+            {"name": "dictation", "path": "models/gigaspeech", "memory_mb": 4500}
+        ]
+    })";
+
+    auto cfg = model_registry::load_config(path.string());
+    EXPECT_EQ(cfg.memory_budget_mb, 6144u);
+    ASSERT_EQ(cfg.models.size(), 2u);
+    EXPECT_EQ(cfg.models[0].name, "commands");
+    EXPECT_TRUE(cfg.models[0].preload);
+    EXPECT_EQ(cfg.models[0].memory_mb, 0u);
+    EXPECT_EQ(cfg.models[1].path, "models/gigaspeech");
+    EXPECT_EQ(cfg.models[1].memory_mb, 4500u);
+    EXPECT_FALSE(cfg.models[1].preload);
+
+    std::ofstream(path) << R"({"models": [{"name": "no-path"}]})";
+    EXPECT_THROW(model_registry::load_config(path.string()), std::invalid_argument);
+    std::ofstream(path) << "not json";
+    EXPECT_THROW(model_registry::load_config(path.string()), std::invalid_argument);
+    EXPECT_THROW(model_registry::load_config((m_dir / "missing.json").string()), std::runtime_error);
+}
+
+TEST_F(ModelRegistryTest, EstimatesMemoryFromModelDirectory) {
+    auto model = m_dir / "model";
+    std::filesystem::create_directories(model / "graph");
+    std::ofstream(model / "am.bin", std::ios::binary) << std::string(3 * 1024 * 1024, 'x');
+    std::ofstream(model / "graph" / "HCLG.fst", std::ios::binary) << std::string(512 * 1024, 'x');
+
+    EXPECT_EQ(model_registry::estimate_memory_mb(model.string()), 4u);
+    EXPECT_EQ(model_registry::estimate_memory_mb((m_dir / "missing").string()), 0u);
+
+    model_registry models(0, counting_factory());
+    models.add(spec("measured", 0, model.string()));
+    EXPECT_EQ(models.status()[0].memory_mb, 4u);
+}
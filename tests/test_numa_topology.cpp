@@ -0,0 +1,103 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "numa_topology.h"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+class NumaTopologyTest : public ::testing::Test {
+protected:
+    fs::path m_root;
+
+    void SetUp() override {
+        m_root = fs::temp_directory_path() / ("vstream_numa_" + std::to_string(::getpid()));
+        fs::remove_all(m_root);
+        fs::create_directories(m_root);
+    }
+
+    void TearDown() override {
+        fs::remove_all(m_root);
+    }
+
+    void add_node(const std::string& name, const std::string& cpulist) {
+        fs::create_directories(m_root / name);
+        std::ofstream(m_root / name / "cpulist") << cpulist << "\n";
+    }
+
+    static numa_topology two_nodes() {
+        return numa_topology({{0, {0, 1, 2, 3}}, {1, {4, 5, 6, 7}}});
+    }
+};
+
+TEST_F(NumaTopologyTest, ParsesCpuLists) {
+    EXPECT_EQ(numa_topology::parse_cpu_list("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_TRUE(numa_topology::parse_cpu_list("").empty());
+    EXPECT_THROW(numa_topology::parse_cpu_list("3-1"), std::invalid_argument);
+    EXPECT_THROW(numa_topology::parse_cpu_list("a"), std::invalid_argument);
+}
+
+TEST_F(NumaTopologyTest, DetectsNodesFromSysfs) {
+    add_node("node1", "8-15");
+    add_node("node0", "0-7");
+    add_node("node2", "");          // memory-only node
+    add_node("possible", "0-1");    // not a node directory
+
+    auto topology = numa_topology::detect(m_root.string());
+    ASSERT_EQ(topology.node_count(), 2u);
+    EXPECT_TRUE(topology.is_numa());
+    EXPECT_EQ(topology.nodes()[0].id, 0);
+    EXPECT_EQ(topology.nodes()[1].id, 1);
+    EXPECT_EQ(topology.node_index_of_cpu(9), 1);
+    EXPECT_EQ(topology.node_index_of_cpu(99), -1);
+}
+
+TEST_F(NumaTopologyTest, FallsBackToOneNode) {
+    auto topology = numa_topology::detect((m_root / "missing").string());
+    ASSERT_EQ(topology.node_count(), 1u);
+    EXPECT_FALSE(topology.is_numa());
+    EXPECT_EQ(topology.nodes()[0].cpus.size(), std::max(1u, std::thread::hardware_concurrency()));
+}
+
+TEST_F(NumaTopologyTest, PlacesWorkersAcrossNodes) {
+    auto placement = two_nodes().place_workers(6);
+    EXPECT_EQ(placement.cpus, (std::vector<int>{0, 4, 1, 5, 2, 6}));
+    EXPECT_EQ(placement.domains, (std::vector<size_t>{0, 1, 0, 1, 0, 1}));
+
+    // More workers than CPUs wrap around within the node
+    auto single = numa_topology({{0, {2, 3}}}).place_workers(3);
+    EXPECT_EQ(single.cpus, (std::vector<int>{2, 3, 2}));
+}
+
+TEST_F(NumaTopologyTest, RestrictsToCpus) {
+    auto topology = two_nodes().restrict_to({1, 2});
+    ASSERT_EQ(topology.node_count(), 1u);
+    EXPECT_EQ(topology.nodes()[0].cpus, (std::vector<int>{1, 2}));
+
+    EXPECT_THROW(two_nodes().restrict_to({42}), std::invalid_argument);
+    EXPECT_THROW(numa_topology(std::vector<numa_topology::node>{{0, {}}}), std::invalid_argument);
+}
+
+TEST_F(NumaTopologyTest, RunsOnNodeAndRethrows) {
+    auto topology = numa_topology::detect();
+    bool ran = false;
+    topology.run_on_node(0, [&] { ran = true; });
+    EXPECT_TRUE(ran);
+
+    EXPECT_THROW(topology.run_on_node(0, [] { throw std::runtime_error("load failed"); }),
+                 std::runtime_error);
+    EXPECT_THROW(topology.run_on_node(topology.node_count(), [] {}), std::out_of_range);
+}
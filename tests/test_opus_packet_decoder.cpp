@@ -0,0 +1,156 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "opus_packet_decoder.h"
+#include <opus.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <cstdint>
+
+class OpusPacketDecoderTest : public ::testing::Test {
+protected:
+    static constexpr int sample_rate = 16000;
+    static constexpr int frame_samples = sample_rate / 50; // 20ms
+
+    void SetUp() override {
+        int error = OPUS_OK;
+        m_encoder = opus_encoder_create(sample_rate, 1, OPUS_APPLICATION_VOIP, &error);
+        ASSERT_EQ(error, OPUS_OK);
+        opus_encoder_ctl(m_encoder, OPUS_SET_BITRATE(24000));
+    }
+
+    void TearDown() override {
+        opus_encoder_destroy(m_encoder);
+    }
+
+    std::vector<uint8_t> encode(const std::vector<int16_t>& pcm, size_t offset) {
+        std::vector<uint8_t> packet(4000);
+        opus_int32 bytes = opus_encode(m_encoder, pcm.data() + offset, frame_samples,
+                                       packet.data(), static_cast<opus_int32>(packet.size()));
+        EXPECT_GT(bytes, 0);
+        packet.resize(static_cast<size_t>(std::max(bytes, 0)));
+        return packet;
+    }
+
+    // A framed message as it arrives in hyni_audio_data::samples
+    static std::vector<int16_t> to_words(const std::vector<uint8_t>& message) {
+        std::vector<int16_t> words(message.size() / 2);
+        std::memcpy(words.data(), message.data(), message.size());
+        return words;
+    }
+
+    static std::vector<int16_t> tone(size_t samples) {
+        std::vector<int16_t> out(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            out[i] = static_cast<int16_t>(8000.0 * std::sin(2.0 * M_PI * 440.0 * i / sample_rate));
+        }
+        return out;
+    }
+
+    static double rms(std::span<const int16_t> samples) {
+        double sum = 0.0;
+        for (int16_t s : samples) {
+            sum += static_cast<double>(s) * s;
+        }
+        return samples.empty() ? 0.0 : std::sqrt(sum / static_cast<double>(samples.size()));
+    }
+
+    OpusEncoder* m_encoder = nullptr;
+};
+
+TEST_F(OpusPacketDecoderTest, RejectsUnsupportedRate) {
+    EXPECT_THROW(opus_packet_decoder{44100}, std::invalid_argument);
+    EXPECT_THROW(opus_packet_decoder{32000}, std::invalid_argument);
+    EXPECT_NO_THROW(opus_packet_decoder{16000});
+
+    EXPECT_TRUE(opus_packet_decoder::supports_rate(48000));
+    EXPECT_FALSE(opus_packet_decoder::supports_rate(44100));
+}
+
+TEST_F(OpusPacketDecoderTest, FramingRejectsEmptyPacket) {
+    std::vector<uint8_t> message;
+    EXPECT_THROW(opus_packet_decoder::frame({}, message), std::invalid_argument);
+    EXPECT_TRUE(message.empty());
+}
+
+TEST_F(OpusPacketDecoderTest, DecodesFramedPackets) {
+    auto pcm = tone(sample_rate);
+    opus_packet_decoder decoder(sample_rate);
+
+    // Five 20ms packets per message, as a client buffering 100ms would send
+    std::vector<int16_t> decoded;
+    for (size_t offset = 0; offset < pcm.size(); offset += 5 * frame_samples) {
+        std::vector<uint8_t> message;
+        for (size_t f = 0; f < 5; ++f) {
+            opus_packet_decoder::frame(encode(pcm, offset + f * frame_samples), message);
+        }
+        EXPECT_EQ(decoder.decode(to_words(message), decoded), 5u);
+    }
+
+    EXPECT_EQ(decoded.size(), pcm.size());
+    EXPECT_EQ(decoder.get_packet_count(), 50u);
+    EXPECT_EQ(decoder.get_error_count(), 0u);
+
+    // Lossy, but the level of a steady tone survives
+    auto tail = std::span<const int16_t>(decoded).subspan(decoded.size() / 2);
+    EXPECT_NEAR(rms(tail), rms(pcm), rms(pcm) * 0.25);
+}
+
+TEST_F(OpusPacketDecoderTest, ConcatenatedMessagesStillParse) {
+    auto pcm = tone(3 * frame_samples);
+    opus_packet_decoder decoder(sample_rate);
+
+    // Odd-sized packets are padded per record, so joined messages stay aligned
+    std::vector<uint8_t> odd = {0xAB, 0xCD, 0xEF};
+    std::vector<uint8_t> message;
+    opus_packet_decoder::frame(odd, message);
+    EXPECT_EQ(message.size(), 6u);
+
+    std::vector<int16_t> joined;
+    for (size_t f = 0; f < 3; ++f) {
+        std::vector<uint8_t> single;
+        opus_packet_decoder::frame(encode(pcm, f * frame_samples), single);
+        auto words = to_words(single);
+        joined.insert(joined.end(), words.begin(), words.end());
+    }
+
+    std::vector<int16_t> decoded;
+    EXPECT_EQ(decoder.decode(joined, decoded), 3u);
+    EXPECT_EQ(decoded.size(), pcm.size());
+    EXPECT_EQ(decoder.get_error_count(), 0u);
+}
+
+TEST_F(OpusPacketDecoderTest, SkipsTruncatedPacket) {
+    auto pcm = tone(frame_samples);
+    opus_packet_decoder decoder(sample_rate);
+
+    std::vector<uint8_t> message;
+    opus_packet_decoder::frame(encode(pcm, 0), message);
+
+    // Header promises 200 bytes, only 10 follow
+    message.push_back(200);
+    message.push_back(0);
+    message.insert(message.end(), 10, 0x55);
+
+    std::vector<int16_t> decoded;
+    EXPECT_EQ(decoder.decode(to_words(message), decoded), 1u);
+    EXPECT_EQ(decoded.size(), static_cast<size_t>(frame_samples));
+    EXPECT_EQ(decoder.get_error_count(), 1u);
+}
+
+TEST_F(OpusPacketDecoderTest, EmptyMessageDecodesNothing) {
+    opus_packet_decoder decoder(sample_rate);
+    std::vector<int16_t> decoded;
+    EXPECT_EQ(decoder.decode({}, decoded), 0u);
+    EXPECT_TRUE(decoded.empty());
+}
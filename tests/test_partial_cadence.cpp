@@ -0,0 +1,79 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "partial_cadence.h"
+
+TEST(PartialCadenceTest, ReportsOncePerIntervalOfAudio) {
+    partial_cadence cadence;
+    cadence.configure(true, 3200);
+
+    // 100ms chunks: every second call
+    cadence.add(1600);
+    EXPECT_FALSE(cadence.due(false));
+    cadence.add(1600);
+    EXPECT_TRUE(cadence.due(false));
+    EXPECT_EQ(cadence.unreported(), 0u);
+
+    // One long chunk covers the interval on its own
+    cadence.add(8000);
+    EXPECT_TRUE(cadence.due(false));
+    EXPECT_FALSE(cadence.due(false));
+}
+
+TEST(PartialCadenceTest, ZeroIntervalReportsEveryCall) {
+    partial_cadence cadence;
+    cadence.configure(true, 0);
+
+    EXPECT_FALSE(cadence.due(false));
+    for (int i = 0; i < 3; ++i) {
+        cadence.add(160);
+        EXPECT_TRUE(cadence.due(false));
+    }
+}
+
+TEST(PartialCadenceTest, FinalResultRestartsInterval) {
+    partial_cadence cadence;
+    cadence.configure(true, 3200);
+
+    cadence.add(3000);
+    cadence.reset();
+    cadence.add(1600);
+    EXPECT_FALSE(cadence.due(false));
+
+    // An endpoint inside a call: only the audio after it counts
+    cadence.add(3000);
+    cadence.reset();
+    cadence.add(400);
+    EXPECT_EQ(cadence.unreported(), 400u);
+    EXPECT_FALSE(cadence.due(false));
+}
+
+TEST(PartialCadenceTest, SuspendedAndDisabledKeepCounting) {
+    partial_cadence cadence;
+    cadence.configure(true, 3200);
+
+    cadence.add(3200);
+    EXPECT_FALSE(cadence.due(true));
+    EXPECT_EQ(cadence.unreported(), 3200u);
+
+    // Resuming reports straight away
+    EXPECT_TRUE(cadence.due(false));
+
+    cadence.configure(false, cadence.interval());
+    cadence.add(6400);
+    EXPECT_FALSE(cadence.due(false));
+    EXPECT_FALSE(cadence.enabled());
+    EXPECT_EQ(cadence.interval(), 3200u);
+
+    cadence.configure(true, 1600);
+    EXPECT_TRUE(cadence.due(false));
+}
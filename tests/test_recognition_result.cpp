@@ -0,0 +1,143 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "recognition_result.h"
+#include <nlohmann/json.hpp>
+
+class RecognitionResultTest : public ::testing::Test {
+protected:
+    recognition_result m_result;
+};
+
+TEST_F(RecognitionResultTest, PartialResult) {
+    ASSERT_TRUE(m_result.assign("{\n  \"partial\" : \"hello wor\"\n}"));
+
+    EXPECT_TRUE(m_result.is_partial());
+    EXPECT_FALSE(m_result.is_final());
+    EXPECT_EQ(m_result.text(), "hello wor");
+    EXPECT_FLOAT_EQ(m_result.confidence(), 1.0f);
+    EXPECT_STREQ(m_result.type_name(), "partial");
+}
+
+TEST_F(RecognitionResultTest, FinalResultWithWords) {
+    const char* json = R"({
+  "result" : [{
+      "conf" : 1.000000,
+      "end" : 0.840000,
+      "start" : 0.330000,
+      "word" : "hello"
+    }, {
+      "conf" : 0.871718,
+      "end" : 1.290000,
+      "start" : 0.840000,
+      "word" : "world"
+    }],
+  "text" : "hello world"
+})";
+
+    ASSERT_TRUE(m_result.assign(json, true));
+
+    EXPECT_TRUE(m_result.is_final());
+    EXPECT_EQ(m_result.text(), "hello world");
+    EXPECT_FLOAT_EQ(m_result.confidence(), 1.0f);
+    ASSERT_EQ(m_result.words().size(), 2u);
+    EXPECT_EQ(m_result.view(m_result.words()[1].text), "world");
+    EXPECT_FLOAT_EQ(m_result.words()[1].start, 0.84f);
+    EXPECT_FLOAT_EQ(m_result.words()[1].end, 1.29f);
+    EXPECT_NEAR(m_result.words()[1].confidence, 0.871718f, 1e-6);
+    EXPECT_EQ(m_result.json(), json);
+}
+
+TEST_F(RecognitionResultTest, WordsAreOptIn) {
+    ASSERT_TRUE(m_result.assign(R"({"result":[{"conf":1.0,"end":1.0,"start":0.5,"word":"hi"}],"text":"hi"})"));
+
+    EXPECT_EQ(m_result.text(), "hi");
+    EXPECT_TRUE(m_result.words().empty());
+}
+
+TEST_F(RecognitionResultTest, AlternativesProvideConfidenceAndText) {
+    const char* json = R"({
+  "alternatives" : [{
+      "confidence" : 228.123,
+      "text" : "one two"
+    }, {
+      "confidence" : 225.5,
+      "text" : "one to"
+    }]
+})";
+
+    ASSERT_TRUE(m_result.assign(json));
+
+    EXPECT_TRUE(m_result.is_final());
+    EXPECT_EQ(m_result.text(), "one two");
+    EXPECT_FLOAT_EQ(m_result.confidence(), 228.123f);
+    ASSERT_EQ(m_result.alternatives().size(), 2u);
+    EXPECT_EQ(m_result.view(m_result.alternatives()[1].text), "one to");
+}
+
+TEST_F(RecognitionResultTest, SkipsSpeakerVectors) {
+    ASSERT_TRUE(m_result.assign(
+        R"({"spk":[0.1,-0.2,3e-2,null,true],"spk_frames":150,"nested":{"a":[{}],"b":false},"text":"ok"})"));
+
+    EXPECT_TRUE(m_result.is_final());
+    EXPECT_EQ(m_result.text(), "ok");
+}
+
+TEST_F(RecognitionResultTest, UnescapesStrings) {
+    ASSERT_TRUE(m_result.assign(R"({"text":"say \"hi\" \u00e9\ud83d\ude00\\n"})"));
+
+    EXPECT_EQ(m_result.text(), "say \"hi\" \xC3\xA9\xF0\x9F\x98\x80\\n");
+}
+
+TEST_F(RecognitionResultTest, MatchesFullJsonParse) {
+    nlohmann::json doc;
+    doc["text"] = "caf\xC3\xA9 \"quoted\" tab\t";
+    doc["result"] = nlohmann::json::array({{{"word", "caf\xC3\xA9"}, {"conf", 0.5}, {"start", 0.0}, {"end", 0.2}}});
+
+    ASSERT_TRUE(m_result.assign(doc.dump(2), true));
+
+    EXPECT_EQ(m_result.text(), doc["text"].get<std::string>());
+    ASSERT_EQ(m_result.words().size(), 1u);
+    EXPECT_EQ(m_result.view(m_result.words()[0].text), "caf\xC3\xA9");
+}
+
+TEST_F(RecognitionResultTest, EmptyAndMalformedInput) {
+    EXPECT_TRUE(m_result.assign("{}"));
+    EXPECT_EQ(m_result.kind(), recognition_result::result_kind::none);
+    EXPECT_TRUE(m_result.empty());
+
+    EXPECT_TRUE(m_result.assign(""));
+    EXPECT_TRUE(m_result.empty());
+
+    EXPECT_TRUE(m_result.assign(R"({"text":""})"));
+    EXPECT_TRUE(m_result.is_final());
+    EXPECT_TRUE(m_result.empty());
+
+    EXPECT_FALSE(m_result.assign(R"({"text":"unterminated)"));
+    EXPECT_EQ(m_result.kind(), recognition_result::result_kind::none);
+    EXPECT_FALSE(m_result.assign(R"({"text":"a"} trailing)"));
+    EXPECT_FALSE(m_result.assign(R"({"text":"a",})"));
+    EXPECT_FALSE(m_result.assign(R"({"spk":[1,2)"));
+    EXPECT_FALSE(m_result.assign("{\"a\":" + std::string(100, '[') + std::string(100, ']') + "}"));
+}
+
+TEST_F(RecognitionResultTest, ReuseAndCopy) {
+    ASSERT_TRUE(m_result.assign(R"({"text":"first utterance"})"));
+    ASSERT_TRUE(m_result.assign(R"({"partial":"second"})"));
+
+    recognition_result copy = m_result;
+    m_result.assign(R"({"text":"third"})");
+
+    EXPECT_TRUE(copy.is_partial());
+    EXPECT_EQ(copy.text(), "second");
+    EXPECT_EQ(m_result.text(), "third");
+}
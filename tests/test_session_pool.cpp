@@ -0,0 +1,104 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "session_pool.h"
+
+using namespace std::chrono_literals;
+
+using pool_type = session_pool<int>;
+
+TEST(SessionPoolTest, FindsAndInsertsSessions) {
+    pool_type pool(4);
+
+    EXPECT_EQ(pool.find("a"), nullptr);
+    auto [a, inserted] = pool.insert("a", std::make_shared<int>(1));
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(pool.find("a"), a);
+    EXPECT_TRUE(pool.contains("a"));
+    EXPECT_EQ(pool.size(), 1u);
+
+    // A racing insert keeps the first object
+    auto [raced, raced_inserted] = pool.insert("a", std::make_shared<int>(2));
+    EXPECT_FALSE(raced_inserted);
+    EXPECT_EQ(raced, a);
+
+    EXPECT_TRUE(pool.erase("a"));
+    EXPECT_FALSE(pool.erase("a"));
+    EXPECT_EQ(pool.size(), 0u);
+}
+
+TEST(SessionPoolTest, EvictsLeastRecentlyUsed) {
+    pool_type pool(2);
+    auto now = pool_type::clock::now();
+
+    pool.insert("a", std::make_shared<int>(1), now);
+    pool.insert("b", std::make_shared<int>(2), now);
+    EXPECT_EQ(pool.make_room(), "a");
+
+    // Same clock reading: use order still decides
+    pool.insert("a", std::make_shared<int>(1), now);
+    pool.find("b", now);
+    EXPECT_EQ(pool.make_room(), "a");
+    EXPECT_TRUE(pool.contains("b"));
+    EXPECT_EQ(pool.size(), 1u);
+}
+
+TEST(SessionPoolTest, MakeRoomIsNoOpWhileNotFull) {
+    pool_type pool(2);
+    pool.insert("a", std::make_shared<int>(1));
+
+    EXPECT_EQ(pool.make_room(), "");
+    EXPECT_EQ(pool.size(), 1u);
+}
+
+TEST(SessionPoolTest, SkipsSessionsInUse) {
+    pool_type pool(2);
+
+    auto held = pool.insert("a", std::make_shared<int>(1)).first;
+    pool.insert("b", std::make_shared<int>(2));
+
+    // "a" is older but held, so "b" makes room
+    EXPECT_EQ(pool.make_room(), "b");
+    EXPECT_TRUE(pool.contains("a"));
+}
+
+TEST(SessionPoolTest, ThrowsWhenEverySessionIsHeld) {
+    pool_type pool(2);
+
+    auto held_a = pool.insert("a", std::make_shared<int>(1)).first;
+    auto held_b = pool.insert("b", std::make_shared<int>(2)).first;
+    EXPECT_THROW(pool.make_room(), std::runtime_error);
+    EXPECT_EQ(pool.size(), 2u);
+
+    held_b.reset();
+    EXPECT_EQ(pool.make_room(), "b");
+}
+
+TEST(SessionPoolTest, EvictsIdleSessionsNobodyHolds) {
+    pool_type pool(4);
+    auto now = pool_type::clock::now();
+
+    pool.insert("old", std::make_shared<int>(1), now - 10s);
+    auto held = pool.insert("held", std::make_shared<int>(2), now - 10s).first;
+    pool.insert("recent", std::make_shared<int>(3), now);
+
+    auto evicted = pool.evict_idle(now - 5s);
+    ASSERT_EQ(evicted.size(), 1u);
+    EXPECT_EQ(evicted[0], "old");
+    EXPECT_TRUE(pool.contains("held"));
+    EXPECT_TRUE(pool.contains("recent"));
+
+    // Using a session keeps it alive
+    pool.find("held", now);
+    held.reset();
+    EXPECT_TRUE(pool.evict_idle(now - 5s).empty());
+}
@@ -0,0 +1,145 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "slice_feeder.h"
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+class SliceFeederTest : public ::testing::Test {
+protected:
+    // Recognizer stand-in: records the audio per utterance, endpoints once
+    // it has accepted the given number of samples
+    struct fake_recognizer {
+        std::vector<size_t> endpoint_at;
+        std::vector<int16_t> utterance;
+        std::vector<std::vector<int16_t>> finals;
+        size_t accepted = 0;
+        size_t calls = 0;
+
+        int accept(std::span<const int16_t> slice) {
+            calls++;
+            utterance.insert(utterance.end(), slice.begin(), slice.end());
+            size_t before = accepted;
+            accepted += slice.size();
+            for (size_t at : endpoint_at) {
+                if (at > before && at <= accepted) {
+                    return 1;
+                }
+            }
+            return 0;
+        }
+
+        void endpoint() {
+            finals.push_back(std::move(utterance));
+            utterance.clear();
+        }
+    };
+
+    static size_t feed(fake_recognizer& recognizer, std::span<const int16_t> audio, size_t slice) {
+        return feed_slices(audio, slice,
+                           [&](std::span<const int16_t> s) { return recognizer.accept(s); },
+                           [&]() { recognizer.endpoint(); });
+    }
+
+    static std::vector<int16_t> ramp(size_t count) {
+        std::vector<int16_t> audio(count);
+        std::iota(audio.begin(), audio.end(), int16_t{0});
+        return audio;
+    }
+};
+
+TEST_F(SliceFeederTest, FeedsEverySliceWithoutEndpoint) {
+    fake_recognizer recognizer;
+    auto audio = ramp(1000);
+
+    EXPECT_EQ(feed(recognizer, audio, 300), 1000u);
+    EXPECT_EQ(recognizer.calls, 4u);
+    EXPECT_TRUE(recognizer.finals.empty());
+    EXPECT_EQ(recognizer.utterance, audio);
+}
+
+TEST_F(SliceFeederTest, EndpointInsideMergedJobKeepsTheRest) {
+    // Five 20ms frames merged into one job, fed in 50ms slices; the
+    // utterance ends in the second slice
+    fake_recognizer recognizer;
+    recognizer.endpoint_at = {1200};
+    auto audio = ramp(5 * 320);
+
+    size_t tail = feed(recognizer, audio, 800);
+
+    ASSERT_EQ(recognizer.finals.size(), 1u);
+    EXPECT_EQ(recognizer.finals[0], std::vector<int16_t>(audio.begin(), audio.begin() + 1600));
+    EXPECT_EQ(tail, 0u);
+
+    recognizer = {};
+    recognizer.endpoint_at = {700};
+    tail = feed(recognizer, audio, 800);
+
+    // The slice after the endpoint goes to the next utterance, in order
+    ASSERT_EQ(recognizer.finals.size(), 1u);
+    EXPECT_EQ(recognizer.finals[0], std::vector<int16_t>(audio.begin(), audio.begin() + 800));
+    EXPECT_EQ(recognizer.utterance, std::vector<int16_t>(audio.begin() + 800, audio.end()));
+    EXPECT_EQ(tail, 800u);
+}
+
+TEST_F(SliceFeederTest, CollectsSeveralEndpointsInOneCall) {
+    fake_recognizer recognizer;
+    recognizer.endpoint_at = {100, 300};
+    auto audio = ramp(500);
+
+    size_t tail = feed(recognizer, audio, 100);
+
+    ASSERT_EQ(recognizer.finals.size(), 2u);
+    EXPECT_EQ(recognizer.finals[0].size(), 100u);
+    EXPECT_EQ(recognizer.finals[1].size(), 200u);
+    EXPECT_EQ(tail, 200u);
+
+    size_t fed = recognizer.utterance.size();
+    for (const auto& final : recognizer.finals) {
+        fed += final.size();
+    }
+    EXPECT_EQ(fed, audio.size());
+}
+
+TEST_F(SliceFeederTest, ErrorsDoNotStopFeeding) {
+    size_t calls = 0;
+    auto audio = ramp(400);
+
+    size_t tail = feed_slices(std::span<const int16_t>(audio), 100,
+                              [&](std::span<const int16_t>) { calls++; return -1; },
+                              []() { FAIL() << "errors are not endpoints"; });
+
+    EXPECT_EQ(calls, 4u);
+    EXPECT_EQ(tail, 400u);
+}
+
+TEST_F(SliceFeederTest, ZeroSliceFeedsOneSampleAtATime) {
+    fake_recognizer recognizer;
+    auto audio = ramp(3);
+
+    EXPECT_EQ(feed(recognizer, audio, 0), 3u);
+    EXPECT_EQ(recognizer.calls, 3u);
+}
+
+TEST_F(SliceFeederTest, FloatAudio) {
+    std::vector<float> audio(250, 1000.0f);
+    std::vector<size_t> slices;
+
+    size_t tail = feed_slices(std::span<const float>(audio), 100,
+                              [&](std::span<const float> s) { slices.push_back(s.size()); return 0; },
+                              []() {});
+
+    EXPECT_EQ(slices, (std::vector<size_t>{100, 100, 50}));
+    EXPECT_EQ(tail, 250u);
+}
@@ -0,0 +1,187 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "speaker_identifier.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Embedding that encodes the speaker in the first sample of the utterance
+std::vector<float> fake_embedding(VoskModel*, std::span<const int16_t> audio, int& frames) {
+    frames = static_cast<int>(audio.size() / 160);
+    if (audio[0] == 1) {
+        return {1.0f, 0.0f, 0.0f};
+    }
+    return {0.0f, 1.0f, 0.0f};
+}
+
+std::vector<int16_t> utterance(int16_t speaker, size_t samples = 16000) {
+    return std::vector<int16_t>(samples, speaker);
+}
+
+} // namespace
+
+TEST(UtteranceBufferTest, KeepsLatestSamplesInOrder) {
+    utterance_buffer buffer(4);
+
+    std::vector<int16_t> first = {1, 2, 3};
+    buffer.append(first);
+    EXPECT_EQ(buffer.size(), 3u);
+
+    std::vector<int16_t> second = {4, 5, 6};
+    buffer.append(second);
+    EXPECT_EQ(buffer.size(), 4u);
+    EXPECT_EQ(buffer.take(), (std::vector<int16_t>{3, 4, 5, 6}));
+    EXPECT_EQ(buffer.size(), 0u);
+
+    std::vector<int16_t> oversized = {7, 8, 9, 10, 11};
+    buffer.append(oversized);
+    EXPECT_EQ(buffer.take(), (std::vector<int16_t>{8, 9, 10, 11}));
+    EXPECT_EQ(buffer.capacity(), 4u);
+}
+
+TEST(SpeakerTrackerTest, ClustersBySimilarity) {
+    speaker_tracker tracker(0.8, 2);
+    std::vector<float> a = {1.0f, 0.1f};
+    std::vector<float> a2 = {0.9f, 0.0f};
+    std::vector<float> b = {0.0f, 1.0f};
+    std::vector<float> c = {-1.0f, 0.2f};
+
+    double similarity = 0.0;
+    EXPECT_EQ(tracker.assign(a, similarity), "S1");
+    EXPECT_DOUBLE_EQ(similarity, 1.0);
+    EXPECT_EQ(tracker.assign(b, similarity), "S2");
+    EXPECT_EQ(tracker.assign(a2, similarity), "S1");
+    EXPECT_GT(similarity, 0.8);
+
+    // At the speaker limit the closest one is chosen
+    EXPECT_EQ(tracker.assign(c, similarity), "S2");
+    EXPECT_EQ(tracker.speaker_count(), 2u);
+}
+
+TEST(SpeakerTrackerTest, Cosine) {
+    std::vector<float> a = {1.0f, 0.0f};
+    std::vector<float> b = {0.0f, 2.0f};
+    std::vector<float> zero = {0.0f, 0.0f};
+    std::vector<float> other = {1.0f};
+
+    EXPECT_DOUBLE_EQ(speaker_tracker::cosine(a, a), 1.0);
+    EXPECT_DOUBLE_EQ(speaker_tracker::cosine(a, b), 0.0);
+    EXPECT_DOUBLE_EQ(speaker_tracker::cosine(a, zero), 0.0);
+    EXPECT_DOUBLE_EQ(speaker_tracker::cosine(a, other), 0.0);
+}
+
+TEST(SpeakerIdentifierTest, LabelsUtterancesAsynchronously) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<speaker_identifier::label> labels;
+
+    speaker_identifier::config cfg;
+    cfg.threads = 2;
+    speaker_identifier speakers(cfg, [&](const speaker_identifier::label& label) {
+        std::lock_guard<std::mutex> lock(mutex);
+        labels.push_back(label);
+        cv.notify_all();
+    }, fake_embedding);
+    EXPECT_EQ(speakers.get_thread_count(), 2u);
+
+    auto alice = utterance(1);
+    auto bob = utterance(2);
+
+    speakers.append("call", alice);
+    EXPECT_EQ(speakers.end_utterance("call", nullptr), 1u);
+
+    // Wait for each label so the tracker sees the utterances in order
+    auto wait_for = [&](size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(5), [&] { return labels.size() >= count; });
+    };
+    ASSERT_TRUE(wait_for(1));
+
+    speakers.append("call", bob);
+    EXPECT_EQ(speakers.end_utterance("call", nullptr), 2u);
+    ASSERT_TRUE(wait_for(2));
+
+    speakers.append("call", alice);
+    EXPECT_EQ(speakers.end_utterance("call", nullptr, "see you then"), 3u);
+    ASSERT_TRUE(wait_for(3));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(labels[0].speaker, "S1");
+        EXPECT_EQ(labels[1].speaker, "S2");
+        EXPECT_EQ(labels[2].speaker, "S1");
+        EXPECT_EQ(labels[2].utterance_id, 3u);
+        EXPECT_EQ(labels[2].text, "see you then");
+        EXPECT_TRUE(labels[0].text.empty());
+        EXPECT_EQ(labels[2].session_id, "call");
+        EXPECT_EQ(labels[2].frames, 100);
+    }
+
+    auto recent = speakers.recent_labels("call");
+    ASSERT_EQ(recent.size(), 3u);
+    EXPECT_EQ(recent.front().utterance_id, 1u);
+    EXPECT_EQ(recent.back().text, "see you then");
+    EXPECT_EQ(speakers.get_labelled_count(), 3u);
+
+    speakers.release_session("call");
+    EXPECT_TRUE(speakers.recent_labels("call").empty());
+}
+
+TEST(SpeakerIdentifierTest, SkipsShortAndOverflowingUtterances) {
+    std::mutex gate;
+    gate.lock();
+    std::atomic<bool> started{false};
+
+    speaker_identifier::config cfg;
+    cfg.max_pending = 1;
+    speaker_identifier speakers(cfg, nullptr, [&](VoskModel* model, std::span<const int16_t> audio, int& frames) {
+        started = true;
+        std::lock_guard<std::mutex> lock(gate);
+        return fake_embedding(model, audio, frames);
+    });
+
+    // Under min_utterance_ms: counted but never queued
+    auto blip = utterance(1, 1600);
+    speakers.append("s", blip);
+    EXPECT_EQ(speakers.end_utterance("s", nullptr), 1u);
+    EXPECT_EQ(speakers.get_short_count(), 1u);
+
+    // The first utterance occupies the worker, the second fills the queue
+    auto speech = utterance(1);
+    speakers.append("s", speech);
+    speakers.end_utterance("s", nullptr);
+    while (!started) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    speakers.append("s", speech);
+    speakers.end_utterance("s", nullptr);
+    speakers.append("s", speech);
+    EXPECT_EQ(speakers.end_utterance("s", nullptr), 4u);
+    EXPECT_EQ(speakers.get_skipped_count(), 1u);
+
+    gate.unlock();
+    speakers.stop();
+    EXPECT_EQ(speakers.get_pending(), 0u);
+}
+
+TEST(SpeakerIdentifierTest, RejectsZeroThreads) {
+    speaker_identifier::config cfg;
+    cfg.threads = 0;
+    EXPECT_THROW(speaker_identifier(cfg, nullptr, fake_embedding), std::invalid_argument);
+}
@@ -0,0 +1,146 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "spsc_ring.h"
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <cstdint>
+
+TEST(SpscRingTest, RejectsZeroCapacity) {
+    EXPECT_THROW(spsc_ring<int16_t>(0), std::invalid_argument);
+}
+
+TEST(SpscRingTest, WriteReadRelease) {
+    spsc_ring<int16_t> ring(8);
+    const int16_t data[] = {1, 2, 3, 4, 5};
+
+    EXPECT_TRUE(ring.try_write(data, 5));
+    EXPECT_EQ(ring.read_available(), 5u);
+
+    auto span = ring.read_span(3);
+    ASSERT_EQ(span.size(), 3u);
+    EXPECT_EQ(span[0], 1);
+    EXPECT_EQ(span[2], 3);
+    ring.release(span.size());
+
+    span = ring.read_span(10);
+    ASSERT_EQ(span.size(), 2u);
+    EXPECT_EQ(span[1], 5);
+    ring.release(span.size());
+
+    EXPECT_EQ(ring.read_available(), 0u);
+    EXPECT_TRUE(ring.read_span(4).empty());
+}
+
+TEST(SpscRingTest, WriteIsAllOrNothing) {
+    spsc_ring<int16_t> ring(4);
+    const int16_t data[] = {1, 2, 3};
+
+    EXPECT_TRUE(ring.try_write(data, 3));
+    EXPECT_FALSE(ring.try_write(data, 2));
+    EXPECT_EQ(ring.read_available(), 3u);
+
+    ring.release(ring.read_span(2).size());
+    EXPECT_TRUE(ring.try_write(data, 2));
+    EXPECT_EQ(ring.read_available(), 3u);
+}
+
+TEST(SpscRingTest, WrapAroundSplitsSpans) {
+    spsc_ring<int16_t> ring(5);
+    const int16_t first[] = {1, 2, 3, 4};
+    const int16_t second[] = {5, 6, 7};
+
+    ASSERT_TRUE(ring.try_write(first, 4));
+    ring.release(ring.read_span(3).size());
+    ASSERT_TRUE(ring.try_write(second, 3));
+
+    // 4 at index 3, 5 at index 4, then 6 and 7 wrapped to the start
+    auto span = ring.read_span(4);
+    ASSERT_EQ(span.size(), 2u);
+    EXPECT_EQ(span[0], 4);
+    EXPECT_EQ(span[1], 5);
+    ring.release(span.size());
+
+    span = ring.read_span(4);
+    ASSERT_EQ(span.size(), 2u);
+    EXPECT_EQ(span[0], 6);
+    EXPECT_EQ(span[1], 7);
+}
+
+TEST(SpscRingTest, ChunkMultipleCapacityKeepsChunksContiguous) {
+    const size_t chunk = 6;
+    spsc_ring<int16_t> ring(chunk * 3);
+    const int16_t data[] = {0, 1, 2, 3};
+
+    // Producer writes in sizes unrelated to the chunk size
+    size_t chunks_read = 0;
+    for (int i = 0; i < 50; ++i) {
+        ring.try_write(data, 4);
+        for (auto span = ring.read_span(chunk); span.size() == chunk; span = ring.read_span(chunk)) {
+            ring.release(chunk);
+            chunks_read++;
+        }
+    }
+
+    EXPECT_EQ(chunks_read, 50u * 4 / chunk);
+}
+
+TEST(SpscRingTest, DiscardDropsReadableData) {
+    spsc_ring<int16_t> ring(8);
+    const int16_t data[] = {1, 2, 3};
+
+    ring.try_write(data, 3);
+    ring.discard();
+
+    EXPECT_EQ(ring.read_available(), 0u);
+    EXPECT_TRUE(ring.try_write(data, 3));
+    EXPECT_EQ(ring.read_span(8)[0], 1);
+}
+
+TEST(SpscRingTest, ConcurrentProducerConsumerPreservesOrder) {
+    spsc_ring<int32_t> ring(1000);
+    const int32_t total = 200000;
+
+    std::thread producer([&ring] {
+        int32_t block[7];
+        int32_t next = 0;
+        while (next < total) {
+            int32_t n = std::min<int32_t>(7, total - next);
+            std::iota(block, block + n, next);
+            if (ring.try_write(block, static_cast<size_t>(n))) {
+                next += n;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int32_t expected = 0;
+    bool in_order = true;
+    while (expected < total) {
+        auto span = ring.read_span(64);
+        if (span.empty()) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (int32_t v : span) {
+            in_order = in_order && (v == expected);
+            expected++;
+        }
+        ring.release(span.size());
+    }
+
+    producer.join();
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(ring.read_available(), 0u);
+}
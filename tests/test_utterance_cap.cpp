@@ -0,0 +1,90 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "utterance_cap.h"
+
+using namespace std::chrono_literals;
+
+class UtteranceCapTest : public ::testing::Test {
+protected:
+    utterance_cap::clock::time_point t0 = utterance_cap::clock::now();
+
+    static bool pending() { return true; }
+    static bool nothing_pending() { return false; }
+};
+
+TEST_F(UtteranceCapTest, KeepsDecodingUnderTheCap) {
+    utterance_cap cap(1000, t0);
+
+    EXPECT_EQ(cap.after_decode(t0 + 500ms, false, false, pending), utterance_cap::action::none);
+    EXPECT_TRUE(cap.open());
+    EXPECT_EQ(cap.elapsed_ms(t0 + 500ms), 500);
+}
+
+TEST_F(UtteranceCapTest, FinalizesLongUtteranceWithText) {
+    utterance_cap cap(1000, t0);
+
+    EXPECT_EQ(cap.after_decode(t0 + 1000ms, false, false, pending), utterance_cap::action::cap_reached);
+
+    // The cap restarts from that chunk
+    EXPECT_EQ(cap.after_decode(t0 + 1500ms, false, false, pending), utterance_cap::action::none);
+    EXPECT_EQ(cap.after_decode(t0 + 2000ms, false, false, pending), utterance_cap::action::cap_reached);
+}
+
+TEST_F(UtteranceCapTest, SkipsEmptyUtterances) {
+    utterance_cap cap(1000, t0);
+    int queried = 0;
+    auto counted = [&]() { queried++; return false; };
+
+    EXPECT_EQ(cap.after_decode(t0 + 100ms, false, false, counted), utterance_cap::action::none);
+    EXPECT_EQ(queried, 0);
+
+    // Silence only restarts the cap
+    EXPECT_EQ(cap.after_decode(t0 + 1200ms, false, false, counted), utterance_cap::action::none);
+    EXPECT_EQ(queried, 1);
+    EXPECT_EQ(cap.elapsed_ms(t0 + 1200ms), 0);
+}
+
+TEST_F(UtteranceCapTest, ModelEndpointRestartsCap) {
+    utterance_cap cap(1000, t0);
+
+    EXPECT_EQ(cap.after_decode(t0 + 600ms, false, false, pending), utterance_cap::action::none);
+    EXPECT_EQ(cap.after_decode(t0 + 900ms, true, true, pending), utterance_cap::action::none);
+    EXPECT_FALSE(cap.open());
+
+    // 1200ms since the first chunk, but only 300ms into the new utterance
+    EXPECT_EQ(cap.after_decode(t0 + 1200ms, false, false, pending), utterance_cap::action::none);
+    EXPECT_TRUE(cap.open());
+}
+
+TEST_F(UtteranceCapTest, SpeechEndFinalizesBeforeTheCap) {
+    utterance_cap cap(1000, t0);
+
+    EXPECT_EQ(cap.after_decode(t0 + 300ms, false, true, nothing_pending), utterance_cap::action::speech_ended);
+
+    // A reached cap takes precedence and restarts
+    EXPECT_EQ(cap.after_decode(t0 + 1300ms, false, true, pending), utterance_cap::action::cap_reached);
+}
+
+TEST_F(UtteranceCapTest, CloseAndRestart) {
+    utterance_cap cap(1000, t0);
+    cap.after_decode(t0 + 100ms, false, false, pending);
+
+    cap.restart(t0 + 800ms);
+    EXPECT_TRUE(cap.open());
+    EXPECT_EQ(cap.after_decode(t0 + 1500ms, false, false, pending), utterance_cap::action::none);
+
+    cap.close(t0 + 1600ms);
+    EXPECT_FALSE(cap.open());
+    EXPECT_EQ(cap.elapsed_ms(t0 + 1700ms), 100);
+    EXPECT_EQ(cap.max_ms(), 1000);
+}
@@ -0,0 +1,197 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "voice_activity_detector.h"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+class VoiceActivityDetectorTest : public ::testing::Test {
+protected:
+    static constexpr int sample_rate = 16000;
+
+    static std::vector<int16_t> tone(size_t samples, double amplitude, double frequency = 220.0) {
+        std::vector<int16_t> out(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            out[i] = static_cast<int16_t>(amplitude * std::sin(2.0 * M_PI * frequency * i / sample_rate));
+        }
+        return out;
+    }
+
+    static std::vector<int16_t> noise(size_t samples, int amplitude, unsigned seed = 42) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(-amplitude, amplitude);
+        std::vector<int16_t> out(samples);
+        for (auto& s : out) {
+            s = static_cast<int16_t>(dist(rng));
+        }
+        return out;
+    }
+
+    static std::vector<int16_t> silence(size_t samples) {
+        return std::vector<int16_t>(samples, 0);
+    }
+};
+
+TEST_F(VoiceActivityDetectorTest, RejectsInvalidConfig) {
+    voice_activity_detector::config cfg;
+    cfg.sample_rate = 0;
+    EXPECT_THROW(voice_activity_detector{cfg}, std::invalid_argument);
+
+    cfg.sample_rate = 16000;
+    cfg.frame_ms = 0;
+    EXPECT_THROW(voice_activity_detector{cfg}, std::invalid_argument);
+}
+
+TEST_F(VoiceActivityDetectorTest, AnalyzeFeatures) {
+    auto quiet = voice_activity_detector::analyze(silence(320));
+    EXPECT_LT(quiet.energy_db, -100.0);
+    EXPECT_FLOAT_EQ(quiet.zero_crossing_rate, 0.0f);
+
+    // Full-scale square wave: 0 dBFS, one crossing every other sample
+    std::vector<int16_t> square(320);
+    for (size_t i = 0; i < square.size(); ++i) {
+        square[i] = (i % 2) ? -32767 : 32767;
+    }
+    auto loud = voice_activity_detector::analyze(square);
+    EXPECT_NEAR(loud.energy_db, 0.0, 0.01);
+    EXPECT_NEAR(loud.zero_crossing_rate, 319.0f / 320.0f, 1e-6);
+}
+
+TEST_F(VoiceActivityDetectorTest, AnalyzeHandlesOddLengths) {
+    // Lengths that exercise both the vector body and the scalar tail
+    for (size_t n : {1u, 31u, 32u, 33u, 65u, 319u}) {
+        auto frame = noise(n, 20000, static_cast<unsigned>(n));
+
+        double sum = 0.0;
+        size_t crossings = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += static_cast<double>(frame[i]) * frame[i];
+            if (i > 0 && ((frame[i - 1] < 0) != (frame[i] < 0))) {
+                crossings++;
+            }
+        }
+        double expected_db = 10.0 * std::log10(sum / n / (32768.0 * 32768.0) + 1e-12);
+
+        auto features = voice_activity_detector::analyze(frame);
+        EXPECT_NEAR(features.energy_db, expected_db, 1e-9) << "n=" << n;
+        EXPECT_FLOAT_EQ(features.zero_crossing_rate, static_cast<float>(crossings) / n) << "n=" << n;
+    }
+}
+
+TEST_F(VoiceActivityDetectorTest, SilenceIsNotSpeech) {
+    voice_activity_detector vad;
+    for (int i = 0; i < 10; ++i) {
+        auto d = vad.process(silence(1600));
+        EXPECT_FALSE(d.speech);
+        EXPECT_FALSE(d.endpoint);
+    }
+    EXPECT_FALSE(vad.in_speech());
+}
+
+TEST_F(VoiceActivityDetectorTest, ToneIsSpeech) {
+    voice_activity_detector vad;
+    vad.process(silence(1600));
+
+    auto d = vad.process(tone(1600, 8000.0));
+    EXPECT_TRUE(d.speech);
+    EXPECT_TRUE(vad.in_speech());
+    EXPECT_EQ(vad.frame_decisions().size(), 5u);
+}
+
+TEST_F(VoiceActivityDetectorTest, QuietBroadbandNoiseIsRejected) {
+    voice_activity_detector vad;
+
+    // About -35 dBFS: above the threshold, but crossing zero every other sample
+    std::vector<int16_t> hiss(1600);
+    for (size_t i = 0; i < hiss.size(); ++i) {
+        hiss[i] = (i % 2) ? -600 : 600;
+    }
+    EXPECT_FALSE(vad.process(hiss).speech);
+}
+
+TEST_F(VoiceActivityDetectorTest, HangoverThenEndpoint) {
+    voice_activity_detector::config cfg;
+    cfg.hangover_ms = 100;
+    voice_activity_detector vad(cfg);
+
+    ASSERT_TRUE(vad.process(tone(3200, 8000.0)).speech);
+
+    // 60 ms of silence stays inside the hangover
+    auto d = vad.process(silence(960));
+    EXPECT_TRUE(d.speech);
+    EXPECT_FALSE(d.endpoint);
+    EXPECT_TRUE(vad.in_speech());
+
+    // Hangover runs out: the endpoint is reported exactly once
+    d = vad.process(silence(1600));
+    EXPECT_TRUE(d.endpoint);
+    EXPECT_FALSE(vad.in_speech());
+
+    d = vad.process(silence(1600));
+    EXPECT_FALSE(d.speech);
+    EXPECT_FALSE(d.endpoint);
+}
+
+TEST_F(VoiceActivityDetectorTest, ShortClickDoesNotStartUtterance) {
+    voice_activity_detector vad;
+
+    // A single loud frame in silence is below min_speech_ms
+    auto chunk = silence(1600);
+    auto click = tone(320, 20000.0);
+    std::copy(click.begin(), click.end(), chunk.begin() + 640);
+
+    EXPECT_FALSE(vad.process(chunk).speech);
+}
+
+TEST_F(VoiceActivityDetectorTest, PartialFramesCarryOver) {
+    voice_activity_detector vad;
+    auto speech = tone(3200, 8000.0);
+
+    // Odd-sized pieces add up to the same number of frames as one call
+    size_t frames = 0;
+    bool speech_seen = false;
+    for (size_t pos = 0; pos < speech.size(); pos += 117) {
+        size_t n = std::min<size_t>(117, speech.size() - pos);
+        auto d = vad.process(std::span<const int16_t>(speech.data() + pos, n));
+        frames += vad.frame_decisions().size();
+        speech_seen = speech_seen || d.speech;
+    }
+
+    EXPECT_EQ(frames, speech.size() / vad.frame_samples());
+    EXPECT_TRUE(speech_seen);
+}
+
+TEST_F(VoiceActivityDetectorTest, NoiseFloorAdapts) {
+    voice_activity_detector vad;
+    double initial = vad.noise_floor_db();
+
+    // Steady low-level noise raises the floor, so it stays silence
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_FALSE(vad.process(noise(1600, 100)).speech);
+    }
+    EXPECT_GT(vad.noise_floor_db(), initial);
+
+    // Speech well above the floor is still detected
+    EXPECT_TRUE(vad.process(tone(1600, 8000.0)).speech);
+}
+
+TEST_F(VoiceActivityDetectorTest, ResetClearsUtterance) {
+    voice_activity_detector vad;
+    vad.process(tone(1600, 8000.0));
+    ASSERT_TRUE(vad.in_speech());
+
+    vad.reset();
+    EXPECT_FALSE(vad.in_speech());
+    EXPECT_FALSE(vad.process(silence(1600)).endpoint);
+}
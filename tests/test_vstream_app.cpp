@@ -341,6 +341,44 @@ TEST_F(VStreamAppTest, Statistics) {
     }
 }
 
+// Test drain requests and the health summary
+TEST_F(VStreamAppTest, DrainAndHealth) {
+    auto cfg = create_valid_config();
+    EXPECT_EQ(cfg.drain_timeout_ms, 30000);
+
+    try {
+        app = std::make_unique<vstream_app>(cfg);
+
+        auto health = app->get_health();
+        EXPECT_EQ(health["status"], "ok");
+        EXPECT_EQ(health["active_sessions"], 0);
+        EXPECT_TRUE(health.contains("queue_depth"));
+        EXPECT_FALSE(app->is_draining());
+
+        app->request_drain();
+        EXPECT_TRUE(app->is_draining());
+        EXPECT_EQ(app->get_health()["status"], "draining");
+        EXPECT_TRUE(app->get_stats()["draining"]);
+
+    } catch (const std::runtime_error& e) {
+        // Expected if Vosk models aren't available
+        EXPECT_THAT(std::string(e.what()), HasSubstr("model"));
+    }
+
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--drain-timeout-ms", "5000"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+    cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.drain_timeout_ms, 5000);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg.drain_timeout_ms = -1;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
 // Test microphone configuration - expect it might not work in test environment
 TEST_F(VStreamAppTest, MicrophoneConfiguration) {
     auto cfg = create_valid_config();
@@ -429,7 +467,8 @@ TEST_F(VStreamAppTest, ConfigurationDefaults) {
     EXPECT_EQ(cfg.port, 8080);
     EXPECT_EQ(cfg.sample_rate, 16000);
     EXPECT_EQ(cfg.buffer_ms, 100);
-    EXPECT_EQ(cfg.finalize_ms, 2000);
+    EXPECT_EQ(cfg.finalize_ms, 15000);
+    EXPECT_EQ(cfg.endpoint_mode, "default");
     EXPECT_EQ(cfg.max_alternatives, 0);
     EXPECT_EQ(cfg.mic_device, -1);
     EXPECT_EQ(cfg.log_level, 0);
@@ -481,6 +520,342 @@ TEST_F(VStreamAppTest, BenchmarkValidation) {
     }
 }
 
+// Test session pool options
+TEST_F(VStreamAppTest, SessionPoolConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--max-sessions", "16",
+        "--session-idle-ms", "5000"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.max_sessions, 16u);
+    EXPECT_EQ(cfg.session_idle_ms, 5000);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    // Idle eviction can be disabled
+    cfg.session_idle_ms = 0;
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg.session_idle_ms = -1;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+
+    cfg = create_valid_config();
+    cfg.max_sessions = 0;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+// Test decoder backend selection
+TEST_F(VStreamAppTest, BackendConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--backend", "gpu",
+        "--gpu-batch", "128",
+        "--gpu-wait-ms", "5"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.backend, "gpu");
+    EXPECT_EQ(cfg.gpu_batch_size, 128u);
+    EXPECT_EQ(cfg.gpu_batch_wait_ms, 5);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    // Features the batch recognizer lacks are rejected up front
+    cfg.grammar = "[\"yes\", \"no\"]";
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+
+    cfg = create_valid_config();
+    EXPECT_EQ(cfg.backend, "cpu");
+    cfg.backend = "tpu";
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+
+    cfg = create_valid_config();
+    cfg.gpu_batch_size = 0;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+// Test partial result cadence options
+TEST_F(VStreamAppTest, PartialResultConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--partial-ms", "500",
+        "--partials-opt-in"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.partial_interval_ms, 500);
+    EXPECT_TRUE(cfg.partials_opt_in);
+    EXPECT_TRUE(cfg.enable_partial_words);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg = create_valid_config();
+    EXPECT_EQ(cfg.partial_interval_ms, 200);
+    EXPECT_FALSE(cfg.partials_opt_in);
+
+    cfg.partial_interval_ms = 0;
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg.partial_interval_ms = -1;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+// Test microphone capture format options
+TEST_F(VStreamAppTest, MicrophoneFormatConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--mic",
+        "--mic-rate", "44100",
+        "--mic-channels", "2",
+        "--mic-split-channels"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.mic_rate, 44100);
+    EXPECT_EQ(cfg.mic_channels, 2);
+    EXPECT_TRUE(cfg.mic_split_channels);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg = create_valid_config();
+    EXPECT_EQ(cfg.mic_rate, 0);
+    EXPECT_EQ(cfg.mic_channels, 1);
+    EXPECT_FALSE(cfg.mic_split_channels);
+
+    cfg.mic_rate = 4000;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+
+    cfg = create_valid_config();
+    cfg.mic_channels = 0;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+// Test local socket transport options
+TEST_F(VStreamAppTest, LocalSocketConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--local-socket", "/run/vstream.sock"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.local_socket, "/run/vstream.sock");
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg = create_valid_config();
+    EXPECT_TRUE(cfg.local_socket.empty());
+
+    cfg.local_socket = "/tmp/" + std::string(120, 's');
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+TEST_F(VStreamAppTest, BenchmarkSegmentsConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--benchmark-live",
+        "--benchmark-segments", "/tmp/segments.csv"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.benchmark_segments_file, "/tmp/segments.csv");
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg.benchmark_enabled = false;
+    cfg.benchmark_live = false;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+TEST_F(VStreamAppTest, SpeakerThreadsConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--spk-model", "/path/to/spk",
+        "--spk-threads", "2"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.speaker_model_path, "/path/to/spk");
+    EXPECT_EQ(cfg.spk_threads, 2u);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg = create_valid_config();
+    EXPECT_EQ(cfg.spk_threads, 1u);
+
+    cfg.spk_threads = 0;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+// Test overload protection options
+TEST_F(VStreamAppTest, LoadSheddingConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--max-session-queue", "0",
+        "--no-load-shedding"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.max_session_queue, 0u);
+    EXPECT_FALSE(cfg.load_shedding);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg = create_valid_config();
+    EXPECT_EQ(cfg.max_session_queue, 50u);
+    EXPECT_TRUE(cfg.load_shedding);
+
+    cfg.max_session_queue = 1000000;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+// Test NUMA and huge page options
+TEST_F(VStreamAppTest, MemoryPlacementConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--numa", "replicate",
+        "--huge-pages"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.numa_mode, "replicate");
+    EXPECT_TRUE(cfg.huge_pages);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg.numa_mode = "interleave";
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg.numa_mode = "spread";
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+
+    cfg = create_valid_config();
+    EXPECT_EQ(cfg.numa_mode, "off");
+    EXPECT_FALSE(cfg.huge_pages);
+}
+
+// Test adaptive chunk options
+TEST_F(VStreamAppTest, AdaptiveChunkConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--latency-target-ms", "300",
+        "--no-adaptive-chunks"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.latency_target_ms, 300);
+    EXPECT_FALSE(cfg.adaptive_chunks);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg = create_valid_config();
+    EXPECT_TRUE(cfg.adaptive_chunks);
+    EXPECT_EQ(cfg.latency_target_ms, 0);
+
+    cfg.latency_target_ms = -1;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+// Test endpointing options
+TEST_F(VStreamAppTest, EndpointConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--endpoint-mode", "short",
+        "--endpoint-silence-ms", "300",
+        "--endpoint-max-ms", "10000"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.endpoint_mode, "short");
+    EXPECT_EQ(cfg.endpoint_start_ms, 0);
+    EXPECT_EQ(cfg.endpoint_silence_ms, 300);
+    EXPECT_EQ(cfg.endpoint_max_ms, 10000);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg.endpoint_mode = "sometimes";
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+
+    cfg = create_valid_config();
+    cfg.endpoint_silence_ms = -1;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+// Test the named model list option
+TEST_F(VStreamAppTest, ModelsConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--models", "/etc/vstream/models.json"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.models_file, "/etc/vstream/models.json");
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg.input_path = "/data/archive";
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+
+    EXPECT_TRUE(create_valid_config().models_file.empty());
+}
+
+// Test grammar cache sizing
+TEST_F(VStreamAppTest, GrammarCacheConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--grammar-cache", "0"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.grammar_cache_size, 0u);
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    cfg = create_valid_config();
+    EXPECT_EQ(cfg.grammar_cache_size, 16u);
+
+    cfg.grammar_cache_size = 5000;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
+// Test offline file transcription options
+TEST_F(VStreamAppTest, FileTranscriptionConfiguration) {
+    const char* argv[] = {
+        "vstream",
+        "--model", "/path/to/model",
+        "--input", "/data/archive",
+        "--output-dir", "/tmp/transcripts"
+    };
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto cfg = vstream_app::parse_command_line(argc, const_cast<char**>(argv));
+    EXPECT_EQ(cfg.input_path, "/data/archive");
+    EXPECT_EQ(cfg.transcript_dir, "/tmp/transcripts");
+    EXPECT_NO_THROW(vstream_app::validate_config(cfg));
+
+    // Files and the microphone are exclusive inputs
+    cfg.use_mic = true;
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+
+    cfg = create_valid_config();
+    cfg.transcript_dir = "/tmp/transcripts";
+    EXPECT_THROW(vstream_app::validate_config(cfg), std::invalid_argument);
+}
+
 // Test stop functionality
 TEST_F(VStreamAppTest, StopFunctionality) {
     auto cfg = create_valid_config();
@@ -503,6 +878,24 @@ TEST_F(VStreamAppTest, StopFunctionality) {
     }
 }
 
+// Test model reload before the engine is running
+TEST_F(VStreamAppTest, ModelReloadRequiresEngine) {
+    auto cfg = create_valid_config();
+
+    try {
+        app = std::make_unique<vstream_app>(cfg);
+
+        // Nothing to swap into yet, and a pending SIGHUP is only a flag
+        EXPECT_FALSE(app->reload_model(cfg.model_path));
+        app->request_model_reload();
+        EXPECT_FALSE(app->get_stats().contains("model_generation"));
+
+    } catch (const std::runtime_error& e) {
+        // Expected if models aren't available
+        EXPECT_THAT(std::string(e.what()), HasSubstr("model"));
+    }
+}
+
 // Test concurrent access to statistics
 TEST_F(VStreamAppTest, ConcurrentStatistics) {
     auto cfg = create_valid_config();
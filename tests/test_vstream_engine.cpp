@@ -12,9 +12,12 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "vstream_engine.h"
+#include "partial_cadence.h"
+#include "session_pool.h"
 #include <thread>
 #include <chrono>
 #include <random>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 
 using ::testing::_;
@@ -55,13 +58,15 @@ public:
         bool enable_partial_words = true;
         int max_alternatives = 0;
         std::string speaker_model_path;
+        int partial_interval_ms = 0;
+        size_t max_sessions = 64;
     };
 
     explicit testable_vstream_engine(const std::string& model_path)
         : testable_vstream_engine(model_path, config{}) {}
 
     explicit testable_vstream_engine(const std::string& model_path, const config& cfg)
-        : m_model_path(model_path), m_config(cfg) {
+        : m_model_path(model_path), m_config(cfg), m_sessions(cfg.max_sessions) {
 
         if (model_path.empty() || model_path == "invalid") {
             throw std::runtime_error("Failed to load Vosk model from: " + model_path);
@@ -69,60 +74,55 @@ public:
 
         // Simulate successful initialization
         m_initialized = true;
+        m_cadence.configure(true, interval_samples());
     }
 
     ~testable_vstream_engine() = default;
 
+    // Per-session decoder state, as pooled by the real engine
+    struct session_state {
+        partial_cadence cadence;
+    };
+
     std::string process_audio(const std::vector<int16_t>& audio_data, bool is_final = false) {
         std::lock_guard<std::mutex> lock(m_mutex);
+        return decode(audio_data, is_final, m_cadence);
+    }
 
-        if (!m_initialized) {
-            return "{}";
-        }
+    std::string process_audio(const std::string& session_id,
+                              const std::vector<int16_t>& audio_data, bool is_final = false) {
+        auto session = acquire_session(session_id);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return decode(audio_data, is_final, session->cadence);
+    }
 
-        m_total_samples += audio_data.size();
+    // Pooled like vstream_engine::acquire_session()
+    std::shared_ptr<session_state> acquire_session(const std::string& session_id) {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
 
-        // Simulate different types of results based on test scenarios
-        if (audio_data.empty() && !is_final) {
-            return "{}";
+        if (auto found = m_sessions.find(session_id)) {
+            return found;
         }
+        m_sessions.make_room();
 
-        if (is_final || m_force_final) {
-            // Return a final result
-            json result;
-            result["text"] = m_test_text.empty() ? "test final result" : m_test_text;
-
-            if (m_config.enable_word_times) {
-                result["result"] = json::array({
-                    {{"word", "test"}, {"start", 0.0}, {"end", 0.5}},
-                    {{"word", "final"}, {"start", 0.5}, {"end", 1.0}},
-                    {{"word", "result"}, {"start", 1.0}, {"end", 1.5}}
-                });
-            }
-
-            if (m_config.max_alternatives > 0) {
-                json alternatives = json::array();
-                for (int i = 0; i < m_config.max_alternatives; ++i) {
-                    alternatives.push_back({
-                        {"text", "alternative " + std::to_string(i + 1)},
-                        {"confidence", 0.9 - i * 0.1}
-                    });
-                }
-                result["alternatives"] = alternatives;
-            }
+        auto created = std::make_shared<session_state>();
+        created->cadence.configure(true, interval_samples());
+        return m_sessions.insert(session_id, created).first;
+    }
 
-            if (m_config.enable_speaker_id) {
-                result["spk"] = json::array({0.1, -0.2, 0.3, 0.4, -0.5});
-                result["spk_frames"] = 150;
-            }
+    void release_session(const std::string& session_id) {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        m_sessions.erase(session_id);
+    }
 
-            return result.dump();
-        }
+    bool has_session(const std::string& session_id) const {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        return m_sessions.contains(session_id);
+    }
 
-        // Return partial result
-        json partial;
-        partial["partial"] = m_test_partial.empty() ? "test partial" : m_test_partial;
-        return partial.dump();
+    size_t get_session_count() const {
+        std::lock_guard<std::mutex> lock(m_sessions_mutex);
+        return m_sessions.size();
     }
 
     void reset() {
@@ -168,11 +168,77 @@ public:
     bool is_nlsml_enabled() const { return m_nlsml_enabled; }
 
 private:
+    size_t interval_samples() const {
+        return static_cast<size_t>(std::max(0, m_config.partial_interval_ms)) * m_config.sample_rate / 1000;
+    }
+
+    // Cadence decisions are the real stream's (partial_cadence)
+    std::string decode(const std::vector<int16_t>& audio_data, bool is_final, partial_cadence& cadence) {
+        if (!m_initialized) {
+            return "{}";
+        }
+
+        m_total_samples += audio_data.size();
+
+        // Simulate different types of results based on test scenarios
+        if (audio_data.empty() && !is_final) {
+            return "{}";
+        }
+
+        if (is_final || m_force_final) {
+            cadence.reset();
+
+            // Return a final result
+            json result;
+            result["text"] = m_test_text.empty() ? "test final result" : m_test_text;
+
+            if (m_config.enable_word_times) {
+                result["result"] = json::array({
+                    {{"word", "test"}, {"start", 0.0}, {"end", 0.5}},
+                    {{"word", "final"}, {"start", 0.5}, {"end", 1.0}},
+                    {{"word", "result"}, {"start", 1.0}, {"end", 1.5}}
+                });
+            }
+
+            if (m_config.max_alternatives > 0) {
+                json alternatives = json::array();
+                for (int i = 0; i < m_config.max_alternatives; ++i) {
+                    alternatives.push_back({
+                        {"text", "alternative " + std::to_string(i + 1)},
+                        {"confidence", 0.9 - i * 0.1}
+                    });
+                }
+                result["alternatives"] = alternatives;
+            }
+
+            if (m_config.enable_speaker_id) {
+                result["spk"] = json::array({0.1, -0.2, 0.3, 0.4, -0.5});
+                result["spk_frames"] = 150;
+            }
+
+            return result.dump();
+        }
+
+        // Return partial result, once per partial_interval_ms of audio
+        cadence.add(audio_data.size());
+        if (!cadence.due(false)) {
+            return "{}";
+        }
+
+        json partial;
+        partial["partial"] = m_test_partial.empty() ? "test partial" : m_test_partial;
+        return partial.dump();
+    }
+
     std::string m_model_path;
     config m_config;
     mutable std::mutex m_mutex;
     std::atomic<size_t> m_total_samples{0};
     bool m_initialized = false;
+    partial_cadence m_cadence;
+
+    session_pool<session_state> m_sessions;
+    mutable std::mutex m_sessions_mutex;
 
     // Test state
     std::string m_test_text;
@@ -423,6 +489,95 @@ TEST_F(VStreamEngineTest, PartialResultDetection) {
     EXPECT_TRUE(engine->has_partial_result());
 }
 
+// Test partial cadence by audio duration
+TEST_F(VStreamEngineTest, PartialCadenceFollowsAudioDuration) {
+    testable_vstream_engine::config cfg;
+    cfg.partial_interval_ms = 200;  // 3200 samples at 16kHz
+    engine = std::make_unique<testable_vstream_engine>("/path/to/model", cfg);
+
+    auto chunk = create_audio_data(1600);  // 100ms
+
+    // One partial per 200ms of audio, however it is chunked
+    EXPECT_EQ(engine->process_audio(chunk), "{}");
+    EXPECT_TRUE(json::parse(engine->process_audio(chunk)).contains("partial"));
+    EXPECT_EQ(engine->process_audio(chunk), "{}");
+    EXPECT_TRUE(json::parse(engine->process_audio(create_audio_data(3200))).contains("partial"));
+
+    // A final result restarts the interval
+    EXPECT_EQ(engine->process_audio(chunk), "{}");
+    EXPECT_TRUE(json::parse(engine->process_audio({}, true)).contains("text"));
+    EXPECT_EQ(engine->process_audio(chunk), "{}");
+    EXPECT_TRUE(json::parse(engine->process_audio(chunk)).contains("partial"));
+}
+
+// Test that a zero interval reports a partial for every chunk
+TEST_F(VStreamEngineTest, PartialCadenceDisabledReportsEveryChunk) {
+    engine = std::make_unique<testable_vstream_engine>("/path/to/model");
+
+    auto chunk = create_audio_data(160);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(json::parse(engine->process_audio(chunk)).contains("partial"));
+    }
+}
+
+// Test that each session keeps its own decoder state
+TEST_F(VStreamEngineTest, SessionsDecodeIndependently) {
+    testable_vstream_engine::config cfg;
+    cfg.partial_interval_ms = 200;
+    engine = std::make_unique<testable_vstream_engine>("/path/to/model", cfg);
+
+    auto chunk = create_audio_data(1600);
+
+    // Interleaved sessions do not advance each other's partial cadence
+    EXPECT_EQ(engine->process_audio("a", chunk), "{}");
+    EXPECT_EQ(engine->process_audio("b", chunk), "{}");
+    EXPECT_TRUE(json::parse(engine->process_audio("a", chunk)).contains("partial"));
+    EXPECT_TRUE(json::parse(engine->process_audio("b", chunk)).contains("partial"));
+    EXPECT_EQ(engine->get_session_count(), 2u);
+
+    engine->release_session("a");
+    EXPECT_FALSE(engine->has_session("a"));
+    EXPECT_EQ(engine->process_audio("a", chunk), "{}");
+}
+
+// Test least recently used eviction when the pool is full
+TEST_F(VStreamEngineTest, SessionPoolEvictsLeastRecentlyUsed) {
+    testable_vstream_engine::config cfg;
+    cfg.max_sessions = 2;
+    engine = std::make_unique<testable_vstream_engine>("/path/to/model", cfg);
+
+    auto chunk = create_audio_data(160);
+    engine->process_audio("a", chunk);
+    engine->process_audio("b", chunk);
+    engine->process_audio("a", chunk);  // "b" is now the oldest
+
+    engine->process_audio("c", chunk);
+    EXPECT_EQ(engine->get_session_count(), 2u);
+    EXPECT_TRUE(engine->has_session("a"));
+    EXPECT_FALSE(engine->has_session("b"));
+    EXPECT_TRUE(engine->has_session("c"));
+}
+
+// Test that sessions in use are never evicted
+TEST_F(VStreamEngineTest, SessionPoolSkipsSessionsInUse) {
+    testable_vstream_engine::config cfg;
+    cfg.max_sessions = 2;
+    engine = std::make_unique<testable_vstream_engine>("/path/to/model", cfg);
+
+    auto held = engine->acquire_session("a");
+    engine->process_audio("b", create_audio_data(160));
+
+    // "a" is older but held, so "b" makes room
+    engine->acquire_session("c");
+    EXPECT_TRUE(engine->has_session("a"));
+    EXPECT_FALSE(engine->has_session("b"));
+
+    // Every session held: nothing can be evicted
+    auto held_c = engine->acquire_session("c");
+    EXPECT_THROW(engine->acquire_session("d"), std::runtime_error);
+    EXPECT_EQ(engine->get_session_count(), 2u);
+}
+
 // Test empty audio handling
 TEST_F(VStreamEngineTest, EmptyAudioHandling) {
     engine = std::make_unique<testable_vstream_engine>("/path/to/model");
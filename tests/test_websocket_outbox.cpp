@@ -0,0 +1,81 @@
+// -------------------------------------------------------------------------------------------------
+//
+// Copyright (C) all of the contributors. All rights reserved.
+//
+// This software, including documentation, is protected by copyright controlled by
+// contributors. All rights are reserved. Copying, including reproducing, storing,
+// adapting or translating, any or all of this material requires the prior written
+// consent of all contributors.
+//
+// -------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+#include "websocket_outbox.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+
+websocket_outbox::message frame(const std::string& json, bool transcript = false) {
+    websocket_outbox::message msg;
+    msg.json = json;
+    msg.transcript = transcript;
+    return msg;
+}
+
+} // namespace
+
+TEST(WebSocketOutboxTest, TakesMessagesOfOneSessionInOrder) {
+    websocket_outbox outbox;
+    outbox.push("s1", frame("a"));
+    outbox.push("s2", frame("x"));
+    outbox.push("s1", frame("b"));
+    EXPECT_EQ(outbox.size(), 3u);
+
+    auto messages = outbox.take("s1");
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0].json, "a");
+    EXPECT_EQ(messages[1].json, "b");
+    EXPECT_TRUE(outbox.take("s1").empty());
+    EXPECT_EQ(outbox.size(), 1u);
+}
+
+TEST(WebSocketOutboxTest, DropsOldestBeyondSessionLimit) {
+    websocket_outbox outbox(2);
+    outbox.push("s1", frame("a"));
+    outbox.push("s1", frame("b"));
+    outbox.push("s1", frame("c"));
+
+    EXPECT_EQ(outbox.get_dropped(), 1u);
+    EXPECT_EQ(outbox.size(), 2u);
+    auto messages = outbox.take("s1");
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0].json, "b");
+    EXPECT_EQ(messages[1].json, "c");
+}
+
+TEST(WebSocketOutboxTest, HandsBackMessagesOfQuietSessions) {
+    websocket_outbox outbox;
+    auto transcript = frame("{\"type\":\"transcribe\"}", true);
+    transcript.text = "hello";
+    transcript.confidence = 0.9f;
+    outbox.push("quiet", transcript);
+    outbox.push("quiet", frame("{\"type\":\"speaker\"}"));
+
+    EXPECT_TRUE(outbox.take_stale(std::chrono::milliseconds(10000)).empty());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    outbox.push("active", frame("{\"type\":\"speaker\"}"));
+
+    auto stale = outbox.take_stale(std::chrono::milliseconds(10));
+    ASSERT_EQ(stale.size(), 2u);
+    EXPECT_EQ(stale[0].first, "quiet");
+    EXPECT_TRUE(stale[0].second.transcript);
+    EXPECT_EQ(stale[0].second.text, "hello");
+    EXPECT_FLOAT_EQ(stale[0].second.confidence, 0.9f);
+    EXPECT_FALSE(stale[1].second.transcript);
+
+    // A session that just got a message keeps it for its next frame
+    EXPECT_EQ(outbox.size(), 1u);
+    EXPECT_EQ(outbox.take("active").size(), 1u);
+}